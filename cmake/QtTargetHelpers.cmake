@@ -485,13 +485,16 @@ function(qt_internal_create_tracepoints name tracepoints_file)
     set(header_filename "${provider_name}_tracepoints_p.h")
     set(header_path "${CMAKE_CURRENT_BINARY_DIR}/${header_filename}")
 
-    if(QT_FEATURE_lttng OR QT_FEATURE_etw)
-        set(source_path "${CMAKE_CURRENT_BINARY_DIR}/${provider_name}_tracepoints.cpp")
-        qt_configure_file(OUTPUT "${source_path}"
-            CONTENT "#define TRACEPOINT_CREATE_PROBES
+    if(QT_FEATURE_lttng OR QT_FEATURE_etw OR QT_FEATURE_trace_builtin)
+        # the built-in backend needs no probes; its tracepoints are all inline
+        if(NOT QT_FEATURE_trace_builtin)
+            set(source_path "${CMAKE_CURRENT_BINARY_DIR}/${provider_name}_tracepoints.cpp")
+            qt_configure_file(OUTPUT "${source_path}"
+                CONTENT "#define TRACEPOINT_CREATE_PROBES
 #define TRACEPOINT_DEFINE
 #include \"${header_filename}\"")
-        target_sources(${name} PRIVATE "${source_path}")
+            target_sources(${name} PRIVATE "${source_path}")
+        endif()
         target_compile_definitions(${name} PRIVATE Q_TRACEPOINT)
 
         if(QT_FEATURE_lttng)
@@ -499,6 +502,8 @@ function(qt_internal_create_tracepoints name tracepoints_file)
             target_link_libraries(${name} PRIVATE LTTng::UST)
         elseif(QT_FEATURE_etw)
             set(tracegen_arg "etw")
+        elseif(QT_FEATURE_trace_builtin)
+            set(tracegen_arg "builtin")
         endif()
 
         if(QT_HOST_PATH)
@@ -331,6 +331,28 @@ shmctl(0, 0, (struct shmid_ds *)(0));
 }
 ")
 
+# io_uring
+qt_config_compile_test(io_uring
+    LABEL "io_uring"
+    CODE
+"#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+struct io_uring_params params = {};
+struct io_uring_sqe sqe = {};
+sqe.opcode = IORING_OP_READ;
+(void)sqe;
+return int(syscall(__NR_io_uring_setup, 1, &params));
+    /* END TEST: */
+    return 0;
+}
+")
+
 # ipc_posix
 if (LINUX)
     set(ipc_posix_TEST_LIBRARIES pthread rt)
@@ -603,6 +625,10 @@ qt_feature("inotify" PUBLIC PRIVATE
     CONDITION TEST_inotify
 )
 qt_feature_definition("inotify" "QT_NO_INOTIFY" NEGATE VALUE "1")
+qt_feature("io_uring" PRIVATE
+    LABEL "io_uring"
+    CONDITION LINUX AND QT_FEATURE_future AND TEST_io_uring
+)
 qt_feature("ipc_posix"
     LABEL "Using POSIX IPC"
     AUTODETECT NOT WIN32
@@ -926,14 +952,21 @@ qt_feature("lttng" PRIVATE
     AUTODETECT OFF
     CONDITION LINUX AND LTTNGUST_FOUND
     ENABLE INPUT_trace STREQUAL 'lttng' OR ( INPUT_trace STREQUAL 'yes' AND LINUX )
-    DISABLE INPUT_trace STREQUAL 'etw' OR INPUT_trace STREQUAL 'no'
+    DISABLE INPUT_trace STREQUAL 'etw' OR INPUT_trace STREQUAL 'builtin' OR INPUT_trace STREQUAL 'no'
 )
 qt_feature("etw" PRIVATE
     LABEL "ETW"
     AUTODETECT OFF
     CONDITION WIN32
     ENABLE INPUT_trace STREQUAL 'etw' OR ( INPUT_trace STREQUAL 'yes' AND WIN32 )
-    DISABLE INPUT_trace STREQUAL 'lttng' OR INPUT_trace STREQUAL 'no'
+    DISABLE INPUT_trace STREQUAL 'lttng' OR INPUT_trace STREQUAL 'builtin' OR INPUT_trace STREQUAL 'no'
+)
+qt_feature("trace_builtin" PRIVATE
+    LABEL "Built-in"
+    AUTODETECT OFF
+    CONDITION QT_FEATURE_thread
+    ENABLE INPUT_trace STREQUAL 'builtin'
+    DISABLE INPUT_trace STREQUAL 'etw' OR INPUT_trace STREQUAL 'lttng' OR INPUT_trace STREQUAL 'no'
 )
 qt_feature("forkfd_pidfd" PRIVATE
     LABEL "CLONE_PIDFD support in forkfd"
@@ -962,7 +995,7 @@ qt_configure_add_summary_entry(ARGS "system-libb2")
 qt_configure_add_summary_entry(ARGS "mimetype-database")
 qt_configure_add_summary_entry(
     TYPE "firstAvailableFeature"
-    ARGS "etw lttng"
+    ARGS "etw lttng trace_builtin"
     MESSAGE "Tracing backend"
 )
 qt_configure_add_summary_section(NAME "Logging backends")
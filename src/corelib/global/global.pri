@@ -18,6 +18,7 @@ HEADERS +=  \
         global/qglobalstatic.h \
         global/qlibraryinfo.h \
         global/qlogging.h \
+        global/qbinarylogging_p.h \
         global/qtypeinfo.h \
         global/qsysinfo.h \
         global/qsimd.h \
@@ -38,6 +39,7 @@ SOURCES += \
         global/qfloat16.cpp \
         global/qoperatingsystemversion.cpp \
         global/qlogging.cpp \
+        global/qbinarylogging.cpp \
         global/qrandom.cpp \
         global/qsimd.cpp \
         global/qhooks.cpp
@@ -107,6 +109,11 @@ linux:!static {
     HEADERS += global/minimum-linux_p.h
 }
 
+qtConfig(trace_builtin) {
+    HEADERS += global/qtracebuffer_p.h
+    SOURCES += global/qtracebuffer.cpp
+}
+
 qtConfig(slog2): \
     LIBS_PRIVATE += -lslog2
 
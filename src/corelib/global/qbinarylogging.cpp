@@ -0,0 +1,697 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qbinarylogging_p.h"
+
+#include "qbytearray.h"
+#include "qcoreapplication.h"
+#include "qdatetime.h"
+#include "qdeadlinetimer.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qstring.h"
+#include "qthread.h"
+#include "qvarlengtharray.h"
+#include "qwaitcondition.h"
+#include <QtCore/private/qlocking_p.h>
+#include <QtCore/private/qlogging_p.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QBinaryLogging {
+
+/*!
+    \internal
+
+    Returns whether messages are written to a binary log, that is whether the
+    QT_BINARY_LOG_FILE environment variable is set.
+*/
+bool isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIsSet("QT_BINARY_LOG_FILE");
+    return enabled;
+}
+
+#if QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+
+namespace {
+
+constexpr quintptr BufferSize = 256 * 1024;    // per thread; must be a power of two
+constexpr int MaxSites = 4096;                  // per thread
+constexpr int FlushInterval = 100;              // ms
+
+using Record = QVarLengthArray<char, 512>;
+
+// How a value is taken from the va_list
+enum ValueKind : quint8 {
+    IntValue,
+    LongValue,
+    LongLongValue,
+    SizeValue,
+    UIntValue,
+    ULongValue,
+    ULongLongValue,
+    USizeValue,
+    DoubleValue,
+    LongDoubleValue,
+    StringValue,
+    PointerValue
+};
+
+static ValueKind valueKind(const FormatConversion &conversion)
+{
+    switch (conversion.argumentType()) {
+    case SignedArgument:
+        switch (conversion.length) {
+        case LongLength:
+        case IntMaxLength:
+            return LongValue;
+        case LongLongLength:
+            return LongLongValue;
+        case SizeLength:
+        case PtrDiffLength:
+            return SizeValue;
+        default:
+            return IntValue;
+        }
+    case UnsignedArgument:
+        switch (conversion.length) {
+        case LongLength:
+            return ULongValue;
+        case LongLongLength:
+            return ULongLongValue;
+        case SizeLength:
+        case PtrDiffLength:
+            return USizeValue;
+        default:
+            return UIntValue;
+        }
+    case DoubleArgument:
+        return conversion.length == LongDoubleLength ? LongDoubleValue : DoubleValue;
+    case StringArgument:
+        return StringValue;
+    case PointerArgument:
+        break;
+    }
+    return PointerValue;
+}
+
+static ArgumentType argumentType(ValueKind kind)
+{
+    switch (kind) {
+    case IntValue:
+    case LongValue:
+    case LongLongValue:
+    case SizeValue:
+        return SignedArgument;
+    case UIntValue:
+    case ULongValue:
+    case ULongLongValue:
+    case USizeValue:
+        return UnsignedArgument;
+    case DoubleValue:
+    case LongDoubleValue:
+        return DoubleArgument;
+    case StringValue:
+        return StringArgument;
+    case PointerValue:
+        break;
+    }
+    return PointerArgument;
+}
+
+template <typename T>
+static void appendValue(Record &record, T value)
+{
+    record.append(reinterpret_cast<const char *>(&value), sizeof value);
+}
+
+static void appendString(Record &record, const char *str, qsizetype size)
+{
+    appendValue(record, quint32(size));
+    record.append(str, size);
+}
+
+static void appendString(Record &record, const char *str)
+{
+    if (str)
+        appendString(record, str, qsizetype(strlen(str)));
+    else
+        appendValue(record, NullString);
+}
+
+static qint64 monotonicNanoseconds()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+    The records logged by one thread. The thread appends to the buffer and
+    the writer thread takes them out, with no lock in between: head is only
+    ever changed by the former, tail only by the latter.
+*/
+class ThreadBuffer
+{
+public:
+    explicit ThreadBuffer(quint32 number)
+        : data(new char[BufferSize]), number(number)
+    {}
+
+    // Returns false if the record does not fit; sets halfFull when the
+    // record made the buffer cross the half-full mark.
+    bool write(const char *record, qsizetype size, bool *halfFull)
+    {
+        const quintptr h = head.loadRelaxed();
+        const quintptr used = h - tail.loadAcquire();
+        if (quintptr(size) > BufferSize - used)
+            return false;
+
+        const quintptr offset = h & (BufferSize - 1);
+        const quintptr first = qMin(quintptr(size), BufferSize - offset);
+        memcpy(data.get() + offset, record, first);
+        memcpy(data.get(), record + first, size - first);
+        head.storeRelease(h + size);
+
+        *halfFull = used < BufferSize / 2 && used + size >= BufferSize / 2;
+        return true;
+    }
+
+    std::unique_ptr<char[]> data;
+    QAtomicInteger<quintptr> head = 0;     // total number of bytes written
+    QAtomicInteger<quintptr> tail = 0;     // total number of bytes taken out
+    QAtomicInteger<bool> retired = false;  // the thread has finished
+    const quint32 number;
+};
+
+class BinaryLogWriter
+{
+public:
+    BinaryLogWriter();
+    ~BinaryLogWriter();
+
+    bool isOpen() const { return file != nullptr; }
+    qint64 timestamp() const { return monotonicNanoseconds() - startTime; }
+
+    std::shared_ptr<ThreadBuffer> registerThread();
+    void wake();
+    void drain();
+
+private:
+    void run();
+
+    FILE *file = nullptr;
+    const qint64 startTime;
+
+    QMutex mutex;
+    QWaitCondition condition;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    quint32 threadCount = 0;
+    bool wakeRequested = false;
+    bool quit = false;
+
+    QMutex drainMutex;
+    std::thread thread;
+};
+
+BinaryLogWriter::BinaryLogWriter()
+    : startTime(monotonicNanoseconds())
+{
+    const QByteArray fileName = qgetenv("QT_BINARY_LOG_FILE");
+    if (fileName.isEmpty())
+        return;
+    file = fopen(fileName.constData(), "wb");
+    if (!file) {
+        fprintf(stderr, "QBinaryLogging: cannot open %s for writing: %s\n",
+                fileName.constData(), strerror(errno));
+        return;
+    }
+
+    const qint64 wallClockTime = QDateTime::currentMSecsSinceEpoch();
+    const qint64 bootTime = QDeadlineTimer::current().deadlineNSecs();
+    const qint64 pid = QCoreApplication::applicationPid();
+    fwrite(Magic, sizeof Magic, 1, file);
+    fwrite(&Version, sizeof Version, 1, file);
+    fwrite(&ByteOrderMark, sizeof ByteOrderMark, 1, file);
+    fwrite(&wallClockTime, sizeof wallClockTime, 1, file);
+    fwrite(&bootTime, sizeof bootTime, 1, file);
+    fwrite(&pid, sizeof pid, 1, file);
+
+    thread = std::thread([this] { run(); });
+}
+
+BinaryLogWriter::~BinaryLogWriter()
+{
+    if (!file)
+        return;
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        quit = true;
+        condition.wakeOne();
+    }
+    thread.join();
+    drain();
+    fclose(file);
+}
+
+std::shared_ptr<ThreadBuffer> BinaryLogWriter::registerThread()
+{
+    const auto locker = qt_scoped_lock(mutex);
+    buffers.push_back(std::make_shared<ThreadBuffer>(++threadCount));
+    return buffers.back();
+}
+
+void BinaryLogWriter::wake()
+{
+    const auto locker = qt_scoped_lock(mutex);
+    wakeRequested = true;
+    condition.wakeOne();
+}
+
+void BinaryLogWriter::run()
+{
+    auto locker = qt_unique_lock(mutex);
+    while (!quit) {
+        if (!wakeRequested)
+            condition.wait(locker.mutex(), QDeadlineTimer(FlushInterval));
+        wakeRequested = false;
+        locker.unlock();
+        drain();
+        locker.lock();
+    }
+}
+
+/*
+    Writes out everything the threads have logged so far. Called regularly by
+    the writer thread, and by any thread that needs the log to be complete,
+    such as before a fatal message terminates the application.
+*/
+void BinaryLogWriter::drain()
+{
+    const auto drainLocker = qt_scoped_lock(drainMutex);
+
+    std::vector<std::shared_ptr<ThreadBuffer>> current;
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        current = buffers;
+    }
+
+    bool removeRetired = false;
+    for (const auto &buffer : current) {
+        // check before taking the records, so that none written before it retired are missed
+        const bool retired = buffer->retired.loadAcquire();
+        const quintptr h = buffer->head.loadAcquire();
+        const quintptr t = buffer->tail.loadRelaxed();
+        if (h != t) {
+            const quint32 size = quint32(h - t);
+            const quintptr offset = t & (BufferSize - 1);
+            const quintptr first = qMin(quintptr(size), BufferSize - offset);
+            fwrite(&buffer->number, sizeof buffer->number, 1, file);
+            fwrite(&size, sizeof size, 1, file);
+            fwrite(buffer->data.get() + offset, 1, first, file);
+            fwrite(buffer->data.get(), 1, size - first, file);
+            buffer->tail.storeRelease(h);
+        }
+        removeRetired |= retired;
+    }
+    fflush(file);
+
+    if (removeRetired) {
+        const auto locker = qt_scoped_lock(mutex);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto &buffer) {
+                          return buffer->retired.loadAcquire()
+                                  && buffer->head.loadAcquire() == buffer->tail.loadRelaxed();
+                      }), buffers.end());
+    }
+}
+
+Q_GLOBAL_STATIC(BinaryLogWriter, binaryLogWriter)
+
+static BinaryLogWriter *writer()
+{
+    if (!isEnabled())
+        return nullptr;
+    BinaryLogWriter *writer = binaryLogWriter();
+    return writer && writer->isOpen() ? writer : nullptr;
+}
+
+struct SiteKey
+{
+    const char *format;
+    const char *category;
+    const char *file;
+    const char *function;
+    int line;
+    QtMsgType type;
+
+    friend bool operator==(const SiteKey &lhs, const SiteKey &rhs) noexcept
+    {
+        return lhs.format == rhs.format && lhs.category == rhs.category
+                && lhs.file == rhs.file && lhs.function == rhs.function
+                && lhs.line == rhs.line && lhs.type == rhs.type;
+    }
+};
+
+size_t qHash(const SiteKey &key, size_t seed = 0) noexcept
+{
+    return qHashMulti(seed, key.format, key.category, key.file, key.function, key.line,
+                      int(key.type));
+}
+
+// A place messages are logged from, with the arguments its format takes
+struct Site
+{
+    QByteArray format;      // to notice a buffer being reused for another format
+    QVarLengthArray<ValueKind, 8> values;
+    quint32 id = 0;
+    bool supported = false;
+    bool announced = false; // the site record has been written
+};
+
+// What a thread needs to log, owned by the thread itself
+struct ThreadState
+{
+    enum State : quint8 { Unused, Alive, Destroyed };
+
+    ~ThreadState()
+    {
+        if (buffer)
+            buffer->retired.storeRelease(true);
+        state = Destroyed;
+    }
+
+    Site *site(QtMsgType type, const QMessageLogContext &context, const char *format);
+    bool commit(BinaryLogWriter *writer, const Record &record);
+
+    std::shared_ptr<ThreadBuffer> buffer;
+    QHash<SiteKey, Site> sites;
+    quint32 nextSiteId = 1;
+    quint64 dropped = 0;
+
+    static thread_local State state;
+};
+thread_local ThreadState::State ThreadState::state = ThreadState::Unused;
+thread_local ThreadState threadState;
+
+static ThreadState *currentThreadState(BinaryLogWriter *writer)
+{
+    // messages can still be logged while the thread is being torn down
+    if (ThreadState::state == ThreadState::Destroyed)
+        return nullptr;
+    ThreadState::state = ThreadState::Alive;
+    if (!threadState.buffer) {
+        threadState.buffer = writer->registerThread();
+
+        Record record;
+        appendValue(record, ThreadRecord);
+        appendValue(record, quint64(quintptr(QThread::currentThreadId())));
+        appendValue(record, QtPrivate::logThreadId());
+        threadState.commit(writer, record);
+    }
+    return &threadState;
+}
+
+Site *ThreadState::site(QtMsgType type, const QMessageLogContext &context, const char *format)
+{
+    const SiteKey key = { format, context.category, context.file, context.function,
+                          context.line, type };
+    auto it = sites.find(key);
+    if (it != sites.end() && qstrcmp(it->format, format) == 0)
+        return it->supported ? &*it : nullptr;
+
+    if (it == sites.end() && sites.size() >= MaxSites)
+        return nullptr;
+
+    Site site;
+    site.format = format;
+    site.id = nextSiteId++;
+    site.supported = parseFormat(format, [&site](const FormatConversion &conversion) {
+        if (conversion.widthArgument)
+            site.values.append(IntValue);
+        if (conversion.precisionArgument)
+            site.values.append(IntValue);
+        site.values.append(valueKind(conversion));
+    }) && site.values.size() <= MaxArguments;
+
+    it = sites.insert(key, std::move(site));
+    return it->supported ? &*it : nullptr;
+}
+
+/*
+    Appends \a record to the buffer of the thread. If it does not fit, the
+    record is dropped; the number of records lost is logged as soon as there
+    is room again.
+*/
+bool ThreadState::commit(BinaryLogWriter *writer, const Record &record)
+{
+    bool halfFull = false;
+    if (dropped) {
+        Record notice;
+        appendValue(notice, DroppedRecord);
+        appendValue(notice, writer->timestamp());
+        appendValue(notice, dropped);
+        if (!buffer->write(notice.constData(), notice.size(), &halfFull)) {
+            ++dropped;
+            return false;
+        }
+        dropped = 0;
+    }
+
+    bool crossed = false;
+    if (!buffer->write(record.constData(), record.size(), &crossed)) {
+        if (dropped++ == 0)
+            writer->wake();
+        return false;
+    }
+    if (halfFull || crossed)
+        writer->wake();
+    return true;
+}
+
+static void appendContext(Record &record, QtMsgType type, const QMessageLogContext &context)
+{
+    appendValue(record, quint8(type));
+    appendValue(record, qint32(context.line));
+    appendString(record, context.category);
+    appendString(record, context.file);
+    appendString(record, context.function);
+}
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Writes a message with format \a format and arguments \a ap to the binary
+    log, without formatting it. The format and the location the message is
+    logged from are stored the first time a thread uses them, later only an id
+    for them followed by the raw values of the arguments.
+
+    Returns false without touching \a ap if there is no binary log or the
+    format uses conversions that cannot be stored that way; the caller is
+    expected to format the message itself then.
+*/
+bool logMessage(QtMsgType type, const QMessageLogContext &context, const char *format, va_list ap)
+{
+    BinaryLogWriter *writer = QBinaryLogging::writer();
+    if (!writer || !format)
+        return false;
+    ThreadState *state = currentThreadState(writer);
+    if (!state)
+        return false;
+    Site *site = state->site(type, context, format);
+    if (!site)
+        return false;
+
+    Record record;
+    if (!site->announced) {
+        appendValue(record, SiteRecord);
+        appendValue(record, site->id);
+        appendContext(record, type, context);
+        appendString(record, format);
+        appendValue(record, quint8(site->values.size()));
+        for (ValueKind kind : qAsConst(site->values))
+            appendValue(record, argumentType(kind));
+    }
+
+    appendValue(record, MessageRecord);
+    appendValue(record, site->id);
+    appendValue(record, writer->timestamp());
+    for (ValueKind kind : qAsConst(site->values)) {
+        switch (kind) {
+        case IntValue:
+            appendValue(record, qint64(va_arg(ap, int)));
+            break;
+        case LongValue:
+            appendValue(record, qint64(va_arg(ap, long)));
+            break;
+        case LongLongValue:
+            appendValue(record, qint64(va_arg(ap, qint64)));
+            break;
+        case SizeValue:
+            appendValue(record, qint64(va_arg(ap, qsizetype)));
+            break;
+        case UIntValue:
+            appendValue(record, quint64(va_arg(ap, uint)));
+            break;
+        case ULongValue:
+            appendValue(record, quint64(va_arg(ap, ulong)));
+            break;
+        case ULongLongValue:
+            appendValue(record, quint64(va_arg(ap, quint64)));
+            break;
+        case USizeValue:
+            appendValue(record, quint64(va_arg(ap, size_t)));
+            break;
+        case DoubleValue:
+            appendValue(record, va_arg(ap, double));
+            break;
+        case LongDoubleValue:
+            appendValue(record, double(va_arg(ap, long double)));
+            break;
+        case StringValue:
+            appendString(record, va_arg(ap, const char *));
+            break;
+        case PointerValue:
+            appendValue(record, quint64(quintptr(va_arg(ap, void *))));
+            break;
+        }
+    }
+
+    if (state->commit(writer, record))
+        site->announced = true;
+    return true;
+}
+
+/*!
+    \internal
+
+    Writes the already formatted \a message to the binary log. Returns false
+    if there is no binary log.
+*/
+bool logText(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    BinaryLogWriter *writer = QBinaryLogging::writer();
+    if (!writer)
+        return false;
+    ThreadState *state = currentThreadState(writer);
+    if (!state)
+        return false;
+
+    const QByteArray text = message.toUtf8();
+    Record record;
+    appendValue(record, TextRecord);
+    appendValue(record, writer->timestamp());
+    appendContext(record, type, context);
+    appendString(record, text.constData(), text.size());
+    state->commit(writer, record);
+    return true;
+}
+
+/*!
+    \internal
+
+    Records that the application is called \a name from now on, so that
+    %{appname} is decoded like it would have been printed.
+*/
+void applicationNameChanged(const QString &name)
+{
+    BinaryLogWriter *writer = QBinaryLogging::writer();
+    if (!writer)
+        return;
+    ThreadState *state = currentThreadState(writer);
+    if (!state)
+        return;
+
+    const QByteArray text = name.toUtf8();
+    Record record;
+    appendValue(record, ApplicationRecord);
+    appendValue(record, writer->timestamp());
+    appendString(record, text.constData(), text.size());
+    state->commit(writer, record);
+}
+
+/*!
+    \internal
+
+    Writes everything logged so far to the binary log file.
+*/
+void flush()
+{
+    if (binaryLogWriter.exists()) {
+        if (BinaryLogWriter *writer = binaryLogWriter(); writer && writer->isOpen())
+            writer->drain();
+    }
+}
+
+#else // !QT_CONFIG(thread) || !Q_COMPILER_THREAD_LOCAL
+
+bool logMessage(QtMsgType, const QMessageLogContext &, const char *, va_list)
+{
+    return false;
+}
+
+bool logText(QtMsgType, const QMessageLogContext &, const QString &)
+{
+    return false;
+}
+
+void applicationNameChanged(const QString &)
+{
+}
+
+void flush()
+{
+}
+
+#endif // QT_CONFIG(thread) && Q_COMPILER_THREAD_LOCAL
+
+} // namespace QBinaryLogging
+
+QT_END_NAMESPACE
@@ -0,0 +1,274 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBINARYLOGGING_P_H
+#define QBINARYLOGGING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qlogging.h>
+
+#include <stdarg.h>
+
+QT_BEGIN_NAMESPACE
+
+class QString;
+
+/*
+    The binary log format, as written when QT_BINARY_LOG_FILE is set and read
+    by the qlogdecode tool. All values are in the byte order of the writing
+    machine, as given by the byte order mark in the file header.
+
+    File header:
+        char[8]   Magic
+        quint32   Version
+        quint32   ByteOrderMark
+        qint64    wall-clock time of the start of the log, in ms since the epoch
+        qint64    time of the start of the log on the clock of QDeadlineTimer, in ns
+        qint64    process id
+
+    The header is followed by chunks of records, each written by one thread:
+        quint32   thread number (counting from 1, in order of the first message)
+        quint32   size of the records in bytes
+        char[]    records
+
+    Strings are stored as a quint32 length followed by that many bytes of
+    UTF-8, with NullString as length for a null pointer. Timestamps are in
+    nanoseconds since the start of the log. Every record starts with a quint8
+    RecordType:
+
+    ThreadRecord, first record of every thread:
+        quint64   native id of the thread
+        qint64    id of the thread as printed by %{threadid}
+
+    SiteRecord, the first time a thread logs from a given place:
+        quint32   site id, unique within the thread
+        quint8    QtMsgType
+        qint32    line
+        string    category, file, function, format
+        quint8    number of arguments, followed by one quint8 ArgumentType each
+
+    MessageRecord, a message logged with a printf-style format:
+        quint32   site id
+        qint64    timestamp
+        then one value per argument of the site: qint64 for SignedArgument,
+        quint64 for UnsignedArgument and PointerArgument, double for
+        DoubleArgument and a string for StringArgument.
+
+    TextRecord, a message that was already formatted when logged, such as
+    the ones streamed into a QDebug:
+        qint64    timestamp
+        quint8    QtMsgType
+        qint32    line
+        string    category, file, function, message
+
+    DroppedRecord, written when messages had to be discarded because the
+    buffer of the thread was full:
+        qint64    timestamp
+        quint64   number of messages lost
+
+    ApplicationRecord, written when the application name is set, and applying
+    to the messages logged after it:
+        qint64    timestamp
+        string    application name
+*/
+namespace QBinaryLogging {
+
+constexpr char Magic[8] = { 'Q', 'T', 'B', 'I', 'N', 'L', 'O', 'G' };
+constexpr quint32 Version = 2;
+constexpr quint32 ByteOrderMark = 0x01020304;
+constexpr quint32 NullString = 0xffffffff;
+constexpr int MaxArguments = 64;
+
+enum RecordType : quint8 {
+    ThreadRecord = 1,
+    SiteRecord,
+    MessageRecord,
+    TextRecord,
+    DroppedRecord,
+    ApplicationRecord
+};
+
+enum ArgumentType : quint8 {
+    SignedArgument = 1,
+    UnsignedArgument,
+    DoubleArgument,
+    StringArgument,
+    PointerArgument
+};
+
+enum LengthModifier : quint8 {
+    NoLength,
+    CharLength,         // hh
+    ShortLength,        // h
+    LongLength,         // l
+    LongLongLength,     // ll
+    LongDoubleLength,   // L
+    IntMaxLength,       // j
+    SizeLength,         // z, Z
+    PtrDiffLength       // t
+};
+
+// One conversion of a printf-style format, as understood by QString::vasprintf()
+struct FormatConversion
+{
+    const char *begin;          // the '%'
+    const char *end;            // one past the conversion character
+    bool widthArgument;         // width given as '*'
+    bool precisionArgument;     // precision given as '*'
+    LengthModifier length;
+    char conversion;
+
+    ArgumentType argumentType() const noexcept
+    {
+        switch (conversion) {
+        case 'd': case 'i': case 'c':
+            return SignedArgument;
+        case 'o': case 'u': case 'x': case 'X':
+            return UnsignedArgument;
+        case 's':
+            return StringArgument;
+        case 'p':
+            return PointerArgument;
+        }
+        return DoubleArgument;
+    }
+};
+
+/*
+    Calls \a callback with each conversion in \a format, in order, and returns
+    true; or returns false as soon as the format contains something that
+    cannot be recorded as plain values: %n, wide strings and escapes that
+    QString::vasprintf() would print literally.
+*/
+template <typename Callback>
+bool parseFormat(const char *format, Callback callback)
+{
+    for (const char *c = format; *c; ) {
+        if (*c != '%') {
+            ++c;
+            continue;
+        }
+        FormatConversion conversion = { c, nullptr, false, false, NoLength, 0 };
+        ++c;
+        if (*c == '%') {
+            ++c;
+            continue;
+        }
+        while (*c == '#' || *c == '0' || *c == '-' || *c == ' ' || *c == '+' || *c == '\'')
+            ++c;
+        if (*c == '*') {
+            conversion.widthArgument = true;
+            ++c;
+        } else {
+            while (*c >= '0' && *c <= '9')
+                ++c;
+        }
+        if (*c == '.') {
+            ++c;
+            if (*c == '*') {
+                conversion.precisionArgument = true;
+                ++c;
+            } else {
+                while (*c >= '0' && *c <= '9')
+                    ++c;
+            }
+        }
+        switch (*c) {
+        case 'h':
+            ++c;
+            conversion.length = *c == 'h' ? (++c, CharLength) : ShortLength;
+            break;
+        case 'l':
+            ++c;
+            conversion.length = *c == 'l' ? (++c, LongLongLength) : LongLength;
+            break;
+        case 'L': ++c; conversion.length = LongDoubleLength; break;
+        case 'j': ++c; conversion.length = IntMaxLength; break;
+        case 'z':
+        case 'Z': ++c; conversion.length = SizeLength; break;
+        case 't': ++c; conversion.length = PtrDiffLength; break;
+        }
+        switch (*c) {
+        case 'd': case 'i':
+            if (conversion.length == LongDoubleLength)
+                return false;   // printed as 0 by vasprintf
+            break;
+        case 'o': case 'u': case 'x': case 'X':
+            if (conversion.length == LongDoubleLength || conversion.length == IntMaxLength)
+                return false;   // printed as 0 by vasprintf
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        case 'c': case 'p':
+            break;
+        case 's':
+            if (conversion.length != NoLength)
+                return false;   // %ls
+            break;
+        default:
+            return false;       // %n, incomplete or unknown escapes
+        }
+        conversion.conversion = *c++;
+        conversion.end = c;
+        callback(conversion);
+    }
+    return true;
+}
+
+bool isEnabled();
+bool logMessage(QtMsgType type, const QMessageLogContext &context, const char *format, va_list ap);
+bool logText(QtMsgType type, const QMessageLogContext &context, const QString &message);
+void applicationNameChanged(const QString &name);
+void flush();
+
+} // namespace QBinaryLogging
+
+QT_END_NAMESPACE
+
+#endif // QBINARYLOGGING_P_H
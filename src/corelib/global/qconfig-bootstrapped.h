@@ -93,11 +93,13 @@
 #define QT_NO_GEOM_VARIANT
 #define QT_FEATURE_hijricalendar -1
 #define QT_FEATURE_icu -1
+#define QT_FEATURE_io_uring -1
 #define QT_FEATURE_islamiccivilcalendar -1
 #define QT_FEATURE_jalalicalendar -1
 #define QT_FEATURE_journald -1
 #define QT_FEATURE_futimens -1
 #define QT_FEATURE_futimes -1
+#define QT_FEATURE_future -1
 #define QT_FEATURE_itemmodel -1
 #define QT_FEATURE_library -1
 #ifdef __linux__
@@ -130,6 +132,7 @@
 #define QT_FEATURE_textdate 1
 #define QT_FEATURE_thread -1
 #define QT_FEATURE_timezone -1
+#define QT_FEATURE_trace_builtin -1
 #define QT_FEATURE_topleveldomain -1
 #define QT_NO_TRANSLATION
 #define QT_FEATURE_translation -1
@@ -4406,6 +4406,12 @@ bool QInternal::activateCallbacks(Callback cb, void **parameters)
     To suppress the output at run-time, install your own message handler
     with qInstallMessageHandler().
 
+    If the \c QT_BINARY_LOG_FILE environment variable is set, debug and
+    informational messages are written to the file it names instead of being
+    passed to the message handler. Messages logged with a format string are
+    stored there without being formatted, as the format and the raw values of
+    the arguments; the \c qlogdecode tool turns the file into text later.
+
     \sa qInfo(), qWarning(), qCritical(), qFatal(), qInstallMessageHandler(),
         {Debugging Techniques}
 */
@@ -4444,6 +4450,10 @@ bool QInternal::activateCallbacks(Callback cb, void **parameters)
     To suppress the output at run-time, install your own message handler
     with qInstallMessageHandler().
 
+    Like debug messages, informational messages are written to a binary log
+    instead if the \c QT_BINARY_LOG_FILE environment variable is set; see
+    qDebug() for details.
+
     \sa qDebug(), qWarning(), qCritical(), qFatal(), qInstallMessageHandler(),
         {Debugging Techniques}
 */
@@ -46,6 +46,7 @@
 #include "qbytearray.h"
 #include "qscopeguard.h"
 #include "qstring.h"
+#include "qstringconverter.h"
 #include "qvarlengtharray.h"
 #include "qdebug.h"
 #include "qmutex.h"
@@ -57,10 +58,15 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#include "private/qbinarylogging_p.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
 #include <qtcore_tracepoints_p.h>
+#if QT_CONFIG(thread)
+#include "qwaitcondition.h"
+#include <thread>
+#endif
 #endif
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
@@ -219,6 +225,24 @@ static bool isDefaultCategory(const char *category)
     return !category || strcmp(category, "default") == 0;
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+
+    Returns whether a message of type \a msgType should be logged, as far as
+    the default category is concerned: qDebug, qWarning, ... macros do not
+    check whether the category is enabled.
+*/
+static bool isDefaultCategoryEnabled(QtMsgType msgType, const QMessageLogContext &context)
+{
+    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
+        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory())
+            return defaultCategory->isEnabled(msgType);
+    }
+    return true;
+}
+#endif
+
 /*!
     Returns true if writing to \c stderr is supported.
 
@@ -371,6 +395,19 @@ static inline void convert_to_wchar_t_elided(wchar_t *d, size_t space, const cha
 Q_NEVER_INLINE
 static QString qt_message(QtMsgType msgType, const QMessageLogContext &context, const char *msg, va_list ap)
 {
+#ifndef QT_BOOTSTRAPPED
+    // debug and info messages go to the binary log unformatted, if one is written
+    if ((msgType == QtDebugMsg || msgType == QtInfoMsg) && QBinaryLogging::isEnabled()) {
+        if (!isDefaultCategoryEnabled(msgType, context))
+            return QString();
+        va_list copy;
+        va_copy(copy, ap);
+        const bool logged = QBinaryLogging::logMessage(msgType, context, msg, copy);
+        va_end(copy);
+        if (logged)
+            return QString();
+    }
+#endif
     QString buf = QString::vasprintf(msg, ap);
     qt_message_print(msgType, context, buf);
     return buf;
@@ -1077,25 +1114,80 @@ struct QMessagePattern
 
     void setPattern(const QString &pattern);
 
-    // 0 terminated arrays of literal tokens / literal or placeholder tokens
-    std::unique_ptr<std::unique_ptr<const char[]>[]> literals;
-    std::unique_ptr<const char *[]> tokens;
-    QList<QString> timeArgs; // timeFormats in sequence of %{time
-#ifndef QT_BOOTSTRAPPED
-    QElapsedTimer timer;
-#endif
+    enum TokenType : quint8 {
+        LiteralToken,
+        MessageToken,
+        CategoryToken,
+        TypeToken,
+        FileToken,
+        LineToken,
+        FunctionToken,
+        PidToken,
+        AppnameToken,
+        ThreadidToken,
+        QthreadptrToken,
+        TimeToken,
+        BacktraceToken,
+        IfCategoryToken,
+        IfDebugToken,
+        IfInfoToken,
+        IfWarningToken,
+        IfCriticalToken,
+        IfFatalToken,
+        EndifToken
+    };
+
+    struct Token
+    {
+        TokenType type;
+        // index into literals, timeArgs or backtraceArgs; for the %{if-*}
+        // tokens, the index of the token following the matching %{endif}
+        int arg;
+    };
+
+    struct TimeParams
+    {
+        enum Kind : quint8 { Process, Boot, IsoDate, Format };
+        Kind kind;
+        QString format;
+    };
+
 #ifdef QLOGGING_HAVE_BACKTRACE
     struct BacktraceParams
     {
         QString backtraceSeparator;
         int backtraceDepth;
     };
-    QList<BacktraceParams> backtraceArgs; // backtrace argumens in sequence of %{backtrace
+#endif
+
+    // A pattern is compiled once into a list of tokens and never changes
+    // afterwards, so messages are formatted without taking the mutex.
+    // Patterns replaced by qSetMessagePattern() stay alive until the
+    // QMessagePattern is destroyed, as other threads may still use them.
+    struct Compiled
+    {
+        QList<Token> tokens;
+        QList<QString> literals;
+        QList<TimeParams> timeArgs; // timeFormats in sequence of %{time
+#ifdef QLOGGING_HAVE_BACKTRACE
+        QList<BacktraceParams> backtraceArgs; // backtrace argumens in sequence of %{backtrace
+#endif
+        std::unique_ptr<Compiled> previous;
+    };
+
+    const Compiled *compiled() const { return current.loadAcquire(); }
+
+    std::unique_ptr<Compiled> pattern;
+    QAtomicPointer<const Compiled> current;
+#ifndef QT_BOOTSTRAPPED
+    QElapsedTimer timer;
 #endif
 
     bool fromEnvironment;
     static QBasicMutex mutex;
 };
+Q_DECLARE_TYPEINFO(QMessagePattern::Token, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(QMessagePattern::TimeParams, Q_RELOCATABLE_TYPE);
 #ifdef QLOGGING_HAVE_BACKTRACE
 Q_DECLARE_TYPEINFO(QMessagePattern::BacktraceParams, Q_RELOCATABLE_TYPE);
 #endif
@@ -1121,11 +1213,6 @@ QMessagePattern::~QMessagePattern() = default;
 
 void QMessagePattern::setPattern(const QString &pattern)
 {
-    timeArgs.clear();
-#ifdef QLOGGING_HAVE_BACKTRACE
-    backtraceArgs.clear();
-#endif
-
     // scanner
     QList<QString> lexemes;
     QString lexeme;
@@ -1158,9 +1245,8 @@ void QMessagePattern::setPattern(const QString &pattern)
         lexemes.append(lexeme);
 
     // tokenizer
-    std::vector<std::unique_ptr<const char[]>> literalsVar;
-    tokens.reset(new const char *[lexemes.size() + 1]);
-    tokens[lexemes.size()] = nullptr;
+    auto compiled = std::make_unique<Compiled>();
+    compiled->tokens.reserve(lexemes.size());
 
     bool nestedIfError = false;
     bool inIf = false;
@@ -1168,39 +1254,49 @@ void QMessagePattern::setPattern(const QString &pattern)
 
     for (int i = 0; i < lexemes.size(); ++i) {
         const QString lexeme = lexemes.at(i);
+        TokenType type = LiteralToken;
+        int arg = 0;
         if (lexeme.startsWith(QLatin1String("%{"))
                 && lexeme.endsWith(QLatin1Char('}'))) {
             // placeholder
             if (lexeme == QLatin1String(typeTokenC)) {
-                tokens[i] = typeTokenC;
+                type = TypeToken;
             } else if (lexeme == QLatin1String(categoryTokenC))
-                tokens[i] = categoryTokenC;
+                type = CategoryToken;
             else if (lexeme == QLatin1String(messageTokenC))
-                tokens[i] = messageTokenC;
+                type = MessageToken;
             else if (lexeme == QLatin1String(fileTokenC))
-                tokens[i] = fileTokenC;
+                type = FileToken;
             else if (lexeme == QLatin1String(lineTokenC))
-                tokens[i] = lineTokenC;
+                type = LineToken;
             else if (lexeme == QLatin1String(functionTokenC))
-                tokens[i] = functionTokenC;
+                type = FunctionToken;
             else if (lexeme == QLatin1String(pidTokenC))
-                tokens[i] = pidTokenC;
+                type = PidToken;
             else if (lexeme == QLatin1String(appnameTokenC))
-                tokens[i] = appnameTokenC;
+                type = AppnameToken;
             else if (lexeme == QLatin1String(threadidTokenC))
-                tokens[i] = threadidTokenC;
+                type = ThreadidToken;
             else if (lexeme == QLatin1String(qthreadptrTokenC))
-                tokens[i] = qthreadptrTokenC;
+                type = QthreadptrToken;
             else if (lexeme.startsWith(QLatin1String(timeTokenC))) {
-                tokens[i] = timeTokenC;
+                type = TimeToken;
+                arg = compiled->timeArgs.size();
+                TimeParams timeParams{TimeParams::IsoDate, QString()};
                 int spaceIdx = lexeme.indexOf(QChar::fromLatin1(' '));
                 if (spaceIdx > 0)
-                    timeArgs.append(lexeme.mid(spaceIdx + 1, lexeme.length() - spaceIdx - 2));
-                else
-                    timeArgs.append(QString());
+                    timeParams.format = lexeme.mid(spaceIdx + 1, lexeme.length() - spaceIdx - 2);
+                if (timeParams.format == QLatin1String("process"))
+                    timeParams.kind = TimeParams::Process;
+                else if (timeParams.format == QLatin1String("boot"))
+                    timeParams.kind = TimeParams::Boot;
+                else if (!timeParams.format.isEmpty())
+                    timeParams.kind = TimeParams::Format;
+                compiled->timeArgs.append(timeParams);
             } else if (lexeme.startsWith(QLatin1String(backtraceTokenC))) {
 #ifdef QLOGGING_HAVE_BACKTRACE
-                tokens[i] = backtraceTokenC;
+                type = BacktraceToken;
+                arg = compiled->backtraceArgs.size();
                 QString backtraceSeparator = QStringLiteral("|");
                 int backtraceDepth = 5;
                 static const QRegularExpression depthRx(QStringLiteral(" depth=(?|\"([^\"]*)\"|([^ }]*))"));
@@ -1219,55 +1315,67 @@ void QMessagePattern::setPattern(const QString &pattern)
                 BacktraceParams backtraceParams;
                 backtraceParams.backtraceDepth = backtraceDepth;
                 backtraceParams.backtraceSeparator = backtraceSeparator;
-                backtraceArgs.append(backtraceParams);
+                compiled->backtraceArgs.append(backtraceParams);
 #else
                 error += QLatin1String("QT_MESSAGE_PATTERN: %{backtrace} is not supported by this Qt build\n");
-                tokens[i] = "";
+                arg = compiled->literals.size();
+                compiled->literals.append(QLatin1String(emptyTokenC));
 #endif
             }
 
-#define IF_TOKEN(LEVEL) \
+#define IF_TOKEN(LEVEL, TYPE) \
             else if (lexeme == QLatin1String(LEVEL)) { \
                 if (inIf) \
                     nestedIfError = true; \
-                tokens[i] = LEVEL; \
+                type = TYPE; \
                 inIf = true; \
             }
-            IF_TOKEN(ifCategoryTokenC)
-            IF_TOKEN(ifDebugTokenC)
-            IF_TOKEN(ifInfoTokenC)
-            IF_TOKEN(ifWarningTokenC)
-            IF_TOKEN(ifCriticalTokenC)
-            IF_TOKEN(ifFatalTokenC)
+            IF_TOKEN(ifCategoryTokenC, IfCategoryToken)
+            IF_TOKEN(ifDebugTokenC, IfDebugToken)
+            IF_TOKEN(ifInfoTokenC, IfInfoToken)
+            IF_TOKEN(ifWarningTokenC, IfWarningToken)
+            IF_TOKEN(ifCriticalTokenC, IfCriticalToken)
+            IF_TOKEN(ifFatalTokenC, IfFatalToken)
 #undef IF_TOKEN
             else if (lexeme == QLatin1String(endifTokenC)) {
-                tokens[i] = endifTokenC;
+                type = EndifToken;
                 if (!inIf && !nestedIfError)
                     error += QLatin1String("QT_MESSAGE_PATTERN: %{endif} without an %{if-*}\n");
                 inIf = false;
             } else {
-                tokens[i] = emptyTokenC;
+                arg = compiled->literals.size();
+                compiled->literals.append(QLatin1String(emptyTokenC));
                 error += QStringLiteral("QT_MESSAGE_PATTERN: Unknown placeholder %1\n")
                         .arg(lexeme);
             }
         } else {
-            char *literal = new char[lexeme.size() + 1];
-            strncpy(literal, lexeme.toLatin1().constData(), lexeme.size());
-            literal[lexeme.size()] = '\0';
-            literalsVar.emplace_back(literal);
-            tokens[i] = literal;
+            // literals are printed as Latin-1, like they always have been
+            arg = compiled->literals.size();
+            compiled->literals.append(QString::fromLatin1(lexeme.toLatin1()));
         }
+        compiled->tokens.append(Token{type, arg});
     }
     if (nestedIfError)
         error += QLatin1String("QT_MESSAGE_PATTERN: %{if-*} cannot be nested\n");
     else if (inIf)
         error += QLatin1String("QT_MESSAGE_PATTERN: missing %{endif}\n");
 
+    // a failed %{if-*} skips everything up to and including the next %{endif}
+    int next = compiled->tokens.size();
+    for (int i = compiled->tokens.size() - 1; i >= 0; --i) {
+        Token &token = compiled->tokens[i];
+        if (token.type == EndifToken)
+            next = i + 1;
+        else if (token.type >= IfCategoryToken)
+            token.arg = next;
+    }
+
     if (!error.isEmpty())
         qt_message_print(error);
 
-    literals.reset(new std::unique_ptr<const char[]>[literalsVar.size() + 1]);
-    std::move(literalsVar.begin(), literalsVar.end(), &literals[0]);
+    compiled->previous = std::move(this->pattern);
+    this->pattern = std::move(compiled);
+    current.storeRelease(this->pattern.get());
 }
 
 #if defined(QLOGGING_HAVE_BACKTRACE) && !defined(QT_BOOTSTRAPPED)
@@ -1288,7 +1396,7 @@ static QStringList backtraceFramesForLogMessage(int frameCount)
     //    /lib/libc.so.6(__libc_start_main+0xf3) [0x4a937413]
     // The offset and function name are optional.
     // This regexp tries to extract the library name (without the path) and the function name.
-    // This code is protected by QMessagePattern::mutex so it is thread safe on all compilers
+    // The initialization of the static is thread safe and QRegularExpression::match() is const
     static const QRegularExpression rx(QStringLiteral("^(?:[^(]*/)?([^(/]+)\\(([^+]*)(?:[\\+[a-f0-9x]*)?\\) \\[[a-f0-9x]*\\]$"));
 
     QVarLengthArray<void *, 32> buffer(8 + frameCount);
@@ -1355,137 +1463,213 @@ static QString formatBacktraceForLogMessage(const QMessagePattern::BacktracePara
 
 Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
 
-/*!
-    \relates <QtGlobal>
-    \since 5.4
-
-    Generates a formatted string out of the \a type, \a context, \a str arguments.
-
-    qFormatLogMessage returns a QString that is formatted according to the current message pattern.
-    It can be used by custom message handlers to format output similar to Qt's default message
-    handler.
-
-    The function is thread-safe.
-
-    \sa qInstallMessageHandler(), qSetMessagePattern()
- */
-QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, const QString &str)
+// Appends the message formatted according to \a pattern to \a message and returns
+// false if nothing at all was appended, in which case qFormatLogMessage() returns
+// a null string. The process, thread and time are those of the caller unless
+// \a origin is given.
+static bool formatLogMessage(QString &message, const QMessagePattern *pattern, QtMsgType type,
+                             const QMessageLogContext &context, const QString &str,
+                             const QtPrivate::LogMessageOrigin *origin = nullptr)
 {
-    QString message;
-
-    const auto locker = qt_scoped_lock(QMessagePattern::mutex);
+#ifdef QT_BOOTSTRAPPED
+    Q_UNUSED(origin);
+#endif
+    bool appended = false;
+    const auto append = [&](const auto &part) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(part)>, QLatin1String>) {
+            if (!part.latin1())
+                return;
+        } else {
+            if (part.isNull())
+                return;
+        }
+        message.append(part);
+        appended = true;
+    };
 
-    QMessagePattern *pattern = qMessagePattern();
     if (!pattern) {
         // after destruction of static QMessagePattern instance
-        message.append(str);
-        return message;
+        append(str);
+        return appended;
     }
 
-    bool skip = false;
-
-#ifndef QT_BOOTSTRAPPED
-    int timeArgsIdx = 0;
-#ifdef QLOGGING_HAVE_BACKTRACE
-    int backtraceArgsIdx = 0;
-#endif
-#endif
+    const QMessagePattern::Compiled *compiled = pattern->compiled();
+    const QMessagePattern::Token *tokens = compiled->tokens.constData();
+    const int tokenCount = compiled->tokens.size();
 
     // we do not convert file, function, line literals to local encoding due to overhead
-    for (int i = 0; pattern->tokens[i]; ++i) {
-        const char *token = pattern->tokens[i];
-        if (token == endifTokenC) {
-            skip = false;
-        } else if (skip) {
-            // we skip adding messages, but we have to iterate over
-            // timeArgsIdx and backtraceArgsIdx anyway
-#ifndef QT_BOOTSTRAPPED
-            if (token == timeTokenC)
-                timeArgsIdx++;
-#ifdef QLOGGING_HAVE_BACKTRACE
-            else if (token == backtraceTokenC)
-                backtraceArgsIdx++;
-#endif
-#endif
-        } else if (token == messageTokenC) {
-            message.append(str);
-        } else if (token == categoryTokenC) {
-            message.append(QLatin1String(context.category));
-        } else if (token == typeTokenC) {
+    for (int i = 0; i < tokenCount; ++i) {
+        const QMessagePattern::Token token = tokens[i];
+        switch (token.type) {
+        case QMessagePattern::LiteralToken:
+            append(compiled->literals.at(token.arg));
+            break;
+        case QMessagePattern::MessageToken:
+            append(str);
+            break;
+        case QMessagePattern::CategoryToken:
+            append(QLatin1String(context.category));
+            break;
+        case QMessagePattern::TypeToken:
             switch (type) {
-            case QtDebugMsg:   message.append(QLatin1String("debug")); break;
-            case QtInfoMsg:    message.append(QLatin1String("info")); break;
-            case QtWarningMsg: message.append(QLatin1String("warning")); break;
-            case QtCriticalMsg:message.append(QLatin1String("critical")); break;
-            case QtFatalMsg:   message.append(QLatin1String("fatal")); break;
+            case QtDebugMsg:   append(QLatin1String("debug")); break;
+            case QtInfoMsg:    append(QLatin1String("info")); break;
+            case QtWarningMsg: append(QLatin1String("warning")); break;
+            case QtCriticalMsg:append(QLatin1String("critical")); break;
+            case QtFatalMsg:   append(QLatin1String("fatal")); break;
             }
-        } else if (token == fileTokenC) {
+            break;
+        case QMessagePattern::FileToken:
             if (context.file)
-                message.append(QLatin1String(context.file));
+                append(QLatin1String(context.file));
             else
-                message.append(QLatin1String("unknown"));
-        } else if (token == lineTokenC) {
-            message.append(QString::number(context.line));
-        } else if (token == functionTokenC) {
+                append(QLatin1String("unknown"));
+            break;
+        case QMessagePattern::LineToken:
+            append(QString::number(context.line));
+            break;
+        case QMessagePattern::FunctionToken:
             if (context.function)
-                message.append(QString::fromLatin1(qCleanupFuncinfo(context.function)));
+                append(QString::fromLatin1(qCleanupFuncinfo(context.function)));
             else
-                message.append(QLatin1String("unknown"));
+                append(QLatin1String("unknown"));
+            break;
 #ifndef QT_BOOTSTRAPPED
-        } else if (token == pidTokenC) {
-            message.append(QString::number(QCoreApplication::applicationPid()));
-        } else if (token == appnameTokenC) {
-            message.append(QCoreApplication::applicationName());
-        } else if (token == threadidTokenC) {
+        case QMessagePattern::PidToken:
+            append(QString::number(origin ? origin->pid : QCoreApplication::applicationPid()));
+            break;
+        case QMessagePattern::AppnameToken:
+            append(origin ? origin->applicationName : QCoreApplication::applicationName());
+            break;
+        case QMessagePattern::ThreadidToken:
             // print the TID as decimal
-            message.append(QString::number(qt_gettid()));
-        } else if (token == qthreadptrTokenC) {
-            message.append(QLatin1String("0x"));
-            message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+            append(QString::number(origin ? origin->threadId : qint64(qt_gettid())));
+            break;
+        case QMessagePattern::QthreadptrToken:
+            // the QThread of another process means nothing here
+            if (origin)
+                break;
+            append(QLatin1String("0x"));
+            append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+            break;
 #ifdef QLOGGING_HAVE_BACKTRACE
-        } else if (token == backtraceTokenC) {
-            QMessagePattern::BacktraceParams backtraceParams = pattern->backtraceArgs.at(backtraceArgsIdx);
-            backtraceArgsIdx++;
-            message.append(formatBacktraceForLogMessage(backtraceParams, context.function));
+        case QMessagePattern::BacktraceToken:
+            append(formatBacktraceForLogMessage(compiled->backtraceArgs.at(token.arg), context.function));
+            break;
 #endif
-        } else if (token == timeTokenC) {
-            QString timeFormat = pattern->timeArgs.at(timeArgsIdx);
-            timeArgsIdx++;
-            if (timeFormat == QLatin1String("process")) {
-                    quint64 ms = pattern->timer.elapsed();
-                    message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
-            } else if (timeFormat ==  QLatin1String("boot")) {
+        case QMessagePattern::TimeToken: {
+            const QMessagePattern::TimeParams &timeParams = compiled->timeArgs.at(token.arg);
+            switch (timeParams.kind) {
+            case QMessagePattern::TimeParams::Process: {
+                quint64 ms = origin ? origin->msecsSinceStart : pattern->timer.elapsed();
+                append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
+                break;
+            }
+            case QMessagePattern::TimeParams::Boot: {
                 // just print the milliseconds since the elapsed timer reference
                 // like the Linux kernel does
-                uint ms = QDeadlineTimer::current().deadline();
-                message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
+                uint ms = origin ? origin->msecsSinceBoot : QDeadlineTimer::current().deadline();
+                append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
+                break;
+            }
 #if QT_CONFIG(datestring)
-            } else if (timeFormat.isEmpty()) {
-                    message.append(QDateTime::currentDateTime().toString(Qt::ISODate));
-            } else {
-                message.append(QDateTime::currentDateTime().toString(timeFormat));
+            case QMessagePattern::TimeParams::IsoDate:
+            case QMessagePattern::TimeParams::Format: {
+                const QDateTime now = origin
+                        ? QDateTime::fromMSecsSinceEpoch(origin->msecsSinceEpoch)
+                        : QDateTime::currentDateTime();
+                if (timeParams.kind == QMessagePattern::TimeParams::IsoDate)
+                    append(now.toString(Qt::ISODate));
+                else
+                    append(now.toString(timeParams.format));
+                break;
+            }
+#else
+            default:
+                break;
 #endif // QT_CONFIG(datestring)
             }
+            break;
+        }
+#else
+        case QMessagePattern::PidToken:
+        case QMessagePattern::AppnameToken:
+        case QMessagePattern::ThreadidToken:
+        case QMessagePattern::QthreadptrToken:
+        case QMessagePattern::TimeToken:
 #endif // !QT_BOOTSTRAPPED
-        } else if (token == ifCategoryTokenC) {
+#ifndef QLOGGING_HAVE_BACKTRACE
+        case QMessagePattern::BacktraceToken:
+#endif
+        case QMessagePattern::EndifToken:
+            break;
+        case QMessagePattern::IfCategoryToken:
             if (isDefaultCategory(context.category))
-                skip = true;
+                i = token.arg - 1;
+            break;
 #define HANDLE_IF_TOKEN(LEVEL)  \
-        } else if (token == if##LEVEL##TokenC) { \
-            skip = type != Qt##LEVEL##Msg;
+        case QMessagePattern::If##LEVEL##Token: \
+            if (type != Qt##LEVEL##Msg) \
+                i = token.arg - 1; \
+            break;
         HANDLE_IF_TOKEN(Debug)
         HANDLE_IF_TOKEN(Info)
         HANDLE_IF_TOKEN(Warning)
         HANDLE_IF_TOKEN(Critical)
         HANDLE_IF_TOKEN(Fatal)
 #undef HANDLE_IF_TOKEN
-        } else {
-            message.append(QLatin1String(token));
         }
     }
+    return appended;
+}
+
+/*!
+    \relates <QtGlobal>
+    \since 5.4
+
+    Generates a formatted string out of the \a type, \a context, \a str arguments.
+
+    qFormatLogMessage returns a QString that is formatted according to the current message pattern.
+    It can be used by custom message handlers to format output similar to Qt's default message
+    handler.
+
+    The function is thread-safe.
+
+    \sa qInstallMessageHandler(), qSetMessagePattern()
+ */
+QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, const QString &str)
+{
+    QString message;
+    formatLogMessage(message, qMessagePattern(), type, context, str);
+    return message;
+}
+
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+
+    Formats the message like qFormatLogMessage() does, but with the process,
+    thread and time given by \a origin instead of the ones of the caller.
+*/
+QString QtPrivate::qFormatLogMessage(QtMsgType type, const QMessageLogContext &context,
+                                     const QString &str, const LogMessageOrigin &origin)
+{
+    QString message;
+    formatLogMessage(message, qMessagePattern(), type, context, str, &origin);
     return message;
 }
 
+/*!
+    \internal
+
+    Returns the id of the calling thread as printed by %{threadid}.
+*/
+qint64 QtPrivate::logThreadId()
+{
+    return qt_gettid();
+}
+#endif
+
 static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &buf);
 
 // pointer to QtMessageHandler debug handler (with context)
@@ -1733,17 +1917,198 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+/*!
+    \internal
+
+    Takes the messages meant for \c stderr and writes them from a thread of its
+    own, so that logging never waits for the console or whatever \c stderr is
+    redirected to. The messages are kept in a ring buffer of fixed size; when
+    that is full, messages are dropped instead of blocking the caller, and a
+    note saying how many were lost is printed once there is room again.
+
+    Enabled by setting the QT_ASYNC_STDERR_LOGGING environment variable to \c 1.
+*/
+class QAsyncMessageSink
+{
+public:
+    QAsyncMessageSink()
+        : buffer(new char[Capacity]), thread([this] { run(); })
+    {}
+
+    ~QAsyncMessageSink()
+    {
+        {
+            const auto locker = qt_scoped_lock(mutex);
+            quit = true;
+            dataAvailable.wakeOne();
+        }
+        thread.join();
+    }
+
+    void write(const char *data, qsizetype size)
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        if (size > Capacity - qsizetype(head - tail)) {
+            ++dropped;
+            return;
+        }
+        const qsizetype pos = qsizetype(head % Capacity);
+        const qsizetype first = qMin(size, Capacity - pos);
+        memcpy(buffer.get() + pos, data, first);
+        memcpy(buffer.get(), data + first, size - first);
+        if (head == tail)
+            dataAvailable.wakeOne();
+        head += size;
+    }
+
+    // blocks until everything written so far has been handed to stderr
+    void flush()
+    {
+        auto locker = qt_unique_lock(mutex);
+        const quint64 target = head;
+        while (tail < target)
+            drained.wait(locker.mutex());
+    }
+
+private:
+    void run()
+    {
+        auto locker = qt_unique_lock(mutex);
+        for (;;) {
+            while (head == tail && !dropped && !quit)
+                dataAvailable.wait(locker.mutex());
+            if (head == tail && !dropped)
+                break;
+
+            // producers only ever write outside of [start, end)
+            const quint64 start = tail;
+            const quint64 end = head;
+            const quint64 lost = std::exchange(dropped, 0);
+            locker.unlock();
+
+            const qsizetype size = qsizetype(end - start);
+            const qsizetype pos = qsizetype(start % Capacity);
+            const qsizetype first = qMin(size, Capacity - pos);
+            fwrite(buffer.get() + pos, 1, first, stderr);
+            fwrite(buffer.get(), 1, size - first, stderr);
+            if (lost)
+                fprintf(stderr, "(%llu log messages were dropped)\n", static_cast<unsigned long long>(lost));
+            fflush(stderr);
+
+            locker.lock();
+            tail = end;
+            drained.wakeAll();
+        }
+    }
+
+    static constexpr qsizetype Capacity = 256 * 1024;
+
+    QMutex mutex;
+    QWaitCondition dataAvailable;
+    QWaitCondition drained;
+    const std::unique_ptr<char[]> buffer;
+    quint64 head = 0;       // total number of bytes written into the buffer
+    quint64 tail = 0;       // total number of bytes printed from the buffer
+    quint64 dropped = 0;    // messages that did not fit since the last round
+    bool quit = false;
+    std::thread thread;
+};
+
+Q_GLOBAL_STATIC(QAsyncMessageSink, asyncMessageSink)
+
+static QAsyncMessageSink *asyncStderrSink()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_ASYNC_STDERR_LOGGING");
+    return enabled ? asyncMessageSink() : nullptr;
+}
+
+static void flushAsyncStderrSink()
+{
+    if (asyncMessageSink.exists()) {
+        if (QAsyncMessageSink *sink = asyncMessageSink())
+            sink->flush();
+    }
+}
+#else
+static void flushAsyncStderrSink() { }
+#endif // QT_CONFIG(thread) && !QT_BOOTSTRAPPED
+
+static void writeToStderr(const char *data, qsizetype size)
+{
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+    if (QAsyncMessageSink *sink = asyncStderrSink()) {
+        sink->write(data, size);
+        return;
+    }
+#endif
+    fwrite(data, 1, size, stderr);
+    fflush(stderr);
+}
+
+#if defined(Q_COMPILER_THREAD_LOCAL)
+namespace {
+// The buffers stderr_message_handler() formats and encodes the messages of one
+// thread into, so that printing a message does not allocate each time.
+struct MessageBuffers
+{
+    enum State : quint8 { Unused, Alive, Destroyed };
+
+    ~MessageBuffers() { state = Destroyed; }
+
+    QString text;
+    QByteArray bytes;
+
+    static thread_local State state;
+};
+thread_local MessageBuffers::State MessageBuffers::state = MessageBuffers::Unused;
+thread_local MessageBuffers threadMessageBuffers;
+} // unnamed namespace
+
+static MessageBuffers *messageBuffers()
+{
+    // messages can still be printed while the thread is being torn down
+    if (MessageBuffers::state == MessageBuffers::Destroyed)
+        return nullptr;
+    MessageBuffers::state = MessageBuffers::Alive;
+    return &threadMessageBuffers;
+}
+#endif // Q_COMPILER_THREAD_LOCAL
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
-    QString formattedMessage = qFormatLogMessage(type, context, message);
+    QString localText;
+    QByteArray localBytes;
+    QString *text = &localText;
+    QByteArray *bytes = &localBytes;
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    MessageBuffers *buffers = messageBuffers();
+    if (buffers) {
+        text = &buffers->text;
+        bytes = &buffers->bytes;
+        text->resize(0);
+    }
+#endif
 
     // print nothing if message pattern didn't apply / was empty.
     // (still print empty lines, e.g. because message itself was empty)
-    if (formattedMessage.isNull())
+    if (!formatLogMessage(*text, qMessagePattern(), type, context, message))
         return;
 
-    fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
-    fflush(stderr);
+    QStringEncoder encoder(QStringEncoder::System, QStringEncoder::Flag::Stateless);
+    bytes->resize(encoder.requiredSpace(text->size()) + 1);
+    char *end = encoder.appendToBuffer(bytes->data(), *text);
+    *end++ = '\n';
+    writeToStderr(bytes->constData(), end - bytes->constData());
+
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    // don't hold on to the memory of an occasional huge message
+    constexpr qsizetype MaxRetainedSize = 64 * 1024;
+    if (buffers && text->capacity() > MaxRetainedSize) {
+        *text = QString();
+        *bytes = QByteArray();
+    }
+#endif
 }
 
 /*!
@@ -1810,12 +2175,12 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
 #ifndef QT_BOOTSTRAPPED
     Q_TRACE(qt_message_print, msgType, context.category, context.function, context.file, context.line, message);
 
-    // qDebug, qWarning, ... macros do not check whether category is enabledgc
-    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
-        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory()) {
-            if (!defaultCategory->isEnabled(msgType))
-                return;
-        }
+    if (!isDefaultCategoryEnabled(msgType, context))
+        return;
+
+    if ((msgType == QtDebugMsg || msgType == QtInfoMsg)
+            && QBinaryLogging::logText(msgType, context, message)) {
+        return;
     }
 #endif
 
@@ -1832,6 +2197,7 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
 
 static void qt_message_print(const QString &message)
 {
+    flushAsyncStderrSink();
 #if defined(Q_OS_WIN) && !defined(QT_BOOTSTRAPPED)
     if (!shouldLogToStderr()) {
         win_outputDebugString_helper(message);
@@ -1844,6 +2210,12 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+    // make sure everything logged before is printed before we go down
+    flushAsyncStderrSink();
+#ifndef QT_BOOTSTRAPPED
+    QBinaryLogging::flush();
+#endif
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
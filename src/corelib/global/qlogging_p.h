@@ -51,12 +51,34 @@
 // We mean it.
 //
 
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qlogging.h>
+#include <QtCore/qstring.h>
+
 QT_BEGIN_NAMESPACE
 
 namespace QtPrivate {
 
 Q_CORE_EXPORT bool shouldLogToStderr();
 
+// The process, thread and time a message was logged in, for formatting it
+// somewhere else, such as when qlogdecode reads it back from a binary log.
+struct LogMessageOrigin
+{
+    qint64 pid = 0;
+    QString applicationName;
+    qint64 threadId = 0;            // as printed by %{threadid}
+    qint64 msecsSinceEpoch = 0;
+    qint64 msecsSinceStart = 0;     // for %{time process}
+    qint64 msecsSinceBoot = 0;      // for %{time boot}
+};
+
+#ifndef QT_BOOTSTRAPPED
+Q_CORE_EXPORT QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context,
+                                        const QString &str, const LogMessageOrigin &origin);
+qint64 logThreadId();
+#endif
+
 }
 
 QT_END_NAMESPACE
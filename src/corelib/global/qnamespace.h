@@ -1305,6 +1305,8 @@ namespace Qt {
         BlockingQueuedConnection,
         UniqueConnection =  0x80,
         SingleShotConnection = 0x100,
+        BatchedConnection = 0x200,
+        CoalescedConnection = 0x400,
     };
 
     enum ShortcutContext {
@@ -0,0 +1,502 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtracebuffer_p.h"
+
+#include "qcoreapplication.h"
+#include "qfile.h"
+#include "qlocale.h"
+#include "qmutex.h"
+#include "qnumeric.h"
+#include "qthread.h"
+#include <QtCore/private/qlocking_p.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+QBasicAtomicInt QTraceBuffer::enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+
+constexpr int BufferEvents = QTraceBuffer::EventsPerThread;
+constexpr int MaxValues = 8;            // per event; further values are not recorded
+constexpr qsizetype MaxTextBytes = 128; // per event, for all its strings
+constexpr size_t MaxFinishedThreads = 64;
+
+// The strings of an event follow each other in its text buffer, in the order
+// of its values; the Value only keeps their size in bytes.
+struct TraceEvent
+{
+    const QTraceBuffer::Tracepoint *tracepoint = nullptr;
+    qint64 timestamp = 0;
+    int valueCount = 0;
+    QTraceBuffer::Value values[MaxValues];
+    alignas(char16_t) char text[MaxTextBytes];
+};
+
+// An event in a thread's ring buffer. Only the thread itself writes it; the
+// sequence number tells readers which event the slot holds, and is odd while
+// the slot is being written, so that they can drop what they read if the
+// slot changed meanwhile.
+struct TraceSlot
+{
+    QAtomicInteger<quint64> sequence = 0;
+    TraceEvent event;
+};
+
+static constexpr quint64 completeSequence(quint64 index)
+{
+    return 2 * index + 2;
+}
+
+// The events recorded by one thread
+struct ThreadTraceBuffer
+{
+    explicit ThreadTraceBuffer(quint32 number)
+        : ring(new TraceSlot[BufferEvents]), number(number),
+          nativeId(quintptr(QThread::currentThreadId()))
+    {}
+
+    std::unique_ptr<TraceSlot[]> ring;
+    QAtomicInteger<quint64> count = 0;          // total number of events recorded
+    QAtomicInteger<quint64> clearedCount = 0;   // events discarded by clear()
+    const quint32 number;
+    const quint64 nativeId;
+    QAtomicInteger<bool> finished = false;
+};
+
+// UTF-16 strings start at an even offset in the text buffer
+static qsizetype alignTextOffset(qsizetype offset, QTraceBuffer::Value::Type type)
+{
+    return type == QTraceBuffer::Value::Utf16 ? (offset + 1) & ~qsizetype(1) : offset;
+}
+
+// Copies the string \a value refers to into \a text at \a offset,
+// truncated to what fits, and makes \a value hold its size in bytes.
+static qsizetype storeText(QTraceBuffer::Value &value, char *text, qsizetype offset)
+{
+    offset = alignTextOffset(offset, value.type);
+    const qsizetype available = qMax(qsizetype(0), MaxTextBytes - offset);
+    const char *data = static_cast<const char *>(value.text.data);
+    qsizetype bytes;
+    if (value.type == QTraceBuffer::Value::Utf16) {
+        const qsizetype units = qMin(value.text.size, available / 2);
+        // don't split a surrogate pair
+        const char16_t *utf16 = static_cast<const char16_t *>(value.text.data);
+        const bool split = units < value.text.size && units > 0
+                && QChar::isHighSurrogate(utf16[units - 1]);
+        bytes = (split ? units - 1 : units) * 2;
+    } else {
+        bytes = qMin(value.text.size, available);
+        // don't split a UTF-8 sequence
+        if (bytes < value.text.size) {
+            while (bytes > 0 && (uchar(data[bytes]) & 0xc0) == 0x80)
+                --bytes;
+        }
+    }
+    if (bytes)
+        memcpy(text + offset, data, size_t(bytes));
+    value.text.data = nullptr;
+    value.text.size = bytes;
+    return offset + bytes;
+}
+
+static qint64 monotonicNanoseconds()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct TraceRegistry;
+static bool writeTrace(QIODevice *device, TraceRegistry *registry);
+
+struct TraceRegistry
+{
+    ~TraceRegistry()
+    {
+        const QString fileName = qEnvironmentVariable("QT_TRACE_OUTPUT");
+        if (fileName.isEmpty())
+            return;
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            writeTrace(&file, this);
+    }
+
+    std::shared_ptr<ThreadTraceBuffer> registerThread()
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        // keep the events of threads that have finished, but not of arbitrarily many
+        size_t finished = 0;
+        for (auto it = buffers.end(); it != buffers.begin(); ) {
+            --it;
+            if ((*it)->finished.loadAcquire() && ++finished > MaxFinishedThreads)
+                it = buffers.erase(it);
+        }
+        buffers.push_back(std::make_shared<ThreadTraceBuffer>(++threadCount));
+        return buffers.back();
+    }
+
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> threadBuffers()
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        return buffers;
+    }
+
+    const qint64 startTime = monotonicNanoseconds();
+    QBasicMutex mutex;
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    quint32 threadCount = 0;
+};
+
+Q_GLOBAL_STATIC(TraceRegistry, traceRegistry)
+
+struct ThreadTraceState
+{
+    enum State : quint8 { Unused, Alive, Destroyed };
+
+    ~ThreadTraceState()
+    {
+        if (buffer)
+            buffer->finished.storeRelease(true);
+        state = Destroyed;
+    }
+
+    std::shared_ptr<ThreadTraceBuffer> buffer;
+
+    static thread_local State state;
+};
+thread_local ThreadTraceState::State ThreadTraceState::state = ThreadTraceState::Unused;
+thread_local ThreadTraceState threadTraceState;
+
+static ThreadTraceBuffer *currentThreadBuffer()
+{
+    // tracepoints can still be hit while the thread is being torn down
+    if (ThreadTraceState::state == ThreadTraceState::Destroyed)
+        return nullptr;
+    ThreadTraceState::state = ThreadTraceState::Alive;
+    if (!threadTraceState.buffer) {
+        TraceRegistry *registry = traceRegistry();
+        if (!registry)
+            return nullptr;
+        threadTraceState.buffer = registry->registerThread();
+    }
+    return threadTraceState.buffer.get();
+}
+
+static void appendJsonString(QByteArray &json, QStringView string)
+{
+    json += '"';
+    for (QChar ch : string) {
+        const char16_t c = ch.unicode();
+        switch (c) {
+        case '"':
+            json += "\\\"";
+            break;
+        case '\\':
+            json += "\\\\";
+            break;
+        case '\n':
+            json += "\\n";
+            break;
+        case '\r':
+            json += "\\r";
+            break;
+        case '\t':
+            json += "\\t";
+            break;
+        default:
+            if (c < 0x20 || c >= 0x7f) {
+                char escape[7];
+                qsnprintf(escape, sizeof escape, "\\u%04x", unsigned(c));
+                json += escape;
+            } else {
+                json += char(c);
+            }
+        }
+    }
+    json += '"';
+}
+
+static void appendJsonValue(QByteArray &json, const QTraceBuffer::Value &value, const char *text)
+{
+    switch (value.type) {
+    case QTraceBuffer::Value::None:
+        json += "null";
+        break;
+    case QTraceBuffer::Value::Signed:
+        json += QByteArray::number(value.integer);
+        break;
+    case QTraceBuffer::Value::Unsigned:
+        json += QByteArray::number(value.unsignedInteger);
+        break;
+    case QTraceBuffer::Value::Bool:
+        json += value.integer ? "true" : "false";
+        break;
+    case QTraceBuffer::Value::Double:
+        if (qIsFinite(value.real))
+            json += QByteArray::number(value.real, 'g', QLocale::FloatingPointShortest);
+        else
+            json += "null";
+        break;
+    case QTraceBuffer::Value::Pointer:
+        json += "\"0x" + QByteArray::number(quintptr(value.pointer), 16) + '"';
+        break;
+    case QTraceBuffer::Value::Utf8:
+        appendJsonString(json, QString::fromUtf8(text, value.text.size));
+        break;
+    case QTraceBuffer::Value::Utf16:
+        appendJsonString(json, QStringView(reinterpret_cast<const char16_t *>(text),
+                                           value.text.size / 2));
+        break;
+    }
+}
+
+static void appendJsonEvent(QByteArray &json, const TraceEvent &event, qint64 startTime,
+                            const QByteArray &pidAndTid)
+{
+    static const char phases[] = { 'i', 'B', 'E' };
+    const QTraceBuffer::Tracepoint &tracepoint = *event.tracepoint;
+
+    json += ",\n{\"name\":\"";
+    json += tracepoint.name;
+    json += "\",\"cat\":\"";
+    json += tracepoint.provider;
+    json += "\",\"ph\":\"";
+    json += phases[tracepoint.phase];
+    json += "\",";
+    if (tracepoint.phase == QTraceBuffer::Instant)
+        json += "\"s\":\"t\",";
+    const qint64 nanoseconds = event.timestamp - startTime;
+    json += "\"ts\":";
+    json += QByteArray::number(nanoseconds / 1000);
+    json += '.';
+    json += QByteArray::number(nanoseconds % 1000).rightJustified(3, '0');
+    json += pidAndTid;
+
+    const int count = qMin(event.valueCount, tracepoint.argumentCount);
+    if (count) {
+        json += ",\"args\":{";
+        qsizetype textOffset = 0;
+        for (int i = 0; i < count; ++i) {
+            const QTraceBuffer::Value &value = event.values[i];
+            if (i)
+                json += ',';
+            json += '"';
+            json += tracepoint.argumentNames[i];
+            json += "\":";
+            if (value.type == QTraceBuffer::Value::Utf8 || value.type == QTraceBuffer::Value::Utf16) {
+                textOffset = alignTextOffset(textOffset, value.type);
+                appendJsonValue(json, value, event.text + textOffset);
+                textOffset += value.text.size;
+            } else {
+                appendJsonValue(json, value, nullptr);
+            }
+        }
+        json += '}';
+    }
+    json += '}';
+}
+
+static bool writeTrace(QIODevice *device, TraceRegistry *registry)
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QByteArray json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+            + QByteArray::number(pid) + ",\"args\":{\"name\":";
+    appendJsonString(json, QCoreApplication::applicationName());
+    json += "}}";
+    if (device->write(json) < 0)
+        return false;
+
+    const auto buffers = registry ? registry->threadBuffers()
+                                  : std::vector<std::shared_ptr<ThreadTraceBuffer>>();
+    std::vector<TraceEvent> events;
+    for (const auto &buffer : buffers) {
+        // The thread may overwrite the oldest events while they are copied;
+        // those are dropped.
+        const quint64 count = buffer->count.loadAcquire();
+        const quint64 first = qMax(count > quint64(BufferEvents) ? count - BufferEvents : 0,
+                                   buffer->clearedCount.loadAcquire());
+        events.clear();
+        events.reserve(count - qMin(first, count));
+        int depth = 0;
+        for (quint64 i = first; i < count; ++i) {
+            const TraceSlot &slot = buffer->ring[i % BufferEvents];
+            if (slot.sequence.loadAcquire() != completeSequence(i))
+                continue;
+            TraceEvent event;
+            memcpy(static_cast<void *>(&event), &slot.event, sizeof event);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.loadRelaxed() != completeSequence(i))
+                continue;
+
+            // Drop the ends of slices whose beginning was overwritten, so
+            // that they don't end the wrong slices.
+            if (event.tracepoint->phase == QTraceBuffer::Begin) {
+                ++depth;
+            } else if (event.tracepoint->phase == QTraceBuffer::End) {
+                if (!depth)
+                    continue;
+                --depth;
+            }
+            events.push_back(event);
+        }
+
+        const QByteArray pidAndTid = ",\"pid\":" + QByteArray::number(pid)
+                + ",\"tid\":" + QByteArray::number(buffer->number);
+        json = ",\n{\"name\":\"thread_name\",\"ph\":\"M\"" + pidAndTid
+                + ",\"args\":{\"name\":\"Thread " + QByteArray::number(buffer->number)
+                + " (0x" + QByteArray::number(buffer->nativeId, 16) + ")\"}}";
+        for (const TraceEvent &event : events)
+            appendJsonEvent(json, event, registry->startTime, pidAndTid);
+        if (device->write(json) < 0)
+            return false;
+    }
+
+    return device->write("\n]}\n") >= 0;
+}
+
+static void initTraceBuffer()
+{
+    if (qEnvironmentVariableIsSet("QT_TRACE_OUTPUT"))
+        QTraceBuffer::setEnabled(true);
+}
+Q_CONSTRUCTOR_FUNCTION(initTraceBuffer)
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Enables or disables recording tracepoints, depending on \a enable.
+    Disabling keeps the events recorded so far.
+*/
+void QTraceBuffer::setEnabled(bool enable)
+{
+    if (enable)
+        traceRegistry(); // start the clock
+    enabled.storeRelaxed(enable);
+}
+
+/*!
+    \internal
+
+    Records \a tracepoint being hit with \a values as its arguments in the
+    ring buffer of the current thread, overwriting the oldest event if the
+    buffer is full.
+*/
+void QTraceBuffer::record(const Tracepoint &tracepoint, std::initializer_list<Value> values)
+{
+    ThreadTraceBuffer *buffer = currentThreadBuffer();
+    if (!buffer)
+        return;
+
+    const qint64 timestamp = monotonicNanoseconds();
+    const quint64 index = buffer->count.loadRelaxed();
+    TraceSlot &slot = buffer->ring[index % BufferEvents];
+    slot.sequence.storeRelaxed(completeSequence(index) - 1);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceEvent &event = slot.event;
+    event.tracepoint = &tracepoint;
+    event.timestamp = timestamp;
+    event.valueCount = qMin(int(values.size()), MaxValues);
+    qsizetype textOffset = 0;
+    for (int i = 0; i < event.valueCount; ++i) {
+        Value value = values.begin()[i];
+        if (value.type == Value::Utf8 || value.type == Value::Utf16)
+            textOffset = storeText(value, event.text, textOffset);
+        event.values[i] = value;
+    }
+
+    slot.sequence.storeRelease(completeSequence(index));
+    buffer->count.storeRelease(index + 1);
+}
+
+/*!
+    \internal
+
+    Discards all events recorded so far.
+*/
+void QTraceBuffer::clear()
+{
+    if (!traceRegistry.exists())
+        return;
+    TraceRegistry *registry = traceRegistry();
+    if (!registry)
+        return;
+    for (const auto &buffer : registry->threadBuffers())
+        buffer->clearedCount.storeRelease(buffer->count.loadAcquire());
+}
+
+/*!
+    \internal
+
+    Writes the events recorded so far, in the Chrome trace event format,
+    to \a device. Returns false if writing failed.
+
+    The threads keep recording while this runs, without waiting for it;
+    events they overwrite while they are being copied are left out, as are
+    the ends of slices whose beginning is no longer in the buffer.
+*/
+bool QTraceBuffer::writeChromeTrace(QIODevice *device)
+{
+    return writeTrace(device, traceRegistry.exists() ? traceRegistry() : nullptr);
+}
+
+/*!
+    \internal
+    \overload
+
+    Writes the trace to the file \a fileName.
+*/
+bool QTraceBuffer::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return writeChromeTrace(&file) && file.flush();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTRACEBUFFER_P_H
+#define QTRACEBUFFER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qstring.h>
+
+#include <initializer_list>
+#include <type_traits>
+
+QT_REQUIRE_CONFIG(trace_builtin);
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+/*
+    The built-in tracing backend, used by the tracepoint headers tracegen
+    writes for "builtin".
+
+    Each thread records the tracepoints it hits into a ring buffer of its own,
+    keeping the most recent EventsPerThread of them. Recording takes no lock
+    and allocates nothing: the arguments are copied into the preallocated
+    buffer, strings truncated to what fits. writeChromeTrace() writes what
+    the buffers hold in the Chrome trace event format, which chrome://tracing
+    and the Perfetto UI can display. Tracepoints whose name ends in _entry
+    and _exit become the beginning and end of a slice, all others instant
+    events.
+
+    Tracing is enabled by setEnabled(), or by setting the QT_TRACE_OUTPUT
+    environment variable to the name of the file to write the trace to when
+    the application exits.
+*/
+class Q_CORE_EXPORT QTraceBuffer
+{
+public:
+    static constexpr int EventsPerThread = 8192;
+
+    enum Phase : quint8 {
+        Instant,
+        Begin,
+        End
+    };
+
+    struct Tracepoint
+    {
+        const char *provider;
+        const char *name;       // without _entry or _exit
+        Phase phase;
+        const char *const *argumentNames;
+        int argumentCount;
+    };
+
+    // An argument of a tracepoint. Strings are only referenced, so a Value
+    // must not outlive the data it was constructed from.
+    class Value
+    {
+    public:
+        enum Type : quint8 {
+            None,               // a type that is not recorded
+            Signed,
+            Unsigned,
+            Bool,
+            Double,
+            Pointer,
+            Utf8,
+            Utf16
+        };
+
+        Value() noexcept = default;
+        Value(bool value) noexcept : type(Bool) { integer = value; }
+        Value(const char *value) noexcept : type(Utf8)
+        { text = { value, value ? qsizetype(qstrlen(value)) : 0 }; }
+        Value(char *value) noexcept : Value(static_cast<const char *>(value)) {}
+        Value(const QString &value) noexcept : type(Utf16)
+        { text = { value.constData(), value.size() }; }
+        Value(const QByteArray &value) noexcept : type(Utf8)
+        { text = { value.constData(), value.size() }; }
+
+        template <typename T>
+        Value(const T &value) noexcept
+        {
+            if constexpr (std::is_enum_v<T>) {
+                type = Signed;
+                integer = qint64(value);
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                type = Signed;
+                integer = value;
+            } else if constexpr (std::is_integral_v<T>) {
+                type = Unsigned;
+                unsignedInteger = value;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                type = Double;
+                real = double(value);
+            } else if constexpr (std::is_pointer_v<T>) {
+                type = Pointer;
+                pointer = reinterpret_cast<const void *>(value);
+            }
+        }
+
+        Type type = None;
+        union {
+            qint64 integer = 0;
+            quint64 unsignedInteger;
+            double real;
+            const void *pointer;
+            struct {
+                const void *data;
+                qsizetype size; // in code units
+            } text;
+        };
+    };
+
+    static bool isEnabled() noexcept { return enabled.loadRelaxed(); }
+    static void setEnabled(bool enable);
+
+    static void record(const Tracepoint &tracepoint, std::initializer_list<Value> values);
+    static void clear();
+
+    static bool writeChromeTrace(QIODevice *device);
+    static bool writeChromeTrace(const QString &fileName);
+
+private:
+    static QBasicAtomicInt enabled;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTRACEBUFFER_P_H
@@ -9,6 +9,7 @@ HEADERS +=  \
         io/qdir.h \
         io/qdir_p.h \
         io/qdiriterator.h \
+        io/qdiriterator_p.h \
         io/qfile.h \
         io/qfiledevice.h \
         io/qfiledevice_p.h \
@@ -44,6 +45,16 @@ HEADERS +=  \
         io/qloggingcategory.h \
         io/qloggingregistry_p.h
 
+qtConfig(thread) {
+    HEADERS += io/qdirwalker_p.h
+    SOURCES += io/qdirwalker.cpp
+}
+
+qtConfig(future) {
+    HEADERS += io/qfileasyncio_p.h
+    SOURCES += io/qfileasyncio.cpp
+}
+
 SOURCES += \
         io/qabstractfileengine.cpp \
         io/qbuffer.cpp \
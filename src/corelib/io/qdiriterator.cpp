@@ -90,15 +90,13 @@
 */
 
 #include "qdiriterator.h"
+#include "qdiriterator_p.h"
 #include "qdir_p.h"
 #include "qabstractfileengine_p.h"
 
 #include <QtCore/qset.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qvariant.h>
-#if QT_CONFIG(regularexpression)
-#include <QtCore/qregularexpression.h>
-#endif
 
 #include <QtCore/private/qfilesystemiterator_p.h>
 #include <QtCore/private/qfilesystementry_p.h>
@@ -121,7 +119,7 @@ public:
     }
 };
 
-class QDirIteratorPrivate
+class QDirIteratorPrivate : public QDirIteratorFilter
 {
 public:
     QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
@@ -132,18 +130,10 @@ public:
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
     void checkAndPushDirectory(const QFileInfo &);
-    bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
 
     std::unique_ptr<QAbstractFileEngine> engine;
 
     QFileSystemEntry dirEntry;
-    const QStringList nameFilters;
-    const QDir::Filters filters;
-    const QDirIterator::IteratorFlags iteratorFlags;
-
-#if QT_CONFIG(regularexpression)
-    QList<QRegularExpression> nameRegExps;
-#endif
 
     QDirIteratorPrivateIteratorStack<QAbstractFileEngineIterator> fileEngineIterators;
 #ifndef QT_NO_FILESYSTEMITERATOR
@@ -160,10 +150,9 @@ public:
 /*!
     \internal
 */
-QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
-                                         QDir::Filters _filters, QDirIterator::IteratorFlags flags, bool resolveEngine)
-    : dirEntry(entry)
-      , nameFilters(nameFilters.contains(QLatin1String("*")) ? QStringList() : nameFilters)
+QDirIteratorFilter::QDirIteratorFilter(const QStringList &nameFilters, QDir::Filters _filters,
+                                       QDirIterator::IteratorFlags flags)
+    : nameFilters(nameFilters.contains(QLatin1String("*")) ? QStringList() : nameFilters)
       , filters(QDir::NoFilter == _filters ? QDir::AllEntries : _filters)
       , iteratorFlags(flags)
 {
@@ -175,6 +164,16 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
         nameRegExps.append(re);
     }
 #endif
+}
+
+/*!
+    \internal
+*/
+QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
+                                         QDir::Filters _filters, QDirIterator::IteratorFlags flags, bool resolveEngine)
+    : QDirIteratorFilter(nameFilters, _filters, flags)
+      , dirEntry(entry)
+{
     QFileSystemMetaData metaData;
     if (resolveEngine)
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
@@ -190,13 +189,6 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
 */
 void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
 {
-    QString path = fileInfo.filePath();
-
-#ifdef Q_OS_WIN
-    if (fileInfo.isSymLink())
-        path = fileInfo.canonicalFilePath();
-#endif
-
     if ((iteratorFlags & QDirIterator::FollowSymlinks)) {
         // Stop link loops
         if (visitedLinks.hasSeen(fileInfo.canonicalFilePath()))
@@ -204,6 +196,11 @@ void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
     }
 
     if (engine) {
+        QString path = fileInfo.filePath();
+#ifdef Q_OS_WIN
+        if (fileInfo.isSymLink())
+            path = fileInfo.canonicalFilePath();
+#endif
         engine->setFileName(path);
         QAbstractFileEngineIterator *it = engine->beginEntryList(filters, nameFilters);
         if (it) {
@@ -214,8 +211,10 @@ void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
         }
     } else {
 #ifndef QT_NO_FILESYSTEMITERATOR
+        // Subdirectories are pushed while their parent's iterator is current
+        const QFileSystemIterator *parent = nativeIterators.isEmpty() ? nullptr : nativeIterators.top();
         QFileSystemIterator *it = new QFileSystemIterator(fileInfo.d_ptr->fileEntry,
-            filters, nameFilters, iteratorFlags);
+            filters, nameFilters, iteratorFlags, parent);
         nativeIterators << it;
 #else
         qWarning("Qt was built with -no-feature-filesystemiterator: no files/plugins will be found!");
@@ -286,29 +285,41 @@ void QDirIteratorPrivate::advance()
     \internal
  */
 void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+{
+    if (shouldFollow(fileInfo))
+        pushDirectory(fileInfo);
+}
+
+/*!
+    \internal
+
+    Returns \c true if iteration should descend into the directory entry
+    \a fileInfo. Symbolic link loops are not detected here.
+ */
+bool QDirIteratorFilter::shouldFollow(const QFileInfo &fileInfo) const
 {
     // If we're doing flat iteration, we're done.
     if (!(iteratorFlags & QDirIterator::Subdirectories))
-        return;
+        return false;
 
     // Never follow non-directory entries
     if (!fileInfo.isDir())
-        return;
+        return false;
 
     // Follow symlinks only when asked
     if (!(iteratorFlags & QDirIterator::FollowSymlinks) && fileInfo.isSymLink())
-        return;
+        return false;
 
     // Never follow . and ..
     QString fileName = fileInfo.fileName();
     if (QLatin1String(".") == fileName || QLatin1String("..") == fileName)
-        return;
+        return false;
 
     // No hidden directories unless requested
     if (!(filters & QDir::AllDirs) && !(filters & QDir::Hidden) && fileInfo.isHidden())
-        return;
+        return false;
 
-    pushDirectory(fileInfo);
+    return true;
 }
 
 /*!
@@ -322,7 +333,7 @@ void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
     otherwise, false is returned.
 */
 
-bool QDirIteratorPrivate::matchesFilters(const QString &fileName, const QFileInfo &fi) const
+bool QDirIteratorFilter::matchesFilters(const QString &fileName, const QFileInfo &fi) const
 {
     if (fileName.isEmpty())
         return false;
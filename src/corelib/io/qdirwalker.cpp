@@ -0,0 +1,704 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+/*!
+    \internal
+    \class QDirWalker
+    \inmodule QtCore
+
+    \brief The QDirWalker class lists a directory tree on several threads.
+
+    QDirWalker visits the same entries as a QDirIterator constructed with the
+    same arguments, but lists the directories on the threads of a
+    QThreadPool. Matching entries are handed to a consumer function in
+    batches of QFileInfo objects, always on the thread that called walk().
+
+    By default, batches are delivered as soon as they are ready; the only
+    guarantee is that the entry of a directory is delivered before any of
+    its contents. With IteratorOrder, entries are delivered in exactly the
+    order QDirIterator returns them, at the cost of buffering the listings
+    that are not yet due.
+
+    Paths handled by a file engine, such as resources, are listed
+    sequentially on the calling thread.
+
+    \sa QDirIterator
+*/
+
+/*!
+    \internal
+    \enum QDirWalker::Ordering
+
+    \value Unordered Batches are delivered as soon as they are ready. A
+    directory's entry always precedes the entries inside it.
+    \value IteratorOrder Entries are delivered in the order QDirIterator
+    returns them.
+*/
+
+/*!
+    \internal
+    \typedef QDirWalker::Consumer
+
+    The function walk() passes each batch of entries to. It returns \c false
+    to stop the walk.
+*/
+
+#include "qdirwalker_p.h"
+#include "qdiriterator_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <QtCore/private/qabstractfileengine_p.h>
+#include <QtCore/private/qduplicatetracker_p.h>
+#include <QtCore/private/qfileinfo_p.h>
+#include <QtCore/private/qfilesystemengine_p.h>
+#include <QtCore/private/qfilesystemiterator_p.h>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QDirWalkerPrivate
+{
+public:
+    QDirWalkerPrivate(const QString &path, const QStringList &nameFilters,
+                      QDir::Filters filters, QDirIterator::IteratorFlags flags)
+        : path(path), filter(nameFilters, filters, flags)
+    {
+    }
+
+    const QString path;
+    const QDirIteratorFilter filter;
+    QThreadPool *pool = nullptr;
+    int maxConcurrency = 0;
+    int batchSize = 256;
+    QDirWalker::Ordering ordering = QDirWalker::Unordered;
+};
+
+#ifndef QT_NO_FILESYSTEMITERATOR
+
+namespace {
+
+struct DirNode
+{
+    enum State {
+        Pending,
+        Listing,
+        Listed
+    };
+
+    struct Child {
+        qsizetype position; // entries delivered before the child's contents
+        DirNode *node;
+    };
+
+    explicit DirNode(const QFileSystemEntry &entry, DirNode *parent = nullptr)
+        : entry(entry), parent(parent)
+    {
+    }
+
+    bool isSkipped() const
+    {
+        for (const DirNode *node = this; node; node = node->parent) {
+            if (node->skipped)
+                return true;
+        }
+        return false;
+    }
+
+    const QFileSystemEntry entry;
+    QString canonicalPath;
+    DirNode *const parent;
+    QFileInfoList entries;  // IteratorOrder only
+    QList<Child> children;  // IteratorOrder only
+    State state = Pending;
+    bool skipped = false;
+};
+
+/*
+    One call to QDirWalker::walk().
+
+    Directories waiting to be listed sit in a queue that pool workers and,
+    when it would otherwise wait, the consumer take from. In Unordered mode
+    listings go straight into the batch queue; subdirectories are only
+    queued once the batch holding their own entry has been, which keeps
+    parents ahead of their contents. In IteratorOrder mode each directory
+    keeps its listing and the consumer walks the resulting tree depth-first,
+    taking over any directory it needs that nobody has started on.
+
+    Both modes bound the number of entries waiting for the consumer; in
+    IteratorOrder mode the bound may be exceeded by the directories the
+    consumer lists itself.
+*/
+class QDirWalkJob
+{
+public:
+    QDirWalkJob(const QDirWalkerPrivate &d, const QDirWalker::Consumer &consumer);
+    ~QDirWalkJob();
+
+    bool run(const QFileSystemEntry &rootEntry);
+
+private:
+    bool runUnordered(DirNode *root);
+    bool runInOrder(DirNode *root);
+    void finish();
+
+    void workerLoop();
+    void startWorkers();
+    DirNode *takeDirectory();
+    DirNode *nextPending();
+    void waitUntilListed(DirNode *node);
+    void listDirectory(DirNode *node, bool byConsumer);
+    DirNode *createChild(DirNode *parent, const QFileSystemEntry &entry, const QFileInfo &info);
+    void flushBatch(QFileInfoList &batch, QList<DirNode *> &subdirs, bool byConsumer);
+    void releaseSkipped(DirNode *node);
+
+    const QDirIteratorFilter &filter;
+    const QDirWalker::Consumer &consumer;
+    QThreadPool *const pool;
+    const int maxWorkers;
+    const qsizetype batchSize;
+    const qsizetype maxBuffered;
+    const bool ordered;
+    const bool followSymlinks;
+
+    QAtomicInt stopRequested;
+
+    QMutex mutex;
+    QWaitCondition workAvailable;   // queue, buffer space or stop
+    QWaitCondition progress;        // batches, listings, worker exits
+
+    QList<DirNode *> queue;
+    QList<QFileInfoList> batches;   // Unordered only
+    QSet<QString> visited;          // Unordered only
+    std::vector<std::unique_ptr<DirNode>> nodes; // IteratorOrder only
+    qsizetype buffered = 0;
+    int busy = 0;       // directories being listed
+    int idle = 0;       // workers waiting for a directory
+    int workers = 0;    // workers handed to the pool and not yet finished
+    int running = 0;    // workers actually running
+    std::vector<QRunnable *> runnables;
+};
+
+QDirWalkJob::QDirWalkJob(const QDirWalkerPrivate &d, const QDirWalker::Consumer &consumer)
+    : filter(d.filter),
+      consumer(consumer),
+      pool(d.pool ? d.pool : QThreadPool::globalInstance()),
+      maxWorkers(qMax(1, d.maxConcurrency > 0 ? d.maxConcurrency : pool->maxThreadCount())),
+      batchSize(qMax(1, d.batchSize)),
+      maxBuffered(qMax(16, 4 * maxWorkers) * batchSize),
+      ordered(d.ordering == QDirWalker::IteratorOrder),
+      followSymlinks(filter.iteratorFlags & QDirIterator::FollowSymlinks)
+{
+}
+
+QDirWalkJob::~QDirWalkJob()
+{
+    qDeleteAll(runnables);
+    if (!ordered)
+        qDeleteAll(queue);
+}
+
+bool QDirWalkJob::run(const QFileSystemEntry &rootEntry)
+{
+    DirNode *root = new DirNode(rootEntry);
+    if (followSymlinks) {
+        root->canonicalPath = QFileInfo(rootEntry.filePath()).canonicalFilePath();
+        visited.insert(root->canonicalPath);
+    }
+
+    bool completed;
+    if (ordered) {
+        nodes.emplace_back(root);
+        completed = runInOrder(root);
+    } else {
+        completed = runUnordered(root);
+    }
+    finish();
+    return completed;
+}
+
+bool QDirWalkJob::runUnordered(DirNode *root)
+{
+    QMutexLocker locker(&mutex);
+    queue.append(root);
+    startWorkers();
+    for (;;) {
+        if (!batches.isEmpty()) {
+            const QFileInfoList batch = batches.takeFirst();
+            buffered -= batch.size();
+            workAvailable.wakeAll();
+            locker.unlock();
+            if (!consumer(batch))
+                return false;
+            locker.relock();
+            continue;
+        }
+        if (queue.isEmpty() && busy == 0)
+            return true;
+        // The pool may be too busy to ever run our workers; make progress here.
+        if (running == 0) {
+            if (DirNode *node = nextPending()) {
+                locker.unlock();
+                listDirectory(node, true);
+                locker.relock();
+                continue;
+            }
+        }
+        progress.wait(&mutex);
+    }
+}
+
+bool QDirWalkJob::runInOrder(DirNode *root)
+{
+    struct Frame {
+        DirNode *node;
+        qsizetype entry;
+        qsizetype child;
+    };
+
+    QDuplicateTracker<QString> seen;
+    if (followSymlinks)
+        (void)seen.hasSeen(root->canonicalPath);
+
+    QFileInfoList batch;
+    QList<Frame> stack;
+    stack.append(Frame{root, 0, 0});
+    waitUntilListed(root);
+
+    // Listed nodes are only read here, so their contents need no locking.
+    while (!stack.isEmpty()) {
+        Frame &frame = stack.last();
+        DirNode *node = frame.node;
+        const qsizetype end = frame.child < node->children.size()
+                ? node->children.at(frame.child).position : node->entries.size();
+        while (frame.entry < end) {
+            batch.append(node->entries.at(frame.entry++));
+            if (batch.size() >= batchSize) {
+                if (!consumer(batch))
+                    return false;
+                batch.clear();
+            }
+        }
+
+        if (frame.child < node->children.size()) {
+            DirNode *child = node->children.at(frame.child++).node;
+            if (followSymlinks && seen.hasSeen(child->canonicalPath)) {
+                QMutexLocker locker(&mutex);
+                child->skipped = true;
+                releaseSkipped(child);
+                continue;
+            }
+            stack.append(Frame{child, 0, 0});
+            waitUntilListed(child);
+            continue;
+        }
+
+        {
+            QMutexLocker locker(&mutex);
+            buffered -= node->entries.size();
+            node->entries = QFileInfoList();
+            workAvailable.wakeAll();
+        }
+        stack.removeLast();
+    }
+    return batch.isEmpty() || consumer(batch);
+}
+
+void QDirWalkJob::finish()
+{
+    QMutexLocker locker(&mutex);
+    stopRequested.storeRelaxed(true);
+    workAvailable.wakeAll();
+    for (QRunnable *runnable : runnables) {
+        if (pool->tryTake(runnable))
+            --workers;
+    }
+    while (workers > 0)
+        progress.wait(&mutex);
+}
+
+void QDirWalkJob::workerLoop()
+{
+    QMutexLocker locker(&mutex);
+    ++running;
+    while (DirNode *node = takeDirectory()) {
+        locker.unlock();
+        listDirectory(node, false);
+        locker.relock();
+    }
+    --running;
+    --workers;
+    progress.wakeAll();
+}
+
+// Called with the mutex held.
+void QDirWalkJob::startWorkers()
+{
+    while (workers < maxWorkers && queue.size() > idle + (workers - running)) {
+        QRunnable *runnable = QRunnable::create([this] { workerLoop(); });
+        runnable->setAutoDelete(false);
+        runnables.push_back(runnable);
+        ++workers;
+        pool->start(runnable);
+    }
+    workAvailable.wakeAll();
+}
+
+// Called with the mutex held. Returns nullptr once the walk is over.
+DirNode *QDirWalkJob::takeDirectory()
+{
+    for (;;) {
+        if (stopRequested.loadRelaxed())
+            return nullptr;
+        if (!ordered || buffered < maxBuffered) {
+            if (DirNode *node = nextPending())
+                return node;
+        }
+        // Only listings add directories, so nothing more will come.
+        if (queue.isEmpty() && busy == 0)
+            return nullptr;
+        ++idle;
+        workAvailable.wait(&mutex);
+        --idle;
+    }
+}
+
+// Called with the mutex held.
+DirNode *QDirWalkJob::nextPending()
+{
+    while (!queue.isEmpty()) {
+        // Depth-first in IteratorOrder mode, so the consumer's next
+        // directory is usually listed first.
+        DirNode *node = ordered ? queue.takeLast() : queue.takeFirst();
+        if (ordered) {
+            if (node->state != DirNode::Pending)
+                continue;
+            if (node->isSkipped()) {
+                node->state = DirNode::Listed;
+                continue;
+            }
+        }
+        node->state = DirNode::Listing;
+        ++busy;
+        return node;
+    }
+    return nullptr;
+}
+
+void QDirWalkJob::waitUntilListed(DirNode *node)
+{
+    QMutexLocker locker(&mutex);
+    while (node->state != DirNode::Listed) {
+        if (node->state == DirNode::Pending) {
+            node->state = DirNode::Listing;
+            ++busy;
+            locker.unlock();
+            listDirectory(node, true);
+            locker.relock();
+        } else {
+            progress.wait(&mutex);
+        }
+    }
+}
+
+void QDirWalkJob::listDirectory(DirNode *node, bool byConsumer)
+{
+    QFileInfoList batch;
+    QList<DirNode *> subdirs;
+    QFileInfoList &listing = ordered ? node->entries : batch;
+
+    QFileSystemIterator it(node->entry, filter.filters, filter.nameFilters, filter.iteratorFlags);
+    QFileSystemEntry entry;
+    QFileSystemMetaData metaData;
+    while (!stopRequested.loadRelaxed() && it.advance(entry, metaData)) {
+        QFileInfo info(new QFileInfoPrivate(entry, metaData));
+
+        // Same order as QDirIteratorPrivate::entryMatches()
+        DirNode *child = filter.shouldFollow(info) ? createChild(node, entry, info) : nullptr;
+        if (filter.matchesFilters(entry.fileName(), info))
+            listing.append(info);
+
+        if (ordered) {
+            if (child)
+                node->children.append(DirNode::Child{listing.size(), child});
+        } else {
+            if (child)
+                subdirs.append(child);
+            if (batch.size() >= batchSize) {
+                QMutexLocker locker(&mutex);
+                flushBatch(batch, subdirs, byConsumer);
+            }
+        }
+        metaData = QFileSystemMetaData();
+    }
+
+    QMutexLocker locker(&mutex);
+    if (ordered) {
+        for (const DirNode::Child &child : qAsConst(node->children))
+            nodes.emplace_back(child.node);
+        node->state = DirNode::Listed;
+        if (node->isSkipped()) {
+            node->entries = QFileInfoList();
+        } else {
+            buffered += node->entries.size();
+            for (qsizetype i = node->children.size(); i > 0; --i)
+                queue.append(node->children.at(i - 1).node);
+            startWorkers();
+        }
+    } else {
+        flushBatch(batch, subdirs, byConsumer);
+        delete node;
+    }
+    if (--busy == 0)
+        workAvailable.wakeAll();
+    progress.wakeAll();
+}
+
+DirNode *QDirWalkJob::createChild(DirNode *parent, const QFileSystemEntry &entry,
+                                  const QFileInfo &info)
+{
+    QString canonicalPath;
+    if (followSymlinks) {
+        canonicalPath = info.canonicalFilePath();
+        if (ordered) {
+            // The consumer drops repeated directories in iteration order;
+            // only loops need cutting here.
+            for (const DirNode *node = parent; node; node = node->parent) {
+                if (node->canonicalPath == canonicalPath)
+                    return nullptr;
+            }
+        } else {
+            QMutexLocker locker(&mutex);
+            const qsizetype count = visited.size();
+            visited.insert(canonicalPath);
+            if (visited.size() == count)
+                return nullptr;
+        }
+    }
+
+    DirNode *child = new DirNode(entry, ordered ? parent : nullptr);
+    child->canonicalPath = canonicalPath;
+    return child;
+}
+
+// Called with the mutex held.
+void QDirWalkJob::flushBatch(QFileInfoList &batch, QList<DirNode *> &subdirs, bool byConsumer)
+{
+    // The consumer must never wait for itself.
+    while (!byConsumer && buffered >= maxBuffered && !stopRequested.loadRelaxed())
+        workAvailable.wait(&mutex);
+
+    if (!batch.isEmpty()) {
+        buffered += batch.size();
+        if (!batches.isEmpty() && batches.last().size() + batch.size() <= batchSize)
+            batches.last().append(batch);
+        else
+            batches.append(batch);
+        batch = QFileInfoList();
+        progress.wakeAll();
+    }
+    if (!subdirs.isEmpty()) {
+        queue.append(subdirs);
+        subdirs.clear();
+        startWorkers();
+    }
+}
+
+// Called with the mutex held.
+void QDirWalkJob::releaseSkipped(DirNode *node)
+{
+    if (node->state != DirNode::Listed)
+        return;
+    buffered -= node->entries.size();
+    node->entries = QFileInfoList();
+    for (const DirNode::Child &child : qAsConst(node->children))
+        releaseSkipped(child.node);
+    workAvailable.wakeAll();
+}
+
+} // unnamed namespace
+
+#endif // QT_NO_FILESYSTEMITERATOR
+
+/*!
+    Constructs a QDirWalker for the directory \a path, listing the entries
+    that match \a filters. By default it descends into all subdirectories;
+    pass other \a flags to change that.
+
+    \sa QDirIterator::QDirIterator()
+*/
+QDirWalker::QDirWalker(const QString &path, QDir::Filters filters,
+                       QDirIterator::IteratorFlags flags)
+    : d(new QDirWalkerPrivate(path, QStringList(), filters, flags))
+{
+}
+
+/*!
+    Constructs a QDirWalker for the directory \a path, listing the entries
+    that match \a nameFilters and \a filters, descending into
+    subdirectories according to \a flags.
+*/
+QDirWalker::QDirWalker(const QString &path, const QStringList &nameFilters,
+                       QDir::Filters filters, QDirIterator::IteratorFlags flags)
+    : d(new QDirWalkerPrivate(path, nameFilters, filters, flags))
+{
+}
+
+/*!
+    Destroys the walker.
+*/
+QDirWalker::~QDirWalker()
+{
+}
+
+/*!
+    Sets the thread pool to list directories on to \a pool. If \a pool is
+    \nullptr, the global thread pool is used.
+*/
+void QDirWalker::setThreadPool(QThreadPool *pool)
+{
+    d->pool = pool;
+}
+
+/*!
+    Returns the thread pool directories are listed on.
+*/
+QThreadPool *QDirWalker::threadPool() const
+{
+    return d->pool ? d->pool : QThreadPool::globalInstance();
+}
+
+/*!
+    Sets the maximum number of pool threads listing directories at the same
+    time to \a maxConcurrency. A value of 0, the default, uses the thread
+    pool's maxThreadCount(). The calling thread may list directories in
+    addition, when it would otherwise sit waiting for the pool.
+*/
+void QDirWalker::setMaxConcurrency(int maxConcurrency)
+{
+    d->maxConcurrency = qMax(0, maxConcurrency);
+}
+
+/*!
+    Returns the maximum number of pool threads listing directories at the
+    same time.
+*/
+int QDirWalker::maxConcurrency() const
+{
+    return d->maxConcurrency > 0 ? d->maxConcurrency : threadPool()->maxThreadCount();
+}
+
+/*!
+    Sets the largest number of entries passed to the consumer at once to
+    \a batchSize. The default is 256.
+*/
+void QDirWalker::setBatchSize(int batchSize)
+{
+    d->batchSize = qMax(1, batchSize);
+}
+
+/*!
+    Returns the largest number of entries passed to the consumer at once.
+*/
+int QDirWalker::batchSize() const
+{
+    return d->batchSize;
+}
+
+/*!
+    Sets the order in which entries are delivered to \a ordering. The
+    default is Unordered.
+*/
+void QDirWalker::setOrdering(Ordering ordering)
+{
+    d->ordering = ordering;
+}
+
+/*!
+    Returns the order in which entries are delivered.
+*/
+QDirWalker::Ordering QDirWalker::ordering() const
+{
+    return d->ordering;
+}
+
+/*!
+    Lists the directory tree, passing the matching entries to \a consumer in
+    batches on the calling thread, and returns once all of them have been
+    delivered or \a consumer returned \c false.
+
+    Returns \c true if every entry was delivered.
+
+    With QDirIterator::FollowSymlinks in Unordered mode, a directory that can
+    be reached through several paths is listed under whichever of them is
+    found first.
+*/
+bool QDirWalker::walk(const Consumer &consumer)
+{
+    QFileSystemEntry rootEntry(d->path);
+    QFileSystemMetaData metaData;
+    std::unique_ptr<QAbstractFileEngine> engine(
+            QFileSystemEngine::resolveEntryAndCreateLegacyEngine(rootEntry, metaData));
+#ifndef QT_NO_FILESYSTEMITERATOR
+    if (!engine) {
+        QDirWalkJob job(*d, consumer);
+        return job.run(rootEntry);
+    }
+#endif
+
+    // File engines make no thread-safety promises; list sequentially.
+    QDirIterator it(d->path, d->filter.nameFilters, d->filter.filters, d->filter.iteratorFlags);
+    QFileInfoList batch;
+    while (it.hasNext()) {
+        it.next();
+        batch.append(it.fileInfo());
+        if (batch.size() >= d->batchSize) {
+            if (!consumer(batch))
+                return false;
+            batch.clear();
+        }
+    }
+    return batch.isEmpty() || consumer(batch);
+}
+
+QT_END_NAMESPACE
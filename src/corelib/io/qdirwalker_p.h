@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDIRWALKER_P_H
+#define QDIRWALKER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qstringlist.h>
+
+#include <functional>
+#include <memory>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+class QDirWalkerPrivate;
+
+class Q_CORE_EXPORT QDirWalker
+{
+public:
+    enum Ordering {
+        Unordered,
+        IteratorOrder
+    };
+
+    // Return false to stop the walk.
+    using Consumer = std::function<bool(const QFileInfoList &)>;
+
+    explicit QDirWalker(const QString &path, QDir::Filters filters = QDir::NoFilter,
+                        QDirIterator::IteratorFlags flags = QDirIterator::Subdirectories);
+    QDirWalker(const QString &path, const QStringList &nameFilters,
+               QDir::Filters filters = QDir::NoFilter,
+               QDirIterator::IteratorFlags flags = QDirIterator::Subdirectories);
+    ~QDirWalker();
+
+    void setThreadPool(QThreadPool *pool);
+    QThreadPool *threadPool() const;
+
+    void setMaxConcurrency(int maxConcurrency);
+    int maxConcurrency() const;
+
+    void setBatchSize(int batchSize);
+    int batchSize() const;
+
+    void setOrdering(Ordering ordering);
+    Ordering ordering() const;
+
+    bool walk(const Consumer &consumer);
+
+private:
+    Q_DISABLE_COPY(QDirWalker)
+
+    std::unique_ptr<QDirWalkerPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QDIRWALKER_P_H
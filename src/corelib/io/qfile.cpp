@@ -51,6 +51,10 @@
 #include "private/qfilesystemengine_p.h"
 #include "private/qsystemerror_p.h"
 #include "private/qtemporaryfile_p.h"
+#if QT_CONFIG(future)
+# include "qfuture.h"
+# include "private/qfileasyncio_p.h"
+#endif
 #if defined(QT_BUILD_CORE_LIB)
 # include "qcoreapplication.h"
 #endif
@@ -1131,6 +1135,101 @@ qint64 QFile::size() const
     return QFileDevice::size(); // for now
 }
 
+#if QT_CONFIG(future)
+/*!
+    \since 6.1
+
+    Starts reading at most \a maxSize bytes at \a offset in the file and
+    returns a QFuture that holds the data once it has been read.
+
+    The read neither blocks nor uses or moves the current position. On Linux
+    it is submitted to io_uring where the kernel supports it; otherwise it
+    runs on a thread pool reserved for file I/O. The data is shorter than
+    \a maxSize at the end of the file, and empty if the read failed.
+
+    The future is finished from another thread, where continuations
+    attached with QFuture::then() run unless told otherwise. The file may
+    be closed or destroyed before that happens.
+
+    Data written with write() is flushed before the read is started, but
+    QFile's read buffer is not updated by writeAsync().
+
+    \sa writeAsync()
+*/
+QFuture<QByteArray> QFile::readAsync(qint64 offset, qint64 maxSize)
+{
+    return readAsync({ qMakePair(offset, maxSize) });
+}
+
+/*!
+    \since 6.1
+    \overload
+
+    Starts one read for each (offset, maximum size) pair in \a requests,
+    submitting them together, and returns a QFuture with one result per
+    request in the same order. Results are reported as their reads
+    complete, which need not be in order; use QFutureWatcher::resultReadyAt()
+    to process them as they arrive.
+*/
+QFuture<QByteArray> QFile::readAsync(const QList<QPair<qint64, qint64>> &requests)
+{
+    Q_D(QFile);
+    if (!(openMode() & ReadOnly)) {
+        qWarning("QFile::readAsync: File not open for reading");
+        return QtFuture::makeReadyFuture<QByteArray>(QList<QByteArray>(requests.size()));
+    }
+    d->ensureFlushed();
+    if (const auto file = d->asyncFileHandle())
+        return QFileAsyncIO::read(file, requests);
+
+    // Engines without a native handle (such as resources) read synchronously
+    QList<QByteArray> results;
+    results.reserve(requests.size());
+    const qint64 position = pos();
+    for (const auto &request : requests) {
+        if (request.first >= 0 && request.second > 0 && seek(request.first))
+            results.append(read(request.second));
+        else
+            results.append(QByteArray());
+    }
+    seek(position);
+    return QtFuture::makeReadyFuture<QByteArray>(results);
+}
+
+/*!
+    \since 6.1
+
+    Starts writing \a data at \a offset in the file and returns a QFuture
+    that holds the number of bytes written once the write has completed,
+    or -1 if nothing could be written.
+
+    Like readAsync(), the write neither blocks nor uses or moves the
+    current position, and the file may be closed before it completes.
+
+    \sa readAsync()
+*/
+QFuture<qint64> QFile::writeAsync(qint64 offset, const QByteArray &data)
+{
+    Q_D(QFile);
+    if (!(openMode() & WriteOnly)) {
+        qWarning("QFile::writeAsync: File not open for writing");
+        return QtFuture::makeReadyFuture(qint64(-1));
+    }
+    d->ensureFlushed();
+    if (const auto file = d->asyncFileHandle())
+        return QFileAsyncIO::write(file, offset, data);
+
+    qint64 written = -1;
+    const qint64 position = pos();
+    if (offset >= 0 && seek(offset)) {
+        written = write(data);
+        flush();
+    }
+    seek(position);
+    return QtFuture::makeReadyFuture(written);
+}
+#endif // QT_CONFIG(future)
+
 /*!
     \fn QFile::QFile(const std::filesystem::path &name)
     \since 6.0
@@ -89,6 +89,9 @@ using ForceFilesystemPath = typename std::enable_if_t<std::is_same_v<std::filesy
 
 class QTemporaryFile;
 class QFilePrivate;
+#if QT_CONFIG(future)
+template <typename T> class QFuture;
+#endif
 
 class Q_CORE_EXPORT QFile : public QFileDevice
 {
@@ -247,6 +250,12 @@ public:
     }
 #endif // QT_CONFIG(cxx17_filesystem)
 
+#if QT_CONFIG(future)
+    QFuture<QByteArray> readAsync(qint64 offset, qint64 maxSize);
+    QFuture<QByteArray> readAsync(const QList<QPair<qint64, qint64>> &requests);
+    QFuture<qint64> writeAsync(qint64 offset, const QByteArray &data);
+#endif
+
 protected:
 #ifdef QT_NO_QOBJECT
     QFile(QFilePrivate &dd);
@@ -0,0 +1,693 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfileasyncio_p.h"
+
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+
+#ifdef Q_OS_WIN
+#  include <qt_windows.h>
+#  include <io.h>
+#else
+#  include <QtCore/private/qcore_unix_p.h>
+#  include <errno.h>
+#endif
+
+#if QT_CONFIG(io_uring)
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#endif
+
+#ifndef Q_OS_WIN
+#  ifndef QT_PREAD
+#    if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#      define QT_PREAD        ::pread64
+#      define QT_PWRITE       ::pwrite64
+#    else
+#      define QT_PREAD        ::pread
+#      define QT_PWRITE       ::pwrite
+#    endif
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+// Linux transfers at most this much in one read or write
+static constexpr qint64 MaxChunkSize = 0x7ffff000;
+
+QFileAsyncHandle::~QFileAsyncHandle()
+{
+#ifdef Q_OS_WIN
+    CloseHandle(handle);
+#else
+    qt_safe_close(fd);
+#endif
+}
+
+std::shared_ptr<QFileAsyncHandle> QFileAsyncHandle::duplicate(int fd,
+                                                              QIODeviceBase::OpenMode mode)
+{
+#ifdef Q_OS_WIN
+    // A duplicated handle would share the file pointer, which ReadFile() and
+    // WriteFile() move even when given an offset.
+    const HANDLE source = HANDLE(_get_osfhandle(fd));
+    if (source == INVALID_HANDLE_VALUE)
+        return nullptr;
+    DWORD access = 0;
+    if (mode & QIODeviceBase::ReadOnly)
+        access |= GENERIC_READ;
+    if (mode & QIODeviceBase::WriteOnly)
+        access |= GENERIC_WRITE;
+    const HANDLE reopened = ReOpenFile(source, access,
+                                       FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                       FILE_FLAG_OVERLAPPED);
+    if (reopened == INVALID_HANDLE_VALUE)
+        return nullptr;
+    std::shared_ptr<QFileAsyncHandle> file(new QFileAsyncHandle);
+    file->handle = reopened;
+#else
+    Q_UNUSED(mode);
+    const int duplicate = qt_safe_dup(fd);
+    if (duplicate == -1)
+        return nullptr;
+    std::shared_ptr<QFileAsyncHandle> file(new QFileAsyncHandle);
+    file->fd = duplicate;
+#endif
+    return file;
+}
+
+namespace {
+
+struct ReadBatch
+{
+    QFutureInterface<QByteArray> result;
+    QAtomicInt remaining;
+};
+
+struct Operation
+{
+    std::shared_ptr<QFileAsyncHandle> file;
+    QByteArray buffer;  // not shared while a read is in flight
+    qint64 offset = 0;
+    qint64 size = 0;
+    qint64 done = 0;
+    bool failed = false;
+
+    // Reads report into their batch, writes into their own future
+    std::shared_ptr<ReadBatch> batch;
+    int index = 0;
+    QFutureInterface<qint64> written;
+
+    bool isWrite() const { return !batch; }
+    char *position() { return const_cast<char *>(buffer.constData()) + done; }
+    qint64 chunkSize() const { return qMin(size - done, MaxChunkSize); }
+
+    bool advance(qint64 result);
+    void finish();
+};
+
+/*
+    Accounts for a transfer that moved \a result bytes, or failed with
+    -errno. Returns \c true if the operation must be resubmitted.
+*/
+bool Operation::advance(qint64 result)
+{
+    if (result < 0) {
+#ifndef Q_OS_WIN
+        if (result == -EINTR || result == -EAGAIN)
+            return true;
+#endif
+        failed = true;
+        return false;
+    }
+    if (result == 0) {
+        // End of file for a read; a write that makes no progress never will.
+        failed = isWrite();
+        return false;
+    }
+    done += result;
+    return done < size;
+}
+
+void Operation::finish()
+{
+    if (isWrite()) {
+        written.reportResult(failed && done == 0 ? qint64(-1) : done);
+        written.reportFinished();
+    } else {
+        buffer.truncate(done);
+        batch->result.reportResult(std::move(buffer), index);
+        if (!batch->remaining.deref())
+            batch->result.reportFinished();
+    }
+}
+
+// Blocks until the operation is complete.
+static void transfer(Operation *op)
+{
+#ifdef Q_OS_WIN
+    // The handle is shared by concurrent operations, so each waits on an
+    // event of its own rather than on the handle.
+    const HANDLE event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    if (!event) {
+        op->failed = true;
+        return;
+    }
+    for (;;) {
+        const qint64 pos = op->offset + op->done;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = DWORD(pos);
+        overlapped.OffsetHigh = DWORD(pos >> 32);
+        overlapped.hEvent = event;
+        DWORD transferred = 0;
+        BOOL ok = op->isWrite()
+                ? WriteFile(op->file->handle, op->position(), DWORD(op->chunkSize()),
+                            nullptr, &overlapped)
+                : ReadFile(op->file->handle, op->position(), DWORD(op->chunkSize()),
+                           nullptr, &overlapped);
+        if (ok || GetLastError() == ERROR_IO_PENDING)
+            ok = GetOverlappedResult(op->file->handle, &overlapped, &transferred, TRUE);
+        if (!ok) {
+            op->failed = op->isWrite() || GetLastError() != ERROR_HANDLE_EOF;
+            break;
+        }
+        if (!op->advance(transferred))
+            break;
+    }
+    CloseHandle(event);
+#else
+    for (;;) {
+        const QT_OFF_T pos = QT_OFF_T(op->offset + op->done);
+        qint64 result;
+        if (op->isWrite())
+            EINTR_LOOP(result, QT_PWRITE(op->file->fd, op->position(), op->chunkSize(), pos));
+        else
+            EINTR_LOOP(result, QT_PREAD(op->file->fd, op->position(), op->chunkSize(), pos));
+        if (!op->advance(result < 0 ? -errno : result))
+            return;
+    }
+#endif
+}
+
+class ThreadPoolBackend
+{
+public:
+    ThreadPoolBackend()
+    {
+        // The threads spend their time blocked on the disk, not computing.
+        pool.setMaxThreadCount(qMax(4, 2 * QThread::idealThreadCount()));
+    }
+
+    ~ThreadPoolBackend()
+    {
+        pool.waitForDone();
+    }
+
+    void submit(const QList<Operation *> &operations)
+    {
+        if (operations.isEmpty())
+            return;
+        QMutexLocker locker(&mutex);
+        pending.append(operations);
+        // Each worker drains the queue, so a batch of thousands of reads
+        // costs a handful of runnables rather than one each.
+        const int wanted = int(qMin(pending.size(), qsizetype(pool.maxThreadCount())));
+        for (; workers < wanted; ++workers)
+            pool.start([this] { drain(); });
+    }
+
+private:
+    void drain()
+    {
+        QMutexLocker locker(&mutex);
+        while (!pending.isEmpty()) {
+            Operation *op = pending.takeFirst();
+            locker.unlock();
+            transfer(op);
+            op->finish();
+            delete op;
+            locker.relock();
+        }
+        --workers;
+    }
+
+    QThreadPool pool;
+    QMutex mutex;
+    QList<Operation *> pending;
+    int workers = 0;
+};
+
+Q_GLOBAL_STATIC(ThreadPoolBackend, threadPoolBackend)
+
+#if QT_CONFIG(io_uring)
+
+static int io_uring_setup(unsigned entries, io_uring_params *params)
+{
+    return int(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *arg, unsigned count)
+{
+    return int(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/*
+    Submits operations to an io_uring instance shared by the whole process.
+    Submission happens on the calling thread, one io_uring_enter() per
+    batch; a dedicated thread waits for completions, resubmits short
+    transfers and reports the results.
+*/
+class IoUringBackend : public QThread
+{
+public:
+    IoUringBackend();
+    ~IoUringBackend();
+
+    bool isValid() const { return ringFd != -1; }
+    void submit(const QList<Operation *> &operations);
+
+protected:
+    void run() override;
+
+private:
+    enum { RingSize = 256 };
+
+    bool setup(int fd, const io_uring_params &params);
+    void submitPending();
+
+    int ringFd = -1;
+    void *sqRing = MAP_FAILED;
+    void *cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqArray = nullptr;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned cqMask = 0;
+    unsigned cqEntries = 0;
+
+    QMutex mutex;
+    QList<Operation *> pending;     // waiting for room in the ring
+    unsigned inFlight = 0;
+};
+
+IoUringBackend::IoUringBackend()
+{
+    setObjectName(QStringLiteral("Qt io_uring"));
+    if (qEnvironmentVariableIsSet("QT_NO_IO_URING"))
+        return;
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int fd = io_uring_setup(RingSize, &params);
+    if (fd == -1)
+        return; // not supported, or not permitted
+    if (!setup(fd, params)) {
+        qt_safe_close(fd);
+        return;
+    }
+    ringFd = fd;
+    start();
+}
+
+bool IoUringBackend::setup(int fd, const io_uring_params &params)
+{
+    // Requires Linux 5.6 for IORING_OP_READ and IORING_OP_WRITE
+    const size_t probeSize = sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op);
+    std::unique_ptr<quint64[]> probeBuffer(new quint64[(probeSize + 7) / 8]());
+    const auto probe = reinterpret_cast<io_uring_probe *>(probeBuffer.get());
+    if (io_uring_register(fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0)
+        return false;
+    const auto supported = [probe](unsigned op) {
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    if (!supported(IORING_OP_READ) || !supported(IORING_OP_WRITE) || !supported(IORING_OP_NOP))
+        return false;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMap)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        return false;
+    if (singleMap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_CQ_RING);
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+        if (sqes != MAP_FAILED)
+            ::munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing)
+            ::munmap(cqRing, cqRingSize);
+        ::munmap(sqRing, sqRingSize);
+        return false;
+    }
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqEntries = params.cq_entries;
+    return true;
+}
+
+IoUringBackend::~IoUringBackend()
+{
+    if (ringFd == -1)
+        return;
+
+    // A completion without an operation tells run() to return.
+    int ret;
+    {
+        QMutexLocker locker(&mutex);
+        const unsigned tail = *sqTail;
+        const unsigned index = tail & sqMask;
+        memset(&sqes[index], 0, sizeof(io_uring_sqe));
+        sqes[index].opcode = IORING_OP_NOP;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        EINTR_LOOP(ret, io_uring_enter(ringFd, 1, 0, 0));
+    }
+    if (ret != 1 && isRunning())
+        return; // cannot unmap the rings under the completion thread
+    wait();
+
+    ::munmap(sqes, sqesSize);
+    if (cqRing != sqRing)
+        ::munmap(cqRing, cqRingSize);
+    ::munmap(sqRing, sqRingSize);
+    qt_safe_close(ringFd);
+}
+
+void IoUringBackend::submit(const QList<Operation *> &operations)
+{
+    QMutexLocker locker(&mutex);
+    pending.append(operations);
+    submitPending();
+}
+
+// Called with the mutex held.
+void IoUringBackend::submitPending()
+{
+    unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    unsigned tail = *sqTail;
+    qsizetype queued = 0;
+
+    // Bounding the operations in flight by the size of the completion
+    // queue means it can never overflow.
+    while (queued < pending.size() && tail - head < sqEntries && inFlight < cqEntries) {
+        Operation *op = pending.at(queued++);
+        const unsigned index = tail & sqMask;
+        io_uring_sqe *sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = op->isWrite() ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe->fd = op->file->fd;
+        sqe->off = quint64(op->offset + op->done);
+        sqe->addr = quintptr(op->position());
+        sqe->len = unsigned(op->chunkSize());
+        sqe->user_data = quintptr(op);
+        sqArray[index] = index;
+        ++tail;
+        ++inFlight;
+    }
+    if (!queued)
+        return;
+    pending.remove(0, queued);
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    while (head != tail) {
+        const int ret = io_uring_enter(ringFd, tail - head, 0, 0);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret > 0) {
+            head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            continue;
+        }
+
+        // Hand whatever the kernel refused to the thread pool instead.
+        QList<Operation *> rejected;
+        for (unsigned i = head; i != tail; ++i) {
+            const io_uring_sqe &sqe = sqes[sqArray[i & sqMask]];
+            rejected.append(reinterpret_cast<Operation *>(quintptr(sqe.user_data)));
+        }
+        __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+        inFlight -= unsigned(rejected.size());
+        threadPoolBackend()->submit(rejected);
+        break;
+    }
+}
+
+void IoUringBackend::run()
+{
+    QList<Operation *> resubmit;
+    for (;;) {
+        if (io_uring_enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            qErrnoWarning("QFileAsyncIO: waiting for io_uring completions failed");
+            return;
+        }
+
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        const unsigned completed = tail - head;
+        bool stop = false;
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            Operation *op = reinterpret_cast<Operation *>(quintptr(cqe.user_data));
+            if (!op) {
+                stop = true;
+            } else if (op->advance(cqe.res)) {
+                resubmit.append(op);
+            } else {
+                op->finish();
+                delete op;
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        if (stop)
+            return;
+
+        QMutexLocker locker(&mutex);
+        inFlight -= completed;
+        if (!resubmit.isEmpty()) {
+            // Continue short transfers ahead of new work
+            resubmit.append(pending);
+            pending.swap(resubmit);
+            resubmit.clear();
+        }
+        submitPending();
+    }
+}
+
+Q_GLOBAL_STATIC(IoUringBackend, ioUringBackend)
+
+#endif // QT_CONFIG(io_uring)
+
+} // unnamed namespace
+
+static QBasicAtomicInt useThreadPool = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static void submit(const QList<Operation *> &operations)
+{
+#if QT_CONFIG(io_uring)
+    if (!useThreadPool.loadRelaxed() && ioUringBackend()->isValid()) {
+        ioUringBackend()->submit(operations);
+        return;
+    }
+#endif
+    threadPoolBackend()->submit(operations);
+}
+
+/*!
+    \internal
+    \class QFileAsyncIO
+    \inmodule QtCore
+
+    \brief QFileAsyncIO performs positional reads and writes without
+    blocking the calling thread.
+
+    On Linux, operations are submitted to an io_uring instance, several at
+    a time for batches of reads; elsewhere, or where io_uring is not
+    available, they run as blocking calls on a dedicated thread pool.
+    Setting the environment variable \c QT_NO_IO_URING forces the thread
+    pool.
+
+    Results are reported from the thread completing the operation.
+
+    \sa QFile::readAsync(), QFile::writeAsync()
+*/
+
+/*!
+    \internal
+
+    Returns the backend new operations are submitted to.
+*/
+QFileAsyncIO::Backend QFileAsyncIO::backend()
+{
+#if QT_CONFIG(io_uring)
+    if (!useThreadPool.loadRelaxed() && ioUringBackend()->isValid())
+        return IoUring;
+#endif
+    return ThreadPool;
+}
+
+/*!
+    \internal
+
+    Submits new operations to \a backend from now on. Returns \c false if
+    \a backend is not available. Intended for testing.
+*/
+bool QFileAsyncIO::setBackend(Backend backend)
+{
+    if (backend == IoUring) {
+#if QT_CONFIG(io_uring)
+        if (!ioUringBackend()->isValid())
+            return false;
+        useThreadPool.storeRelaxed(0);
+        return true;
+#else
+        return false;
+#endif
+    }
+    useThreadPool.storeRelaxed(1);
+    return true;
+}
+
+/*!
+    \internal
+
+    Reads each (offset, maximum size) pair of \a requests from \a file. The
+    returned future has one result per request, in the same order, holding
+    the data read; it is shorter than requested at the end of the file or
+    after an error.
+*/
+QFuture<QByteArray> QFileAsyncIO::read(const std::shared_ptr<QFileAsyncHandle> &file,
+                                       const QList<QPair<qint64, qint64>> &requests)
+{
+    auto batch = std::make_shared<ReadBatch>();
+    batch->result.reportStarted();
+    QFuture<QByteArray> future = batch->result.future();
+    if (requests.isEmpty()) {
+        batch->result.reportFinished();
+        return future;
+    }
+    batch->remaining.storeRelaxed(int(requests.size()));
+
+    QList<Operation *> operations;
+    operations.reserve(requests.size());
+    for (qsizetype i = 0; i < requests.size(); ++i) {
+        Operation *op = new Operation;
+        op->file = file;
+        op->offset = requests.at(i).first;
+        op->size = qMax(qint64(0), requests.at(i).second);
+        op->batch = batch;
+        op->index = int(i);
+        if (op->size == 0 || op->offset < 0) {
+            op->finish();
+            delete op;
+            continue;
+        }
+        op->buffer = QByteArray(op->size, Qt::Uninitialized);
+        operations.append(op);
+    }
+    submit(operations);
+    return future;
+}
+
+/*!
+    \internal
+
+    Writes \a data to \a file at \a offset. The returned future holds the
+    number of bytes written, or -1 if nothing could be written.
+*/
+QFuture<qint64> QFileAsyncIO::write(const std::shared_ptr<QFileAsyncHandle> &file,
+                                    qint64 offset, const QByteArray &data)
+{
+    Operation *op = new Operation;
+    op->file = file;
+    op->buffer = data;
+    op->offset = offset;
+    op->size = data.size();
+    op->written.reportStarted();
+    QFuture<qint64> future = op->written.future();
+    if (op->size == 0 || offset < 0) {
+        op->failed = offset < 0;
+        op->finish();
+        delete op;
+        return future;
+    }
+    submit({ op });
+    return future;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILEASYNCIO_P_H
+#define QFILEASYNCIO_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qiodevicebase.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+
+#include <memory>
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+// A native handle of its own on an open file. Every operation holds a
+// reference, so closing the QFile does not invalidate operations in flight.
+// On Windows the file is reopened for overlapped I/O, which leaves the file
+// pointer shared with the QFile alone.
+class QFileAsyncHandle
+{
+public:
+    ~QFileAsyncHandle();
+
+    static std::shared_ptr<QFileAsyncHandle> duplicate(int fd, QIODeviceBase::OpenMode mode);
+
+#ifdef Q_OS_WIN
+    Qt::HANDLE handle;
+#else
+    int fd;
+#endif
+
+private:
+    QFileAsyncHandle() = default;
+};
+
+class Q_CORE_EXPORT QFileAsyncIO
+{
+public:
+    enum Backend {
+        ThreadPool,
+        IoUring
+    };
+
+    static Backend backend();
+    static bool setBackend(Backend backend);
+
+    static QFuture<QByteArray> read(const std::shared_ptr<QFileAsyncHandle> &file,
+                                    const QList<QPair<qint64, qint64>> &requests);
+    static QFuture<qint64> write(const std::shared_ptr<QFileAsyncHandle> &file,
+                                 qint64 offset, const QByteArray &data);
+};
+
+QT_END_NAMESPACE
+
+#endif // QFILEASYNCIO_P_H
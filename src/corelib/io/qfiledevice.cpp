@@ -41,6 +41,9 @@
 #include "qfiledevice.h"
 #include "qfiledevice_p.h"
 #include "qfsfileengine_p.h"
+#if QT_CONFIG(future)
+#include "qfileasyncio_p.h"
+#endif
 
 #ifdef QT_NO_QOBJECT
 #define tr(X) QString::fromLatin1(X)
@@ -68,6 +71,24 @@ QAbstractFileEngine *QFileDevicePrivate::engine() const
     return fileEngine.get();
 }
 
+#if QT_CONFIG(future)
+/*!
+    \internal
+
+    Returns a native handle of its own on the open file, or \nullptr if the
+    file engine has none.
+*/
+std::shared_ptr<QFileAsyncHandle> QFileDevicePrivate::asyncFileHandle()
+{
+    if (!asyncHandle && fileEngine) {
+        const int fd = fileEngine->handle();
+        if (fd != -1)
+            asyncHandle = QFileAsyncHandle::duplicate(fd, openMode);
+    }
+    return asyncHandle;
+}
+#endif
+
 void QFileDevicePrivate::setError(QFileDevice::FileError err)
 {
     error = err;
@@ -326,6 +347,11 @@ void QFileDevice::close()
     // reset cached size
     d->cachedSize = 0;
 
+#if QT_CONFIG(future)
+    // operations in flight keep their own reference
+    d->asyncHandle.reset();
+#endif
+
     // keep earlier error from flush
     if (d->fileEngine->close() && flushed)
         unsetError();
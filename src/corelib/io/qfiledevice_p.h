@@ -59,6 +59,9 @@ QT_BEGIN_NAMESPACE
 
 class QAbstractFileEngine;
 class QFSFileEngine;
+#if QT_CONFIG(future)
+class QFileAsyncHandle;
+#endif
 
 class QFileDevicePrivate : public QIODevicePrivate
 {
@@ -84,6 +87,13 @@ protected:
     QFileDevice::FileError error;
 
     bool lastWasWrite;
+
+#if QT_CONFIG(future)
+    std::shared_ptr<QFileAsyncHandle> asyncFileHandle();
+
+    // Duplicate of the engine's handle for QFile::readAsync() and writeAsync()
+    std::shared_ptr<QFileAsyncHandle> asyncHandle;
+#endif
 };
 
 inline bool QFileDevicePrivate::ensureFlushed() const
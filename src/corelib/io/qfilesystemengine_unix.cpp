@@ -110,6 +110,14 @@ extern "C" NSString *NSTemporaryDirectory();
 struct statx { mode_t stx_mode; };      // dummy
 #endif
 
+#ifndef QT_FSTATAT
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#    define QT_FSTATAT      ::fstatat64
+#  else
+#    define QT_FSTATAT      ::fstatat
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 enum {
@@ -330,6 +338,11 @@ static int qt_fstatx(int fd, struct statx *statxBuffer)
     return qt_real_statx(fd, "", AT_EMPTY_PATH, statxBuffer);
 }
 
+static int qt_statxat(int dirFd, const char *fileName, int flags, struct statx *statxBuffer)
+{
+    return qt_real_statx(dirFd, fileName, flags, statxBuffer);
+}
+
 inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &statxBuffer)
 {
     // Permissions
@@ -396,6 +409,9 @@ static int qt_lstatx(const char *, struct statx *)
 static int qt_fstatx(int, struct statx *)
 { return -ENOSYS; }
 
+static int qt_statxat(int, const char *, int, struct statx *)
+{ return -ENOSYS; }
+
 inline void QFileSystemMetaData::fillFromStatxBuf(const struct statx &)
 { }
 #endif
@@ -428,6 +444,58 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+#ifdef AT_FDCWD
+// Returns 1 if statxBuffer was filled, 0 if statBuffer was and -1 on error
+static int qt_statat(int dirFd, const char *fileName, int flags,
+                     struct statx *statxBuffer, QT_STATBUF *statBuffer)
+{
+    const int ret = qt_statxat(dirFd, fileName, flags, statxBuffer);
+    if (ret == -ENOSYS)
+        return QT_FSTATAT(dirFd, fileName, statBuffer, flags) == 0 ? 0 : -1;
+    return ret == 0 ? 1 : -1;
+}
+#endif
+
+//static
+bool QFileSystemEngine::fillMetaData(int dirFd, const char *fileName, QFileSystemMetaData &data)
+{
+#ifdef AT_FDCWD
+    // Same as fillMetaData(entry, data, LinkType | PosixStatFlags), except that
+    // fileName is looked up in dirFd instead of walking its full path again.
+    union {
+        struct statx statxBuffer;
+        QT_STATBUF statBuffer;
+    };
+
+    int result = qt_statat(dirFd, fileName, AT_SYMLINK_NOFOLLOW, &statxBuffer, &statBuffer);
+    if (result < 0)
+        return false;
+
+    const mode_t mode = result ? mode_t(statxBuffer.stx_mode) : statBuffer.st_mode;
+    data.entryFlags &= ~(QFileSystemMetaData::LinkType | QFileSystemMetaData::PosixStatFlags);
+    data.knownFlagsMask |= QFileSystemMetaData::LinkType;
+    if (S_ISLNK(mode)) {
+        data.entryFlags |= QFileSystemMetaData::LinkType;
+        result = qt_statat(dirFd, fileName, 0, &statxBuffer, &statBuffer);
+        if (result < 0)
+            return false; // broken symlink, let fillMetaData() sort it out
+    }
+
+    if (result)
+        data.fillFromStatxBuf(statxBuffer);
+    else
+        data.fillFromStatBuf(statBuffer);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags
+            | QFileSystemMetaData::ExistsAttribute;
+    return true;
+#else
+    Q_UNUSED(dirFd);
+    Q_UNUSED(fileName);
+    Q_UNUSED(data);
+    return false;
+#endif
+}
+
 #if defined(_DEXTRA_FIRST)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
@@ -617,6 +685,13 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
 #else
     Q_UNUSED(entry);
 #endif
+
+#if !defined(Q_OS_DARWIN)
+    // Hidden files are exactly the dot files, see fillMetaData()
+    knownFlagsMask |= QFileSystemMetaData::HiddenAttribute;
+    if (entry.d_name[0] == '.')
+        entryFlags |= QFileSystemMetaData::HiddenAttribute;
+#endif
 }
 
 //static
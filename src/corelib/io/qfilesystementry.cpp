@@ -172,6 +172,14 @@ void QFileSystemEntry::resolveNativeFilePath() const
 
 QString QFileSystemEntry::fileName() const
 {
+#if !defined(QFILESYSTEMENTRY_NATIVE_PATH_IS_UTF16)
+    // Entries created by QFileSystemIterator only have the native path; avoid
+    // decoding all of it when only the last component is needed.
+    if (m_filePath.isEmpty() && !m_nativeFilePath.isEmpty()) {
+        const qsizetype separator = m_nativeFilePath.lastIndexOf('/');
+        return QFile::decodeName(m_nativeFilePath.mid(separator + 1));
+    }
+#endif
     findLastSeparator();
 #if defined(Q_OS_WIN)
     if (m_lastSeparator == -1 && m_filePath.length() >= 2 && m_filePath.at(1) == QLatin1Char(':'))
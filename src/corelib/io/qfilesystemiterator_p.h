@@ -72,9 +72,12 @@ QT_BEGIN_NAMESPACE
 class QFileSystemIterator
 {
 public:
+    // If given, parent must be the iterator whose current entry is entry;
+    // it lets the Unix implementation open entry relative to parent's directory.
     QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
             const QStringList &nameFilters, QDirIterator::IteratorFlags flags
-                = QDirIterator::FollowSymlinks | QDirIterator::Subdirectories);
+                = QDirIterator::FollowSymlinks | QDirIterator::Subdirectories,
+            const QFileSystemIterator *parent = nullptr);
     ~QFileSystemIterator();
 
     bool advance(QFileSystemEntry &fileEntry, QFileSystemMetaData &metaData);
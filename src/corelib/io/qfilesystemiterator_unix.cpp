@@ -40,6 +40,8 @@
 #include "qplatformdefs.h"
 #include "qfilesystemiterator_p.h"
 
+#include <private/qcore_unix_p.h>
+#include <private/qfilesystemengine_p.h>
 #include <private/qstringconverter_p.h>
 
 #ifndef QT_NO_FILESYSTEMITERATOR
@@ -60,7 +62,8 @@ static bool checkNameDecodable(const char *d_name, qsizetype len)
 }
 
 QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
-                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
+                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags,
+                                         const QFileSystemIterator *parent)
     : nativePath(entry.nativeFilePath())
     , dir(nullptr)
     , dirEntry(nullptr)
@@ -70,6 +73,31 @@ QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Fi
     Q_UNUSED(nameFilters);
     Q_UNUSED(flags);
 
+#ifdef AT_FDCWD
+    // Open subdirectories relative to the parent directory, so that the
+    // kernel does not have to resolve the whole path again.
+    if (parent && parent->dir && parent->dirEntry) {
+        const char *name = parent->dirEntry->d_name;
+        const qsizetype len = qstrlen(name);
+        if (nativePath.size() == parent->nativePath.size() + len
+                && nativePath.startsWith(parent->nativePath) && nativePath.endsWith(name)) {
+            int fd;
+            EINTR_LOOP(fd, ::openat(::dirfd(parent->dir), name, O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+            if (fd == -1) {
+                lastError = errno;
+            } else if ((dir = ::fdopendir(fd)) == nullptr) {
+                lastError = errno;
+                qt_safe_close(fd);
+            }
+            if (dir)
+                nativePath.append('/');
+            return;
+        }
+    }
+#else
+    Q_UNUSED(parent);
+#endif
+
     if ((dir = QT_OPENDIR(nativePath.constData())) == nullptr) {
         lastError = errno;
     } else {
@@ -95,8 +123,17 @@ bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaDa
         if (dirEntry) {
             qsizetype len = strlen(dirEntry->d_name);
             if (checkNameDecodable(dirEntry->d_name, len)) {
-                fileEntry = QFileSystemEntry(nativePath + QByteArray(dirEntry->d_name, len), QFileSystemEntry::FromNativePath());
+                QFileSystemEntry::NativePath path;
+                path.reserve(nativePath.size() + len);
+                path.append(nativePath).append(dirEntry->d_name, len);
+                fileEntry = QFileSystemEntry(path, QFileSystemEntry::FromNativePath());
                 metaData.fillFromDirEnt(*dirEntry);
+#ifdef AT_FDCWD
+                // d_type did not tell us the type, or this is a symlink and
+                // the filters need its target: stat relative to the directory
+                if (!metaData.hasFlags(QFileSystemMetaData::DirectoryType))
+                    QFileSystemEngine::fillMetaData(::dirfd(dir), dirEntry->d_name, metaData);
+#endif
                 return true;
             }
         } else {
@@ -49,7 +49,8 @@ QT_BEGIN_NAMESPACE
 bool done = true;
 
 QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
-                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
+                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags,
+                                         const QFileSystemIterator *parent)
     : nativePath(entry.nativeFilePath())
     , dirPath(entry.filePath())
     , findFileHandle(INVALID_HANDLE_VALUE)
@@ -59,6 +60,7 @@ QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Fi
 {
     Q_UNUSED(nameFilters);
     Q_UNUSED(flags);
+    Q_UNUSED(parent);
     if (nativePath.endsWith(QLatin1String(".lnk"))) {
         QFileSystemMetaData metaData;
         QFileSystemEntry link = QFileSystemEngine::getLinkTarget(entry, metaData);
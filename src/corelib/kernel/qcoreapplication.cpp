@@ -48,7 +48,11 @@
 #endif
 #include "qmetaobject.h"
 #include "qcorecmdlineargs_p.h"
+#include "qeventloopstatistics_p.h"
 #include <qdatastream.h>
+#ifndef QT_BOOTSTRAPPED
+#include <private/qbinarylogging_p.h>
+#endif
 #include <qdebug.h>
 #include <qdir.h>
 #include <qfile.h>
@@ -340,6 +344,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    const auto locker = qt_scoped_lock(currentThreadData->postEventList.mutex);
+    currentThreadData->postEventList.mergeIncoming();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -488,6 +494,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->postEventList.mergeIncoming();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -772,8 +779,12 @@ void QCoreApplicationPrivate::init()
 #endif
 
     // Store app name/version (so they're still available after QCoreApplication is destroyed)
-    if (!coreappdata()->applicationNameSet)
+    if (!coreappdata()->applicationNameSet) {
         coreappdata()->application = appName();
+#ifndef QT_BOOTSTRAPPED
+        QBinaryLogging::applicationNameChanged(coreappdata()->application);
+#endif
+    }
 
     if (!coreappdata()->applicationVersionSet)
         coreappdata()->applicationVersion = appVersion();
@@ -1035,9 +1046,19 @@ bool QCoreApplication::notifyInternal2(QObject *receiver, QEvent *event)
     QObjectPrivate *d = receiver->d_func();
     QThreadData *threadData = d->threadData;
     QScopedScopeLevelCounter scopeLevelCounter(threadData);
-    if (!selfRequired)
-        return doNotify(receiver, event);
-    return self->notify(receiver, event);
+    const qint64 startTime = QEventLoopStatistics::timestamp();
+    if (Q_LIKELY(!startTime)) {
+        if (!selfRequired)
+            return doNotify(receiver, event);
+        return self->notify(receiver, event);
+    }
+
+    // the receiver, and a dynamic metaobject with it, may well be gone afterwards
+    const QByteArray receiverClass = QEventLoopStatistics::receiverClass(receiver);
+    const int eventType = event->type();
+    result = selfRequired ? self->notify(receiver, event) : doNotify(receiver, event);
+    QEventLoopStatistics::recordHandler(threadData, receiverClass, eventType, startTime);
+    return result;
 }
 
 /*!
@@ -1523,6 +1544,32 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued calls at the default priority don't need to see the sorted list
+    // right away: push them onto the lock-free stack of the receiver's thread,
+    // which merges (and possibly compresses) them under its own lock later.
+    if (priority == Qt::NormalEventPriority && event->type() == QEvent::MetaCall) {
+        QObjectPrivate *d = receiver->d_func();
+        d->postingThreads.fetch_add(1, std::memory_order_relaxed);
+        // Pairs with the fence in QObjectPrivate::setThreadData_helper(): either
+        // we see the thread data the receiver has been moved to, or the move
+        // waits for us. Either way, the receiver holds a reference to the thread
+        // data until we're done with it.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (QThreadData *data = d->threadData.loadAcquire()) {
+            Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+            event->m_posted = true;
+            data->postEventList.pushIncoming(new QPostEventList::IncomingEvent{
+                    nullptr, receiver, event, QEventLoopStatistics::timestamp()});
+
+            QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+            if (dispatcher)
+                dispatcher->wakeUp();
+            d->postingThreads.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        d->postingThreads.fetch_sub(1, std::memory_order_release);
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1531,10 +1578,10 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     }
 
     QThreadData *data = locker.threadData;
+    data->postEventList.mergeIncoming();
 
     // if this is one of the compressible events, do compression
-    if (receiver->d_func()->postedEvents
-        && self && self->compressEvent(event, receiver, &data->postEventList)) {
+    if (QCoreApplicationPrivate::compressPostedEvent(event, receiver, &data->postEventList)) {
         Q_TRACE(QCoreApplication_postEvent_event_compressed, receiver, event);
         return;
     }
@@ -1568,7 +1615,8 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     // properly owned in the postEventList
     QScopedPointer<QEvent> eventDeleter(event);
     Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
-    data->postEventList.addEvent(QPostEvent(receiver, event, priority));
+    data->postEventList.addEvent(QPostEvent(receiver, event, priority,
+                                            QEventLoopStatistics::timestamp()));
     eventDeleter.take();
     event->m_posted = true;
     ++receiver->d_func()->postedEvents;
@@ -1580,6 +1628,28 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         dispatcher->wakeUp();
 }
 
+/*!
+  \internal
+  Lets the application compress \a event, posted to \a receiver, into the
+  events already in \a postedEvents, whose mutex must be locked. Returns
+  \c true if \a event was compressed away (possibly deleted) and should not
+  be added to the list.
+*/
+bool QCoreApplicationPrivate::compressPostedEvent(QEvent *event, QObject *receiver,
+                                                  QPostEventList *postedEvents)
+{
+    if (!receiver->d_func()->postedEvents || !QCoreApplication::self)
+        return false;
+
+    // events merged from the lock-free stack are already marked as posted, but
+    // they aren't in the list for removePostedEvent() if compressEvent() deletes them
+    const bool posted = std::exchange(event->m_posted, false);
+    if (QCoreApplication::self->compressEvent(event, receiver, postedEvents))
+        return true;
+    event->m_posted = posted;
+    return false;
+}
+
 /*!
   \internal
   Returns \c true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1677,6 +1747,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->postEventList.mergeIncoming();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1690,6 +1761,11 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
     data->canWait = true;
 
+    if (!receiver && !event_type && QEventLoopStatistics::isEnabled()) {
+        QEventLoopStatistics::recordQueueDepth(data, data->postEventList.size()
+                                                     - data->postEventList.startOffset);
+    }
+
     // okay. here is the tricky loop. be careful about optimizing
     // this, it looks the way it does for good reasons.
     int startOffset = data->postEventList.startOffset;
@@ -1784,6 +1860,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
         pe.event->m_posted = false;
         QEvent *e = pe.event;
         QObject * r = pe.receiver;
+        const qint64 postTime = pe.postTime;
 
         --r->d_func()->postedEvents;
         Q_ASSERT(r->d_func()->postedEvents >= 0);
@@ -1797,6 +1874,10 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
         QScopedPointer<QEvent> event_deleter(e); // will delete the event (with the mutex unlocked)
 
+        if (postTime)
+            QEventLoopStatistics::recordQueueWait(data, QEventLoopStatistics::receiverClass(r),
+                                                  e->type(), postTime);
+
         // after all that work, it's time to deliver the event.
         QCoreApplication::sendEvent(r, e);
 
@@ -1831,6 +1912,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     QThreadData *data = locker.threadData;
+    data->postEventList.mergeIncoming();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1894,6 +1976,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->postEventList.mergeIncoming();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -2562,6 +2645,9 @@ void QCoreApplication::setApplicationName(const QString &application)
     if (coreappdata()->application == newAppName)
         return;
     coreappdata()->application = newAppName;
+#ifndef QT_BOOTSTRAPPED
+    QBinaryLogging::applicationNameChanged(newAppName);
+#endif
 #ifndef QT_NO_QOBJECT
     if (QCoreApplication::self)
         emit QCoreApplication::self->applicationNameChanged();
@@ -156,6 +156,7 @@ public:
         void unlock() { locker.unlock(); }
     };
     static QPostEventListLocker lockThreadPostEventList(QObject *object);
+    static bool compressPostedEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents);
 #endif // QT_NO_QOBJECT
 
     int &argc;
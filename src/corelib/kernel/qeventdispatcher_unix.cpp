@@ -228,12 +228,6 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
 }
 
-QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
-{
-    // cleanup timers
-    qDeleteAll(timerList);
-}
-
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
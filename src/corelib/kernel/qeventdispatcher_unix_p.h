@@ -130,7 +130,6 @@ class Q_CORE_EXPORT QEventDispatcherUNIXPrivate : public QAbstractEventDispatche
 
 public:
     QEventDispatcherUNIXPrivate();
-    ~QEventDispatcherUNIXPrivate();
 
     int activateTimers();
 
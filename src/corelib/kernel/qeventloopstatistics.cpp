@@ -0,0 +1,466 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qeventloopstatistics_p.h"
+
+#include "qcoreevent.h"
+#include "qhash.h"
+#include "qloggingcategory.h"
+#include "qmetaobject.h"
+#include "qmutex.h"
+#include "qthread.h"
+#if QT_CONFIG(thread)
+#include "qwaitcondition.h"
+#endif
+#include <QtCore/private/qlocking_p.h>
+#include <QtCore/private/qobject_p.h>
+#include <QtCore/private/qthread_p.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#if QT_CONFIG(thread)
+#include <thread>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcEventLoopStatistics, "qt.core.eventloop.statistics")
+
+QBasicAtomicInt QEventLoopStatistics::enabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+struct QEventLoopStatisticsData
+{
+    using Key = std::pair<QByteArray, int>;
+
+    QEventLoopStatisticsData(quintptr threadId, const QString &threadName)
+        : threadId(threadId), threadName(threadName)
+    {}
+
+    QEventLoopStatistics::EventStatistics &entry(const QByteArray &receiverClass, int eventType)
+    {
+        auto it = events.find(Key(receiverClass, eventType));
+        if (it == events.end()) {
+            // receiverClass may be raw data, keep a copy
+            const QByteArray className(receiverClass.constData(), receiverClass.size());
+            it = events.insert(Key(className, eventType), QEventLoopStatistics::EventStatistics());
+            it->eventType = eventType;
+            it->receiverClass = className;
+        }
+        return *it;
+    }
+
+    // only contended while a snapshot is taken or the statistics are reset
+    QBasicMutex mutex;
+    QHash<Key, QEventLoopStatistics::EventStatistics> events;
+    QEventLoopStatistics::Histogram queueDepth;
+    quint64 stalls = 0;
+    const quintptr threadId;
+    const QString threadName;
+    QAtomicInteger<bool> finished = false;
+};
+
+namespace {
+
+constexpr size_t MaxFinishedThreads = 64;
+constexpr qint64 DefaultStallThreshold = 100 * 1000; // microseconds
+
+QBasicAtomicInteger<qint64> stallThresholdNs = Q_BASIC_ATOMIC_INITIALIZER(DefaultStallThreshold * 1000);
+
+struct StatisticsRegistry
+{
+    StatisticsRegistry()
+    {
+        bool ok = false;
+        const int interval = qEnvironmentVariableIntValue("QT_EVENT_LOOP_STATISTICS_INTERVAL", &ok);
+        if (ok && interval > 0)
+            QEventLoopStatistics::setDumpInterval(interval);
+    }
+
+    std::shared_ptr<QEventLoopStatisticsData> registerThread(QThreadData *data)
+    {
+        const QThread *thread = data->thread.loadRelaxed();
+        auto statistics = std::make_shared<QEventLoopStatisticsData>(
+                    quintptr(QThread::currentThreadId()), thread ? thread->objectName() : QString());
+
+        const auto locker = qt_scoped_lock(mutex);
+        // keep the statistics of threads that have finished, but not of arbitrarily many
+        size_t finished = 0;
+        for (auto it = threads.end(); it != threads.begin(); ) {
+            --it;
+            if ((*it)->finished.loadAcquire() && ++finished > MaxFinishedThreads)
+                it = threads.erase(it);
+        }
+        threads.push_back(statistics);
+        return statistics;
+    }
+
+    std::vector<std::shared_ptr<QEventLoopStatisticsData>> threadStatistics()
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        return threads;
+    }
+
+    QBasicMutex mutex;
+    std::vector<std::shared_ptr<QEventLoopStatisticsData>> threads;
+};
+
+Q_GLOBAL_STATIC(StatisticsRegistry, statisticsRegistry)
+
+#if QT_CONFIG(thread)
+// Calls QEventLoopStatistics::dump() from a thread of its own, so that the
+// report comes out even while the threads being looked at are stuck.
+struct StatisticsDumper
+{
+    ~StatisticsDumper() { stop(); }
+
+    void start(int msecs)
+    {
+        stop();
+        interval = msecs;
+        if (msecs <= 0)
+            return;
+        quit = false;
+        thread = std::thread([this] { run(); });
+    }
+
+    void stop()
+    {
+        {
+            const auto locker = qt_scoped_lock(mutex);
+            quit = true;
+            wakeUp.wakeAll();
+        }
+        if (thread.joinable())
+            thread.join();
+        interval = 0;
+    }
+
+    void run()
+    {
+        auto locker = qt_unique_lock(mutex);
+        QDeadlineTimer deadline(interval);
+        while (!quit) {
+            if (wakeUp.wait(locker.mutex(), deadline) || quit)
+                continue;
+            locker.unlock();
+            QEventLoopStatistics::dump();
+            locker.lock();
+            deadline.setRemainingTime(interval);
+        }
+    }
+
+    QBasicMutex controlMutex;   // serializes start() and stop()
+    QMutex mutex;
+    QWaitCondition wakeUp;
+    int interval = 0;
+    bool quit = false;
+    std::thread thread;
+};
+
+Q_GLOBAL_STATIC(StatisticsDumper, statisticsDumper)
+#endif // QT_CONFIG(thread)
+
+} // unnamed namespace
+
+static QEventLoopStatisticsData *threadStatistics(QThreadData *data)
+{
+    if (Q_UNLIKELY(!data->eventLoopStatistics)) {
+        StatisticsRegistry *registry = statisticsRegistry();
+        if (!registry)
+            return nullptr;
+        data->eventLoopStatistics = registry->registerThread(data);
+    }
+    return data->eventLoopStatistics.get();
+}
+
+static QByteArray eventTypeName(int type)
+{
+    if (const char *name = QMetaEnum::fromType<QEvent::Type>().valueToKey(type))
+        return name;
+    return QByteArray::number(type);
+}
+
+void QEventLoopStatistics::Histogram::add(quint64 value) noexcept
+{
+    const int bucket = value ? 64 - qCountLeadingZeroBits(value) : 0;
+    ++buckets[qMin(bucket, int(BucketCount) - 1)];
+    ++count;
+    total += value;
+    maximum = qMax(maximum, value);
+}
+
+void QEventLoopStatistics::Histogram::merge(const Histogram &other) noexcept
+{
+    for (int i = 0; i < BucketCount; ++i)
+        buckets[i] += other.buckets[i];
+    count += other.count;
+    total += other.total;
+    maximum = qMax(maximum, other.maximum);
+}
+
+quint64 QEventLoopStatistics::Histogram::percentile(double fraction) const noexcept
+{
+    if (!count)
+        return 0;
+    const quint64 wanted = qMax<quint64>(1, quint64(fraction * count + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount - 1; ++i) {
+        seen += buckets[i];
+        if (seen >= wanted)
+            return qMin(quint64(1) << i, maximum);
+    }
+    return maximum;
+}
+
+qint64 QEventLoopStatistics::currentTime() noexcept
+{
+    using namespace std::chrono;
+    // never 0, which stands for "not recorded"
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() | 1;
+}
+
+void QEventLoopStatistics::setEnabled(bool enable)
+{
+    enabled.storeRelaxed(enable);
+}
+
+qint64 QEventLoopStatistics::stallThreshold() noexcept
+{
+    return stallThresholdNs.loadRelaxed() / 1000;
+}
+
+void QEventLoopStatistics::setStallThreshold(qint64 usecs)
+{
+    stallThresholdNs.storeRelaxed(usecs * 1000);
+}
+
+void QEventLoopStatistics::setDumpInterval(int msecs)
+{
+#if QT_CONFIG(thread)
+    if (StatisticsDumper *dumper = statisticsDumper()) {
+        const auto locker = qt_scoped_lock(dumper->controlMutex);
+        dumper->start(msecs);
+    }
+#else
+    Q_UNUSED(msecs);
+#endif
+}
+
+int QEventLoopStatistics::dumpInterval()
+{
+#if QT_CONFIG(thread)
+    if (statisticsDumper.exists()) {
+        StatisticsDumper *dumper = statisticsDumper();
+        const auto locker = qt_scoped_lock(dumper->controlMutex);
+        return dumper->interval;
+    }
+#endif
+    return 0;
+}
+
+QList<QEventLoopStatistics::ThreadStatistics> QEventLoopStatistics::snapshot()
+{
+    QList<ThreadStatistics> result;
+    StatisticsRegistry *registry = statisticsRegistry();
+    if (!registry)
+        return result;
+
+    const auto threads = registry->threadStatistics();
+    result.reserve(qsizetype(threads.size()));
+    for (const auto &statistics : threads) {
+        ThreadStatistics thread;
+        thread.threadId = statistics->threadId;
+        thread.threadName = statistics->threadName;
+        thread.finished = statistics->finished.loadAcquire();
+
+        const auto locker = qt_scoped_lock(statistics->mutex);
+        thread.queueDepth = statistics->queueDepth;
+        thread.stalls = statistics->stalls;
+        thread.events.reserve(statistics->events.size());
+        for (const EventStatistics &event : qAsConst(statistics->events))
+            thread.events.append(event);
+        result.append(std::move(thread));
+    }
+    return result;
+}
+
+QString QEventLoopStatistics::report()
+{
+    constexpr int MaxEventsPerThread = 20;
+    constexpr quint64 NsPerUs = 1000;
+
+    QString text;
+    const QList<ThreadStatistics> threads = snapshot();
+    for (const ThreadStatistics &thread : threads) {
+        text += QStringLiteral("Thread 0x%1").arg(thread.threadId, 0, 16);
+        if (!thread.threadName.isEmpty())
+            text += QLatin1String(" (") + thread.threadName + QLatin1Char(')');
+        if (thread.finished)
+            text += QLatin1String(" [finished]");
+        text += QStringLiteral(": queue depth avg %1, p99 %2, max %3 over %4 passes; %5 stalls\n")
+                .arg(thread.queueDepth.average()).arg(thread.queueDepth.percentile(0.99))
+                .arg(thread.queueDepth.maximum).arg(thread.queueDepth.count).arg(thread.stalls);
+
+        QList<EventStatistics> events = thread.events;
+        std::sort(events.begin(), events.end(), [](const EventStatistics &a, const EventStatistics &b) {
+            return a.handlerDuration.total > b.handlerDuration.total;
+        });
+        for (qsizetype i = 0; i < qMin(events.size(), qsizetype(MaxEventsPerThread)); ++i) {
+            const EventStatistics &event = events.at(i);
+            text += QLatin1String("  ") + QString::fromLatin1(eventTypeName(event.eventType))
+                    + QLatin1String(" -> ") + QString::fromLatin1(event.receiverClass);
+            text += QStringLiteral(": %1 handled, avg %2 us, p99 %3 us, max %4 us")
+                    .arg(event.handlerDuration.count)
+                    .arg(event.handlerDuration.average() / NsPerUs)
+                    .arg(event.handlerDuration.percentile(0.99) / NsPerUs)
+                    .arg(event.handlerDuration.maximum / NsPerUs);
+            if (event.queueWait.count) {
+                text += QStringLiteral("; %1 queued, wait avg %2 us, p99 %3 us, max %4 us")
+                        .arg(event.queueWait.count)
+                        .arg(event.queueWait.average() / NsPerUs)
+                        .arg(event.queueWait.percentile(0.99) / NsPerUs)
+                        .arg(event.queueWait.maximum / NsPerUs);
+            }
+            if (event.stalls)
+                text += QStringLiteral("; %1 stalls").arg(event.stalls);
+            text += QLatin1Char('\n');
+        }
+        if (events.size() > MaxEventsPerThread)
+            text += QStringLiteral("  ... %1 more\n").arg(events.size() - MaxEventsPerThread);
+    }
+    return text;
+}
+
+void QEventLoopStatistics::dump()
+{
+    const QString text = report();
+    if (!text.isEmpty())
+        qCInfo(lcEventLoopStatistics, "%s", qPrintable(text.chopped(1)));
+}
+
+void QEventLoopStatistics::reset()
+{
+    StatisticsRegistry *registry = statisticsRegistry();
+    if (!registry)
+        return;
+    for (const auto &statistics : registry->threadStatistics()) {
+        const auto locker = qt_scoped_lock(statistics->mutex);
+        statistics->events.clear();
+        statistics->queueDepth = Histogram();
+        statistics->stalls = 0;
+    }
+}
+
+void QEventLoopStatistics::recordQueueDepth(QThreadData *data, qsizetype depth)
+{
+    if (QEventLoopStatisticsData *statistics = threadStatistics(data)) {
+        const auto locker = qt_scoped_lock(statistics->mutex);
+        statistics->queueDepth.add(quint64(depth));
+    }
+}
+
+/*
+    Returns the class name the statistics of \a receiver are recorded under.
+    Dynamic metaobjects, like those of QML objects and D-Bus interfaces, are
+    destroyed together with their object, so their class name is copied; the
+    ones generated by moc are static and their name is used in place.
+*/
+QByteArray QEventLoopStatistics::receiverClass(const QObject *receiver)
+{
+    const char *className = receiver->metaObject()->className();
+    if (QObjectPrivate::get(receiver)->metaObject)
+        return QByteArray(className);
+    return QByteArray::fromRawData(className, qstrlen(className));
+}
+
+void QEventLoopStatistics::recordQueueWait(QThreadData *data, const QByteArray &receiverClass,
+                                           int eventType, qint64 postTime)
+{
+    const qint64 now = currentTime();
+    if (QEventLoopStatisticsData *statistics = threadStatistics(data)) {
+        const auto locker = qt_scoped_lock(statistics->mutex);
+        statistics->entry(receiverClass, eventType).queueWait.add(quint64(qMax<qint64>(0, now - postTime)));
+    }
+}
+
+void QEventLoopStatistics::recordHandler(QThreadData *data, const QByteArray &receiverClass,
+                                         int eventType, qint64 startTime)
+{
+    const qint64 duration = qMax<qint64>(0, currentTime() - startTime);
+    QEventLoopStatisticsData *statistics = threadStatistics(data);
+    if (!statistics)
+        return;
+
+    const qint64 threshold = stallThresholdNs.loadRelaxed();
+    const bool stalled = threshold > 0 && duration >= threshold;
+    {
+        const auto locker = qt_scoped_lock(statistics->mutex);
+        EventStatistics &event = statistics->entry(receiverClass, eventType);
+        event.handlerDuration.add(quint64(duration));
+        if (stalled) {
+            ++event.stalls;
+            ++statistics->stalls;
+        }
+    }
+    if (stalled) {
+        qCWarning(lcEventLoopStatistics, "Event loop stalled: handling %s for %s took %lld ms",
+                  eventTypeName(eventType).constData(), receiverClass.constData(),
+                  duration / (1000 * 1000));
+    }
+}
+
+void QEventLoopStatistics::threadFinished(QEventLoopStatisticsData *statistics)
+{
+    statistics->finished.storeRelease(true);
+}
+
+static void initEventLoopStatistics()
+{
+    if (qEnvironmentVariableIntValue("QT_EVENT_LOOP_STATISTICS"))
+        QEventLoopStatistics::setEnabled(true);
+    bool ok = false;
+    const int threshold = qEnvironmentVariableIntValue("QT_EVENT_LOOP_STALL_THRESHOLD", &ok);
+    if (ok)
+        QEventLoopStatistics::setStallThreshold(qint64(threshold) * 1000);
+}
+Q_CONSTRUCTOR_FUNCTION(initEventLoopStatistics)
+
+QT_END_NAMESPACE
@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QEVENTLOOPSTATISTICS_P_H
+#define QEVENTLOOPSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QEvent;
+class QObject;
+class QThreadData;
+struct QEventLoopStatisticsData;
+
+/*
+    Collects, per thread, how deep the posted event queue gets, how long
+    posted events wait in it, and how long their handlers take, broken down
+    by event type and receiver class. Recording is off by default; it is
+    switched on with setEnabled() or by setting QT_EVENT_LOOP_STATISTICS in
+    the environment, and costs a relaxed atomic load per event otherwise.
+
+    Handler durations are measured around QCoreApplication::notifyInternal2(),
+    so they include nested event delivery and hold for sent events as well;
+    queue wait times only exist for events that went through postEvent().
+    Handlers running for longer than stallThreshold() are counted as stalls
+    and reported with a warning in the qt.core.eventloop.statistics category.
+
+    QT_EVENT_LOOP_STALL_THRESHOLD sets the stall threshold in milliseconds,
+    and QT_EVENT_LOOP_STATISTICS_INTERVAL makes report() be logged to that
+    category every so many milliseconds.
+*/
+class Q_CORE_EXPORT QEventLoopStatistics
+{
+public:
+    // Counts samples in buckets of exponentially growing size: bucket 0
+    // holds values below 1, bucket i values in [2^(i-1), 2^i).
+    struct Histogram
+    {
+        enum { BucketCount = 40 };
+
+        quint64 buckets[BucketCount] = {};
+        quint64 count = 0;
+        quint64 total = 0;
+        quint64 maximum = 0;
+
+        void add(quint64 value) noexcept;
+        void merge(const Histogram &other) noexcept;
+        quint64 average() const noexcept { return count ? total / count : 0; }
+        // upper bound of the bucket the given fraction of the samples falls into
+        quint64 percentile(double fraction) const noexcept;
+    };
+
+    struct EventStatistics
+    {
+        int eventType = 0;
+        QByteArray receiverClass;
+        Histogram queueWait;        // nanoseconds between postEvent() and delivery
+        Histogram handlerDuration;  // nanoseconds spent in notify()
+        quint64 stalls = 0;
+    };
+
+    struct ThreadStatistics
+    {
+        quintptr threadId = 0;
+        QString threadName;
+        bool finished = false;
+        Histogram queueDepth;       // pending events each time the queue is processed
+        quint64 stalls = 0;
+        QList<EventStatistics> events;
+    };
+
+    static bool isEnabled() noexcept { return enabled.loadRelaxed(); }
+    static void setEnabled(bool enable);
+
+    static qint64 stallThreshold() noexcept; // in microseconds
+    static void setStallThreshold(qint64 usecs);
+
+    // dumps report() with qCInfo every msecs milliseconds, 0 stops it
+    static void setDumpInterval(int msecs);
+    static int dumpInterval();
+
+    static QList<ThreadStatistics> snapshot();
+    static QString report();
+    static void dump();
+    static void reset();
+
+    // hooks for QCoreApplication and QThreadData
+    static qint64 timestamp() noexcept
+    { return isEnabled() ? currentTime() : 0; }
+    static QByteArray receiverClass(const QObject *receiver);
+    static void recordQueueDepth(QThreadData *data, qsizetype depth);
+    static void recordQueueWait(QThreadData *data, const QByteArray &receiverClass,
+                                int eventType, qint64 postTime);
+    static void recordHandler(QThreadData *data, const QByteArray &receiverClass,
+                              int eventType, qint64 startTime);
+    static void threadFinished(QEventLoopStatisticsData *statistics);
+
+private:
+    static qint64 currentTime() noexcept;
+
+    static QBasicAtomicInt enabled;
+};
+
+Q_DECLARE_TYPEINFO(QEventLoopStatistics::EventStatistics, Q_RELOCATABLE_TYPE);
+Q_DECLARE_TYPEINFO(QEventLoopStatistics::ThreadStatistics, Q_RELOCATABLE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QEVENTLOOPSTATISTICS_P_H
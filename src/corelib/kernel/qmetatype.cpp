@@ -42,6 +42,7 @@
 #include "qobjectdefs.h"
 #include "qdatetime.h"
 #include "qbytearray.h"
+#include "qmutex.h"
 #include "qreadwritelock.h"
 #include "qstring.h"
 #include "qstringlist.h"
@@ -87,9 +88,11 @@
 # include "qline.h"
 #endif
 
+#include <array>
 #include <bitset>
 #include <new>
 #include <cstring>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -106,16 +109,143 @@ struct DefinedTypesFilter {
 
 struct QMetaTypeCustomRegistry
 {
-    QReadWriteLock lock;
-    QList<const QtPrivate::QMetaTypeInterface *> registry;
-    QHash<QByteArray, const QtPrivate::QMetaTypeInterface *> aliases;
+    // Lookups by id and by name don't lock: registration takes the mutex and
+    // publishes new entries with release semantics. Memory reachable by
+    // readers is only freed when the registry itself is destroyed.
+    using Interface = const QtPrivate::QMetaTypeInterface *;
+    using Entry = QAtomicPointer<const QtPrivate::QMetaTypeInterface>;
+
+    // Chunk c holds the FirstChunkSize << c entries following those of chunk
+    // c - 1, so the entries never move once allocated.
+    enum { FirstChunkSize = 16, ChunkCount = 28 };
+    QAtomicPointer<Entry> chunks[ChunkCount] = {};
+
+    struct Alias
+    {
+        QByteArray name;
+        size_t hash;
+        Entry iface;
+    };
+
+    // Open addressing hash table of aliases. It is replaced by a bigger copy
+    // once half full; the old one is kept alive for concurrent readers.
+    struct AliasTable
+    {
+        explicit AliasTable(size_t capacity, AliasTable *previous)
+            : mask(capacity - 1), previous(previous), buckets(new QAtomicPointer<Alias>[capacity])
+        {}
+
+        const size_t mask;
+        AliasTable *const previous;
+        const std::unique_ptr<QAtomicPointer<Alias>[]> buckets;
+    };
+
+    QMutex lock;
+    QAtomicPointer<AliasTable> aliasTable;
+    QList<Alias *> aliases;
+    // number of entries used in the registry
+    int size = 0;
     // index of first empty (unregistered) type in registry, if any.
     int firstEmpty = 0;
 
+    ~QMetaTypeCustomRegistry()
+    {
+        for (auto &chunk : chunks)
+            delete[] chunk.loadRelaxed();
+        qDeleteAll(aliases);
+        AliasTable *table = aliasTable.loadRelaxed();
+        while (table) {
+            AliasTable *previous = table->previous;
+            delete table;
+            table = previous;
+        }
+    }
+
+    static int chunkIndex(int idx, int *offset)
+    {
+        const uint chunk = 31 - qCountLeadingZeroBits(uint(idx) / FirstChunkSize + 1);
+        *offset = idx - FirstChunkSize * ((1 << chunk) - 1);
+        return chunk;
+    }
+
+    // must be called with the lock held
+    Entry &entry(int idx)
+    {
+        int offset;
+        const int chunk = chunkIndex(idx, &offset);
+        Entry *entries = chunks[chunk].loadRelaxed();
+        if (!entries) {
+            entries = new Entry[FirstChunkSize << chunk];
+            chunks[chunk].storeRelease(entries);
+        }
+        return entries[offset];
+    }
+
+    Interface entryAt(int idx) const
+    {
+        if (idx < 0)
+            return nullptr;
+        int offset;
+        const int chunk = chunkIndex(idx, &offset);
+        if (chunk >= ChunkCount)
+            return nullptr;
+        const Entry *entries = chunks[chunk].loadAcquire();
+        return entries ? entries[offset].loadAcquire() : nullptr;
+    }
+
+    Alias *findAlias(QByteArrayView name, size_t hash) const
+    {
+        const AliasTable *table = aliasTable.loadAcquire();
+        if (!table)
+            return nullptr;
+        for (size_t i = hash & table->mask; ; i = (i + 1) & table->mask) {
+            Alias *alias = table->buckets[i].loadAcquire();
+            if (!alias || (alias->hash == hash && alias->name == name))
+                return alias;
+        }
+    }
+
+    Interface alias(QByteArrayView name) const
+    {
+        const Alias *alias = findAlias(name, qHash(name));
+        return alias ? alias->iface.loadAcquire() : nullptr;
+    }
+
+    // must be called with the lock held
+    void insertAlias(const QByteArray &name, Interface ti)
+    {
+        const size_t hash = qHash(QByteArrayView(name));
+        if (Alias *alias = findAlias(name, hash)) {
+            alias->iface.storeRelease(ti);
+            return;
+        }
+
+        AliasTable *table = aliasTable.loadRelaxed();
+        if (!table || size_t(aliases.size() + 1) * 2 > table->mask + 1) {
+            AliasTable *grown = new AliasTable(table ? 2 * (table->mask + 1) : 64, table);
+            for (Alias *alias : qAsConst(aliases))
+                insertAlias(grown, alias);
+            aliasTable.storeRelease(grown);
+            table = grown;
+        }
+
+        Alias *alias = new Alias{name, hash, ti};
+        aliases.append(alias);
+        insertAlias(table, alias);
+    }
+
+    static void insertAlias(AliasTable *table, Alias *alias)
+    {
+        size_t i = alias->hash & table->mask;
+        while (table->buckets[i].loadRelaxed())
+            i = (i + 1) & table->mask;
+        table->buckets[i].storeRelease(alias);
+    }
+
     int registerCustomType(const QtPrivate::QMetaTypeInterface *ti)
     {
         {
-            QWriteLocker l(&lock);
+            QMutexLocker l(&lock);
             if (ti->typeId)
                 return ti->typeId;
             QByteArray name =
@@ -123,22 +253,21 @@ struct QMetaTypeCustomRegistry
                     QMetaObject::normalizedType
 #endif
                     (ti->name);
-            if (auto ti2 = aliases.value(name)) {
+            if (auto ti2 = alias(name)) {
                 ti->typeId.storeRelaxed(ti2->typeId.loadRelaxed());
                 return ti2->typeId;
             }
-            aliases[name] = ti;
-            int size = registry.size();
-            while (firstEmpty < size && registry[firstEmpty])
+            while (firstEmpty < size && entry(firstEmpty).loadRelaxed())
                 ++firstEmpty;
             if (firstEmpty < size) {
-                registry[firstEmpty] = ti;
+                entry(firstEmpty).storeRelease(ti);
                 ++firstEmpty;
             } else {
-                registry.append(ti);
-                firstEmpty = registry.size();
+                entry(size).storeRelease(ti);
+                firstEmpty = ++size;
             }
             ti->typeId = firstEmpty + QMetaType::User;
+            insertAlias(name, ti);
         }
         if (ti->legacyRegisterOp)
             ti->legacyRegisterOp();
@@ -150,28 +279,24 @@ struct QMetaTypeCustomRegistry
         if (!id)
             return;
         Q_ASSERT(id > QMetaType::User);
-        QWriteLocker l(&lock);
+        QMutexLocker l(&lock);
         int idx = id - QMetaType::User - 1;
-        auto &ti = registry[idx];
+        Entry &ti = entry(idx);
 
         // We must unregister all names.
-        auto it = aliases.begin();
-        while (it != aliases.end()) {
-            if (it.value() == ti)
-                it = aliases.erase(it);
-            else
-                ++it;
+        for (Alias *alias : qAsConst(aliases)) {
+            if (alias->iface.loadRelaxed() == ti.loadRelaxed())
+                alias->iface.storeRelease(nullptr);
         }
 
-        ti = nullptr;
+        ti.storeRelease(nullptr);
 
         firstEmpty = std::min(firstEmpty, idx);
     }
 
-    const QtPrivate::QMetaTypeInterface *getCustomType(int id)
+    const QtPrivate::QMetaTypeInterface *getCustomType(int id) const
     {
-        QReadLocker l(&lock);
-        return registry.value(id - QMetaType::User - 1);
+        return entryAt(id - QMetaType::User - 1);
     }
 };
 
@@ -828,49 +953,53 @@ static const struct { const char * typeName; int typeNameLength; int type; } typ
     {nullptr, 0, QMetaType::UnknownType}
 };
 
-static const struct : QMetaTypeModuleHelper
+namespace {
+using Char = char;
+using SChar = signed char;
+using UChar = unsigned char;
+using Short = short;
+using UShort = unsigned short;
+using Int = int;
+using UInt = unsigned int;
+using Long = long;
+using LongLong = qlonglong;
+using ULong = unsigned long;
+using ULongLong = qulonglong;
+using Float = float;
+using Double = double;
+using Bool = bool;
+using Nullptr = std::nullptr_t;
+
+using BuiltinConverterFunction = bool (*)(const void *from, void *to);
+
+// Every conversion between two core types is an explicit specialization of
+// BuiltinConverter; the pairs without one keep the null function below.
+template <int To, int From>
+struct BuiltinConverter
 {
-    template<typename T, typename LiteralWrapper =
-             std::conditional_t<std::is_same_v<T, QString>, QLatin1String, const char *>>
-    static inline bool convertToBool(const T &source)
-    {
-        T str = source.toLower();
-        return !(str.isEmpty() || str == LiteralWrapper("0") || str == LiteralWrapper("false"));
-    }
-
-    const QtPrivate::QMetaTypeInterface *interfaceForType(int type) const override {
-        switch (type) {
-            QT_FOR_EACH_STATIC_PRIMITIVE_TYPE(QT_METATYPE_CONVERT_ID_TO_TYPE)
-            QT_FOR_EACH_STATIC_PRIMITIVE_POINTER(QT_METATYPE_CONVERT_ID_TO_TYPE)
-            QT_FOR_EACH_STATIC_CORE_CLASS(QT_METATYPE_CONVERT_ID_TO_TYPE)
-            QT_FOR_EACH_STATIC_CORE_POINTER(QT_METATYPE_CONVERT_ID_TO_TYPE)
-            QT_FOR_EACH_STATIC_CORE_TEMPLATE(QT_METATYPE_CONVERT_ID_TO_TYPE)
-        default:
-            return nullptr;
-        }
-    }
+    static constexpr BuiltinConverterFunction convert = nullptr;
+};
 
-    bool convert(const void *from, int fromTypeId, void *to, int toTypeId) const override
-    {
-        Q_ASSERT(fromTypeId != toTypeId);
+template<typename T, typename LiteralWrapper =
+         std::conditional_t<std::is_same_v<T, QString>, QLatin1String, const char *>>
+inline bool convertToBool(const T &source)
+{
+    T str = source.toLower();
+    return !(str.isEmpty() || str == LiteralWrapper("0") || str == LiteralWrapper("false"));
+}
 
-        bool onlyCheck = (from == nullptr && to == nullptr);
-
-        using Char = char;
-        using SChar = signed char;
-        using UChar = unsigned char;
-        using Short = short;
-        using UShort = unsigned short;
-        using Int = int;
-        using UInt = unsigned int;
-        using Long = long;
-        using LongLong = qlonglong;
-        using ULong = unsigned long;
-        using ULongLong = qulonglong;
-        using Float = float;
-        using Double = double;
-        using Bool = bool;
-        using Nullptr = std::nullptr_t;
+#undef QMETATYPE_CONVERTER
+#define QMETATYPE_CONVERTER(To, From, assign_and_return) \
+    template <> \
+    struct BuiltinConverter<QMetaType::To, QMetaType::From> \
+    { \
+        static bool convert(const void *from, void *to) \
+        { \
+            const From &source = *static_cast<const From *>(from); \
+            To &result = *static_cast<To *>(to); \
+            assign_and_return \
+        } \
+    }
 
 #define QMETATYPE_CONVERTER_ASSIGN_DOUBLE(To, From) \
     QMETATYPE_CONVERTER(To, From, result = double(source); return true;)
@@ -977,530 +1106,589 @@ static const struct : QMetaTypeModuleHelper
     ); \
     CONVERT_CBOR_AND_JSON(To)
 
-        switch (makePair(toTypeId, fromTypeId)) {
-
-        // integral conversions
-        INTEGRAL_CONVERTER(Bool);
-        INTEGRAL_CONVERTER(Char);
-        INTEGRAL_CONVERTER(UChar);
-        INTEGRAL_CONVERTER(SChar);
-        INTEGRAL_CONVERTER(Short);
-        INTEGRAL_CONVERTER(UShort);
-        INTEGRAL_CONVERTER(Int);
-        INTEGRAL_CONVERTER(UInt);
-        INTEGRAL_CONVERTER(Long);
-        INTEGRAL_CONVERTER(ULong);
-        INTEGRAL_CONVERTER(LongLong);
-        INTEGRAL_CONVERTER(ULongLong);
-        FLOAT_CONVERTER(Float);
-        FLOAT_CONVERTER(Double);
+// integral conversions
+INTEGRAL_CONVERTER(Bool);
+INTEGRAL_CONVERTER(Char);
+INTEGRAL_CONVERTER(UChar);
+INTEGRAL_CONVERTER(SChar);
+INTEGRAL_CONVERTER(Short);
+INTEGRAL_CONVERTER(UShort);
+INTEGRAL_CONVERTER(Int);
+INTEGRAL_CONVERTER(UInt);
+INTEGRAL_CONVERTER(Long);
+INTEGRAL_CONVERTER(ULong);
+INTEGRAL_CONVERTER(LongLong);
+INTEGRAL_CONVERTER(ULongLong);
+FLOAT_CONVERTER(Float);
+FLOAT_CONVERTER(Double);
 
 #ifndef QT_BOOTSTRAPPED
-        QMETATYPE_CONVERTER_ASSIGN(QUrl, QString);
-        QMETATYPE_CONVERTER(QUrl, QCborValue,
-            if (source.isUrl()) {
-                result = source.toUrl();
-                return true;
-             }
-            return false;
-        );
+QMETATYPE_CONVERTER_ASSIGN(QUrl, QString);
+QMETATYPE_CONVERTER(QUrl, QCborValue,
+    if (source.isUrl()) {
+        result = source.toUrl();
+        return true;
+     }
+    return false;
+);
 #endif
 #if QT_CONFIG(itemmodel)
-        QMETATYPE_CONVERTER_ASSIGN(QModelIndex, QPersistentModelIndex);
-        QMETATYPE_CONVERTER_ASSIGN(QPersistentModelIndex, QModelIndex);
+QMETATYPE_CONVERTER_ASSIGN(QModelIndex, QPersistentModelIndex);
+QMETATYPE_CONVERTER_ASSIGN(QPersistentModelIndex, QModelIndex);
 #endif // QT_CONFIG(itemmodel)
 
-        // QChar methods
+// QChar methods
 #define QMETATYPE_CONVERTER_ASSIGN_QCHAR(From) \
-        QMETATYPE_CONVERTER(QChar, From, result = QChar::fromUcs2(source); return true;)
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(Char);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(SChar);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(Short);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(Long);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(Int);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(LongLong);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(Float);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(UChar);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(UShort);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(ULong);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(UInt);
-        QMETATYPE_CONVERTER_ASSIGN_QCHAR(ULongLong);
-
-        // conversions to QString
-        QMETATYPE_CONVERTER_ASSIGN(QString, QChar);
-        QMETATYPE_CONVERTER(QString, Bool,
-            result = source ? QStringLiteral("true") : QStringLiteral("false");
-            return true;
-        );
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Short);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Long);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Int);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, LongLong);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, UShort);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, ULong);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, UInt);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, ULongLong);
-        QMETATYPE_CONVERTER(QString, Float,
-            result = QString::number(source, 'g', QLocale::FloatingPointShortest);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QString, Double,
-            result = QString::number(source, 'g', QLocale::FloatingPointShortest);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QString, Char,
-            result = QString::fromLatin1(&source, 1);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QString, SChar,
-            char s = source;
-            result = QString::fromLatin1(&s, 1);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QString, UChar,
-            char s = source;
-            result = QString::fromLatin1(&s, 1);
-            return true;
-        );
+QMETATYPE_CONVERTER(QChar, From, result = QChar::fromUcs2(source); return true;)
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(Char);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(SChar);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(Short);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(Long);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(Int);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(LongLong);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(Float);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(UChar);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(UShort);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(ULong);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(UInt);
+QMETATYPE_CONVERTER_ASSIGN_QCHAR(ULongLong);
+
+// conversions to QString
+QMETATYPE_CONVERTER_ASSIGN(QString, QChar);
+QMETATYPE_CONVERTER(QString, Bool,
+    result = source ? QStringLiteral("true") : QStringLiteral("false");
+    return true;
+);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Short);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Long);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, Int);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, LongLong);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, UShort);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, ULong);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, UInt);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QString, ULongLong);
+QMETATYPE_CONVERTER(QString, Float,
+    result = QString::number(source, 'g', QLocale::FloatingPointShortest);
+    return true;
+);
+QMETATYPE_CONVERTER(QString, Double,
+    result = QString::number(source, 'g', QLocale::FloatingPointShortest);
+    return true;
+);
+QMETATYPE_CONVERTER(QString, Char,
+    result = QString::fromLatin1(&source, 1);
+    return true;
+);
+QMETATYPE_CONVERTER(QString, SChar,
+    char s = source;
+    result = QString::fromLatin1(&s, 1);
+    return true;
+);
+QMETATYPE_CONVERTER(QString, UChar,
+    char s = source;
+    result = QString::fromLatin1(&s, 1);
+    return true;
+);
 #if QT_CONFIG(datestring)
-        QMETATYPE_CONVERTER(QString, QDate, result = source.toString(Qt::ISODate); return true;);
-        QMETATYPE_CONVERTER(QString, QTime, result = source.toString(Qt::ISODateWithMs); return true;);
-        QMETATYPE_CONVERTER(QString, QDateTime, result = source.toString(Qt::ISODateWithMs); return true;);
+QMETATYPE_CONVERTER(QString, QDate, result = source.toString(Qt::ISODate); return true;);
+QMETATYPE_CONVERTER(QString, QTime, result = source.toString(Qt::ISODateWithMs); return true;);
+QMETATYPE_CONVERTER(QString, QDateTime, result = source.toString(Qt::ISODateWithMs); return true;);
 #endif
-        QMETATYPE_CONVERTER(QString, QByteArray, result = QString::fromUtf8(source); return true;);
-        QMETATYPE_CONVERTER(QString, QStringList,
-            return (source.count() == 1) ? (result = source.at(0), true) : false;
-        );
+QMETATYPE_CONVERTER(QString, QByteArray, result = QString::fromUtf8(source); return true;);
+QMETATYPE_CONVERTER(QString, QStringList,
+    return (source.count() == 1) ? (result = source.at(0), true) : false;
+);
 #ifndef QT_BOOTSTRAPPED
-        QMETATYPE_CONVERTER(QString, QUrl, result = source.toString(); return true;);
-        QMETATYPE_CONVERTER(QString, QJsonValue,
-            if (source.isString() || source.isNull()) {
-                result = source.toString();
-                return true;
-            }
-            return false;
-        );
+QMETATYPE_CONVERTER(QString, QUrl, result = source.toString(); return true;);
+QMETATYPE_CONVERTER(QString, QJsonValue,
+    if (source.isString() || source.isNull()) {
+        result = source.toString();
+        return true;
+    }
+    return false;
+);
 #endif
-        QMETATYPE_CONVERTER(QString, Nullptr, Q_UNUSED(source); result = QString(); return true;);
+QMETATYPE_CONVERTER(QString, Nullptr, Q_UNUSED(source); result = QString(); return true;);
 
-        // QByteArray
-        QMETATYPE_CONVERTER(QByteArray, QString, result = source.toUtf8(); return true;);
-        QMETATYPE_CONVERTER(QByteArray, Bool,
-            result = source ? "true" : "false";
-            return true;
-        );
-        QMETATYPE_CONVERTER(QByteArray, Char, result = QByteArray(source, 1); return true;);
-        QMETATYPE_CONVERTER(QByteArray, SChar, result = QByteArray(source, 1); return true;);
-        QMETATYPE_CONVERTER(QByteArray, UChar, result = QByteArray(source, 1); return true;);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Short);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Long);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Int);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, LongLong);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, UShort);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, ULong);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, UInt);
-        QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, ULongLong);
-        QMETATYPE_CONVERTER(QByteArray, Float,
-            result = QByteArray::number(source, 'g', QLocale::FloatingPointShortest);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QByteArray, Double,
-            result = QByteArray::number(source, 'g', QLocale::FloatingPointShortest);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QByteArray, Nullptr, Q_UNUSED(source); result = QByteArray(); return true;);
+// QByteArray
+QMETATYPE_CONVERTER(QByteArray, QString, result = source.toUtf8(); return true;);
+QMETATYPE_CONVERTER(QByteArray, Bool,
+    result = source ? "true" : "false";
+    return true;
+);
+QMETATYPE_CONVERTER(QByteArray, Char, result = QByteArray(source, 1); return true;);
+QMETATYPE_CONVERTER(QByteArray, SChar, result = QByteArray(source, 1); return true;);
+QMETATYPE_CONVERTER(QByteArray, UChar, result = QByteArray(source, 1); return true;);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Short);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Long);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, Int);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, LongLong);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, UShort);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, ULong);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, UInt);
+QMETATYPE_CONVERTER_ASSIGN_NUMBER(QByteArray, ULongLong);
+QMETATYPE_CONVERTER(QByteArray, Float,
+    result = QByteArray::number(source, 'g', QLocale::FloatingPointShortest);
+    return true;
+);
+QMETATYPE_CONVERTER(QByteArray, Double,
+    result = QByteArray::number(source, 'g', QLocale::FloatingPointShortest);
+    return true;
+);
+QMETATYPE_CONVERTER(QByteArray, Nullptr, Q_UNUSED(source); result = QByteArray(); return true;);
 
-        QMETATYPE_CONVERTER(QString, QUuid, result = source.toString(); return true;);
-        QMETATYPE_CONVERTER(QUuid, QString, result = QUuid(source); return true;);
-        QMETATYPE_CONVERTER(QByteArray, QUuid, result = source.toByteArray(); return true;);
-        QMETATYPE_CONVERTER(QUuid, QByteArray, result = QUuid(source); return true;);
+QMETATYPE_CONVERTER(QString, QUuid, result = source.toString(); return true;);
+QMETATYPE_CONVERTER(QUuid, QString, result = QUuid(source); return true;);
+QMETATYPE_CONVERTER(QByteArray, QUuid, result = source.toByteArray(); return true;);
+QMETATYPE_CONVERTER(QUuid, QByteArray, result = QUuid(source); return true;);
 
 #ifndef QT_NO_GEOM_VARIANT
-        QMETATYPE_CONVERTER(QSize, QSizeF, result = source.toSize(); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QSizeF, QSize);
-        QMETATYPE_CONVERTER(QLine, QLineF, result = source.toLine(); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QLineF, QLine);
-        QMETATYPE_CONVERTER(QRect, QRectF, result = source.toRect(); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QRectF, QRect);
-        QMETATYPE_CONVERTER(QPoint, QPointF, result = source.toPoint(); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QPointF, QPoint);
- #endif
-
-        QMETATYPE_CONVERTER(QByteArrayList, QVariantList,
-            result.reserve(source.size());
-            for (auto v: source)
-                result.append(v.toByteArray());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantList, QByteArrayList,
-            result.reserve(source.size());
-            for (auto v: source)
-                result.append(QVariant(v));
-            return true;
-        );
+QMETATYPE_CONVERTER(QSize, QSizeF, result = source.toSize(); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QSizeF, QSize);
+QMETATYPE_CONVERTER(QLine, QLineF, result = source.toLine(); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QLineF, QLine);
+QMETATYPE_CONVERTER(QRect, QRectF, result = source.toRect(); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QRectF, QRect);
+QMETATYPE_CONVERTER(QPoint, QPointF, result = source.toPoint(); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QPointF, QPoint);
+#endif
 
-        QMETATYPE_CONVERTER(QStringList, QVariantList,
-            result.reserve(source.size());
-            for (auto v: source)
-                result.append(v.toString());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantList, QStringList,
-            result.reserve(source.size());
-            for (auto v: source)
-                result.append(QVariant(v));
-            return true;
-        );
-        QMETATYPE_CONVERTER(QStringList, QString, result = QStringList() << source; return true;);
+QMETATYPE_CONVERTER(QByteArrayList, QVariantList,
+    result.reserve(source.size());
+    for (auto v: source)
+        result.append(v.toByteArray());
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantList, QByteArrayList,
+    result.reserve(source.size());
+    for (auto v: source)
+        result.append(QVariant(v));
+    return true;
+);
 
-        QMETATYPE_CONVERTER(QVariantHash, QVariantMap,
-            for (auto it = source.begin(); it != source.end(); ++it)
-                result.insert(it.key(), it.value());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantMap, QVariantHash,
-            for (auto it = source.begin(); it != source.end(); ++it)
-                result.insert(it.key(), it.value());
-            return true;
-        );
+QMETATYPE_CONVERTER(QStringList, QVariantList,
+    result.reserve(source.size());
+    for (auto v: source)
+        result.append(v.toString());
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantList, QStringList,
+    result.reserve(source.size());
+    for (auto v: source)
+        result.append(QVariant(v));
+    return true;
+);
+QMETATYPE_CONVERTER(QStringList, QString, result = QStringList() << source; return true;);
+
+QMETATYPE_CONVERTER(QVariantHash, QVariantMap,
+    for (auto it = source.begin(); it != source.end(); ++it)
+        result.insert(it.key(), it.value());
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantMap, QVariantHash,
+    for (auto it = source.begin(); it != source.end(); ++it)
+        result.insert(it.key(), it.value());
+    return true;
+);
 
 #ifndef QT_BOOTSTRAPPED
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QString);
-        QMETATYPE_CONVERTER(QString, QCborValue,
-            if (source.isContainer() || source.isTag())
-                 return false;
-            result = source.toVariant().toString();
-            return true;
-        );
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QByteArray);
-        QMETATYPE_CONVERTER(QByteArray, QCborValue,
-            if (source.isByteArray()) {
-                result = source.toByteArray();
-                return true;
-            }
-            return false;
-        );
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QUuid);
-        QMETATYPE_CONVERTER(QUuid, QCborValue,
-            if (!source.isUuid())
-                return false;
-            result = source.toUuid();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QVariantList, result = QCborArray::fromVariantList(source); return true;);
-        QMETATYPE_CONVERTER(QVariantList, QCborValue,
-            if (!source.isArray())
-                return false;
-            result = source.toArray().toVariantList();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QVariantMap, result = QCborMap::fromVariantMap(source); return true;);
-        QMETATYPE_CONVERTER(QVariantMap, QCborValue,
-            if (!source.isMap())
-                return false;
-                result = source.toMap().toVariantMap();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QVariantHash, result = QCborMap::fromVariantHash(source); return true;);
-        QMETATYPE_CONVERTER(QVariantHash, QCborValue,
-            if (!source.isMap())
-                return false;
-            result = source.toMap().toVariantHash();
-            return true;
-        );
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QString);
+QMETATYPE_CONVERTER(QString, QCborValue,
+    if (source.isContainer() || source.isTag())
+         return false;
+    result = source.toVariant().toString();
+    return true;
+);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QByteArray);
+QMETATYPE_CONVERTER(QByteArray, QCborValue,
+    if (source.isByteArray()) {
+        result = source.toByteArray();
+        return true;
+    }
+    return false;
+);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QUuid);
+QMETATYPE_CONVERTER(QUuid, QCborValue,
+    if (!source.isUuid())
+        return false;
+    result = source.toUuid();
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QVariantList, result = QCborArray::fromVariantList(source); return true;);
+QMETATYPE_CONVERTER(QVariantList, QCborValue,
+    if (!source.isArray())
+        return false;
+    result = source.toArray().toVariantList();
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QVariantMap, result = QCborMap::fromVariantMap(source); return true;);
+QMETATYPE_CONVERTER(QVariantMap, QCborValue,
+    if (!source.isMap())
+        return false;
+        result = source.toMap().toVariantMap();
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QVariantHash, result = QCborMap::fromVariantHash(source); return true;);
+QMETATYPE_CONVERTER(QVariantHash, QCborValue,
+    if (!source.isMap())
+        return false;
+    result = source.toMap().toVariantHash();
+    return true;
+);
 #if QT_CONFIG(regularexpression)
-        QMETATYPE_CONVERTER(QCborValue, QRegularExpression, result = QCborValue(source); return true;);
-        QMETATYPE_CONVERTER(QRegularExpression, QCborValue,
-            if (!source.isRegularExpression())
-                return false;
-            result = source.toRegularExpression();
-            return true;
-        );
+QMETATYPE_CONVERTER(QCborValue, QRegularExpression, result = QCborValue(source); return true;);
+QMETATYPE_CONVERTER(QRegularExpression, QCborValue,
+    if (!source.isRegularExpression())
+        return false;
+    result = source.toRegularExpression();
+    return true;
+);
 #endif
 
-        QMETATYPE_CONVERTER(QCborValue, Nullptr,
-            Q_UNUSED(source);
-            result = QCborValue(QCborValue::Null);
-            return true;
-        );
-        QMETATYPE_CONVERTER(Nullptr, QCborValue,
-            result = nullptr;
-            return source.isNull();
-        );
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Bool);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Int);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, UInt);
-        QMETATYPE_CONVERTER(QCborValue, ULong, result = qlonglong(source); return true;);
-        QMETATYPE_CONVERTER(QCborValue, Long, result = qlonglong(source); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, LongLong);
-        QMETATYPE_CONVERTER(QCborValue, ULongLong, result = qlonglong(source); return true;);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, UShort);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, UChar);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Char);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, SChar);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Short);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Double);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, Float);
-        QMETATYPE_CONVERTER(QCborValue, QStringList,
-            result = QCborArray::fromStringList(source);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QDate,
-            result = QCborValue(source.startOfDay());
-            return true;
-        );
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QUrl);
-        QMETATYPE_CONVERTER(QCborValue, QJsonValue,
-            result = QCborValue::fromJsonValue(source);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QJsonObject,
-            result = QCborMap::fromJsonObject(source);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QJsonArray,
-            result = QCborArray::fromJsonArray(source);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborValue, QJsonDocument,
-            QJsonDocument doc = source;
-            if (doc.isArray())
-                result = QCborArray::fromJsonArray(doc.array());
-            else
-                result = QCborMap::fromJsonObject(doc.object());
-            return true;
-        );
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborMap);
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborArray);
-
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QDateTime);
-        QMETATYPE_CONVERTER(QDateTime, QCborValue,
-            if (source.isDateTime()) {
-                result = source.toDateTime();
-                return true;
-            }
-            return false;
-        );
-
-        QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborSimpleType);
-        QMETATYPE_CONVERTER(QCborSimpleType, QCborValue,
-            if (source.isSimpleType()) {
-                 result = source.toSimpleType();
-                 return true;
-             }
-             return false;
-        );
-
-        QMETATYPE_CONVERTER(QCborArray, QVariantList, result = QCborArray::fromVariantList(source); return true;);
-        QMETATYPE_CONVERTER(QVariantList, QCborArray, result = source.toVariantList(); return true;);
-        QMETATYPE_CONVERTER(QCborArray, QStringList, result = QCborArray::fromStringList(source); return true;);
-        QMETATYPE_CONVERTER(QCborMap, QVariantMap, result = QCborMap::fromVariantMap(source); return true;);
-        QMETATYPE_CONVERTER(QVariantMap, QCborMap, result = source.toVariantMap(); return true;);
-        QMETATYPE_CONVERTER(QCborMap, QVariantHash, result = QCborMap::fromVariantHash(source); return true;);
-        QMETATYPE_CONVERTER(QVariantHash, QCborMap, result = source.toVariantHash(); return true;);
-
-        QMETATYPE_CONVERTER(QCborArray, QCborValue,
-            if (!source.isArray())
-                return false;
-            result = source.toArray();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborArray, QJsonDocument,
-            if (!source.isArray())
-                return false;
-            result = QCborArray::fromJsonArray(source.array());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborArray, QJsonValue,
-            if (!source.isArray())
-                return false;
-            result = QCborArray::fromJsonArray(source.toArray());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborArray, QJsonArray,
-            result = QCborArray::fromJsonArray(source);
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborMap, QCborValue,
-            if (!source.isMap())
-                return false;
-            result = source.toMap();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborMap, QJsonDocument,
-            if (source.isArray())
-                return false;
-            result = QCborMap::fromJsonObject(source.object());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborMap, QJsonValue,
-            if (!source.isObject())
-                return false;
-            result = QCborMap::fromJsonObject(source.toObject());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QCborMap, QJsonObject,
-            result = QCborMap::fromJsonObject(source);
-            return true;
-        );
+QMETATYPE_CONVERTER(QCborValue, Nullptr,
+    Q_UNUSED(source);
+    result = QCborValue(QCborValue::Null);
+    return true;
+);
+QMETATYPE_CONVERTER(Nullptr, QCborValue,
+    result = nullptr;
+    return source.isNull();
+);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Bool);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Int);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, UInt);
+QMETATYPE_CONVERTER(QCborValue, ULong, result = qlonglong(source); return true;);
+QMETATYPE_CONVERTER(QCborValue, Long, result = qlonglong(source); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, LongLong);
+QMETATYPE_CONVERTER(QCborValue, ULongLong, result = qlonglong(source); return true;);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, UShort);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, UChar);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Char);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, SChar);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Short);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Double);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, Float);
+QMETATYPE_CONVERTER(QCborValue, QStringList,
+    result = QCborArray::fromStringList(source);
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QDate,
+    result = QCborValue(source.startOfDay());
+    return true;
+);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QUrl);
+QMETATYPE_CONVERTER(QCborValue, QJsonValue,
+    result = QCborValue::fromJsonValue(source);
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QJsonObject,
+    result = QCborMap::fromJsonObject(source);
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QJsonArray,
+    result = QCborArray::fromJsonArray(source);
+    return true;
+);
+QMETATYPE_CONVERTER(QCborValue, QJsonDocument,
+    QJsonDocument doc = source;
+    if (doc.isArray())
+        result = QCborArray::fromJsonArray(doc.array());
+    else
+        result = QCborMap::fromJsonObject(doc.object());
+    return true;
+);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborMap);
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborArray);
+
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QDateTime);
+QMETATYPE_CONVERTER(QDateTime, QCborValue,
+    if (source.isDateTime()) {
+        result = source.toDateTime();
+        return true;
+    }
+    return false;
+);
+
+QMETATYPE_CONVERTER_ASSIGN(QCborValue, QCborSimpleType);
+QMETATYPE_CONVERTER(QCborSimpleType, QCborValue,
+    if (source.isSimpleType()) {
+         result = source.toSimpleType();
+         return true;
+     }
+     return false;
+);
+
+QMETATYPE_CONVERTER(QCborArray, QVariantList, result = QCborArray::fromVariantList(source); return true;);
+QMETATYPE_CONVERTER(QVariantList, QCborArray, result = source.toVariantList(); return true;);
+QMETATYPE_CONVERTER(QCborArray, QStringList, result = QCborArray::fromStringList(source); return true;);
+QMETATYPE_CONVERTER(QCborMap, QVariantMap, result = QCborMap::fromVariantMap(source); return true;);
+QMETATYPE_CONVERTER(QVariantMap, QCborMap, result = source.toVariantMap(); return true;);
+QMETATYPE_CONVERTER(QCborMap, QVariantHash, result = QCborMap::fromVariantHash(source); return true;);
+QMETATYPE_CONVERTER(QVariantHash, QCborMap, result = source.toVariantHash(); return true;);
+
+QMETATYPE_CONVERTER(QCborArray, QCborValue,
+    if (!source.isArray())
+        return false;
+    result = source.toArray();
+    return true;
+);
+QMETATYPE_CONVERTER(QCborArray, QJsonDocument,
+    if (!source.isArray())
+        return false;
+    result = QCborArray::fromJsonArray(source.array());
+    return true;
+);
+QMETATYPE_CONVERTER(QCborArray, QJsonValue,
+    if (!source.isArray())
+        return false;
+    result = QCborArray::fromJsonArray(source.toArray());
+    return true;
+);
+QMETATYPE_CONVERTER(QCborArray, QJsonArray,
+    result = QCborArray::fromJsonArray(source);
+    return true;
+);
+QMETATYPE_CONVERTER(QCborMap, QCborValue,
+    if (!source.isMap())
+        return false;
+    result = source.toMap();
+    return true;
+);
+QMETATYPE_CONVERTER(QCborMap, QJsonDocument,
+    if (source.isArray())
+        return false;
+    result = QCborMap::fromJsonObject(source.object());
+    return true;
+);
+QMETATYPE_CONVERTER(QCborMap, QJsonValue,
+    if (!source.isObject())
+        return false;
+    result = QCborMap::fromJsonObject(source.toObject());
+    return true;
+);
+QMETATYPE_CONVERTER(QCborMap, QJsonObject,
+    result = QCborMap::fromJsonObject(source);
+    return true;
+);
 
 
-        QMETATYPE_CONVERTER(QVariantList, QJsonValue,
-            if (!source.isArray())
-                return false;
-            result = source.toArray().toVariantList();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantList, QJsonArray, result = source.toVariantList(); return true;);
-        QMETATYPE_CONVERTER(QVariantMap, QJsonValue,
-            if (!source.isObject())
-                return false;
-            result = source.toObject().toVariantMap();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantMap, QJsonObject, result = source.toVariantMap(); return true;);
-        QMETATYPE_CONVERTER(QVariantHash, QJsonValue,
-            if (!source.isObject())
-                return false;
-            result = source.toObject().toVariantHash();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QVariantHash, QJsonObject, result = source.toVariantHash(); return true;);
+QMETATYPE_CONVERTER(QVariantList, QJsonValue,
+    if (!source.isArray())
+        return false;
+    result = source.toArray().toVariantList();
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantList, QJsonArray, result = source.toVariantList(); return true;);
+QMETATYPE_CONVERTER(QVariantMap, QJsonValue,
+    if (!source.isObject())
+        return false;
+    result = source.toObject().toVariantMap();
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantMap, QJsonObject, result = source.toVariantMap(); return true;);
+QMETATYPE_CONVERTER(QVariantHash, QJsonValue,
+    if (!source.isObject())
+        return false;
+    result = source.toObject().toVariantHash();
+    return true;
+);
+QMETATYPE_CONVERTER(QVariantHash, QJsonObject, result = source.toVariantHash(); return true;);
 
 
-        QMETATYPE_CONVERTER(QJsonArray, QStringList, result = QJsonArray::fromStringList(source); return true;);
-        QMETATYPE_CONVERTER(QJsonArray, QVariantList, result = QJsonArray::fromVariantList(source); return true;);
-        QMETATYPE_CONVERTER(QJsonArray, QJsonValue,
-            if (!source.isArray())
-                return false;
-            result = source.toArray();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonArray, QJsonDocument,
-            if (!source.isArray())
-                return false;
-            result = source.array();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonArray, QCborValue,
-            if (!source.isArray())
-                return false;
-            result = source.toArray().toJsonArray();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonArray, QCborArray, result = source.toJsonArray(); return true;);
-        QMETATYPE_CONVERTER(QJsonObject, QVariantMap, result = QJsonObject::fromVariantMap(source); return true;);
-        QMETATYPE_CONVERTER(QJsonObject, QVariantHash, result = QJsonObject::fromVariantHash(source); return true;);
-        QMETATYPE_CONVERTER(QJsonObject, QJsonValue,
-            if (!source.isObject())
-                return false;
-            result = source.toObject();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonObject, QJsonDocument,
-            if (source.isArray())
-                return false;
-            result = source.object();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonObject, QCborValue,
-            if (!source.isMap())
-                return false;
-            result = source.toMap().toJsonObject();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonObject, QCborMap, result = source.toJsonObject(); return true; );
+QMETATYPE_CONVERTER(QJsonArray, QStringList, result = QJsonArray::fromStringList(source); return true;);
+QMETATYPE_CONVERTER(QJsonArray, QVariantList, result = QJsonArray::fromVariantList(source); return true;);
+QMETATYPE_CONVERTER(QJsonArray, QJsonValue,
+    if (!source.isArray())
+        return false;
+    result = source.toArray();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonArray, QJsonDocument,
+    if (!source.isArray())
+        return false;
+    result = source.array();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonArray, QCborValue,
+    if (!source.isArray())
+        return false;
+    result = source.toArray().toJsonArray();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonArray, QCborArray, result = source.toJsonArray(); return true;);
+QMETATYPE_CONVERTER(QJsonObject, QVariantMap, result = QJsonObject::fromVariantMap(source); return true;);
+QMETATYPE_CONVERTER(QJsonObject, QVariantHash, result = QJsonObject::fromVariantHash(source); return true;);
+QMETATYPE_CONVERTER(QJsonObject, QJsonValue,
+    if (!source.isObject())
+        return false;
+    result = source.toObject();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonObject, QJsonDocument,
+    if (source.isArray())
+        return false;
+    result = source.object();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonObject, QCborValue,
+    if (!source.isMap())
+        return false;
+    result = source.toMap().toJsonObject();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonObject, QCborMap, result = source.toJsonObject(); return true; );
 
-        QMETATYPE_CONVERTER(QJsonValue, Nullptr,
-            Q_UNUSED(source);
-            result = QJsonValue(QJsonValue::Null);
-            return true;
-        );
-        QMETATYPE_CONVERTER(Nullptr, QJsonValue,
-            result = nullptr;
-            return source.isNull();
-        );
-        QMETATYPE_CONVERTER(QJsonValue, Bool,
-            result = QJsonValue(source);
-            return true;);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Int);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UInt);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Double);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Float);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, ULong);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Long);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, LongLong);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, ULongLong);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UShort);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UChar);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Char);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, SChar);
-        QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Short);
-        QMETATYPE_CONVERTER_ASSIGN(QJsonValue, QString);
-        QMETATYPE_CONVERTER(QJsonValue, QStringList,
-            result = QJsonValue(QJsonArray::fromStringList(source));
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QVariantList,
-            result = QJsonValue(QJsonArray::fromVariantList(source));
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QVariantMap,
-            result = QJsonValue(QJsonObject::fromVariantMap(source));
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QVariantHash,
-            result = QJsonValue(QJsonObject::fromVariantHash(source));
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QJsonObject,
-            result = source;
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QJsonArray,
-            result = source;
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QJsonDocument,
-            QJsonDocument doc = source;
-            result = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QCborValue,
-            result = source.toJsonValue();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QCborMap,
-            result = source.toJsonObject();
-            return true;
-        );
-        QMETATYPE_CONVERTER(QJsonValue, QCborArray,
-            result = source.toJsonArray();
-            return true;
-        );
+QMETATYPE_CONVERTER(QJsonValue, Nullptr,
+    Q_UNUSED(source);
+    result = QJsonValue(QJsonValue::Null);
+    return true;
+);
+QMETATYPE_CONVERTER(Nullptr, QJsonValue,
+    result = nullptr;
+    return source.isNull();
+);
+QMETATYPE_CONVERTER(QJsonValue, Bool,
+    result = QJsonValue(source);
+    return true;);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Int);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UInt);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Double);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Float);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, ULong);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Long);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, LongLong);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, ULongLong);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UShort);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, UChar);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Char);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, SChar);
+QMETATYPE_CONVERTER_ASSIGN_DOUBLE(QJsonValue, Short);
+QMETATYPE_CONVERTER_ASSIGN(QJsonValue, QString);
+QMETATYPE_CONVERTER(QJsonValue, QStringList,
+    result = QJsonValue(QJsonArray::fromStringList(source));
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QVariantList,
+    result = QJsonValue(QJsonArray::fromVariantList(source));
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QVariantMap,
+    result = QJsonValue(QJsonObject::fromVariantMap(source));
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QVariantHash,
+    result = QJsonValue(QJsonObject::fromVariantHash(source));
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QJsonObject,
+    result = source;
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QJsonArray,
+    result = source;
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QJsonDocument,
+    QJsonDocument doc = source;
+    result = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QCborValue,
+    result = source.toJsonValue();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QCborMap,
+    result = source.toJsonObject();
+    return true;
+);
+QMETATYPE_CONVERTER(QJsonValue, QCborArray,
+    result = source.toJsonArray();
+    return true;
+);
 
 #endif
 
-        QMETATYPE_CONVERTER(QDate, QDateTime, result = source.date(); return true;);
-        QMETATYPE_CONVERTER(QTime, QDateTime, result = source.time(); return true;);
-        QMETATYPE_CONVERTER(QDateTime, QDate, result = source.startOfDay(); return true;);
+QMETATYPE_CONVERTER(QDate, QDateTime, result = source.date(); return true;);
+QMETATYPE_CONVERTER(QTime, QDateTime, result = source.time(); return true;);
+QMETATYPE_CONVERTER(QDateTime, QDate, result = source.startOfDay(); return true;);
 #if QT_CONFIG(datestring)
-        QMETATYPE_CONVERTER(QDate, QString,
-            result = QDate::fromString(source, Qt::ISODate);
-            return result.isValid();
-        );
-        QMETATYPE_CONVERTER(QTime, QString,
-            result = QTime::fromString(source, Qt::ISODate);
-            return result.isValid();
-        );
-        QMETATYPE_CONVERTER(QDateTime, QString,
-            result = QDateTime::fromString(source, Qt::ISODate);
-            return result.isValid();
-        );
+QMETATYPE_CONVERTER(QDate, QString,
+    result = QDate::fromString(source, Qt::ISODate);
+    return result.isValid();
+);
+QMETATYPE_CONVERTER(QTime, QString,
+    result = QTime::fromString(source, Qt::ISODate);
+    return result.isValid();
+);
+QMETATYPE_CONVERTER(QDateTime, QString,
+    result = QDateTime::fromString(source, Qt::ISODate);
+    return result.isValid();
+);
 #endif
 
+#undef QMETATYPE_CONVERTER
+#undef QMETATYPE_CONVERTER_ASSIGN_DOUBLE
+#undef QMETATYPE_CONVERTER_ASSIGN_NUMBER
+#undef QMETATYPE_CONVERTER_ASSIGN_QCHAR
+#undef CONVERT_CBOR_AND_JSON
+#undef INTEGRAL_CONVERTER
+#undef FLOAT_CONVERTER
+
+// The conversion matrix is laid out as builtinConverters[toTypeId][fromTypeId] and
+// is generated entirely at compile time.
+constexpr int BuiltinConverterTableSize = QMetaType::LastCoreType + 1;
+using BuiltinConverterRow = std::array<BuiltinConverterFunction, BuiltinConverterTableSize>;
+
+template <int To, int... From>
+constexpr BuiltinConverterRow builtinConverterRow(std::integer_sequence<int, From...>)
+{
+    return {{ BuiltinConverter<To, From>::convert... }};
+}
+
+template <int... To>
+constexpr std::array<BuiltinConverterRow, BuiltinConverterTableSize>
+builtinConverterTable(std::integer_sequence<int, To...>)
+{
+    return {{ builtinConverterRow<To>(std::make_integer_sequence<int, BuiltinConverterTableSize>())... }};
+}
+
+constexpr auto builtinConverters =
+        builtinConverterTable(std::make_integer_sequence<int, BuiltinConverterTableSize>());
+
+inline BuiltinConverterFunction builtinConverter(int fromTypeId, int toTypeId)
+{
+    if (uint(fromTypeId) >= uint(BuiltinConverterTableSize)
+            || uint(toTypeId) >= uint(BuiltinConverterTableSize)) {
+        return nullptr;
+    }
+    return builtinConverters[toTypeId][fromTypeId];
+}
+} // unnamed namespace
+
+static const struct : QMetaTypeModuleHelper
+{
+    const QtPrivate::QMetaTypeInterface *interfaceForType(int type) const override {
+        switch (type) {
+            QT_FOR_EACH_STATIC_PRIMITIVE_TYPE(QT_METATYPE_CONVERT_ID_TO_TYPE)
+            QT_FOR_EACH_STATIC_PRIMITIVE_POINTER(QT_METATYPE_CONVERT_ID_TO_TYPE)
+            QT_FOR_EACH_STATIC_CORE_CLASS(QT_METATYPE_CONVERT_ID_TO_TYPE)
+            QT_FOR_EACH_STATIC_CORE_POINTER(QT_METATYPE_CONVERT_ID_TO_TYPE)
+            QT_FOR_EACH_STATIC_CORE_TEMPLATE(QT_METATYPE_CONVERT_ID_TO_TYPE)
+        default:
+            return nullptr;
         }
-        return false;
+    }
+
+    bool convert(const void *from, int fromTypeId, void *to, int toTypeId) const override
+    {
+        Q_ASSERT(fromTypeId != toTypeId);
+
+        const BuiltinConverterFunction converter = builtinConverter(fromTypeId, toTypeId);
+        if (!converter)
+            return false;
+        if (from == nullptr && to == nullptr)   // only check
+            return true;
+        return converter(from, to);
     }
 } metatypeHelper;
 
@@ -2163,7 +2351,13 @@ bool QMetaType::convert(QMetaType fromType, const void *from, QMetaType toType,
     int fromTypeId = fromType.id();
     int toTypeId = toType.id();
 
-    if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
+    if (fromTypeId <= LastCoreType && toTypeId <= LastCoreType) {
+        // no need to go through the module helper for the core types
+        if (const BuiltinConverterFunction converter = builtinConverter(fromTypeId, toTypeId)) {
+            if (converter(from, to))
+                return true;
+        }
+    } else if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
         if (moduleHelper->convert(from, fromTypeId, to, toTypeId))
             return true;
     }
@@ -2367,7 +2561,10 @@ bool QMetaType::canConvert(QMetaType fromType, QMetaType toType)
     if (fromTypeId == toTypeId)
         return true;
 
-    if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
+    if (fromTypeId <= LastCoreType && toTypeId <= LastCoreType) {
+        if (builtinConverter(fromTypeId, toTypeId))
+            return true;
+    } else if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
         if (moduleHelper->convert(nullptr, fromTypeId, nullptr, toTypeId))
             return true;
     }
@@ -2498,18 +2695,13 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
 
 /*
     Similar to QMetaType::type(), but only looks in the custom set of
-    types, and doesn't lock the mutex.
-
+    types. Doesn't lock, see QMetaTypeCustomRegistry.
 */
 static int qMetaTypeCustomType_unlocked(const char *typeName, int length)
 {
     if (auto reg = customTypeRegistry()) {
-#if QT_CONFIG(thread)
-        Q_ASSERT(!reg->lock.tryLockForWrite());
-#endif
-        if (auto ti = reg->aliases.value(QByteArray(typeName, length), nullptr)) {
+        if (auto ti = reg->alias(QByteArrayView(typeName, length)))
             return ti->typeId;
-        }
     }
     return QMetaType::UnknownType;
 }
@@ -2527,11 +2719,10 @@ void QMetaType::registerNormalizedTypedef(const NS(QByteArray) & normalizedTypeN
     if (!metaType.isValid())
         return;
     if (auto reg = customTypeRegistry()) {
-        QWriteLocker lock(&reg->lock);
-        auto &al = reg->aliases[normalizedTypeName];
-        if (al)
+        QMutexLocker lock(&reg->lock);
+        if (reg->alias(normalizedTypeName))
             return;
-        al = metaType.d_ptr;
+        reg->insertAlias(normalizedTypeName, metaType.d_ptr);
     }
 }
 
@@ -2553,7 +2744,6 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
         return QMetaType::UnknownType;
     int type = qMetaTypeStaticType(typeName, length);
     if (type == QMetaType::UnknownType) {
-        QReadLocker locker(&customTypeRegistry()->lock);
         type = qMetaTypeCustomType_unlocked(typeName, length);
 #ifndef QT_NO_QOBJECT
         if ((type == QMetaType::UnknownType) && tryNormalizedType) {
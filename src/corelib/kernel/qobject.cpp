@@ -147,7 +147,47 @@ static int *queuedConnectionTypes(const QArgumentType *argumentTypes, int argc)
     return types.take();
 }
 
-static QBasicMutex _q_ObjectMutexPool[131];
+namespace {
+// each mutex gets its own cache line, so that threads working on unrelated
+// objects don't contend on the same line
+struct alignas(64) SignalSlotMutex
+{
+    QBasicMutex mutex;
+};
+
+struct SignalSlotLockTable
+{
+    enum { DefaultCount = 512, MaximumCount = 65536 };
+
+    SignalSlotLockTable()
+    {
+        // QT_SIGNALSLOT_LOCK_COUNT is rounded up to a power of two
+        int count = qEnvironmentVariableIntValue("QT_SIGNALSLOT_LOCK_COUNT");
+        if (count <= 0)
+            count = DefaultCount;
+        count = qMin<int>(count, MaximumCount);
+        int bits = 0;
+        while ((1 << bits) < count)
+            ++bits;
+        shift = int(sizeof(quintptr)) * 8 - bits;
+        // never freed: objects may be destroyed after static destructors ran
+        mutexes = new SignalSlotMutex[size_t(1) << bits];
+    }
+
+    QBasicMutex *lock(const QObject *o) const
+    {
+        // Fibonacci hashing, so that neighbouring objects spread over the table
+        constexpr quintptr multiplier = sizeof(quintptr) == 8 ? quintptr(Q_UINT64_C(0x9E3779B97F4A7C15))
+                                                              : quintptr(0x9E3779B9);
+        if (shift == int(sizeof(quintptr)) * 8)
+            return &mutexes[0].mutex;
+        return &mutexes[(quintptr(o) * multiplier) >> shift].mutex;
+    }
+
+    SignalSlotMutex *mutexes;
+    int shift;
+};
+} // unnamed namespace
 
 /**
  * \internal
@@ -155,7 +195,8 @@ static QBasicMutex _q_ObjectMutexPool[131];
  */
 static inline QBasicMutex *signalSlotLock(const QObject *o)
 {
-    return &_q_ObjectMutexPool[uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QBasicMutex)];
+    static const SignalSlotLockTable table;
+    return table.lock(o);
 }
 
 #if QT_VERSION < 0x60000
@@ -224,7 +265,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || thisThreadData->postEventList.hasIncoming())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -620,6 +661,111 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+
+    Collects the copied arguments of the emissions made through a batched or
+    coalesced connection until the QMetaCallBatchEvent delivering them gets
+    to run. Once the event has started (or has been dropped), the batch is
+    closed and the next emission starts a new one.
+ */
+class QMetaCallBatch
+{
+    Q_DISABLE_COPY_MOVE(QMetaCallBatch)
+public:
+    QMetaCallBatch(const int *argumentTypes, int nargs)
+        : ref(2), nargs(nargs), argv(nargs), types(nargs)
+    {
+        // one reference for the connection, one for the event
+        argv[0] = nullptr; // return value
+        for (int n = 1; n < nargs; ++n)
+            types[n] = QMetaType(argumentTypes[n - 1]);
+    }
+    ~QMetaCallBatch() { destroyArgs(args); }
+
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+
+    void destroyArgs(const QList<void *> &copies) const
+    {
+        const int perCall = nargs - 1;
+        for (qsizetype i = 0; i < copies.size(); ++i)
+            types[1 + i % perCall].destroy(copies.at(i));
+    }
+
+    QAtomicInt ref;
+    QBasicMutex mutex;
+    bool open = true;
+    int count = 0; // number of emissions collected
+    QList<void *> args; // nargs - 1 copies per emission
+
+    const int nargs;
+    QVarLengthArray<void *, 4> argv; // only used while delivering
+    QVarLengthArray<QMetaType, 4> types;
+};
+
+/*!
+    \internal
+
+    Delivers all the emissions collected in a QMetaCallBatch with a single
+    posted event.
+ */
+class QMetaCallBatchEvent : public QMetaCallEvent
+{
+public:
+    QMetaCallBatchEvent(QObjectPrivate::Connection *c, const QObject *sender, int signalId,
+                        QMetaCallBatch *batch)
+        : QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction,
+                         sender, signalId, batch->argv.data(), nullptr),
+          batch(batch)
+    {
+    }
+
+    QMetaCallBatchEvent(QtPrivate::QSlotObjectBase *slotObj, const QObject *sender, int signalId,
+                        QMetaCallBatch *batch)
+        : QMetaCallEvent(slotObj, sender, signalId, batch->argv.data(), nullptr),
+          batch(batch)
+    {
+    }
+
+    ~QMetaCallBatchEvent() override
+    {
+        // dropped without being delivered
+        int count;
+        batch->destroyArgs(close(&count));
+        batch->deref();
+    }
+
+    void placeMetaCall(QObject *object) override
+    {
+        int count;
+        const QList<void *> args = close(&count);
+        const int perCall = batch->nargs - 1;
+        QPointer<QObject> guard(object);
+        for (int call = 0; call < count && guard; ++call) {
+            std::copy_n(args.constData() + call * perCall, perCall, batch->argv.data() + 1);
+            QMetaCallEvent::placeMetaCall(object);
+        }
+        batch->destroyArgs(args);
+    }
+
+private:
+    QList<void *> close(int *count)
+    {
+        QList<void *> args;
+        QBasicMutexLocker locker(&batch->mutex);
+        batch->open = false;
+        *count = batch->count;
+        args.swap(batch->args);
+        return args;
+    }
+
+    QMetaCallBatch *batch;
+};
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals().
@@ -1094,6 +1240,8 @@ QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (pendingBatch)
+        pendingBatch->deref();
 }
 
 
@@ -1579,6 +1727,12 @@ void QObject::moveToThread(QThread *targetThread)
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // forward the queued calls pushed onto currentData's lock-free stack
+    if (currentData->postEventList.mergeIncoming(targetData) && targetData->hasEventDispatcher()) {
+        targetData->canWait = false;
+        targetData->eventDispatcher.loadRelaxed()->wakeUp();
+    }
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -1652,6 +1806,13 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     // synchronizes with loadAcquire e.g. in QCoreApplication::postEvent
     threadData.storeRelease(targetData);
 
+    // Queued calls may still be on their way onto currentData's lock-free
+    // stack; wait for them (pairs with the fence in QCoreApplication::postEvent()),
+    // so that moveToThread() can forward them.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (postingThreads.load(std::memory_order_acquire))
+        QThread::yieldCurrentThread();
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
@@ -3341,6 +3502,10 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const bool isBatched = type & Qt::BatchedConnection;
+    const bool isCoalesced = type & Qt::CoalescedConnection;
+    type &= ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -3358,6 +3523,8 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->argumentTypes.storeRelaxed(types);
     c->callFunction = callFunction;
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
+    c->isCoalesced = isCoalesced;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
 
@@ -3629,6 +3796,60 @@ void QMetaObject::connectSlotsByName(QObject *o)
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
+static void batched_activate(QObject *sender, int signal, QObjectPrivate::Connection *c,
+                             void **argv, const int *argumentTypes, int nargs)
+{
+    // copy the arguments before taking any lock
+    QList<void *> copies;
+    copies.reserve(nargs - 1);
+    for (int n = 1; n < nargs; ++n)
+        copies.append(QMetaType(argumentTypes[n - 1]).create(argv[n]));
+    const auto destroyCopies = [&] {
+        for (qsizetype i = 0; i < copies.size(); ++i)
+            QMetaType(argumentTypes[i]).destroy(copies.at(i));
+    };
+
+    QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
+    QObject *receiver = c->receiver.loadRelaxed();
+    if (!receiver) {
+        // the connection has been disconnected before we got the lock
+        locker.unlock();
+        destroyCopies();
+        return;
+    }
+
+    if (QMetaCallBatch *batch = c->pendingBatch) {
+        QBasicMutexLocker batchLocker(&batch->mutex);
+        if (batch->open) {
+            if (c->isCoalesced && batch->count) {
+                // latest value wins; the previous arguments are destroyed below
+                batch->args.swap(copies);
+            } else {
+                batch->args.append(copies);
+                ++batch->count;
+                copies.clear();
+            }
+            batchLocker.unlock();
+            locker.unlock();
+            destroyCopies();
+            return;
+        }
+        // the pending event is already being delivered
+        batchLocker.unlock();
+        batch->deref();
+    }
+
+    QMetaCallBatch *batch = new QMetaCallBatch(argumentTypes, nargs);
+    batch->args.swap(copies);
+    batch->count = 1;
+    c->pendingBatch = batch;
+
+    QMetaCallBatchEvent *ev = c->isSlotObject ?
+        new QMetaCallBatchEvent(c->slotObj, sender, signal, batch) :
+        new QMetaCallBatchEvent(c, sender, signal, batch);
+    QCoreApplication::postEvent(receiver, ev);
+}
+
 static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
 {
     const int *argumentTypes = c->argumentTypes.loadRelaxed();
@@ -3649,6 +3870,11 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     while (argumentTypes[nargs - 1])
         ++nargs;
 
+    if ((c->isBatched || c->isCoalesced) && !c->isSingleShot) {
+        batched_activate(sender, signal, c, argv, argumentTypes, nargs);
+        return;
+    }
+
     QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
     QObject *receiver = c->receiver.loadRelaxed();
     if (!receiver) {
@@ -3744,6 +3970,8 @@ void doActivate(QObject *sender, int signal_index, void **argv)
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
     bool inSenderThread = currentThreadId == QObjectPrivate::get(sender)->threadData.loadRelaxed()->threadId.loadRelaxed();
+    // only needed when emitting from another thread than the sender's
+    QThreadData *currentThreadData = inSenderThread ? nullptr : QThreadData::current(false);
 
     // We need to check against the highest connection id to ensure that signals added
     // during the signal emission are not emitted in this emission.
@@ -3766,9 +3994,9 @@ void doActivate(QObject *sender, int signal_index, void **argv)
             if (inSenderThread) {
                 receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
             } else {
-                // need to lock before reading the threadId, because moveToThread() could interfere
-                QMutexLocker lock(signalSlotLock(receiver));
-                receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
+                // moveToThread() could release td concurrently, so don't
+                // dereference it; comparing the pointer needs no lock
+                receiverInSameThread = td == currentThreadData;
             }
 
 
@@ -4925,6 +5153,10 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
 
+    const bool isBatched = type & Qt::BatchedConnection;
+    const bool isCoalesced = type & Qt::CoalescedConnection;
+    type &= ~(Qt::BatchedConnection | Qt::CoalescedConnection);
+
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
 
@@ -4943,6 +5175,8 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
         c->ownArgumentTypes = false;
     }
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
+    c->isCoalesced = isCoalesced;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
     QMetaObject::Connection ret(c.release());
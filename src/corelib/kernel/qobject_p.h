@@ -67,6 +67,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+class QMetaCallBatch;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -159,6 +160,11 @@ public:
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
         ushort isSingleShot : 1;
+        ushort isBatched : 1;
+        ushort isCoalesced : 1;
+        // the batch collecting queued emissions until they are delivered, guarded
+        // by the receiver's signalSlotLock()
+        QMetaCallBatch *pendingBatch = nullptr;
         Connection() : ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
@@ -372,6 +378,8 @@ public:
     // However, most of the code paths involving QObject are only reentrant and
     // not thread-safe, so synchronization should not be necessary there.
     QAtomicPointer<QThreadData> threadData; // id of the thread that owns the object
+    // number of threads in QCoreApplication::postEvent()'s lock-free path for this object
+    std::atomic<int> postingThreads = 0;
 
     using ConnectionDataPointer = QExplicitlySharedDataPointer<ConnectionData>;
     QAtomicPointer<ConnectionData> connections;
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -53,6 +54,8 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
@@ -83,7 +86,21 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
-    firstTimerInfo = nullptr;
+    std::fill_n(lists, int(ListCount), nullptr);
+    std::fill_n(occupiedSlots, int(Levels), 0);
+    wheelTick = 0;
+    nextTimeoutValid = false;
+
+    // start on a millisecond boundary, so that the coarse timers, which
+    // fire on whole milliseconds, never need to wait for the next tick
+    origin = qt_gettime();
+    origin.tv_nsec -= origin.tv_nsec % (1000 * 1000);
+    currentTime = origin;
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timers);
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -146,11 +163,11 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 */
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    // repair all timers; moving the origin along keeps their ticks valid
+    for (QTimerInfo *t : qAsConst(timers))
         t->timeout = t->timeout + diff;
-    }
+    origin = origin + diff;
+    nextTimeoutValid = false;
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -170,18 +187,163 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+qint64 QTimerInfoList::tickFor(const timespec &time) const
+{
+    const timespec sinceOrigin = time - origin;
+    if (sinceOrigin.tv_sec < 0)
+        return 0;
+    return qint64(sinceOrigin.tv_sec) * 1000 + sinceOrigin.tv_nsec / (1000 * 1000);
+}
+
+void QTimerInfoList::link(QTimerInfo *t, int list)
+{
+    t->list = list;
+    t->prev = nullptr;
+    t->next = lists[list];
+    if (t->next)
+        t->next->prev = t;
+    lists[list] = t;
+    if (list < WheelSlots)
+        occupiedSlots[list / SlotsPerLevel] |= quint64(1) << (list % SlotsPerLevel);
+}
+
+void QTimerInfoList::unlink(QTimerInfo *t)
+{
+    const int list = t->list;
+    if (t->prev)
+        t->prev->next = t->next;
+    else
+        lists[list] = t->next;
+    if (t->next)
+        t->next->prev = t->prev;
+    t->list = -1;
+
+    if (list < WheelSlots) {
+        if (!lists[list])
+            occupiedSlots[list / SlotsPerLevel] &= ~(quint64(1) << (list % SlotsPerLevel));
+        if (nextTimeoutValid && !(nextTimeout < t->timeout))
+            nextTimeoutValid = false;
+    }
+}
+
+template <typename Container>
+void QTimerInfoList::takeList(int list, Container &container)
+{
+    for (QTimerInfo *t = lists[list]; t; t = t->next) {
+        container.append(t);
+        t->list = -1;
+    }
+    lists[list] = nullptr;
+    if (list < WheelSlots)
+        occupiedSlots[list / SlotsPerLevel] &= ~(quint64(1) << (list % SlotsPerLevel));
+}
+
 /*
-  insert timer info into list
+  insert timer info into the wheel
 */
-void QTimerInfoList::timerInsert(QTimerInfo *ti)
+void QTimerInfoList::timerInsert(QTimerInfo *t)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    t->tick = tickFor(t->timeout);
+    if (t->tick <= wheelTick) {
+        link(t, PendingList);
+        return;
     }
-    insert(index+1, ti);
+
+    const int highestDifferentBit = 63 - qCountLeadingZeroBits(quint64(t->tick ^ wheelTick));
+    const int level = highestDifferentBit / LevelBits;
+    Q_ASSERT(level < Levels);
+    link(t, level * SlotsPerLevel + ((t->tick >> (level * LevelBits)) & (SlotsPerLevel - 1)));
+
+    if (nextTimeoutValid && t->timeout < nextTimeout)
+        nextTimeout = t->timeout;
+}
+
+/*
+  remove timer info from wherever it is and delete it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *t)
+{
+    if (t->list >= 0)
+        unlink(t);
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+}
+
+/*
+  Moves the wheel forward to \a tick and the timers that are due by
+  currentTime into the expired list, earliest first.
+*/
+void QTimerInfoList::advance(qint64 tick)
+{
+    QVarLengthArray<QTimerInfo *, 64> candidates;
+    takeList(PendingList, candidates);
+
+    if (tick > wheelTick) {
+        for (int level = 0; level < Levels; ++level) {
+            // if the wheel stays within the same slot of the level above,
+            // only the slots it moves past at this level can hold timers
+            // that are due or need to move down; otherwise all of them do
+            const int shift = level * LevelBits;
+            quint64 mask = ~quint64(0);
+            if ((wheelTick >> (shift + LevelBits)) == (tick >> (shift + LevelBits))) {
+                const int from = (wheelTick >> shift) & (SlotsPerLevel - 1);
+                const int to = (tick >> shift) & (SlotsPerLevel - 1);
+                mask = ((quint64(2) << to) - 1) & ~((quint64(2) << from) - 1);
+            }
+            mask &= occupiedSlots[level];
+            while (mask) {
+                takeList(level * SlotsPerLevel + qCountTrailingZeroBits(mask), candidates);
+                mask &= mask - 1;
+            }
+        }
+        wheelTick = tick;
+        nextTimeoutValid = false;
+    }
+
+    QVarLengthArray<QTimerInfo *, 64> due;
+    for (QTimerInfo *t : qAsConst(candidates)) {
+        if (currentTime < t->timeout)
+            timerInsert(t);
+        else
+            due.append(t);
+    }
+    if (due.isEmpty())
+        return;
+
+    // a recursive activateTimers() may not have fired all of them yet
+    takeList(ExpiredList, due);
+    std::sort(due.begin(), due.end(), [](const QTimerInfo *t1, const QTimerInfo *t2) {
+        return t1->timeout < t2->timeout;
+    });
+    for (auto it = due.crbegin(); it != due.crend(); ++it)
+        link(*it, ExpiredList);
+}
+
+/*
+  Returns the earliest timeout of the timers in the wheel.
+*/
+bool QTimerInfoList::wheelTimeout(timespec &timeout)
+{
+    if (!nextTimeoutValid) {
+        int level = 0;
+        while (level < Levels && !occupiedSlots[level])
+            ++level;
+        if (level == Levels)
+            return false;
+
+        // lower levels and slots expire first, but within a slot the
+        // timers are unordered
+        const int slot = level * SlotsPerLevel + qCountTrailingZeroBits(occupiedSlots[level]);
+        nextTimeout = lists[slot]->timeout;
+        for (const QTimerInfo *t = lists[slot]->next; t; t = t->next) {
+            if (t->timeout < nextTimeout)
+                nextTimeout = t->timeout;
+        }
+        nextTimeoutValid = true;
+    }
+    timeout = nextTimeout;
+    return true;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -384,21 +546,27 @@ bool QTimerInfoList::timerWait(timespec &tm)
     timespec currentTime = updateCurrentTime();
     repairTimersIfNeeded();
 
-    // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
+    // Find first waiting timer not already active; those being delivered
+    // are kept in a list of their own
+    bool found = lists[ExpiredList] != nullptr;
+    timespec timeout = currentTime;
+    for (const QTimerInfo *t = lists[PendingList]; t; t = t->next) {
+        if (!found || t->timeout < timeout)
+            timeout = t->timeout;
+        found = true;
+    }
+    timespec wheel;
+    if (wheelTimeout(wheel) && (!found || wheel < timeout)) {
+        timeout = wheel;
+        found = true;
     }
 
-    if (!t)
+    if (!found)
       return false;
 
-    if (currentTime < t->timeout) {
+    if (currentTime < timeout) {
         // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
+        tm = roundToMillisecond(timeout - currentTime);
     } else {
         // no time to wait
         tm.tv_sec  = 0;
@@ -419,16 +587,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -447,6 +612,8 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = nullptr;
+    t->next = t->prev = nullptr;
+    t->list = -1;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -489,6 +656,8 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
+    objectTimers.insert(object, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -503,41 +672,23 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    QTimerInfo *t = timers.take(timerId);
+    if (!t)
+        return false; // id not found
+    objectTimers.remove(t->obj, t);
+    timerRemove(t);
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+    const QList<QTimerInfo *> objectTimerList = objectTimers.values(object);
+    objectTimers.remove(object);
+    for (QTimerInfo *t : objectTimerList) {
+        timers.remove(t->id);
+        timerRemove(t);
     }
     return true;
 }
@@ -545,15 +696,13 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    for (auto it = objectTimers.constFind(object); it != objectTimers.cend() && it.key() == object; ++it) {
+        const QTimerInfo * const t = it.value();
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -566,42 +715,23 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = nullptr;
+    int n_act = 0;
 
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Find out which timers have expired. Those fired below go back into the
+    // wheel or the pending list, never straight into the expired one, so
+    // that no timer is sent twice.
+    advance(tickFor(currentTime));
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = constFirst();
-        if (currentTime < currentTimerInfo->timeout)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+    while (lists[ExpiredList]) {
+        QTimerInfo *currentTimerInfo = lists[ExpiredList];
 
         // remove from list
-        removeFirst();
+        unlink(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -625,25 +755,24 @@ int QTimerInfoList::activateTimers()
 
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
-
-        // reinsert timer
-        timerInsert(currentTimerInfo);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
-        if (!currentTimerInfo->activateRef) {
-            // send event, but don't allow it to recurse
-            currentTimerInfo->activateRef = &currentTimerInfo;
+        // send event, but don't allow it to recurse: recursive calls don't
+        // see the timer until it is reinserted
+        link(currentTimerInfo, ActiveList);
+        currentTimerInfo->activateRef = &currentTimerInfo;
 
-            QTimerEvent e(currentTimerInfo->id);
-            QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
+        QTimerEvent e(currentTimerInfo->id);
+        QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
-            if (currentTimerInfo)
-                currentTimerInfo->activateRef = nullptr;
+        if (currentTimerInfo) {
+            currentTimerInfo->activateRef = nullptr;
+            unlink(currentTimerInfo);
+            timerInsert(currentTimerInfo);
         }
     }
 
-    firstTimerInfo = nullptr;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
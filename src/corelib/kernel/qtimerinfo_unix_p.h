@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -70,6 +71,12 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    // position in QTimerInfoList
+    QTimerInfo *next;
+    QTimerInfo *prev;
+    qint64 tick;      // - timeout in milliseconds since the list's origin, rounded down
+    int list;         // - wheel slot or list the timer is in, -1 if none
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -77,7 +84,9 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+// Keeps the timers in a hierarchical timing wheel, so that starting and
+// stopping a timer takes constant time however many are running.
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -89,11 +98,45 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    // Level n of the wheel has 64 slots of 64^n milliseconds each. A timer
+    // goes to the level of the highest 6-bit group in which its tick differs
+    // from wheelTick, so each level only holds timers of the slot of the next
+    // higher level wheelTick is in, and lower levels always expire first.
+    enum {
+        LevelBits = 6,
+        SlotsPerLevel = 1 << LevelBits,
+        Levels = 7,                         // 2^42 ms, more than a century
+        WheelSlots = Levels * SlotsPerLevel,
+        PendingList = WheelSlots,           // tick <= wheelTick, but not yet due
+        ExpiredList,                        // due, in the order they fire in
+        ActiveList,                         // currently being delivered
+        ListCount
+    };
+
+    QTimerInfo *lists[ListCount];
+    quint64 occupiedSlots[Levels];
+    qint64 wheelTick;         // all timers in the wheel have a later tick
+    timespec origin;          // time of tick 0
+
+    // earliest timeout in the wheel, computed on demand
+    timespec nextTimeout;
+    bool nextTimeoutValid;
+
+    QHash<int, QTimerInfo *> timers;
+    QMultiHash<QObject *, QTimerInfo *> objectTimers;
+
+    qint64 tickFor(const timespec &time) const;
+    void link(QTimerInfo *t, int list);
+    void unlink(QTimerInfo *t);
+    template <typename Container> void takeList(int list, Container &container);
+    void advance(qint64 tick);
+    bool wheelTimeout(timespec &timeout);
+    void timerInsert(QTimerInfo *);
+    void timerRemove(QTimerInfo *);
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
 
     timespec currentTime;
     timespec updateCurrentTime();
@@ -102,7 +145,6 @@ public:
     void repairTimersIfNeeded();
 
     bool timerWait(timespec &);
-    void timerInsert(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
 
@@ -112,6 +154,12 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+    bool isEmpty() const { return timers.isEmpty(); }
+    qsizetype size() const { return timers.size(); }
+
+private:
+    Q_DISABLE_COPY(QTimerInfoList)
 };
 
 QT_END_NAMESPACE
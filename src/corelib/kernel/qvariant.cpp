@@ -2013,12 +2013,13 @@ bool QVariant::convert(QMetaType targetType)
     if (d.type() == targetType)
         return targetType.isValid();
 
-    QVariant oldValue = *this;
+    // Take over the old value instead of copying it, and convert straight into
+    // the storage of the new one; QMetaType::convert() fails for the pairs that
+    // canConvert() would reject, so there is no need to look them up twice.
+    const QVariant oldValue = std::move(*this);
 
-    clear();
-    create(targetType.id(), nullptr);
-    if (!oldValue.canConvert(targetType))
-        return false;
+    d = Private(targetType);
+    customConstruct(&d, nullptr);
 
     // Fail if the value is not initialized or was forced null by a previous failed convert.
     if (oldValue.d.is_null && oldValue.d.typeId() != QMetaType::Nullptr)
@@ -2029,6 +2030,29 @@ bool QVariant::convert(QMetaType targetType)
     return ok;
 }
 
+/*!
+    \since 6.1
+
+    Converts the value of this variant to \a targetType and stores the result in
+    \a target, which must point to a constructed object of that type. The variant
+    itself is left unchanged, and no temporary QVariant is created; use this
+    function to convert many values into the same, reused object.
+
+    Returns \c true if the conversion succeeded; otherwise returns \c false.
+
+    \note As with convert(QMetaType), converting a null variant always fails;
+    \a target is left unchanged in that case.
+
+    \sa convert(QMetaType), canConvert(), QMetaType::convert()
+*/
+bool QVariant::convert(QMetaType targetType, void *target) const
+{
+    if (d.is_null && d.typeId() != QMetaType::Nullptr)
+        return false;
+
+    return QMetaType::convert(d.type(), constData(), targetType, target);
+}
+
 /*!
   \fn bool QVariant::convert(int type, void *ptr) const
   \internal
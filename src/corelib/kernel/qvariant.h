@@ -251,6 +251,7 @@ class Q_CORE_EXPORT QVariant
     bool canConvert(QMetaType targetType) const
     { return QMetaType::canConvert(d.type(), targetType); }
     bool convert(QMetaType type);
+    bool convert(QMetaType targetType, void *target) const;
 
     bool canView(QMetaType targetType) const
     { return QMetaType::canView(d.type(), targetType); }
@@ -11,4 +11,4 @@ qt_commandline_option(posix-ipc TYPE boolean NAME ipc_posix)
 qt_commandline_option(pps TYPE boolean NAME qqnx_pps)
 qt_commandline_option(slog2 TYPE boolean)
 qt_commandline_option(syslog TYPE boolean)
-qt_commandline_option(trace TYPE optionalString VALUES etw lttng no yes)
+qt_commandline_option(trace TYPE optionalString VALUES builtin etw lttng no yes)
@@ -39,6 +39,8 @@
 
 #include "qbytearraymatcher.h"
 
+#include <private/qsimd_p.h>
+
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
@@ -87,6 +89,105 @@ static inline qsizetype bm_find(const uchar *cc, qsizetype l, qsizetype index, c
     return -1; // not found
 }
 
+/*
+    The SIMD search compares the first and last bytes of the needle with the bytes at the same
+    offsets of sixteen candidate positions of the haystack at once, and only compares the whole
+    needle where both match, like the one of QStringMatcher. Longer needles are left to
+    Boyer-Moore, which skips further ahead with them.
+*/
+enum { SimdFindMaxNeedleLength = 32 };
+
+static inline bool simd_find_usable(qsizetype pl)
+{
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+    return pl > 0 && pl <= SimdFindMaxNeedleLength;
+#else
+    Q_UNUSED(pl);
+    return false;
+#endif
+}
+
+#if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) && !defined(__SSE2__)
+// Returns one bit per lane of v, which must be all set or all clear
+static inline uint simd_movemask(uint8x16_t v)
+{
+    const uint8x8_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    return vaddv_u8(vand_u8(vget_low_u8(v), bits)) | (vaddv_u8(vand_u8(vget_high_u8(v), bits)) << 8);
+}
+#endif
+
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+/*
+    Text made to pass the filter at most positions, like runs of the needle's first and last
+    bytes, would make the SIMD search compare the whole needle almost everywhere. It gives up
+    once that has cost more than a few times the text it got through, and lets Boyer-Moore
+    continue from there. skiptable may be null, then it's only built if that happens.
+*/
+static inline bool simd_find_give_up(qsizetype misses, qsizetype pl, qsizetype searched)
+{
+    return misses * pl > 4 * searched + 256;
+}
+
+static qsizetype simd_find_fallback(const uchar *cc, qsizetype l, qsizetype index,
+                                    const uchar *puc, qsizetype pl, const uchar *skiptable)
+{
+    uchar localSkiptable[256];
+    if (!skiptable) {
+        bm_init_skiptable(puc, pl, localSkiptable);
+        skiptable = localSkiptable;
+    }
+    return bm_find(cc, l, index, puc, pl, skiptable);
+}
+#endif
+
+static qsizetype simd_find(const uchar *cc, qsizetype l, qsizetype index, const uchar *puc,
+                           qsizetype pl, const uchar *skiptable = nullptr)
+{
+    if (index > l - pl)
+        return -1;
+    const uchar *n = cc + index;
+    const uchar *const lastCandidate = cc + l - pl;
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(char(puc[0]));
+    const __m128i last = _mm_set1_epi8(char(puc[pl - 1]));
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    const uint8x16_t first = vdupq_n_u8(puc[0]);
+    const uint8x16_t last = vdupq_n_u8(puc[pl - 1]);
+#endif
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+    // we're going to check the candidates n[0..15], reading up to n[pl - 1 + 15]
+    qsizetype misses = 0;
+    for ( ; lastCandidate - n >= 15; n += 16) {
+#  ifdef __SSE2__
+        const __m128i atFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n));
+        const __m128i atLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n + pl - 1));
+        uint mask = uint(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(atFirst, first),
+                                                         _mm_cmpeq_epi8(atLast, last))));
+#  else
+        const uint8x16_t atFirst = vld1q_u8(n);
+        const uint8x16_t atLast = vld1q_u8(n + pl - 1);
+        uint mask = simd_movemask(vandq_u8(vceqq_u8(atFirst, first), vceqq_u8(atLast, last)));
+#  endif
+        while (mask) {
+            const uint idx = qCountTrailingZeroBits(mask);
+            if (memcmp(n + idx, puc, pl) == 0)
+                return n + idx - cc;
+            mask &= mask - 1;
+            if (Q_UNLIKELY(simd_find_give_up(++misses, pl, n - cc - index)))
+                return simd_find_fallback(cc, l, n - cc, puc, pl, skiptable);
+        }
+    }
+#else
+    Q_UNUSED(skiptable);
+#endif
+
+    for ( ; n <= lastCandidate; ++n) {
+        if (memcmp(n, puc, pl) == 0)
+            return n - cc;
+    }
+    return -1;
+}
+
 /*! \class QByteArrayMatcher
     \inmodule QtCore
     \brief The QByteArrayMatcher class holds a sequence of bytes that
@@ -199,6 +300,9 @@ qsizetype QByteArrayMatcher::indexIn(const QByteArray &ba, qsizetype from) const
 {
     if (from < 0)
         from = 0;
+    if (simd_find_usable(p.l))
+        return simd_find(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
+                         p.p, p.l, p.q_skiptable);
     return bm_find(reinterpret_cast<const uchar *>(ba.constData()), ba.size(), from,
                    p.p, p.l, p.q_skiptable);
 }
@@ -214,6 +318,9 @@ qsizetype QByteArrayMatcher::indexIn(const char *str, qsizetype len, qsizetype f
 {
     if (from < 0)
         from = 0;
+    if (simd_find_usable(p.l))
+        return simd_find(reinterpret_cast<const uchar *>(str), len, from, p.p, p.l,
+                         p.q_skiptable);
     return bm_find(reinterpret_cast<const uchar *>(str), len, from,
                    p.p, p.l, p.q_skiptable);
 }
@@ -285,6 +392,10 @@ qsizetype qFindByteArray(
     if (sl == 1)
         return findChar(haystack0, haystackLen, needle[0], from);
 
+    if (simd_find_usable(sl))
+        return simd_find(reinterpret_cast<const uchar *>(haystack0), haystackLen, from,
+                         reinterpret_cast<const uchar *>(needle), sl);
+
     /*
       We use the Boyer-Moore algorithm in cases where the overhead
       for the skip table should pay off, otherwise we use a simple
@@ -10151,6 +10151,11 @@ qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringVi
     if (sl == 1)
         return qFindChar(haystack0, needle0[0], from, cs);
 
+    // see qstringmatcher.cpp
+    qsizetype firstPos, lastPos;
+    if (simd_find_usable(needle0, cs, firstPos, lastPos))
+        return simd_find(haystack0, from, needle0, cs, firstPos, lastPos);
+
     /*
         We use the Boyer-Moore algorithm in cases where the overhead
         for the skip table should pay off, otherwise we use a simple
@@ -77,6 +77,62 @@ static Q_ALWAYS_INLINE uint qBitScanReverse(unsigned v) noexcept
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+// Byte shuffles for the SIMD UTF-8 codecs, and the number of bytes they produce. The decoding
+// table compacts eight 16-bit lanes and is indexed by the lanes to drop (those of UTF-8
+// continuation bytes). The encoding one gathers the sequences of four characters from a
+// register holding each one's lead byte in bytes 0 to 3, the next byte in 4 to 7 and the last
+// in 8 to 11; it is indexed by the characters in US-ASCII (bits 0 to 3) and by those that
+// need three bytes (bits 4 to 7).
+struct Utf8ShuffleTable
+{
+    uchar masks[256][16];
+    uchar sizes[256];
+};
+
+static constexpr Utf8ShuffleTable makeUtf8DecodeShuffleTable()
+{
+    Utf8ShuffleTable table = {};
+    for (uint mask = 0; mask < 256; ++mask) {
+        uint j = 0;
+        for (uint i = 0; i < 8; ++i) {
+            if (mask & (1U << i))
+                continue;
+            table.masks[mask][j++] = 2 * i;
+            table.masks[mask][j++] = 2 * i + 1;
+        }
+        table.sizes[mask] = j;
+        for ( ; j < 16; ++j)
+            table.masks[mask][j] = 0x80;
+    }
+    return table;
+}
+
+static constexpr Utf8ShuffleTable makeUtf8EncodeShuffleTable()
+{
+    Utf8ShuffleTable table = {};
+    for (uint mask = 0; mask < 256; ++mask) {
+        uint j = 0;
+        for (uint i = 0; i < 4; ++i) {
+            const bool ascii = mask & (1U << i);
+            const bool threeByte = mask & (0x10U << i);
+            table.masks[mask][j++] = i;
+            if (!ascii)
+                table.masks[mask][j++] = 4 + i;
+            if (threeByte)
+                table.masks[mask][j++] = 8 + i;
+        }
+        table.sizes[mask] = j;
+        for ( ; j < 16; ++j)
+            table.masks[mask][j] = 0x80;
+    }
+    return table;
+}
+
+alignas(16) static constexpr Utf8ShuffleTable utf8DecodeShuffleTable = makeUtf8DecodeShuffleTable();
+alignas(16) static constexpr Utf8ShuffleTable utf8EncodeShuffleTable = makeUtf8EncodeShuffleTable();
+#endif
+
 #if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
 static inline bool simdEncodeAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
 {
@@ -360,6 +416,198 @@ static void simdCompareAscii(const char8_t *&src8, const char8_t *end8, const ch
     src8 += offset;
     src16 += offset;
 }
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+#  define UTF8_MULTIBYTE_SIMD
+#  define UTF8_MULTIBYTE_SIMD_TARGET    QT_FUNCTION_TARGET(SSSE3)
+
+// Number of characters in the blocks handled by simdEncodeThreeByteBlock()
+enum { ThreeByteBlockChars = 8 };
+
+static inline bool hasMultiByteSimd()
+{
+    return qCpuHasFeature(SSSE3);
+}
+
+// Decodes one half of a window for simdDecodeMultiByteWindow(): b0 has the bytes at each
+// position, b1 and b2 the two following ones, and is2 and is3 flag the lead bytes of two- and
+// three-byte sequences, all as 16-bit lanes. Without ThreeByte, is3 must be all clear.
+template <bool ThreeByte>
+UTF8_MULTIBYTE_SIMD_TARGET
+static Q_ALWAYS_INLINE __m128i simdDecodeMultiByteLanes(__m128i b0, __m128i b1, __m128i b2, __m128i is2, __m128i is3,
+                                                        __m128i &invalid)
+{
+    const __m128i low6 = _mm_set1_epi16(0x3f);
+    const __m128i twoByte = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6),
+                                         _mm_and_si128(b1, low6));
+    if (!ThreeByte)
+        return _mm_or_si128(_mm_and_si128(is2, twoByte), _mm_andnot_si128(is2, b0));
+
+    const __m128i threeByte = _mm_or_si128(
+            _mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(_mm_and_si128(b1, low6), 6)),
+            _mm_and_si128(b2, low6));
+
+    // reject overlong three-byte sequences (below U+0800) and surrogates
+    const __m128i range = _mm_and_si128(threeByte, _mm_set1_epi16(short(0xf800)));
+    invalid = _mm_or_si128(invalid, _mm_and_si128(is3, _mm_or_si128(
+            _mm_cmpeq_epi16(range, _mm_setzero_si128()),
+            _mm_cmpeq_epi16(range, _mm_set1_epi16(short(0xd800))))));
+
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(is3, threeByte), _mm_and_si128(is2, twoByte)),
+                        _mm_andnot_si128(_mm_or_si128(is2, is3), b0));
+}
+
+// Decodes the UTF-8 sequences starting in the sixteen bytes at src, if they're all US-ASCII or
+// two- and three-byte sequences (that is, up to U+FFFF); the last ones may end in the two
+// following bytes. Needs eighteen readable bytes at src and writes sixteen characters' worth
+// at dst. Returns the number of characters decoded and advances src past them, or returns 0
+// if the bytes contain anything else, like four-byte sequences or invalid UTF-8.
+UTF8_MULTIBYTE_SIMD_TARGET
+static Q_ALWAYS_INLINE qsizetype simdDecodeMultiByteWindow(ushort *dst, const uchar *&src)
+{
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+    // signed comparisons: US-ASCII is positive, continuation bytes are below (char)0xC0, lead
+    // bytes of two-byte sequences go from (char)0xC2 to (char)0xDF (0xC0 and 0xC1 can only
+    // start overlong sequences) and those of three-byte sequences from (char)0xE0 to (char)0xEF
+    const __m128i isAscii = _mm_cmpgt_epi8(data, _mm_set1_epi8(-1));
+    const __m128i isCont = _mm_cmplt_epi8(data, _mm_set1_epi8(char(0xc0)));
+    const __m128i isLead2 = _mm_and_si128(_mm_cmpgt_epi8(data, _mm_set1_epi8(char(0xc1))),
+                                          _mm_cmplt_epi8(data, _mm_set1_epi8(char(0xe0))));
+    const __m128i isLead3 = _mm_and_si128(_mm_cmpgt_epi8(data, _mm_set1_epi8(char(0xdf))),
+                                          _mm_cmplt_epi8(data, _mm_set1_epi8(char(0xf0))));
+    const uint lead2 = _mm_movemask_epi8(isLead2);
+    const uint lead3 = _mm_movemask_epi8(isLead3);
+    const uint cont = _mm_movemask_epi8(isCont)
+            | ((src[16] & 0xc0) == 0x80 ? 0x10000 : 0) | ((src[17] & 0xc0) == 0x80 ? 0x20000 : 0);
+
+    // every byte must be one of those, and exactly the bytes following the lead bytes must be
+    // continuation bytes (the two bytes after the window only matter if a sequence needs them)
+    const uint expectedCont = (lead2 << 1) | (lead3 << 1) | (lead3 << 2);
+    if (((_mm_movemask_epi8(isAscii) | lead2 | lead3 | cont) & 0xffff) != 0xffff
+            || (cont & (expectedCont | 0xffff)) != expectedCont)
+        return 0;
+
+    const __m128i next1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1));
+    const __m128i next2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low0 = _mm_unpacklo_epi8(data, zero);
+    const __m128i low1 = _mm_unpacklo_epi8(next1, zero);
+    const __m128i low2 = _mm_unpacklo_epi8(next2, zero);
+    const __m128i lowIs2 = _mm_unpacklo_epi8(isLead2, isLead2);
+    const __m128i lowIs3 = _mm_unpacklo_epi8(isLead3, isLead3);
+    const __m128i high0 = _mm_unpackhi_epi8(data, zero);
+    const __m128i high1 = _mm_unpackhi_epi8(next1, zero);
+    const __m128i high2 = _mm_unpackhi_epi8(next2, zero);
+    const __m128i highIs2 = _mm_unpackhi_epi8(isLead2, isLead2);
+    const __m128i highIs3 = _mm_unpackhi_epi8(isLead3, isLead3);
+    __m128i invalid = zero;
+    __m128i low, high;
+    if (lead3) {
+        low = simdDecodeMultiByteLanes<true>(low0, low1, low2, lowIs2, lowIs3, invalid);
+        high = simdDecodeMultiByteLanes<true>(high0, high1, high2, highIs2, highIs3, invalid);
+        if (_mm_movemask_epi8(invalid))
+            return 0;
+    } else {
+        low = simdDecodeMultiByteLanes<false>(low0, low1, low2, lowIs2, lowIs3, invalid);
+        high = simdDecodeMultiByteLanes<false>(high0, high1, high2, highIs2, highIs3, invalid);
+    }
+
+    // drop the lanes of the continuation bytes
+    const uint lowCont = cont & 0xff;
+    const uint highCont = (cont >> 8) & 0xff;
+    const qsizetype lowSize = utf8DecodeShuffleTable.sizes[lowCont] / 2;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(low,
+            _mm_load_si128(reinterpret_cast<const __m128i *>(utf8DecodeShuffleTable.masks[lowCont]))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + lowSize), _mm_shuffle_epi8(high,
+            _mm_load_si128(reinterpret_cast<const __m128i *>(utf8DecodeShuffleTable.masks[highCont]))));
+
+    // skip the continuation bytes past the window
+    const uint tail = expectedCont >> 16;
+    src += 16 + (tail & 1) + (tail >> 1);
+    return lowSize + utf8DecodeShuffleTable.sizes[highCont] / 2;
+}
+
+// Encodes the eight characters at src as UTF-8 if none of them is a surrogate. Writes 28
+// bytes' worth at dst and returns the number of bytes produced, or returns 0 if there's a
+// surrogate.
+UTF8_MULTIBYTE_SIMD_TARGET
+static Q_ALWAYS_INLINE qsizetype simdEncodeMultiByteWindow(uchar *dst, const ushort *src)
+{
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i range = _mm_and_si128(data, _mm_set1_epi16(short(0xf800)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(range, _mm_set1_epi16(short(0xd800)))))
+        return 0;
+
+    // the bytes of each sequence: the lead byte, then the first and the second continuation
+    // byte for three-byte sequences or just the last one otherwise
+    const __m128i isAscii = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(short(0xff80))), zero);
+    const __m128i isSmall = _mm_cmpeq_epi16(range, zero);
+    const __m128i lastCont = _mm_or_si128(_mm_and_si128(data, _mm_set1_epi16(0x3f)), _mm_set1_epi16(0x80));
+    const __m128i firstCont = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0x3f)),
+                                           _mm_set1_epi16(0x80));
+    const __m128i lead = _mm_or_si128(
+            _mm_and_si128(isSmall, _mm_or_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0xc0))),
+            _mm_andnot_si128(isSmall, _mm_or_si128(_mm_srli_epi16(data, 12), _mm_set1_epi16(0xe0))));
+    const __m128i first = _mm_or_si128(_mm_and_si128(isAscii, data), _mm_andnot_si128(isAscii, lead));
+    const __m128i second = _mm_or_si128(_mm_and_si128(isSmall, lastCont), _mm_andnot_si128(isSmall, firstCont));
+
+    // lay out four characters per register as utf8EncodeShuffleTable expects
+    const __m128i firstSecond = _mm_shuffle_epi32(_mm_packus_epi16(first, second), _MM_SHUFFLE(3, 1, 2, 0));
+    const __m128i third = _mm_packus_epi16(lastCont, lastCont);
+    const __m128i low = _mm_unpacklo_epi64(firstSecond, third);
+    const __m128i high = _mm_unpackhi_epi64(firstSecond, _mm_srli_epi64(third, 32));
+
+    const uint ascii = _mm_movemask_epi8(_mm_packs_epi16(isAscii, zero));
+    const uint threeByte = ~_mm_movemask_epi8(_mm_packs_epi16(isSmall, zero)) & 0xff;
+    const uint lowMask = (ascii & 0xf) | ((threeByte & 0xf) << 4);
+    const uint highMask = ((ascii >> 4) & 0xf) | (threeByte & 0xf0);
+    const qsizetype lowSize = utf8EncodeShuffleTable.sizes[lowMask];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(low,
+            _mm_load_si128(reinterpret_cast<const __m128i *>(utf8EncodeShuffleTable.masks[lowMask]))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + lowSize), _mm_shuffle_epi8(high,
+            _mm_load_si128(reinterpret_cast<const __m128i *>(utf8EncodeShuffleTable.masks[highMask]))));
+    return lowSize + utf8EncodeShuffleTable.sizes[highMask];
+}
+
+// Encodes eight characters from U+0800 to U+FFFF, except surrogates, at src as UTF-8 into
+// the 24 bytes at dst. Returns false, without writing anything, if any character is outside
+// that range.
+UTF8_MULTIBYTE_SIMD_TARGET
+static inline bool simdEncodeThreeByteBlock(uchar *dst, const ushort *src)
+{
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i range = _mm_and_si128(data, _mm_set1_epi16(short(0xf800)));
+    const __m128i invalid = _mm_or_si128(_mm_cmpeq_epi16(range, _mm_setzero_si128()),
+                                         _mm_cmpeq_epi16(range, _mm_set1_epi16(short(0xd800))));
+    if (_mm_movemask_epi8(invalid))
+        return false;
+
+    const __m128i lead = _mm_or_si128(_mm_srli_epi16(data, 12), _mm_set1_epi16(0xe0));
+    const __m128i cont1 = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(data, 6), _mm_set1_epi16(0x3f)),
+                                       _mm_set1_epi16(0x80));
+    const __m128i cont2 = _mm_or_si128(_mm_and_si128(data, _mm_set1_epi16(0x3f)),
+                                       _mm_set1_epi16(0x80));
+
+    // leadCont1 holds the lead bytes in its low half and the first continuation bytes in the
+    // high one; interleave them with the second continuation bytes
+    const __m128i leadCont1 = _mm_packus_epi16(lead, cont1);
+    const __m128i cont2x2 = _mm_packus_epi16(cont2, cont2);
+    const __m128i out1 = _mm_or_si128(
+            _mm_shuffle_epi8(leadCont1, _mm_setr_epi8(0, 8, -1, 1, 9, -1, 2, 10,
+                                                      -1, 3, 11, -1, 4, 12, -1, 5)),
+            _mm_shuffle_epi8(cont2x2, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1,
+                                                    2, -1, -1, 3, -1, -1, 4, -1)));
+    const __m128i out2 = _mm_or_si128(
+            _mm_shuffle_epi8(leadCont1, _mm_setr_epi8(13, -1, 6, 14, -1, 7, 15, -1,
+                                                      -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(cont2x2, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7,
+                                                    -1, -1, -1, -1, -1, -1, -1, -1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), out1);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + 16), out2);
+    return true;
+}
+#endif // SSSE3
 #elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv is only available on Aarch64
 static inline bool simdEncodeAscii(uchar *&dst, const ushort *&nextAscii, const ushort *&src, const ushort *end)
 {
@@ -460,6 +708,172 @@ static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end,
 static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *&, const char16_t *)
 {
 }
+#define UTF8_MULTIBYTE_SIMD
+#define UTF8_MULTIBYTE_SIMD_TARGET
+
+// Number of characters in the blocks handled by simdEncodeThreeByteBlock()
+enum { ThreeByteBlockChars = 16 };
+
+static inline bool hasMultiByteSimd()
+{
+    return true;
+}
+
+// Returns one bit per lane of v, which must be all set or all clear
+static inline uint simdMovemask(uint8x16_t v)
+{
+    const uint8x8_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    return vaddv_u8(vand_u8(vget_low_u8(v), bits)) | (vaddv_u8(vand_u8(vget_high_u8(v), bits)) << 8);
+}
+
+// Decodes one half of a window for simdDecodeMultiByteWindow(): b0 has the bytes at each
+// position, b1 and b2 the two following ones, and is2 and is3 flag the lead bytes of two- and
+// three-byte sequences. Without ThreeByte, is3 must be all clear.
+template <bool ThreeByte>
+static Q_ALWAYS_INLINE uint16x8_t simdDecodeMultiByteLanes(uint8x8_t b0, uint8x8_t b1, uint8x8_t b2,
+                                                           uint8x8_t is2, uint8x8_t is3, uint16x8_t &invalid)
+{
+    const uint16x8_t low6 = vdupq_n_u16(0x3f);
+    const uint16x8_t w0 = vmovl_u8(b0);
+    const uint16x8_t twoByte = vorrq_u16(vshlq_n_u16(vandq_u16(w0, vdupq_n_u16(0x1f)), 6),
+                                         vandq_u16(vmovl_u8(b1), low6));
+    const uint16x8_t is2Lanes = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(is2)));
+    if (!ThreeByte)
+        return vbslq_u16(is2Lanes, twoByte, w0);
+
+    const uint16x8_t threeByte = vorrq_u16(
+            vorrq_u16(vshlq_n_u16(w0, 12), vshlq_n_u16(vandq_u16(vmovl_u8(b1), low6), 6)),
+            vandq_u16(vmovl_u8(b2), low6));
+    const uint16x8_t is3Lanes = vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(is3)));
+
+    // reject overlong three-byte sequences (below U+0800) and surrogates
+    const uint16x8_t range = vandq_u16(threeByte, vdupq_n_u16(0xf800));
+    invalid = vorrq_u16(invalid, vandq_u16(is3Lanes, vorrq_u16(vceqzq_u16(range),
+                                                               vceqq_u16(range, vdupq_n_u16(0xd800)))));
+
+    return vbslq_u16(is3Lanes, threeByte, vbslq_u16(is2Lanes, twoByte, w0));
+}
+
+// Decodes the UTF-8 sequences starting in the sixteen bytes at src, if they're all US-ASCII or
+// two- and three-byte sequences (that is, up to U+FFFF); the last ones may end in the two
+// following bytes. Needs eighteen readable bytes at src and writes sixteen characters' worth
+// at dst. Returns the number of characters decoded and advances src past them, or returns 0
+// if the bytes contain anything else, like four-byte sequences or invalid UTF-8.
+static Q_ALWAYS_INLINE qsizetype simdDecodeMultiByteWindow(ushort *dst, const uchar *&src)
+{
+    const uint8x16_t data = vld1q_u8(src);
+    const uint8x16_t isAscii = vcltq_u8(data, vdupq_n_u8(0x80));
+    const uint8x16_t isCont = vceqq_u8(vandq_u8(data, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80));
+    // 0xC0 and 0xC1 can only start overlong sequences
+    const uint8x16_t isLead2 = vandq_u8(vcgeq_u8(data, vdupq_n_u8(0xc2)), vcleq_u8(data, vdupq_n_u8(0xdf)));
+    const uint8x16_t isLead3 = vceqq_u8(vandq_u8(data, vdupq_n_u8(0xf0)), vdupq_n_u8(0xe0));
+    const uint lead2 = simdMovemask(isLead2);
+    const uint lead3 = simdMovemask(isLead3);
+    const uint cont = simdMovemask(isCont)
+            | ((src[16] & 0xc0) == 0x80 ? 0x10000 : 0) | ((src[17] & 0xc0) == 0x80 ? 0x20000 : 0);
+
+    // every byte must be one of those, and exactly the bytes following the lead bytes must be
+    // continuation bytes (the two bytes after the window only matter if a sequence needs them)
+    const uint expectedCont = (lead2 << 1) | (lead3 << 1) | (lead3 << 2);
+    if (((simdMovemask(isAscii) | lead2 | lead3 | cont) & 0xffff) != 0xffff
+            || (cont & (expectedCont | 0xffff)) != expectedCont)
+        return 0;
+
+    const uint8x16_t next1 = vld1q_u8(src + 1);
+    const uint8x16_t next2 = vld1q_u8(src + 2);
+    uint16x8_t invalid = vdupq_n_u16(0);
+    uint16x8_t low, high;
+    if (lead3) {
+        low = simdDecodeMultiByteLanes<true>(vget_low_u8(data), vget_low_u8(next1), vget_low_u8(next2),
+                                             vget_low_u8(isLead2), vget_low_u8(isLead3), invalid);
+        high = simdDecodeMultiByteLanes<true>(vget_high_u8(data), vget_high_u8(next1), vget_high_u8(next2),
+                                              vget_high_u8(isLead2), vget_high_u8(isLead3), invalid);
+        if (vmaxvq_u16(invalid))
+            return 0;
+    } else {
+        low = simdDecodeMultiByteLanes<false>(vget_low_u8(data), vget_low_u8(next1), vget_low_u8(next2),
+                                              vget_low_u8(isLead2), vget_low_u8(isLead3), invalid);
+        high = simdDecodeMultiByteLanes<false>(vget_high_u8(data), vget_high_u8(next1), vget_high_u8(next2),
+                                               vget_high_u8(isLead2), vget_high_u8(isLead3), invalid);
+    }
+
+    // drop the lanes of the continuation bytes
+    const uint lowCont = cont & 0xff;
+    const uint highCont = (cont >> 8) & 0xff;
+    const qsizetype lowSize = utf8DecodeShuffleTable.sizes[lowCont] / 2;
+    vst1q_u16(dst, vreinterpretq_u16_u8(vqtbl1q_u8(vreinterpretq_u8_u16(low),
+                                                   vld1q_u8(utf8DecodeShuffleTable.masks[lowCont]))));
+    vst1q_u16(dst + lowSize, vreinterpretq_u16_u8(vqtbl1q_u8(vreinterpretq_u8_u16(high),
+                                                             vld1q_u8(utf8DecodeShuffleTable.masks[highCont]))));
+
+    // skip the continuation bytes past the window
+    const uint tail = expectedCont >> 16;
+    src += 16 + (tail & 1) + (tail >> 1);
+    return lowSize + utf8DecodeShuffleTable.sizes[highCont] / 2;
+}
+
+// Encodes the eight characters at src as UTF-8 if none of them is a surrogate. Writes 28
+// bytes' worth at dst and returns the number of bytes produced, or returns 0 if there's a
+// surrogate.
+static Q_ALWAYS_INLINE qsizetype simdEncodeMultiByteWindow(uchar *dst, const ushort *src)
+{
+    const uint16x8_t data = vld1q_u16(src);
+    const uint16x8_t range = vandq_u16(data, vdupq_n_u16(0xf800));
+    if (vmaxvq_u16(vceqq_u16(range, vdupq_n_u16(0xd800))))
+        return 0;
+
+    // the bytes of each sequence: the lead byte, then the first and the second continuation
+    // byte for three-byte sequences or just the last one otherwise
+    const uint16x8_t isAscii = vcltq_u16(data, vdupq_n_u16(0x80));
+    const uint16x8_t isSmall = vceqzq_u16(range);
+    const uint16x8_t lastCont = vorrq_u16(vandq_u16(data, vdupq_n_u16(0x3f)), vdupq_n_u16(0x80));
+    const uint16x8_t firstCont = vorrq_u16(vandq_u16(vshrq_n_u16(data, 6), vdupq_n_u16(0x3f)), vdupq_n_u16(0x80));
+    const uint16x8_t lead = vbslq_u16(isSmall, vorrq_u16(vshrq_n_u16(data, 6), vdupq_n_u16(0xc0)),
+                                      vorrq_u16(vshrq_n_u16(data, 12), vdupq_n_u16(0xe0)));
+    const uint32x2_t first = vreinterpret_u32_u8(vmovn_u16(vbslq_u16(isAscii, data, lead)));
+    const uint32x2_t second = vreinterpret_u32_u8(vmovn_u16(vbslq_u16(isSmall, lastCont, firstCont)));
+    const uint32x2_t third = vreinterpret_u32_u8(vmovn_u16(lastCont));
+
+    // lay out four characters per register as utf8EncodeShuffleTable expects
+    const uint8x16_t low = vreinterpretq_u8_u32(vcombine_u32(vzip1_u32(first, second), third));
+    const uint8x16_t high = vreinterpretq_u8_u32(vcombine_u32(vzip2_u32(first, second), vext_u32(third, third, 1)));
+
+    const uint16x8_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    const uint ascii = vaddvq_u16(vandq_u16(isAscii, bits));
+    const uint threeByte = vaddvq_u16(vbicq_u16(bits, isSmall));
+    const uint lowMask = (ascii & 0xf) | ((threeByte & 0xf) << 4);
+    const uint highMask = ((ascii >> 4) & 0xf) | (threeByte & 0xf0);
+    const qsizetype lowSize = utf8EncodeShuffleTable.sizes[lowMask];
+    vst1q_u8(dst, vqtbl1q_u8(low, vld1q_u8(utf8EncodeShuffleTable.masks[lowMask])));
+    vst1q_u8(dst + lowSize, vqtbl1q_u8(high, vld1q_u8(utf8EncodeShuffleTable.masks[highMask])));
+    return lowSize + utf8EncodeShuffleTable.sizes[highMask];
+}
+
+// Encodes sixteen characters from U+0800 to U+FFFF, except surrogates, at src as UTF-8 into
+// the 48 bytes at dst. Returns false, without writing anything, if any character is outside
+// that range.
+static inline bool simdEncodeThreeByteBlock(uchar *dst, const ushort *src)
+{
+    const uint16x8_t data1 = vld1q_u16(src);
+    const uint16x8_t data2 = vld1q_u16(src + 8);
+    const auto isInvalid = [](uint16x8_t data) {
+        const uint16x8_t range = vandq_u16(data, vdupq_n_u16(0xf800));
+        return vorrq_u16(vceqzq_u16(range), vceqq_u16(range, vdupq_n_u16(0xd800)));
+    };
+    if (vmaxvq_u16(vorrq_u16(isInvalid(data1), isInvalid(data2))))
+        return false;
+
+    const auto bits = [&](int shift) {
+        const int16x8_t shift16 = vdupq_n_s16(-shift);
+        return vcombine_u8(vmovn_u16(vshlq_u16(data1, shift16)), vmovn_u16(vshlq_u16(data2, shift16)));
+    };
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(bits(12), vdupq_n_u8(0xe0));
+    out.val[1] = vorrq_u8(vandq_u8(bits(6), vdupq_n_u8(0x3f)), vdupq_n_u8(0x80));
+    out.val[2] = vorrq_u8(vandq_u8(bits(0), vdupq_n_u8(0x3f)), vdupq_n_u8(0x80));
+    vst3q_u8(dst, out);
+    return true;
+}
 #else
 static inline bool simdEncodeAscii(uchar *, const ushort *, const ushort *, const ushort *)
 {
@@ -482,6 +896,133 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+#ifdef UTF8_MULTIBYTE_SIMD
+template <typename Output, typename Input>
+struct MultiByteSimdResult
+{
+    Output *dst;
+    const Input *src;
+    const Input *nextAttempt;   // if src didn't move: where trying again is worth it
+};
+
+// Decodes text with two- and three-byte UTF-8 sequences, like Cyrillic or CJK text, possibly
+// mixed with US-ASCII, sixteen bytes at a time. Returns where it stopped. This is kept out of
+// line and takes and returns the pointers by value, so the callers' scalar loops stay small
+// and can keep theirs in registers.
+template <bool WriteOutput>
+UTF8_MULTIBYTE_SIMD_TARGET
+static MultiByteSimdResult<ushort, uchar> simdDecodeMultiByteImpl(ushort *dst, const uchar *src, const uchar *end)
+{
+    const uchar *const start = src;
+    while (end - src >= 18) {
+        const uchar *windowStart = src;
+        const qsizetype n = simdDecodeMultiByteWindow(dst, src);
+        if (!n)
+            break;
+        if (WriteOutput)
+            dst += n;
+        if (n == src - windowStart)
+            break;  // all US-ASCII, let simdDecodeAscii() take over
+    }
+    return { dst, src, start + 16 };
+}
+
+// If no block could be decoded at src, sets nextMultiByte to where the next attempt is worth
+// making, so text that doesn't fit the blocks doesn't get checked for every character.
+// The CPU check is done here, outside of the functions built for the SIMD target.
+static inline bool simdDecodeMultiByte(ushort *&dst, const uchar *&nextMultiByte, const uchar *&src, const uchar *end)
+{
+    if (!hasMultiByteSimd()) {
+        nextMultiByte = end;
+        return false;
+    }
+    const auto result = simdDecodeMultiByteImpl<true>(dst, src, end);
+    if (result.src == src) {
+        nextMultiByte = result.nextAttempt;
+        return false;
+    }
+    dst = result.dst;
+    src = result.src;
+    return true;
+}
+
+static inline bool simdValidateMultiByte(const uchar *&nextMultiByte, const uchar *&src, const uchar *end)
+{
+    if (!hasMultiByteSimd()) {
+        nextMultiByte = end;
+        return false;
+    }
+    ushort buffer[16];
+    const auto result = simdDecodeMultiByteImpl<false>(buffer, src, end);
+    if (result.src == src) {
+        nextMultiByte = result.nextAttempt;
+        return false;
+    }
+    src = result.src;
+    return true;
+}
+
+// Encodes text up to U+FFFF, eight characters at a time or a block at a time for runs of
+// characters that all need three bytes, like CJK text. See simdDecodeMultiByteImpl().
+UTF8_MULTIBYTE_SIMD_TARGET
+static MultiByteSimdResult<uchar, ushort> simdEncodeMultiByteImpl(uchar *dst, const ushort *src, const ushort *end)
+{
+    const ushort *const start = src;
+    // the windows write up to 28 bytes, while the output has room for three per character
+    while (end - src >= 10) {
+        if (end - src >= ThreeByteBlockChars && *src >= 0x800 && src[ThreeByteBlockChars - 1] >= 0x800
+                && simdEncodeThreeByteBlock(dst, src)) {
+            dst += 3 * ThreeByteBlockChars;
+            src += ThreeByteBlockChars;
+            continue;
+        }
+
+        const qsizetype n = simdEncodeMultiByteWindow(dst, src);
+        if (!n)
+            break;
+        dst += n;
+        src += 8;
+        if (n == 8)
+            break;  // all US-ASCII, let simdEncodeAscii() take over
+    }
+    return { dst, src, start + 8 };
+}
+
+static inline bool simdEncodeMultiByte(uchar *&dst, const ushort *&nextMultiByte, const ushort *&src, const ushort *end)
+{
+    if (!hasMultiByteSimd()) {
+        nextMultiByte = end;
+        return false;
+    }
+    const auto result = simdEncodeMultiByteImpl(dst, src, end);
+    if (result.src == src) {
+        nextMultiByte = result.nextAttempt;
+        return false;
+    }
+    dst = result.dst;
+    src = result.src;
+    return true;
+}
+#else
+static inline bool simdDecodeMultiByte(ushort *, const uchar *&nextMultiByte, const uchar *, const uchar *end)
+{
+    nextMultiByte = end;
+    return false;
+}
+
+static inline bool simdValidateMultiByte(const uchar *&nextMultiByte, const uchar *, const uchar *end)
+{
+    nextMultiByte = end;
+    return false;
+}
+
+static inline bool simdEncodeMultiByte(uchar *, const ushort *&nextMultiByte, const ushort *, const ushort *end)
+{
+    nextMultiByte = end;
+    return false;
+}
+#endif
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -494,12 +1035,16 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
     const ushort *src = reinterpret_cast<const ushort *>(in.data());
     const ushort *const end = src + len;
 
+    const ushort *nextMultiByte = src;
     while (src != end) {
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
 
         do {
+            if (Q_UNLIKELY(src >= nextMultiByte) && simdEncodeMultiByte(dst, nextMultiByte, src, end))
+                continue;
+
             ushort u = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, dst, src, end);
             if (res < 0) {
@@ -561,12 +1106,16 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         }
     }
 
+    const ushort *nextMultiByte = src;
     while (src != end) {
         const ushort *nextAscii = end;
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
 
         do {
+            if (Q_UNLIKELY(src >= nextMultiByte) && simdEncodeMultiByte(cursor, nextMultiByte, src, end))
+                continue;
+
             ushort uc = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
             if (Q_LIKELY(res >= 0))
@@ -648,12 +1197,16 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             src += 3;
         }
 
+        const uchar *nextMultiByte = src;
         while (src < end) {
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
 
             do {
+                if (Q_UNLIKELY(src >= nextMultiByte) && simdDecodeMultiByte(dst, nextMultiByte, src, end))
+                    continue;
+
                 uchar b = *src++;
                 int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end);
                 if (res < 0) {
@@ -753,9 +1306,12 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     // main body, stateless decoding
     res = 0;
     const uchar *nextAscii = src;
+    const uchar *nextMultiByte = src;
     while (res >= 0 && src < end) {
         if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
             break;
+        if (Q_UNLIKELY(src >= nextMultiByte) && simdDecodeMultiByte(dst, nextMultiByte, src, end))
+            continue;
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -800,6 +1356,7 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
     const uchar *src = reinterpret_cast<const uchar *>(in.data());
     const uchar *end = src + in.size();
     const uchar *nextAscii = src;
+    const uchar *nextMultiByte = src;
     bool isValidAscii = true;
 
     while (src < end) {
@@ -809,6 +1366,11 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
             break;
 
         do {
+            if (Q_UNLIKELY(src >= nextMultiByte) && simdValidateMultiByte(nextMultiByte, src, end)) {
+                isValidAscii = false;
+                continue;
+            }
+
             uchar b = *src++;
             if ((b & 0x80) == 0)
                 continue;
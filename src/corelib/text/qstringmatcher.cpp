@@ -128,6 +128,226 @@ static inline qsizetype bm_find(QStringView haystack, qsizetype index, QStringVi
     return -1; // not found
 }
 
+/*
+    The SIMD search compares two characters of the needle, at firstPos and lastPos, with the
+    characters at the same offsets of several candidate positions of the haystack at once, and
+    only compares the whole needle where both match. Longer needles are left to Boyer-Moore,
+    which skips further ahead with them. For case-insensitive searches it can only
+    use needle characters whose case folding is in US-ASCII: the only other characters folding
+    to those are the upper case letters, U+017F LATIN SMALL LETTER LONG S and U+212A KELVIN
+    SIGN, so the vector code can check for them.
+*/
+enum { SimdFindMaxNeedleLength = 32 };
+
+static bool simd_find_usable(QStringView needle, Qt::CaseSensitivity cs,
+                             qsizetype &firstPos, qsizetype &lastPos)
+{
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+    const char16_t *puc = needle.utf16();
+    const qsizetype pl = needle.size();
+    if (pl == 0 || pl > SimdFindMaxNeedleLength)
+        return false;
+
+    if (cs == Qt::CaseSensitive) {
+        firstPos = 0;
+        lastPos = pl - 1;
+        return true;
+    }
+
+    for (firstPos = 0; firstPos < pl; ++firstPos) {
+        if (foldCase(puc + firstPos, puc) < 0x80)
+            break;
+    }
+    if (firstPos == pl)
+        return false;
+    for (lastPos = pl - 1; foldCase(puc + lastPos, puc) >= 0x80; --lastPos)
+        ;
+    return true;
+#else
+    Q_UNUSED(needle);
+    Q_UNUSED(cs);
+    Q_UNUSED(firstPos);
+    Q_UNUSED(lastPos);
+    return false;
+#endif
+}
+
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+/*
+    Text made to pass the filter at most positions, like runs of the needle's first and last
+    characters, would make the SIMD search compare the whole needle almost everywhere. It
+    gives up once that has cost more than a few times the text it got through, and lets
+    Boyer-Moore continue from there.
+*/
+static inline bool simd_find_give_up(qsizetype misses, qsizetype pl, qsizetype searched)
+{
+    return misses * pl > 4 * searched + 256;
+}
+
+static qsizetype simd_find_fallback(QStringView haystack, qsizetype index, QStringView needle,
+                                    const uchar *skiptable, Qt::CaseSensitivity cs)
+{
+    uchar localSkiptable[256];
+    if (!skiptable) {
+        bm_init_skiptable(needle, localSkiptable, cs);
+        skiptable = localSkiptable;
+    }
+    return bm_find(haystack, index, needle, skiptable, cs);
+}
+
+static inline char16_t nonAsciiCaseVariant(char16_t folded)
+{
+    if (folded == u's')
+        return 0x17f;
+    if (folded == u'k')
+        return 0x212a;
+    return folded;
+}
+
+static inline bool simd_matches(const char16_t *candidate, const char16_t *uc, QStringView needle,
+                                Qt::CaseSensitivity cs)
+{
+    const char16_t *puc = needle.utf16();
+    if (cs == Qt::CaseSensitive)
+        return memcmp(candidate, puc, needle.size() * sizeof(char16_t)) == 0;
+
+    for (qsizetype i = 0; i < needle.size(); ++i) {
+        if (foldCase(candidate + i, uc) != foldCase(puc + i, puc))
+            return false;
+    }
+    return true;
+}
+
+#  ifdef __SSE2__
+static inline __m128i simd_fold_ascii(__m128i data)
+{
+    const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi16(data, _mm_set1_epi16('A' - 1)),
+                                          _mm_cmplt_epi16(data, _mm_set1_epi16('Z' + 1)));
+    return _mm_or_si128(data, _mm_and_si128(isUpper, _mm_set1_epi16(0x20)));
+}
+
+// Returns two bits for each of the eight candidates at n that have the needle's characters
+// at firstPos and lastPos
+template <Qt::CaseSensitivity cs>
+static inline uint simd_candidates(const char16_t *n, qsizetype firstPos, qsizetype lastPos,
+                                   __m128i first, __m128i firstVariant,
+                                   __m128i last, __m128i lastVariant)
+{
+    __m128i atFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n + firstPos));
+    __m128i atLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(n + lastPos));
+    __m128i match;
+    if (cs == Qt::CaseSensitive) {
+        match = _mm_and_si128(_mm_cmpeq_epi16(atFirst, first), _mm_cmpeq_epi16(atLast, last));
+    } else {
+        atFirst = simd_fold_ascii(atFirst);
+        atLast = simd_fold_ascii(atLast);
+        match = _mm_and_si128(
+                _mm_or_si128(_mm_cmpeq_epi16(atFirst, first), _mm_cmpeq_epi16(atFirst, firstVariant)),
+                _mm_or_si128(_mm_cmpeq_epi16(atLast, last), _mm_cmpeq_epi16(atLast, lastVariant)));
+    }
+    return uint(_mm_movemask_epi8(match));
+}
+#  else
+static inline uint16x8_t simd_fold_ascii(uint16x8_t data)
+{
+    const uint16x8_t isUpper = vcleq_u16(vsubq_u16(data, vdupq_n_u16('A')), vdupq_n_u16('Z' - 'A'));
+    return vorrq_u16(data, vandq_u16(isUpper, vdupq_n_u16(0x20)));
+}
+
+// Returns two bits for each of the eight candidates at n that have the needle's characters
+// at firstPos and lastPos
+template <Qt::CaseSensitivity cs>
+static inline uint simd_candidates(const char16_t *n, qsizetype firstPos, qsizetype lastPos,
+                                   uint16x8_t first, uint16x8_t firstVariant,
+                                   uint16x8_t last, uint16x8_t lastVariant)
+{
+    const uint16x8_t vmask = { 3, 3 << 2, 3 << 4, 3 << 6, 3 << 8, 3 << 10, 3 << 12, 3 << 14 };
+    uint16x8_t atFirst = vld1q_u16(reinterpret_cast<const uint16_t *>(n + firstPos));
+    uint16x8_t atLast = vld1q_u16(reinterpret_cast<const uint16_t *>(n + lastPos));
+    uint16x8_t match;
+    if (cs == Qt::CaseSensitive) {
+        match = vandq_u16(vceqq_u16(atFirst, first), vceqq_u16(atLast, last));
+    } else {
+        atFirst = simd_fold_ascii(atFirst);
+        atLast = simd_fold_ascii(atLast);
+        match = vandq_u16(vorrq_u16(vceqq_u16(atFirst, first), vceqq_u16(atFirst, firstVariant)),
+                          vorrq_u16(vceqq_u16(atLast, last), vceqq_u16(atLast, lastVariant)));
+    }
+    return vaddvq_u16(vandq_u16(match, vmask));
+}
+#  endif
+
+template <Qt::CaseSensitivity cs>
+static qsizetype simd_find_impl(QStringView haystack, qsizetype index, QStringView needle,
+                                qsizetype firstPos, qsizetype lastPos, const uchar *skiptable)
+{
+    const char16_t *uc = haystack.utf16();
+    const char16_t *puc = needle.utf16();
+    const char16_t *const start = uc + index;
+    const char16_t *n = start;
+    const char16_t *const lastCandidate = uc + haystack.size() - needle.size();
+
+    char16_t firstChar = puc[firstPos];
+    char16_t lastChar = puc[lastPos];
+    if (cs == Qt::CaseInsensitive) {
+        firstChar = char16_t(foldCase(puc + firstPos, puc));
+        lastChar = char16_t(foldCase(puc + lastPos, puc));
+    }
+#  ifdef __SSE2__
+    const __m128i first = _mm_set1_epi16(firstChar);
+    const __m128i firstVariant = _mm_set1_epi16(nonAsciiCaseVariant(firstChar));
+    const __m128i last = _mm_set1_epi16(lastChar);
+    const __m128i lastVariant = _mm_set1_epi16(nonAsciiCaseVariant(lastChar));
+#  else
+    const uint16x8_t first = vdupq_n_u16(firstChar);
+    const uint16x8_t firstVariant = vdupq_n_u16(nonAsciiCaseVariant(firstChar));
+    const uint16x8_t last = vdupq_n_u16(lastChar);
+    const uint16x8_t lastVariant = vdupq_n_u16(nonAsciiCaseVariant(lastChar));
+#  endif
+
+    // we're going to check the candidates n[0..7], reading up to n[lastPos + 7]
+    qsizetype misses = 0;
+    for ( ; lastCandidate - n >= 7; n += 8) {
+        uint mask = simd_candidates<cs>(n, firstPos, lastPos, first, firstVariant, last, lastVariant);
+        while (mask) {
+            const uint idx = qCountTrailingZeroBits(mask) / 2;
+            if (simd_matches(n + idx, uc, needle, cs))
+                return n + idx - uc;
+            mask &= ~(3U << (2 * idx));
+            if (Q_UNLIKELY(simd_find_give_up(++misses, needle.size(), n - start)))
+                return simd_find_fallback(haystack, n - uc, needle, skiptable, cs);
+        }
+    }
+
+    for ( ; n <= lastCandidate; ++n) {
+        if (simd_matches(n, uc, needle, cs))
+            return n - uc;
+    }
+    return -1;
+}
+#endif
+
+// skiptable may be null, then it's only built if the search falls back to Boyer-Moore
+static qsizetype simd_find(QStringView haystack, qsizetype index, QStringView needle,
+                           Qt::CaseSensitivity cs, qsizetype firstPos, qsizetype lastPos,
+                           const uchar *skiptable = nullptr)
+{
+    if (index > haystack.size() - needle.size())
+        return -1;
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+    if (cs == Qt::CaseSensitive)
+        return simd_find_impl<Qt::CaseSensitive>(haystack, index, needle, firstPos, lastPos, skiptable);
+    return simd_find_impl<Qt::CaseInsensitive>(haystack, index, needle, firstPos, lastPos, skiptable);
+#else
+    Q_UNUSED(cs);
+    Q_UNUSED(firstPos);
+    Q_UNUSED(lastPos);
+    Q_UNUSED(skiptable);
+    Q_UNREACHABLE(); // simd_find_usable() returned false
+    return -1;
+#endif
+}
+
 void QStringMatcher::updateSkipTable()
 {
     bm_init_skiptable(q_sv, q_skiptable, q_cs);
@@ -310,6 +530,9 @@ qsizetype QStringMatcher::indexIn(QStringView str, qsizetype from) const
 {
     if (from < 0)
         from = 0;
+    qsizetype firstPos, lastPos;
+    if (simd_find_usable(q_sv, q_cs, firstPos, lastPos))
+        return simd_find(str, from, q_sv, q_cs, firstPos, lastPos, q_skiptable);
     return bm_find(str, from, q_sv, q_skiptable, q_cs);
 }
 
@@ -48,6 +48,7 @@
 
 #include "qthread_p.h"
 #include "private/qcoreapplication_p.h"
+#include "private/qeventloopstatistics_p.h"
 
 #include <limits>
 
@@ -57,6 +58,48 @@ QT_BEGIN_NAMESPACE
   QThreadData
 */
 
+/*
+    Moves the events pushed by QCoreApplication::postEvent() onto the
+    lock-free stack into the sorted list, in the order they were posted,
+    giving the application the chance to compress them as postEvent() would
+    have. Events whose receiver has meanwhile been moved to \a movedTo go to
+    that thread's list instead, whose mutex must be locked as well. Returns
+    the number of such events.
+*/
+int QPostEventList::mergeIncoming(QThreadData *movedTo)
+{
+    IncomingEvent *node = incoming.exchange(nullptr, std::memory_order_acquire);
+
+    // the stack is LIFO, reverse it to restore the posting order
+    IncomingEvent *head = nullptr;
+    while (node) {
+        IncomingEvent *next = node->next;
+        node->next = head;
+        head = node;
+        node = next;
+    }
+
+    int moved = 0;
+    while (head) {
+        QObjectPrivate *d = QObjectPrivate::get(head->receiver);
+        QPostEventList *list = this;
+        if (movedTo && d->threadData.loadRelaxed() == movedTo) {
+            list = &movedTo->postEventList;
+            ++moved;
+        }
+        if (!QCoreApplicationPrivate::compressPostedEvent(head->event, head->receiver, list)) {
+            list->addEvent(QPostEvent(head->receiver, head->event, Qt::NormalEventPriority,
+                                      head->postTime));
+            ++d->postedEvents;
+        }
+
+        IncomingEvent *next = head->next;
+        delete head;
+        head = next;
+    }
+    return moved;
+}
+
 QThreadData::QThreadData(int initialRefCount)
     : _ref(initialRefCount), loopLevel(0), scopeLevel(0),
       eventDispatcher(nullptr),
@@ -93,6 +136,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    postEventList.mergeIncoming();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -102,6 +146,9 @@ QThreadData::~QThreadData()
         }
     }
 
+    if (eventLoopStatistics)
+        QEventLoopStatistics::threadFinished(eventLoopStatistics.get());
+
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
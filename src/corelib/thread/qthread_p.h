@@ -66,11 +66,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
 class QAbstractEventDispatcher;
 class QEventLoop;
+class QThreadData;
+struct QEventLoopStatisticsData;
 
 class QPostEvent
 {
@@ -78,11 +81,12 @@ public:
     QObject *receiver;
     QEvent *event;
     int priority;
+    qint64 postTime; // see QEventLoopStatistics::timestamp()
     inline QPostEvent()
-        : receiver(nullptr), event(nullptr), priority(0)
+        : receiver(nullptr), event(nullptr), priority(0), postTime(0)
     { }
-    inline QPostEvent(QObject *r, QEvent *e, int p)
-        : receiver(r), event(e), priority(p)
+    inline QPostEvent(QObject *r, QEvent *e, int p, qint64 t = 0)
+        : receiver(r), event(e), priority(p), postTime(t)
     { }
 };
 Q_DECLARE_TYPEINFO(QPostEvent, Q_RELOCATABLE_TYPE);
@@ -107,7 +111,45 @@ public:
 
     QMutex mutex;
 
-    inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
+    // Events posted with Qt::NormalEventPriority that can never be compressed
+    // are pushed onto this lock-free stack instead of taking the mutex.
+    // Whoever holds the mutex moves them into the sorted list with
+    // mergeIncoming() before looking at it.
+    struct IncomingEvent
+    {
+        IncomingEvent *next;
+        QObject *receiver;
+        QEvent *event;
+        qint64 postTime;
+    };
+    std::atomic<IncomingEvent *> incoming;
+
+    inline QPostEventList()
+        : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0),
+          incoming(nullptr)
+    { }
+
+    bool hasIncoming() const
+    {
+        return incoming.load(std::memory_order_acquire) != nullptr;
+    }
+
+    void pushIncoming(IncomingEvent *node)
+    {
+        IncomingEvent *head = incoming.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!incoming.compare_exchange_weak(head, node, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    }
+
+    // must be called with the mutex locked
+    void mergeIncoming()
+    {
+        if (hasIncoming())
+            mergeIncoming(nullptr);
+    }
+    int mergeIncoming(QThreadData *movedTo);
 
     void addEvent(const QPostEvent &ev)
     {
@@ -257,7 +299,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncoming();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -294,6 +336,8 @@ public:
     QAtomicPointer<QAbstractEventDispatcher> eventDispatcher;
     QList<void *> tls;
     FlaggedDebugSignatures flaggedSignatures;
+    // created on first use by QEventLoopStatistics, in this thread
+    std::shared_ptr<QEventLoopStatisticsData> eventLoopStatistics;
 
     bool quitNow;
     bool canWait;
@@ -42,6 +42,8 @@
 #include "qdeadlinetimer.h"
 #include "qcoreapplication.h"
 
+#include <qtcore_tracepoints_p.h>
+
 #include <algorithm>
 
 QT_BEGIN_NAMESPACE
@@ -96,6 +98,7 @@ void QThreadPoolThread::run()
 #ifndef QT_NO_EXCEPTIONS
                 try {
 #endif
+                    Q_TRACE_SCOPE(QThreadPool_runTask, r);
                     r->run();
 #ifndef QT_NO_EXCEPTIONS
                 } catch (...) {
@@ -390,7 +393,10 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     // If autoDelete() is false, runnable might already be deleted after run(), so check status now.
     const bool del = runnable->autoDelete();
 
-    runnable->run();
+    {
+        Q_TRACE_SCOPE(QThreadPool_runTask, runnable);
+        runnable->run();
+    }
 
     if (del)
         delete runnable;
@@ -57,6 +57,7 @@
 #include <private/qfontengine_p.h>
 #include <private/qpainter_p.h>
 #include <private/qtextengine_p.h>
+#include <private/qshapedtextcache_p.h>
 #include <limits.h>
 
 #include <qpa/qplatformscreen.h>
@@ -2867,17 +2868,30 @@ static QBasicAtomicInt font_cache_id = Q_BASIC_ATOMIC_INITIALIZER(0);
 QFontCache::QFontCache()
     : QObject(), total_cost(0), max_cost(min_cost),
       current_timestamp(0), fast(false), timer_id(-1),
-      m_id(font_cache_id.fetchAndAddRelaxed(1) + 1)
+      m_id(font_cache_id.fetchAndAddRelaxed(1) + 1),
+      m_shapedTextCache(nullptr)
 {
 }
 
 QFontCache::~QFontCache()
 {
     clear();
+    delete m_shapedTextCache;
+}
+
+QShapedTextCache *QFontCache::shapedTextCache()
+{
+    if (!m_shapedTextCache)
+        m_shapedTextCache = new QShapedTextCache;
+    return m_shapedTextCache;
 }
 
 void QFontCache::clear()
 {
+    // shaped text holds references to engines, drop them first
+    if (m_shapedTextCache)
+        m_shapedTextCache->clear();
+
     {
         EngineDataCache::Iterator it = engineDataCache.begin(),
                                  end = engineDataCache.end();
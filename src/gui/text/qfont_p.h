@@ -65,6 +65,7 @@ QT_BEGIN_NAMESPACE
 // forwards
 class QFontCache;
 class QFontEngine;
+class QShapedTextCache;
 
 #define QFONT_WEIGHT_MIN 1
 #define QFONT_WEIGHT_MAX 1000
@@ -233,6 +234,8 @@ public:
 
     void clear();
 
+    QShapedTextCache *shapedTextCache();
+
     struct Key {
         Key() : script(0), multi(0) { }
         Key(const QFontDef &d, uchar c, bool m = 0)
@@ -297,6 +300,7 @@ private:
     bool fast;
     int timer_id;
     const int m_id;
+    QShapedTextCache *m_shapedTextCache;
 };
 
 Q_GUI_EXPORT int qt_defaultDpiX();
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qshapedtextcache_p.h"
+
+#include "qfont_p.h"
+#include "qfontengine_p.h"
+#include "qtextengine_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QShapedTextCache
+
+    QShapedTextCache remembers the glyphs, advances, log clusters and metrics
+    produced by QTextEngine::shapeText() for short script items, so that
+    identical strings shaped by different QTextLayout instances, or painted
+    repeatedly with QPainter::drawText(), do not go through HarfBuzz again.
+
+    Entries are keyed on the item text, the font engine used for shaping and
+    every option that influences the shaping result. Each entry keeps a
+    reference to its font engine, so the engine pointer in the key stays
+    unique for as long as the entry lives.
+
+    Like QFontCache, which owns it, the cache is per thread, because font
+    engines are never shared between threads. The size of the cache can be
+    changed with the \c QT_SHAPED_TEXT_CACHE_SIZE environment variable, in
+    kilobytes; a value of 0 disables it.
+*/
+
+#ifndef QSHAPEDTEXTCACHE_DEFAULT_COST
+#  define QSHAPEDTEXTCACHE_DEFAULT_COST 1024 // 1mb
+#endif
+
+QShapedTextCache::Entry::Entry(QFontEngine *engine, const QGlyphLayout &glyphs,
+                               const ushort *logClusters, int length)
+    : numGlyphs(glyphs.numGlyphs),
+      m_fontEngine(engine),
+      m_glyphData(glyphs.numGlyphs * QGlyphLayout::SpaceNeeded, Qt::Uninitialized),
+      m_logClusters(logClusters, logClusters + length)
+{
+    m_fontEngine->ref.ref();
+
+    QGlyphLayout copy(m_glyphData.data(), numGlyphs);
+    memcpy(static_cast<void *>(copy.offsets), glyphs.offsets, numGlyphs * sizeof(QFixedPoint));
+    memcpy(copy.glyphs, glyphs.glyphs, numGlyphs * sizeof(glyph_t));
+    memcpy(static_cast<void *>(copy.advances), glyphs.advances, numGlyphs * sizeof(QFixed));
+    memcpy(static_cast<void *>(copy.justifications), glyphs.justifications, numGlyphs * sizeof(QGlyphJustification));
+    memcpy(copy.attributes, glyphs.attributes, numGlyphs * sizeof(QGlyphAttributes));
+}
+
+QShapedTextCache::Entry::~Entry()
+{
+    if (!m_fontEngine->ref.deref())
+        delete m_fontEngine;
+}
+
+void QShapedTextCache::Entry::copyTo(QGlyphLayout *glyphs, ushort *logClusters) const
+{
+    Q_ASSERT(glyphs->numGlyphs >= numGlyphs);
+
+    // m_glyphData is contiguous, but the target usually isn't
+    const QGlyphLayout source(const_cast<char *>(m_glyphData.constData()), numGlyphs);
+    memcpy(static_cast<void *>(glyphs->offsets), source.offsets, numGlyphs * sizeof(QFixedPoint));
+    memcpy(glyphs->glyphs, source.glyphs, numGlyphs * sizeof(glyph_t));
+    memcpy(static_cast<void *>(glyphs->advances), source.advances, numGlyphs * sizeof(QFixed));
+    memcpy(static_cast<void *>(glyphs->justifications), source.justifications, numGlyphs * sizeof(QGlyphJustification));
+    memcpy(glyphs->attributes, source.attributes, numGlyphs * sizeof(QGlyphAttributes));
+    memcpy(logClusters, m_logClusters.constData(), m_logClusters.size() * sizeof(ushort));
+}
+
+QShapedTextCache::QShapedTextCache()
+    : m_cache(QSHAPEDTEXTCACHE_DEFAULT_COST * 1024)
+{
+    bool ok = false;
+    const int size = qEnvironmentVariableIntValue("QT_SHAPED_TEXT_CACHE_SIZE", &ok);
+    if (ok)
+        m_cache.setMaxCost(qMax(size, 0) * qsizetype(1024));
+}
+
+QShapedTextCache::~QShapedTextCache()
+{
+    clear();
+}
+
+/*!
+    \internal
+
+    Returns the shaped text cache of the calling thread.
+*/
+QShapedTextCache *QShapedTextCache::instance()
+{
+    return QFontCache::instance()->shapedTextCache();
+}
+
+/*!
+    \internal
+
+    Returns the entry stored for \a key, or \nullptr if there is none. The
+    returned entry is only valid until the next call to insert() or clear().
+*/
+const QShapedTextCache::Entry *QShapedTextCache::find(const Key &key)
+{
+    const Entry *entry = m_cache.object(key);
+    if (entry)
+        ++m_statistics.hits;
+    else
+        ++m_statistics.misses;
+    return entry;
+}
+
+/*!
+    \internal
+
+    Takes ownership of \a entry and stores it under \a key, evicting the
+    least recently used entries if the cache grows beyond maxCost(). The
+    text of \a key may be a raw data string; it is deep-copied here.
+*/
+void QShapedTextCache::insert(const Key &key, Entry *entry)
+{
+    Key ownedKey = key;
+    ownedKey.text = QString(key.text.constData(), key.text.size());
+
+    const qsizetype cost = sizeof(Entry)
+            + entry->numGlyphs * QGlyphLayout::SpaceNeeded
+            + key.text.size() * 2 * sizeof(ushort);
+
+    const qsizetype sizeBefore = m_cache.size();
+    if (!m_cache.insert(ownedKey, entry, cost))
+        return; // too big, QCache already deleted it
+    ++m_statistics.insertions;
+    m_statistics.evictions += sizeBefore + 1 - m_cache.size();
+}
+
+void QShapedTextCache::clear()
+{
+    m_cache.clear();
+}
+
+void QShapedTextCache::setMaxCost(qsizetype bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSHAPEDTEXTCACHE_P_H
+#define QSHAPEDTEXTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/private/qtguiglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include "private/qfixed_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QFontEngine;
+struct QGlyphLayout;
+
+class Q_GUI_EXPORT QShapedTextCache
+{
+public:
+    struct Key
+    {
+        QString text;
+        QFontEngine *fontEngine = nullptr;
+        QFixed letterSpacing;
+        QFixed wordSpacing;
+        uchar script = 0;
+        uchar caseFlags = 0;
+        bool rightToLeft = false;
+        bool kerning = false;
+        bool shaping = false;
+        bool letterSpacingIsAbsolute = false;
+        bool designMetrics = false;
+
+        bool operator==(const Key &other) const noexcept
+        {
+            return fontEngine == other.fontEngine
+                    && script == other.script
+                    && caseFlags == other.caseFlags
+                    && rightToLeft == other.rightToLeft
+                    && kerning == other.kerning
+                    && shaping == other.shaping
+                    && letterSpacingIsAbsolute == other.letterSpacingIsAbsolute
+                    && designMetrics == other.designMetrics
+                    && letterSpacing == other.letterSpacing
+                    && wordSpacing == other.wordSpacing
+                    && text == other.text;
+        }
+    };
+
+    class Entry
+    {
+    public:
+        Entry(QFontEngine *engine, const QGlyphLayout &glyphs,
+              const ushort *logClusters, int length);
+        ~Entry();
+
+        void copyTo(QGlyphLayout *glyphs, ushort *logClusters) const;
+
+        int numGlyphs;
+        QFixed width;
+        QFixed ascent;
+        QFixed descent;
+        QFixed leading;
+
+    private:
+        Q_DISABLE_COPY_MOVE(Entry)
+
+        QFontEngine *m_fontEngine; // we hold a reference
+        QByteArray m_glyphData;
+        QList<ushort> m_logClusters;
+    };
+
+    struct Statistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 insertions = 0;
+        quint64 evictions = 0;
+
+        qreal hitRate() const noexcept
+        {
+            const quint64 lookups = hits + misses;
+            return lookups ? qreal(hits) / qreal(lookups) : qreal(0);
+        }
+    };
+
+    // Longer items are very unlikely to repeat and would only push
+    // the short, frequently shaped strings out of the cache.
+    enum { MaxTextLength = 256 };
+
+    QShapedTextCache();
+    ~QShapedTextCache();
+
+    static QShapedTextCache *instance();
+
+    bool isEnabled() const noexcept { return m_cache.maxCost() > 0; }
+    static bool isCacheable(int length) noexcept { return length > 0 && length <= MaxTextLength; }
+
+    const Entry *find(const Key &key);
+    void insert(const Key &key, Entry *entry);
+    void clear();
+
+    qsizetype maxCost() const noexcept { return m_cache.maxCost(); }
+    void setMaxCost(qsizetype bytes);
+    qsizetype totalCost() const noexcept { return m_cache.totalCost(); }
+    qsizetype size() const noexcept { return m_cache.size(); }
+
+    Statistics statistics() const noexcept { return m_statistics; }
+    void resetStatistics() noexcept { m_statistics = Statistics(); }
+
+private:
+    Q_DISABLE_COPY_MOVE(QShapedTextCache)
+
+    QCache<Key, Entry> m_cache;
+    Statistics m_statistics;
+};
+
+inline size_t qHash(const QShapedTextCache::Key &key, size_t seed = 0) noexcept
+{
+    return qHashMulti(seed,
+                      key.text,
+                      key.fontEngine,
+                      uint(key.script) | uint(key.caseFlags) << 8
+                      | uint(key.rightToLeft) << 16 | uint(key.kerning) << 17
+                      | uint(key.shaping) << 18 | uint(key.letterSpacingIsAbsolute) << 19
+                      | uint(key.designMetrics) << 20,
+                      key.letterSpacing.value(),
+                      key.wordSpacing.value());
+}
+
+QT_END_NAMESPACE
+
+#endif // QSHAPEDTEXTCACHE_P_H
@@ -59,6 +59,9 @@
 #include <qbasictimer.h>
 #include "private/qfunctions_p.h"
 #include <qloggingcategory.h>
+#include <qsemaphore.h>
+#include <qset.h>
+#include <qthreadpool.h>
 
 #include <algorithm>
 
@@ -535,8 +538,15 @@ public:
     int lastPageCount;
     qreal idealWidth;
     bool contentHasAlignment;
+    bool parallelLayout;
+
+    // blocks whose lines were broken by layoutBlocksInParallel() and only need positioning
+    QSet<QTextLayout *> parallelLaidOutBlocks;
 
     QFixed blockIndent(const QTextBlockFormat &blockFormat) const;
+    void blockMargins(const QTextBlock &bl, const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir,
+                      QFixed *totalLeftMargin, QFixed *totalRightMargin) const;
+    QTextOption blockTextOption(const QTextBlockFormat &blockFormat, Qt::LayoutDirection dir) const;
 
     void drawFrame(const QPointF &offset, QPainter *painter, const QAbstractTextDocumentLayout::PaintContext &context,
                    QTextFrame *f) const;
@@ -581,6 +591,7 @@ public:
     void layoutBlock(const QTextBlock &bl, int blockPosition, const QTextBlockFormat &blockFormat,
                      QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, const QTextBlockFormat *previousBlockFormat);
     void layoutFlow(QTextFrame::Iterator it, QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, QFixed width = 0);
+    void layoutBlocksInParallel(QTextFrame::Iterator it, const QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo);
 
     void floatMargins(const QFixed &y, const QTextLayoutStruct *layoutStruct, QFixed *left, QFixed *right) const;
     QFixed findY(QFixed yFrom, const QTextLayoutStruct *layoutStruct, QFixed requiredWidth) const;
@@ -613,6 +624,7 @@ QTextDocumentLayoutPrivate::QTextDocumentLayoutPrivate()
     insideDocumentChange = false;
     idealWidth = 0;
     contentHasAlignment = false;
+    parallelLayout = qEnvironmentVariableIntValue("QT_TEXT_PARALLEL_LAYOUT") > 0;
 }
 
 QTextFrame::Iterator QTextDocumentLayoutPrivate::frameIteratorForYPosition(QFixed y) const
@@ -3134,6 +3146,9 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
         }
     }
 
+    if (inRootFrame && parallelLayout)
+        layoutBlocksInParallel(it, layoutStruct, layoutFrom, layoutTo);
+
     QTextBlockFormat previousBlockFormat = previousIt.currentBlock().blockFormat();
 
     QFixed maximumBlockWidth = 0;
@@ -3404,6 +3419,8 @@ void QTextDocumentLayoutPrivate::layoutFlow(QTextFrame::Iterator it, QTextLayout
             // #######
             //checkPoints.last().positionInFrame = QTextDocumentPrivate::get(q->document())->length();
         }
+
+        parallelLaidOutBlocks.clear();
     }
 
 
@@ -3430,6 +3447,220 @@ static inline void getLineHeightParams(const QTextBlockFormat &blockFormat, cons
     }
 }
 
+void QTextDocumentLayoutPrivate::blockMargins(const QTextBlock &bl, const QTextBlockFormat &blockFormat,
+                                              Qt::LayoutDirection dir, QFixed *totalLeftMargin,
+                                              QFixed *totalRightMargin) const
+{
+    QFixed extraMargin;
+    if (docPrivate->defaultTextOption.flags() & QTextOption::AddSpaceForLineAndParagraphSeparators) {
+        QFontMetricsF fm(bl.charFormat().font());
+        extraMargin = QFixed::fromReal(fm.horizontalAdvance(u'\x21B5'));
+    }
+
+    const QFixed indent = this->blockIndent(blockFormat);
+    *totalLeftMargin = QFixed::fromReal(blockFormat.leftMargin()) + (dir == Qt::RightToLeft ? extraMargin : indent);
+    *totalRightMargin = QFixed::fromReal(blockFormat.rightMargin()) + (dir == Qt::RightToLeft ? indent : extraMargin);
+}
+
+QTextOption QTextDocumentLayoutPrivate::blockTextOption(const QTextBlockFormat &blockFormat,
+                                                       Qt::LayoutDirection dir) const
+{
+    QTextOption option = docPrivate->defaultTextOption;
+    option.setTextDirection(dir);
+    option.setTabs( blockFormat.tabPositions() );
+
+    Qt::Alignment align = docPrivate->defaultTextOption.alignment();
+    if (blockFormat.hasProperty(QTextFormat::BlockAlignment))
+        align = blockFormat.alignment();
+    option.setAlignment(QGuiApplicationPrivate::visualAlignment(dir, align)); // for paragraph that are RTL, alignment is auto-reversed;
+
+    if (blockFormat.nonBreakableLines() || document->pageSize().width() < 0) {
+        option.setWrapMode(QTextOption::ManualWrap);
+    }
+    return option;
+}
+
+namespace {
+// Everything a worker thread needs to break the lines of one block; all of
+// it is computed on the layout's thread, so the worker only touches the
+// block's own QTextLayout.
+struct QParallelBlockLayoutJob
+{
+    QTextLayout *layout;
+    QTextBlockFormat blockFormat;
+    QTextOption option;
+    QFixed left;
+    QFixed right;
+    QFixed textIndent;
+    qreal scaling;
+};
+}
+
+static void breakBlockLines(QParallelBlockLayoutJob &job, const QTextEngine::FormatFonts *formatFonts)
+{
+    QTextLayout *tl = job.layout;
+    QTextOption &option = job.option;
+    const bool haveWordOrAnyWrapMode = (option.wrapMode() == QTextOption::WrapAtWordBoundaryOrAnywhere);
+    const bool leftToRight = option.textDirection() == Qt::LeftToRight;
+
+    QTextEngine *engine = tl->engine();
+    engine->formatFonts = formatFonts;
+
+    // this mirrors the line loop of layoutBlock() for a flow without floats
+    // and page breaks, with line positions relative to the top of the block
+    QFixed y;
+    tl->beginLayout();
+    bool firstLine = true;
+    while (1) {
+        QTextLine line = tl->createLine();
+        if (!line.isValid())
+            break;
+        line.setLeadingIncluded(true);
+
+        QFixed left = job.left;
+        QFixed right = job.right;
+        if (firstLine) {
+            if (leftToRight)
+                left += job.textIndent;
+            else
+                right -= job.textIndent;
+            firstLine = false;
+        }
+
+        line.setLineWidth((right - left).toReal());
+        if (QFixed::fromReal(line.naturalTextWidth()) > right - left) {
+            if (haveWordOrAnyWrapMode) {
+                option.setWrapMode(QTextOption::WrapAnywhere);
+                tl->setTextOption(option);
+            }
+            line.setLineWidth(qMax<qreal>(line.naturalTextWidth(), (right - left).toReal()));
+            if (haveWordOrAnyWrapMode) {
+                option.setWrapMode(QTextOption::WordWrap);
+                tl->setTextOption(option);
+            }
+        }
+
+        QFixed lineBreakHeight, lineHeight, lineAdjustment, lineBottom;
+        getLineHeightParams(job.blockFormat, line, job.scaling, &lineAdjustment, &lineBreakHeight, &lineHeight, &lineBottom);
+
+        line.setPosition(QPointF(left.toReal(), (y - lineAdjustment).toReal()));
+        y += lineHeight;
+    }
+    tl->endLayout();
+
+    // the font engines belong to this thread, the layout's thread loads its
+    // own ones when it draws the block
+    engine->resetFontEngineCache();
+    engine->formatFonts = nullptr;
+}
+
+/*
+    Breaks the lines of the blocks that the following layoutFlow() pass is
+    going to lay out, using the global thread pool. Shaping and line breaking
+    of a block do not depend on any other block as long as there are no
+    floats and no page breaks, so only the vertical positioning has to stay
+    sequential: layoutBlock() then treats the blocks as already laid out and
+    merely moves their lines into place.
+
+    The fonts of the char formats are resolved for the paint device up front.
+    Font engines are per thread, so every worker gets its own copy of these
+    fonts and loads its engines from them; the workers touch neither the
+    paint device nor the fonts of the format collection.
+
+    Blocks that need the document layout while being shaped (inline objects),
+    or that would write to the shared format collection (additional formats,
+    preedit text), are left to the sequential pass.
+*/
+void QTextDocumentLayoutPrivate::layoutBlocksInParallel(QTextFrame::Iterator it, const QTextLayoutStruct *layoutStruct,
+                                                        int layoutFrom, int layoutTo)
+{
+    Q_Q(QTextDocumentLayout);
+    enum { MinimumBlockCount = 32, MinimumBlocksPerThread = 8 };
+
+    parallelLaidOutBlocks.clear();
+    if (layoutStruct->pageHeight != QFIXED_MAX || fixedColumnWidth != -1
+        || !data(layoutStruct->frame)->floats.isEmpty())
+        return;
+
+    const qreal scaling = (q->paintDevice() && q->paintDevice()->logicalDpiY() != qt_defaultDpi()) ?
+                          qreal(q->paintDevice()->logicalDpiY()) / qreal(qt_defaultDpi()) : 1;
+
+    QList<QParallelBlockLayoutJob> jobs;
+    for (; !it.atEnd() && !it.currentFrame(); ++it) {
+        const QTextBlock block = it.currentBlock();
+        const int blockPosition = block.position();
+        if (currentLazyLayoutPosition != -1
+            && blockPosition > currentLazyLayoutPosition + lazyLayoutStepSize)
+            break;
+        if (!layoutStruct->fullLayout && blockPosition > layoutTo)
+            break;
+        if (!block.isVisible())
+            continue;
+        if (!layoutStruct->fullLayout && blockPosition + block.length() <= layoutFrom)
+            continue;
+
+        QTextLayout *tl = block.layout();
+        if (!tl->formats().isEmpty() || !tl->preeditAreaText().isEmpty()
+            || block.text().contains(QChar::ObjectReplacementCharacter))
+            continue;
+
+        const QTextBlockFormat blockFormat = block.blockFormat();
+        const Qt::LayoutDirection dir = block.textDirection();
+        QFixed totalLeftMargin;
+        QFixed totalRightMargin;
+        blockMargins(block, blockFormat, dir, &totalLeftMargin, &totalRightMargin);
+
+        QParallelBlockLayoutJob job;
+        job.layout = tl;
+        job.blockFormat = blockFormat;
+        job.option = blockTextOption(blockFormat, dir);
+        // relative to x_left, clamped like in layoutBlock()
+        const QFixed flowWidth = layoutStruct->x_right - layoutStruct->x_left;
+        job.left = qMax(QFixed(), totalLeftMargin);
+        job.right = qMin(flowWidth, flowWidth - totalRightMargin);
+        job.textIndent = QFixed::fromReal(blockFormat.textIndent());
+        job.scaling = scaling;
+        tl->setTextOption(job.option);
+        jobs.append(job);
+    }
+
+    if (jobs.size() < MinimumBlockCount)
+        return;
+
+    // the workers must not release the font engines of this thread
+    for (const QParallelBlockLayoutJob &job : qAsConst(jobs))
+        job.layout->engine()->resetFontEngineCache();
+
+    const QTextEngine::FormatFonts formatFonts =
+            QTextEngine::resolveFormatFonts(docPrivate->formatCollection(), q->paintDevice());
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QAtomicInt nextJob(0);
+    auto breakLines = [&jobs, &nextJob](const QTextEngine::FormatFonts *fonts) {
+        for (int i = nextJob.fetchAndAddRelaxed(1); i < jobs.size(); i = nextJob.fetchAndAddRelaxed(1))
+            breakBlockLines(jobs[i], fonts);
+    };
+
+    QSemaphore helpersDone;
+    const int maxHelpers = qMin(pool->maxThreadCount(), int(jobs.size() / MinimumBlocksPerThread) - 1);
+    int helpers = 0;
+    // the copy of the fonts is destroyed together with the runnable, on the
+    // worker thread that loaded engines for it
+    while (helpers < maxHelpers
+           && pool->tryStart([&breakLines, &helpersDone,
+                              fonts = QTextEngine::copyFormatFontsForThread(formatFonts)]() {
+                breakLines(&fonts);
+                helpersDone.release();
+            })) {
+        ++helpers;
+    }
+    breakLines(&formatFonts);
+    helpersDone.acquire(helpers);
+
+    for (const QParallelBlockLayoutJob &job : qAsConst(jobs))
+        parallelLaidOutBlocks.insert(job.layout);
+}
+
 void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosition, const QTextBlockFormat &blockFormat,
                                              QTextLayoutStruct *layoutStruct, int layoutFrom, int layoutTo, const QTextBlockFormat *previousBlockFormat)
 {
@@ -3455,38 +3686,24 @@ void QTextDocumentLayoutPrivate::layoutBlock(const QTextBlock &bl, int blockPosi
 
     Qt::LayoutDirection dir = bl.textDirection();
 
-    QFixed extraMargin;
-    if (docPrivate->defaultTextOption.flags() & QTextOption::AddSpaceForLineAndParagraphSeparators) {
-        QFontMetricsF fm(bl.charFormat().font());
-        extraMargin = QFixed::fromReal(fm.horizontalAdvance(u'\x21B5'));
-    }
-
-    const QFixed indent = this->blockIndent(blockFormat);
-    const QFixed totalLeftMargin = QFixed::fromReal(blockFormat.leftMargin()) + (dir == Qt::RightToLeft ? extraMargin : indent);
-    const QFixed totalRightMargin = QFixed::fromReal(blockFormat.rightMargin()) + (dir == Qt::RightToLeft ? indent : extraMargin);
+    QFixed totalLeftMargin;
+    QFixed totalRightMargin;
+    blockMargins(bl, blockFormat, dir, &totalLeftMargin, &totalRightMargin);
 
     const QPointF oldPosition = tl->position();
     tl->setPosition(QPointF(layoutStruct->x_left.toReal(), layoutStruct->y.toReal()));
 
-    if (layoutStruct->fullLayout
-        || (blockPosition + blockLength > layoutFrom && blockPosition <= layoutTo)
-        // force relayout if we cross a page boundary
-        || (layoutStruct->pageHeight != QFIXED_MAX && layoutStruct->absoluteY() + QFixed::fromReal(tl->boundingRect().height()) > layoutStruct->pageBottom)) {
-
-        qCDebug(lcLayout) << "do layout";
-        QTextOption option = docPrivate->defaultTextOption;
-        option.setTextDirection(dir);
-        option.setTabs( blockFormat.tabPositions() );
-
-        Qt::Alignment align = docPrivate->defaultTextOption.alignment();
-        if (blockFormat.hasProperty(QTextFormat::BlockAlignment))
-            align = blockFormat.alignment();
-        option.setAlignment(QGuiApplicationPrivate::visualAlignment(dir, align)); // for paragraph that are RTL, alignment is auto-reversed;
+    // lines of blocks broken in parallel only need to be positioned, see layoutBlocksInParallel()
+    const bool laidOutInParallel = parallelLaidOutBlocks.remove(tl);
 
-        if (blockFormat.nonBreakableLines() || document->pageSize().width() < 0) {
-            option.setWrapMode(QTextOption::ManualWrap);
-        }
+    if (!laidOutInParallel
+        && (layoutStruct->fullLayout
+            || (blockPosition + blockLength > layoutFrom && blockPosition <= layoutTo)
+            // force relayout if we cross a page boundary
+            || (layoutStruct->pageHeight != QFIXED_MAX && layoutStruct->absoluteY() + QFixed::fromReal(tl->boundingRect().height()) > layoutStruct->pageBottom))) {
 
+        qCDebug(lcLayout) << "do layout";
+        QTextOption option = blockTextOption(blockFormat, dir);
         tl->setTextOption(option);
 
         const bool haveWordOrAnyWrapMode = (option.wrapMode() == QTextOption::WrapAtWordBoundaryOrAnywhere);
@@ -4041,6 +4258,26 @@ void QTextDocumentLayout::setFixedColumnWidth(int width)
     d->fixedColumnWidth = width;
 }
 
+/*!
+    \internal
+
+    When \a enable is true, the lines of consecutive paragraphs are broken on
+    the global QThreadPool before they are positioned on the calling thread.
+    This mode can also be enabled by setting the \c QT_TEXT_PARALLEL_LAYOUT
+    environment variable to 1.
+*/
+void QTextDocumentLayout::setParallelLayoutEnabled(bool enable)
+{
+    Q_D(QTextDocumentLayout);
+    d->parallelLayout = enable;
+}
+
+bool QTextDocumentLayout::isParallelLayoutEnabled() const
+{
+    Q_D(const QTextDocumentLayout);
+    return d->parallelLayout;
+}
+
 QRectF QTextDocumentLayout::tableCellBoundingRect(QTextTable *table, const QTextTableCell &cell) const
 {
     if (!cell.isValid())
@@ -85,6 +85,10 @@ public:
     // internal, to support the ugly FixedColumnWidth wordwrap mode in QTextEdit
     void setFixedColumnWidth(int width);
 
+    // internal, breaks the lines of paragraphs on QThreadPool::globalInstance()
+    void setParallelLayoutEnabled(bool enable);
+    bool isParallelLayoutEnabled() const;
+
     // internal for QTextEdit's NoWrap mode
     void setViewport(const QRectF &viewport);
 
@@ -54,6 +54,7 @@
 #include "qtextdocument_p.h"
 #include "qrawfont.h"
 #include "qrawfont_p.h"
+#include "qshapedtextcache_p.h"
 #include <qguiapplication.h>
 #include <qinputmethod.h>
 #include <algorithm>
@@ -1464,6 +1465,42 @@ void QTextEngine::shapeText(int item) const
             letterSpacing *= font.d->dpi / qt_defaultDpiY();
     }
 
+    // identical strings are often shaped over and over by different layouts
+    // (item views, QPainter::drawText), so try to reuse an earlier result
+    QShapedTextCache *shapedTextCache = nullptr;
+    QShapedTextCache::Key cacheKey;
+    if (QShapedTextCache::isCacheable(itemLength)) {
+        shapedTextCache = QShapedTextCache::instance();
+        if (!shapedTextCache->isEnabled()) {
+            shapedTextCache = nullptr;
+        } else {
+            cacheKey.text = QString::fromRawData(reinterpret_cast<const QChar *>(string), itemLength);
+            cacheKey.fontEngine = fontEngine;
+            cacheKey.letterSpacing = letterSpacing;
+            cacheKey.wordSpacing = wordSpacing;
+            cacheKey.script = uchar(si.analysis.script);
+            cacheKey.caseFlags = uchar(si.analysis.flags);
+            cacheKey.rightToLeft = si.analysis.bidiLevel % 2;
+            cacheKey.kerning = kerningEnabled;
+            cacheKey.shaping = shapingEnabled;
+            cacheKey.letterSpacingIsAbsolute = letterSpacingIsAbsolute;
+            cacheKey.designMetrics = option.useDesignMetrics();
+
+            const QShapedTextCache::Entry *entry = shapedTextCache->find(cacheKey);
+            if (entry && Q_LIKELY(ensureSpace(entry->numGlyphs))) {
+                QGlyphLayout glyphs = availableGlyphs(&si);
+                entry->copyTo(&glyphs, logClusters(&si));
+                si.num_glyphs = entry->numGlyphs;
+                si.width = entry->width;
+                si.ascent = entry->ascent;
+                si.descent = entry->descent;
+                si.leading = entry->leading;
+                layoutData->used += si.num_glyphs;
+                return;
+            }
+        }
+    }
+
     // split up the item into parts that come from different font engines
     // k * 3 entries, array[k] == index in string, array[k + 1] == index in glyphs, array[k + 2] == engine index
     QList<uint> itemBoundaries;
@@ -1594,6 +1631,15 @@ void QTextEngine::shapeText(int item) const
 
     for (int i = 0; i < si.num_glyphs; ++i)
         si.width += glyphs.advances[i] * !glyphs.attributes[i].dontPrint;
+
+    if (shapedTextCache) {
+        auto *entry = new QShapedTextCache::Entry(fontEngine, glyphs, logClusters(&si), itemLength);
+        entry->width = si.width;
+        entry->ascent = si.ascent;
+        entry->descent = si.descent;
+        entry->leading = si.leading;
+        shapedTextCache->insert(cacheKey, entry);
+    }
 }
 
 #if QT_CONFIG(harfbuzz)
@@ -1765,6 +1811,7 @@ void QTextEngine::init(QTextEngine *e)
     e->maxWidth = 0;
 
     e->specialData = nullptr;
+    e->formatFonts = nullptr;
     e->stackEngine = false;
 #ifndef QT_NO_RAWFONT
     e->useRawFont = false;
@@ -2242,22 +2289,30 @@ glyph_metrics_t QTextEngine::tightBoundingBox(int from,  int len) const
     return gm;
 }
 
+QFont QTextEngine::formatFont(const QScriptItem &si, const QTextCharFormat &f) const
+{
+    if (formatFonts)
+        return formatFonts->fonts.value(formatIndex(&si));
+
+    QFont font = f.font();
+    const QTextDocumentPrivate *document_d = QTextDocumentPrivate::get(block);
+    if (document_d != nullptr && document_d->layout() != nullptr) {
+        // Make sure we get the right dpi on printers
+        QPaintDevice *pdev = document_d->layout()->paintDevice();
+        if (pdev)
+            font = QFont(font, pdev);
+    } else {
+        font = font.resolve(fnt);
+    }
+    return font;
+}
+
 QFont QTextEngine::font(const QScriptItem &si) const
 {
     QFont font = fnt;
     if (hasFormats()) {
         QTextCharFormat f = format(&si);
-        font = f.font();
-
-        const QTextDocumentPrivate *document_d = QTextDocumentPrivate::get(block);
-        if (document_d != nullptr && document_d->layout() != nullptr) {
-            // Make sure we get the right dpi on printers
-            QPaintDevice *pdev = document_d->layout()->paintDevice();
-            if (pdev)
-                font = QFont(font, pdev);
-        } else {
-            font = font.resolve(fnt);
-        }
+        font = formatFont(si, f);
         QTextCharFormat::VerticalAlignment valign = f.verticalAlignment();
         if (valign == QTextCharFormat::AlignSuperScript || valign == QTextCharFormat::AlignSubScript) {
             if (font.pointSize() != -1)
@@ -2273,6 +2328,43 @@ QFont QTextEngine::font(const QScriptItem &si) const
     return font;
 }
 
+QTextEngine::FormatFonts QTextEngine::resolveFormatFonts(const QTextFormatCollection *collection,
+                                                         const QPaintDevice *pdev)
+{
+    FormatFonts formatFonts;
+    if (pdev)
+        formatFonts.dpi = pdev->logicalDpiY();
+    for (int i = 0; i < collection->formats.size(); ++i) {
+        const QTextFormat &format = collection->formats.at(i);
+        if (!format.isCharFormat())
+            continue;
+        QFont font = format.toCharFormat().font();
+        if (pdev)
+            font = QFont(font, pdev);
+        formatFonts.fonts.insert(i, font);
+    }
+    return formatFonts;
+}
+
+QTextEngine::FormatFonts QTextEngine::copyFormatFontsForThread(const FormatFonts &formatFonts)
+{
+    FormatFonts copy;
+    copy.dpi = formatFonts.dpi;
+    for (auto it = formatFonts.fonts.cbegin(), end = formatFonts.fonts.cend(); it != end; ++it) {
+        // a QFontPrivate of its own, without the engines and the small caps
+        // font that were loaded for the original's thread
+        QFontPrivate *d = new QFontPrivate(*it.value().d);
+        if (d->scFont) {
+            d->scFont->ref.deref();
+            d->scFont = nullptr;
+        }
+        QFont font(d);
+        font.resolve_mask = it.value().resolve_mask;
+        copy.fonts.insert(it.key(), font);
+    }
+    return copy;
+}
+
 QTextEngine::FontEngineCache::FontEngineCache()
 {
     reset();
@@ -2325,16 +2417,7 @@ QFontEngine *QTextEngine::fontEngine(const QScriptItem &si, QFixed *ascent, QFix
                 scaledEngine = feCache.prevScaledFontEngine;
             } else {
                 QTextCharFormat f = format(&si);
-                font = f.font();
-
-                if (QTextDocumentPrivate::get(block) != nullptr && QTextDocumentPrivate::get(block)->layout() != nullptr) {
-                    // Make sure we get the right dpi on printers
-                    QPaintDevice *pdev = QTextDocumentPrivate::get(block)->layout()->paintDevice();
-                    if (pdev)
-                        font = QFont(font, pdev);
-                } else {
-                    font = font.resolve(fnt);
-                }
+                font = formatFont(si, f);
                 engine = font.d->engineForScript(script);
                 if (engine)
                     engine->ref.ref();
@@ -2626,7 +2709,10 @@ void QScriptLine::setDefaultHeight(QTextEngine *eng)
     QFont f;
     QFontEngine *e;
 
-    if (QTextDocumentPrivate::get(eng->block) != nullptr && QTextDocumentPrivate::get(eng->block)->layout() != nullptr) {
+    if (eng->formatFonts) {
+        f = eng->formatFonts->fonts.value(eng->block.charFormatIndex());
+        e = f.d->engineForScript(QChar::Script_Common);
+    } else if (QTextDocumentPrivate::get(eng->block) != nullptr && QTextDocumentPrivate::get(eng->block)->layout() != nullptr) {
         f = eng->block.charFormat().font();
         // Make sure we get the right dpi on printers
         QPaintDevice *pdev = QTextDocumentPrivate::get(eng->block)->layout()->paintDevice();
@@ -3180,7 +3266,10 @@ QFixed QTextEngine::calculateTabWidth(int item, QFixed x) const
     const QScriptItem &si = layoutData->items[item];
 
     QFixed dpiScale = 1;
-    if (QTextDocumentPrivate::get(block) != nullptr && QTextDocumentPrivate::get(block)->layout() != nullptr) {
+    if (formatFonts) {
+        if (formatFonts->dpi != -1)
+            dpiScale = QFixed::fromReal(formatFonts->dpi / qreal(qt_defaultDpiY()));
+    } else if (QTextDocumentPrivate::get(block) != nullptr && QTextDocumentPrivate::get(block)->layout() != nullptr) {
         QPaintDevice *pdev = QTextDocumentPrivate::get(block)->layout()->paintDevice();
         if (pdev)
             dpiScale = QFixed::fromReal(pdev->logicalDpiY() / qreal(qt_defaultDpiY()));
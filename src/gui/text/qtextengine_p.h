@@ -59,6 +59,7 @@
 #include "QtGui/qtextlayout.h"
 
 #include "QtCore/qdebug.h"
+#include "QtCore/qhash.h"
 #include "QtCore/qlist.h"
 #include "QtCore/qnamespace.h"
 #include "QtCore/qset.h"
@@ -530,6 +531,7 @@ public:
         return specialData ? specialData->formatCollection.data() : nullptr;
     }
     QTextCharFormat format(const QScriptItem *si) const;
+    QFont formatFont(const QScriptItem &si, const QTextCharFormat &format) const;
     inline QAbstractTextDocumentLayout *docLayout() const {
         Q_ASSERT(QTextDocumentPrivate::get(block) != nullptr);
         return QTextDocumentPrivate::get(block)->document()->documentLayout();
@@ -539,6 +541,19 @@ public:
     /// returns the width of tab at index (in the tabs array) with the tab-start at position x
     QFixed calculateTabWidth(int index, QFixed x) const;
 
+    // The fonts of a document's char formats, resolved for the paint device
+    // of its layout, for laying out blocks on threads other than the
+    // document's. Font engines are per thread, so every thread needs its own
+    // copy of the fonts.
+    struct FormatFonts {
+        int dpi = -1;
+        QHash<int, QFont> fonts;
+    };
+    static FormatFonts resolveFormatFonts(const QTextFormatCollection *collection, const QPaintDevice *pdev);
+    static FormatFonts copyFormatFontsForThread(const FormatFonts &formatFonts);
+    // if set, used instead of the document's formats and paint device
+    const FormatFonts *formatFonts;
+
     mutable QScriptLineArray lines;
 
 private:
@@ -38,6 +38,7 @@ HEADERS += \
     text/qstatictext.h \
     text/qrawfont.h \
     text/qrawfont_p.h \
+    text/qshapedtextcache_p.h \
     text/qglyphrun.h \
     text/qglyphrun_p.h \
     text/qdistancefield_p.h \
@@ -70,6 +71,7 @@ SOURCES += \
     text/qsyntaxhighlighter.cpp \
     text/qstatictext.cpp \
     text/qrawfont.cpp \
+    text/qshapedtextcache.cpp \
     text/qglyphrun.cpp \
     text/qdistancefield.cpp \
     text/qinputcontrol.cpp
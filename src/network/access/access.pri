@@ -89,6 +89,7 @@ qtConfig(http) {
         access/qhttpprotocolhandler.cpp \
         access/qhttpthreaddelegate.cpp \
         access/qnetworkreplyhttpimpl.cpp \
+        access/qhttp1configuration.cpp \
         access/qhttp2configuration.cpp
 
     HEADERS += \
@@ -105,6 +106,7 @@ qtConfig(http) {
         access/qhttpprotocolhandler_p.h \
         access/qhttpthreaddelegate_p.h \
         access/qnetworkreplyhttpimpl_p.h \
+        access/qhttp1configuration.h \
         access/qhttp2configuration.h
 
     qtConfig(brotli) {
@@ -152,6 +152,10 @@ const quint32 lastValidStreamID((quint32(1) << 31) - 1); // HTTP/2, 5.1.1
 // we do the same and split this window size between our concurrent streams.
 const qint32 maxSessionReceiveWindowSize((quint32(1) << 31) - 1);
 const qint32 qtDefaultStreamReceiveWindowSize = maxSessionReceiveWindowSize / maxConcurrentStreams;
+// With the receive window auto-tuning enabled we start with the configured
+// window sizes and grow them as needed, but not beyond this limit (unless
+// the configured size is bigger already):
+const qint32 maxAutoTunedWindowSize = 16 * 1024 * 1024;
 
 struct Frame configurationToSettingsFrame(const QHttp2Configuration &configuration);
 QByteArray settingsFrameToBase64(const Frame &settingsFrame);
@@ -57,6 +57,7 @@
 #include <private/qhttpnetworkconnectionchannel_p.h>
 #include <private/qhttpnetworkrequest_p.h>
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qstring.h>
 
@@ -105,6 +106,14 @@ struct Q_AUTOTEST_EXPORT Stream
 
     StreamState state = idle;
     QString key; // for PUSH_PROMISE
+
+    // Statistics, payload octets only:
+    qint64 bytesSent = 0;
+    qint64 bytesReceived = 0;
+    // How long (in ms) we had data to send, but the stream
+    // or session send window was exhausted:
+    qint64 flowControlBlockedTime = 0;
+    QElapsedTimer flowControlBlockedTimer;
 };
 
 struct PushPromise
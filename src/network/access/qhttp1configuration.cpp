@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttp1configuration.h"
+
+#include "private/qhttpnetworkconnection_p.h"
+
+#include "qdebug.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QHttp1Configuration
+    \brief The QHttp1Configuration class controls HTTP/1 parameters and settings.
+    \since 6.1
+
+    \reentrant
+    \inmodule QtNetwork
+    \ingroup network
+    \ingroup shared
+
+    QHttp1Configuration controls HTTP/1 parameters and settings that
+    QNetworkAccessManager will use to send requests and process responses
+    when the HTTP/1 protocol is used.
+
+    The HTTP/1 parameters that QHttp1Configuration currently supports include:
+
+    \list
+      \li The number of connections QNetworkAccessManager opens in parallel
+         to the same host. Requests to the host are queued and sent over the
+         first connection that becomes free.
+      \li The pipeline depth. This limits how many requests are written to a
+         connection while the reply to an earlier request is still being
+         received, for requests that have the
+         QNetworkRequest::HttpPipeliningAllowedAttribute set.
+    \endlist
+
+    \note The configuration must be set before the first request
+    was sent to a given host (and thus the connections to the host
+    were set up). Later requests to the same host share the connections
+    and their configuration.
+
+    \note Details about HTTP/1.1 connection management and pipelining
+    can be found in \l {https://httpwg.org/specs/rfc7230.html#persistent.connections}{RFC 7230}.
+
+    \sa QNetworkRequest::setHttp1Configuration(), QNetworkRequest::http1Configuration(), QNetworkAccessManager
+*/
+
+class QHttp1ConfigurationPrivate : public QSharedData
+{
+public:
+    qsizetype numberOfConnectionsPerHost = QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+    qsizetype pipelineDepth = QHttpNetworkConnectionPrivate::defaultPipelineLength;
+};
+
+/*!
+    Default constructs a QHttp1Configuration object.
+
+    Such a configuration has the following values:
+    \list
+        \li Six connections are opened per host
+        \li Up to three requests are pipelined behind the one being processed
+    \endlist
+*/
+QHttp1Configuration::QHttp1Configuration()
+    : d(new QHttp1ConfigurationPrivate)
+{
+}
+
+/*!
+    Copy-constructs this QHttp1Configuration.
+*/
+QHttp1Configuration::QHttp1Configuration(const QHttp1Configuration &) = default;
+
+/*!
+    Move-constructs this QHttp1Configuration from \a other
+*/
+QHttp1Configuration::QHttp1Configuration(QHttp1Configuration &&other) noexcept
+{
+    swap(other);
+}
+
+/*!
+    Copy-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(const QHttp1Configuration &) = default;
+
+/*!
+    Move-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(QHttp1Configuration &&) noexcept = default;
+
+/*!
+    Destructor.
+*/
+QHttp1Configuration::~QHttp1Configuration()
+{
+}
+
+/*!
+    Sets the number of connections QNetworkAccessManager opens in
+    parallel to the same host to \a amount. \a amount cannot be 0
+    and must not exceed 65535.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa numberOfConnectionsPerHost
+*/
+bool QHttp1Configuration::setNumberOfConnectionsPerHost(qsizetype amount)
+{
+    if (amount < 1 || amount > std::numeric_limits<quint16>::max()) {
+        qWarning("QHttp1Configuration: Invalid number of connections per host: %lld",
+                 qlonglong(amount));
+        return false;
+    }
+
+    d->numberOfConnectionsPerHost = amount;
+    return true;
+}
+
+/*!
+    Returns the number of connections QNetworkAccessManager opens in
+    parallel to the same host. The default value is 6.
+
+    \sa setNumberOfConnectionsPerHost
+*/
+qsizetype QHttp1Configuration::numberOfConnectionsPerHost() const
+{
+    return d->numberOfConnectionsPerHost;
+}
+
+/*!
+    Sets the number of requests that can be pipelined on a connection
+    behind the request whose reply is being received to \a depth.
+    A \a depth of 0 disables pipelining. \a depth cannot be negative.
+
+    Only requests that have the QNetworkRequest::HttpPipeliningAllowedAttribute
+    set are pipelined, and only on connections to servers that appear to
+    support it. If a server closes a connection while requests are pipelined
+    on it, the requests are sent again and no further requests are pipelined
+    to that server.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa pipelineDepth
+*/
+bool QHttp1Configuration::setPipelineDepth(qsizetype depth)
+{
+    if (depth < 0) {
+        qWarning("QHttp1Configuration: Invalid pipeline depth: %lld", qlonglong(depth));
+        return false;
+    }
+
+    d->pipelineDepth = depth;
+    return true;
+}
+
+/*!
+    Returns the number of requests that can be pipelined on a connection
+    behind the request whose reply is being received. The default value
+    is 3.
+
+    \sa setPipelineDepth
+*/
+qsizetype QHttp1Configuration::pipelineDepth() const
+{
+    return d->pipelineDepth;
+}
+
+/*!
+    Swaps this configuration with the \a other configuration.
+*/
+void QHttp1Configuration::swap(QHttp1Configuration &other) noexcept
+{
+    d.swap(other.d);
+}
+
+/*!
+    \fn bool QHttp1Configuration::operator==(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs have the same set of HTTP/1
+    parameters.
+*/
+
+/*!
+    \fn bool QHttp1Configuration::operator!=(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs do not have the same set of HTTP/1
+    parameters.
+*/
+
+/*!
+    \internal
+*/
+bool QHttp1Configuration::isEqual(const QHttp1Configuration &other) const noexcept
+{
+    if (d == other.d)
+        return true;
+
+    return d->numberOfConnectionsPerHost == other.d->numberOfConnectionsPerHost
+           && d->pipelineDepth == other.d->pipelineDepth;
+}
+
+QT_END_NAMESPACE
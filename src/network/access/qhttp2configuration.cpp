@@ -77,6 +77,10 @@ QT_BEGIN_NAMESPACE
       \li The server push. Allows to enable or disable server push. Sent
          as 'SETTINGS_ENABLE_PUSH' parameter in the initial 'SETTINGS'
          frame.
+      \li The receive window auto-tuning. When enabled, QNetworkAccessManager
+         estimates the bandwidth-delay product of the connection by timing
+         'PING' frames and grows the session and stream receive windows
+         when they are limiting the download throughput.
     \endlist
 
     The QHttp2Configuration class also controls if the header compression
@@ -106,6 +110,7 @@ public:
     unsigned maxFrameSize = Http2::minPayloadLimit; // Initial (default) value of 16Kb.
 
     bool pushEnabled = false;
+    bool windowAutoTuningEnabled = false;
     // TODO: for now those two below are noop.
     bool huffmanCompressionEnabled = true;
 };
@@ -120,6 +125,7 @@ public:
         \li Window size for connection-level flow control is 65535 octets
         \li Window size for stream-level flow control is 65535 octets
         \li Frame size is 16384 octets
+        \li Receive window auto-tuning is disabled
     \endlist
 */
 QHttp2Configuration::QHttp2Configuration()
@@ -292,6 +298,40 @@ unsigned QHttp2Configuration::maxFrameSize() const
     return d->maxFrameSize;
 }
 
+/*!
+    \since 6.1
+
+    If \a enable is \c true, QNetworkAccessManager will grow the session
+    and stream receive windows at run-time, based on the bandwidth-delay
+    product it measures while a response is being downloaded. The windows
+    start with the values set by setSessionReceiveWindowSize() and
+    setStreamReceiveWindowSize() and are never shrunk, but they are not
+    grown beyond 16777216 octets, or the configured size if it is larger.
+
+    To measure the round-trip time, QNetworkAccessManager sends 'PING'
+    frames while 'DATA' frames are being received, one at a time.
+
+    Disabled by default.
+
+    \sa windowAutoTuningEnabled(), setStreamReceiveWindowSize()
+*/
+void QHttp2Configuration::setWindowAutoTuningEnabled(bool enable)
+{
+    d->windowAutoTuningEnabled = enable;
+}
+
+/*!
+    \since 6.1
+
+    Returns \c true if the receive window auto-tuning is enabled.
+
+    \sa setWindowAutoTuningEnabled()
+*/
+bool QHttp2Configuration::windowAutoTuningEnabled() const
+{
+    return d->windowAutoTuningEnabled;
+}
+
 /*!
     Swaps this configuration with the \a other configuration.
 */
@@ -322,6 +362,7 @@ bool QHttp2Configuration::isEqual(const QHttp2Configuration &other) const noexce
 
     return d->pushEnabled == other.d->pushEnabled
            && d->huffmanCompressionEnabled == other.d->huffmanCompressionEnabled
+           && d->windowAutoTuningEnabled == other.d->windowAutoTuningEnabled
            && d->sessionWindowSize == other.d->sessionWindowSize
            && d->streamWindowSize == other.d->streamWindowSize;
 }
@@ -77,6 +77,9 @@ public:
     bool setMaxFrameSize(unsigned size);
     unsigned maxFrameSize() const;
 
+    void setWindowAutoTuningEnabled(bool enable);
+    bool windowAutoTuningEnabled() const;
+
     void swap(QHttp2Configuration &other) noexcept;
 
 private:
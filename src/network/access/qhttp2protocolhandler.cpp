@@ -181,6 +181,9 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
     maxSessionReceiveWindowSize = h2Config.sessionReceiveWindowSize();
     pushPromiseEnabled = h2Config.serverPushEnabled();
     streamInitialReceiveWindowSize = h2Config.streamReceiveWindowSize();
+    streamReceiveWindowSize = streamInitialReceiveWindowSize;
+    windowAutoTuningEnabled = h2Config.windowAutoTuningEnabled();
+    maxAutoTunedWindowSize = std::max(Http2::maxAutoTunedWindowSize, streamInitialReceiveWindowSize);
     encoder.setCompressStrings(h2Config.huffmanCompressionEnabled());
 
     if (!channel->ssl && m_connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
@@ -520,6 +523,11 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
     Q_ASSERT(replyPrivate);
 
     auto slot = std::min<qint32>(sessionSendWindowSize, stream.sendWindow);
+    if (stream.flowControlBlockedTimer.isValid() && slot > 0) {
+        stream.flowControlBlockedTime += stream.flowControlBlockedTimer.elapsed();
+        stream.flowControlBlockedTimer.invalidate();
+    }
+
     while (!stream.data()->atEnd() && slot) {
         qint64 chunkSize = 0;
         const uchar *src =
@@ -543,6 +551,7 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.data()->advanceReadPointer(bytesWritten);
         stream.sendWindow -= bytesWritten;
         sessionSendWindowSize -= bytesWritten;
+        stream.bytesSent += bytesWritten;
         replyPrivate->totallyUploadedData += bytesWritten;
         emit reply->dataSendProgress(replyPrivate->totallyUploadedData,
                                      request.contentLength());
@@ -557,6 +566,10 @@ bool QHttp2ProtocolHandler::sendDATA(Stream &stream)
         stream.data()->disconnect(this);
         removeFromSuspended(stream.streamID);
     } else if (!stream.data()->atEnd()) {
+        // The loop above only stops with data left when we are out of
+        // the send window (stream's or session's):
+        if (!stream.flowControlBlockedTimer.isValid())
+            stream.flowControlBlockedTimer.start();
         addToSuspended(stream);
     }
 
@@ -572,6 +585,20 @@ bool QHttp2ProtocolHandler::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
     return frameWriter.write(*m_socket);
 }
 
+bool QHttp2ProtocolHandler::sendPING()
+{
+    Q_ASSERT(m_socket);
+
+    frameWriter.start(FrameType::PING, FrameFlag::EMPTY, connectionStreamID);
+    frameWriter.append(++bdpPingPayload);
+
+    bdpPingInFlight = true;
+    bdpSample = 0;
+    bdpPingTimer.start();
+
+    return frameWriter.write(*m_socket);
+}
+
 bool QHttp2ProtocolHandler::sendRST_STREAM(quint32 streamID, quint32 errorCode)
 {
     Q_ASSERT(m_socket);
@@ -607,6 +634,12 @@ void QHttp2ProtocolHandler::handleDATA()
 
     sessionReceiveWindowSize -= inboundFrame.payloadSize();
 
+    if (windowAutoTuningEnabled && streamReceiveWindowSize < maxAutoTunedWindowSize) {
+        if (!bdpPingInFlight)
+            sendPING();
+        bdpSample += inboundFrame.payloadSize();
+    }
+
     if (activeStreams.contains(streamID)) {
         auto &stream = activeStreams[streamID];
 
@@ -618,17 +651,18 @@ void QHttp2ProtocolHandler::handleDATA()
             deleteActiveStream(streamID);
         } else {
             stream.recvWindow -= inboundFrame.payloadSize();
+            stream.bytesReceived += inboundFrame.payloadSize();
             // Uncompress data if needed and append it ...
             updateStream(stream, inboundFrame);
 
             if (inboundFrame.flags().testFlag(FrameFlag::END_STREAM)) {
                 finishStream(stream);
                 deleteActiveStream(stream.streamID);
-            } else if (stream.recvWindow < streamInitialReceiveWindowSize / 2) {
+            } else if (stream.recvWindow < streamReceiveWindowSize / 2) {
                 QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                           Q_ARG(quint32, stream.streamID),
-                                          Q_ARG(quint32, streamInitialReceiveWindowSize - stream.recvWindow));
-                stream.recvWindow = streamInitialReceiveWindowSize;
+                                          Q_ARG(quint32, streamReceiveWindowSize - stream.recvWindow));
+                stream.recvWindow = streamReceiveWindowSize;
             }
         }
     }
@@ -821,17 +855,22 @@ void QHttp2ProtocolHandler::handlePING()
 {
     // Since we're implementing a client and not
     // a server, we only reply to a PING, ACKing it.
+    // The only PING we send ourselves is the one
+    // for the window auto-tuning.
     Q_ASSERT(inboundFrame.type() == FrameType::PING);
     Q_ASSERT(m_socket);
 
     if (inboundFrame.streamID() != connectionStreamID)
         return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
 
-    if (inboundFrame.flags() & FrameFlag::ACK)
-        return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
-
     Q_ASSERT(inboundFrame.dataSize() == 8);
 
+    if (inboundFrame.flags() & FrameFlag::ACK) {
+        if (!bdpPingInFlight || qFromBigEndian<quint64>(inboundFrame.dataBegin()) != bdpPingPayload)
+            return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
+        return updateBdpEstimate();
+    }
+
     frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
     frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
     frameWriter.write(*m_socket);
@@ -1036,6 +1075,39 @@ void QHttp2ProtocolHandler::handleContinuedHEADERS()
     }
 }
 
+void QHttp2ProtocolHandler::updateBdpEstimate()
+{
+    Q_ASSERT(bdpPingInFlight);
+
+    bdpPingInFlight = false;
+    const qint64 rtt = bdpPingTimer.nsecsElapsed();
+    if (rtt <= 0)
+        return;
+
+    // Only grow the window if the bandwidth is not dropping - otherwise the
+    // sample may be a result of some queueing somewhere on the path and not
+    // of a bigger bandwidth-delay product:
+    const double bandwidth = double(bdpSample) / rtt;
+    if (bandwidth < bdpMaxBandwidth)
+        return;
+    bdpMaxBandwidth = bandwidth;
+
+    if (bdpSample < qint64(streamReceiveWindowSize) * 2 / 3)
+        return;
+
+    const qint32 newSize = qint32(std::min<qint64>(bdpSample * 2, maxAutoTunedWindowSize));
+    if (newSize <= streamReceiveWindowSize)
+        return;
+
+    qCDebug(QT_HTTP2) << "receive window auto-tuned from" << streamReceiveWindowSize
+                      << "to" << newSize << "octets, RTT" << rtt / 1000 << "us";
+
+    // New WINDOW_UPDATE frames will be sent (with bigger deltas) as soon as
+    // the current windows are half-consumed, see handleDATA():
+    streamReceiveWindowSize = newSize;
+    maxSessionReceiveWindowSize = std::max(maxSessionReceiveWindowSize, newSize);
+}
+
 bool QHttp2ProtocolHandler::acceptSetting(Http2::Settings identifier, quint32 newValue)
 {
     if (identifier == Settings::HEADER_TABLE_SIZE_ID) {
@@ -1253,6 +1325,7 @@ void QHttp2ProtocolHandler::finishStream(Stream &stream, Qt::ConnectionType conn
     Q_ASSERT(stream.state == Stream::remoteReserved || stream.reply());
 
     stream.state = Stream::closed;
+    updateStreamStatistics(stream);
     auto httpReply = stream.reply();
     if (httpReply) {
         httpReply->disconnect(this);
@@ -1265,7 +1338,23 @@ void QHttp2ProtocolHandler::finishStream(Stream &stream, Qt::ConnectionType conn
             QMetaObject::invokeMethod(httpReply, "finished", connectionType);
     }
 
-    qCDebug(QT_HTTP2) << "stream" << stream.streamID << "closed";
+    qCDebug(QT_HTTP2) << "stream" << stream.streamID << "closed, sent" << stream.bytesSent
+                      << "received" << stream.bytesReceived << "octets, blocked by flow control"
+                      << stream.flowControlBlockedTime << "ms";
+}
+
+// Hands the final counters of the stream to its reply
+void QHttp2ProtocolHandler::updateStreamStatistics(Stream &stream)
+{
+    if (stream.flowControlBlockedTimer.isValid()) {
+        stream.flowControlBlockedTime += stream.flowControlBlockedTimer.elapsed();
+        stream.flowControlBlockedTimer.invalidate();
+    }
+
+    if (auto httpReply = stream.reply()) {
+        httpReply->setHttp2StreamStatistics(stream.bytesSent, stream.bytesReceived,
+                                            stream.flowControlBlockedTime);
+    }
 }
 
 void QHttp2ProtocolHandler::finishStreamWithError(Stream &stream, quint32 errorCode)
@@ -1282,6 +1371,7 @@ void QHttp2ProtocolHandler::finishStreamWithError(Stream &stream, QNetworkReply:
     Q_ASSERT(stream.state == Stream::remoteReserved || stream.reply());
 
     stream.state = Stream::closed;
+    updateStreamStatistics(stream);
     if (auto httpReply = stream.reply()) {
         httpReply->disconnect(this);
         if (stream.data())
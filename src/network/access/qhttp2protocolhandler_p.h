@@ -64,6 +64,7 @@
 #include <private/hpack_p.h>
 
 #include <QtCore/qnamespace.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qbytearray.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qobject.h>
@@ -112,6 +113,7 @@ private:
     bool sendHEADERS(Stream &stream);
     bool sendDATA(Stream &stream);
     Q_INVOKABLE bool sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    bool sendPING();
     bool sendRST_STREAM(quint32 streamID, quint32 errorCoder);
     bool sendGOAWAY(quint32 errorCode);
 
@@ -140,6 +142,7 @@ private:
     // Locally encountered error:
     void finishStreamWithError(Stream &stream, QNetworkReply::NetworkError error,
                                const QString &message);
+    void updateStreamStatistics(Stream &stream);
 
     // Stream's lifecycle management:
     quint32 createNewStream(const HttpMessagePair &message, bool uploadDone = false);
@@ -190,8 +193,8 @@ private:
     // sending requests and creating streams while maxConcurrentStreams allows).
 
     // This is our (client-side) maximum possible receive window size, we set
-    // it in a ctor from QHttp2Configuration, it does not change after that.
-    // The default is 64Kb:
+    // it in a ctor from QHttp2Configuration, it only changes (grows) if the
+    // window auto-tuning is enabled. The default is 64Kb:
     qint32 maxSessionReceiveWindowSize = Http2::defaultSessionWindowSize;
 
     // Our session current receive window size, updated in a ctor from
@@ -201,6 +204,25 @@ private:
     // Our per-stream receive window size, default is 64 Kb, will be updated
     // from QHttp2Configuration. Again, signed - can become negative.
     qint32 streamInitialReceiveWindowSize = Http2::defaultSessionWindowSize;
+    // The window size we restore a stream's receive window to when sending
+    // WINDOW_UPDATE. Initially the same as above, can grow if the window
+    // auto-tuning is enabled (we never re-send SETTINGS_INITIAL_WINDOW_SIZE,
+    // new streams start small and grow with their first WINDOW_UPDATE):
+    qint32 streamReceiveWindowSize = Http2::defaultSessionWindowSize;
+
+    // Window auto-tuning: while receiving DATA frames, we send a PING and
+    // count the payload received until its ACK arrives. This sample
+    // approximates the bandwidth-delay product of the connection; if it's
+    // close to our current window size, the window is what's limiting the
+    // throughput and we double it (similar to what gRPC does):
+    void updateBdpEstimate();
+    bool windowAutoTuningEnabled = false;
+    qint32 maxAutoTunedWindowSize = Http2::maxAutoTunedWindowSize;
+    bool bdpPingInFlight = false;
+    quint64 bdpPingPayload = 0;
+    QElapsedTimer bdpPingTimer;
+    qint64 bdpSample = 0;
+    double bdpMaxBandwidth = 0.; // octets per ns
 
     // These are our peer's receive window sizes, they will be updated by the
     // peer's SETTINGS and WINDOW_UPDATE frames, defaults presumed to be 64Kb.
@@ -102,7 +102,10 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                     || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+                     ? 1 : connectionCount),
+  channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -737,6 +740,7 @@ void QHttpNetworkConnectionPrivate::updateChannel(int i, const HttpMessagePair &
 {
     channels[i].request = messagePair.first;
     channels[i].reply = messagePair.second;
+    ++channels[i].requestsSent;
     // Now that reply is assigned a channel, correct reply to channel association
     // previously set in queueRequest.
     channels[i].reply->d_func()->connectionChannel = &channels[i];
@@ -764,7 +768,12 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     if (channels[i].reply == nullptr)
         return;
 
-    if (! (defaultPipelineLength - channels[i].alreadyPipelinedRequests.length() >= defaultRePipelineLength)) {
+    const int pipelineLength = int(http1Parameters.pipelineDepth());
+    if (pipelineLength == 0)
+        return;
+
+    if (! (pipelineLength - channels[i].alreadyPipelinedRequests.length()
+           >= qMin(defaultRePipelineLength, pipelineLength))) {
         return;
     }
 
@@ -808,7 +817,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(highPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -821,7 +830,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(lowPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -1417,6 +1426,18 @@ void QHttpNetworkConnection::setConnectionType(ConnectionType type)
     d->connectionType = type;
 }
 
+QHttp1Configuration QHttpNetworkConnection::http1Parameters() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->http1Parameters;
+}
+
+void QHttpNetworkConnection::setHttp1Parameters(const QHttp1Configuration &params)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http1Parameters = params;
+}
+
 QHttp2Configuration QHttpNetworkConnection::http2Parameters() const
 {
     Q_D(const QHttpNetworkConnection);
@@ -1429,6 +1450,35 @@ void QHttpNetworkConnection::setHttp2Parameters(const QHttp2Configuration &param
     d->http2Parameters = params;
 }
 
+// Returns the number of requests each channel sent so far and how deep its
+// pipeline is and has been; used to tune the channel count and pipeline depth.
+QList<QHttpNetworkConnection::ChannelStatistics> QHttpNetworkConnection::channelStatistics() const
+{
+    Q_D(const QHttpNetworkConnection);
+    QList<ChannelStatistics> statistics;
+    statistics.reserve(d->channelCount);
+    for (int i = 0; i < d->channelCount; ++i) {
+        const QHttpNetworkConnectionChannel &channel = d->channels[i];
+        ChannelStatistics channelStatistics;
+        channelStatistics.requestsSent = channel.requestsSent;
+        channelStatistics.requestsPipelined = channel.requestsPipelined;
+        channelStatistics.pipelineDepth = int(channel.alreadyPipelinedRequests.length());
+        channelStatistics.maximumPipelineDepth = channel.maximumPipelineDepth;
+        statistics.append(channelStatistics);
+    }
+    return statistics;
+}
+
+// Returns the number of requests waiting in the queue that requests of the
+// given priority are put in; normal and low priority requests share one.
+int QHttpNetworkConnection::pendingRequestCount(QHttpNetworkRequest::Priority priority) const
+{
+    Q_D(const QHttpNetworkConnection);
+    if (priority == QHttpNetworkRequest::HighPriority)
+        return int(d->highPriorityQueue.size());
+    return int(d->lowPriorityQueue.size());
+}
+
 // SSL support below
 #ifndef QT_NO_SSL
 void QHttpNetworkConnection::setSslConfiguration(const QSslConfiguration &config)
@@ -56,6 +56,7 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qabstractsocket.h>
 
+#include <qhttp1configuration.h>
 #include <qhttp2configuration.h>
 
 #include <private/qobject_p.h>
@@ -131,9 +132,22 @@ public:
     ConnectionType connectionType();
     void setConnectionType(ConnectionType type);
 
+    QHttp1Configuration http1Parameters() const;
+    void setHttp1Parameters(const QHttp1Configuration &params);
+
     QHttp2Configuration http2Parameters() const;
     void setHttp2Parameters(const QHttp2Configuration &params);
 
+    struct ChannelStatistics
+    {
+        qint64 requestsSent = 0;
+        qint64 requestsPipelined = 0;
+        int pipelineDepth = 0;
+        int maximumPipelineDepth = 0;
+    };
+    QList<ChannelStatistics> channelStatistics() const;
+    int pendingRequestCount(QHttpNetworkRequest::Priority priority) const;
+
 #ifndef QT_NO_SSL
     void setSslConfiguration(const QSslConfiguration &config);
     void ignoreSslErrors(int channel = -1);
@@ -278,7 +292,10 @@ public:
     QSharedPointer<QSslContext> sslContext;
 #endif
 
+    QHttp1Configuration http1Parameters;
     QHttp2Configuration http2Parameters;
+    // set once the server dropped requests pipelined to it
+    bool pipeliningBroken = false;
 
     QString peerVerifyName;
     // If network status monitoring is enabled, we activate connectionMonitor
@@ -593,7 +593,9 @@ void QHttpNetworkConnectionChannel::detectPipeliningSupport()
             && (!serverHeaderField.contains("WebLogic"))
             && (!serverHeaderField.startsWith("Rocket")) // a Python Web Server, see Web2py.com
             ) {
-        pipeliningSupported = QHttpNetworkConnectionChannel::PipeliningProbablySupported;
+        pipeliningSupported = connection->d_func()->pipeliningBroken
+                ? QHttpNetworkConnectionChannel::PipeliningNotSupported
+                : QHttpNetworkConnectionChannel::PipeliningProbablySupported;
     } else {
         pipeliningSupported = QHttpNetworkConnectionChannel::PipeliningSupportUnknown;
     }
@@ -764,6 +766,9 @@ void QHttpNetworkConnectionChannel::pipelineInto(HttpMessagePair &pair)
 #endif
 
     alreadyPipelinedRequests.append(pair);
+    ++requestsSent;
+    ++requestsPipelined;
+    maximumPipelineDepth = qMax(maximumPipelineDepth, int(alreadyPipelinedRequests.length()));
 
     // pipelineFlush() needs to be called at some point afterwards
 }
@@ -857,6 +862,8 @@ void QHttpNetworkConnectionChannel::_q_disconnected()
     }
     state = QHttpNetworkConnectionChannel::IdleState;
     if (alreadyPipelinedRequests.length()) {
+        // The server dropped the pipelined requests, do not pipeline to it anymore
+        connection->d_func()->pipeliningBroken = true;
         // If nothing was in a pipeline, no need in calling
         // _q_startNextRequest (which it does):
         requeueCurrentlyPipelinedRequests();
@@ -979,6 +986,10 @@ void QHttpNetworkConnectionChannel::_q_error(QAbstractSocket::SocketError socket
         errorCode = QNetworkReply::ConnectionRefusedError;
         break;
     case QAbstractSocket::RemoteHostClosedError:
+        // A server that closes the connection while requests are pipelined
+        // on it does not handle pipelining, so stop pipelining to it
+        if (!alreadyPipelinedRequests.isEmpty())
+            connection->d_func()->pipeliningBroken = true;
         // This error for SSL comes twice in a row, first from SSL layer ("The TLS/SSL connection has been closed") then from TCP layer.
         // Depending on timing it can also come three times in a row (first time when we try to write into a closing QSslSocket).
         // The reconnectAttempts handling catches the cases where we can re-send the request.
@@ -141,7 +141,7 @@ public:
     enum PipeliningSupport {
         PipeliningSupportUnknown, // default for a new connection
         PipeliningProbablySupported, // after having received a server response that indicates support
-        PipeliningNotSupported // currently not used
+        PipeliningNotSupported // after the server broke a pipeline on this connection
     };
     PipeliningSupport pipeliningSupported;
     QList<HttpMessagePair> alreadyPipelinedRequests;
@@ -151,6 +151,11 @@ public:
     void requeueCurrentlyPipelinedRequests();
     void detectPipeliningSupport();
 
+    // statistics for tuning the channel count and pipeline depth
+    qint64 requestsSent = 0;
+    qint64 requestsPipelined = 0;
+    int maximumPipelineDepth = 0;
+
     QHttpNetworkConnectionChannel();
 
     QAbstractSocket::NetworkLayerProtocol networkLayerPreference;
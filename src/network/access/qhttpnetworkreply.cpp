@@ -293,6 +293,30 @@ void QHttpNetworkReply::setHttp2WasUsed(bool h2)
     d_func()->h2Used = h2;
 }
 
+void QHttpNetworkReply::setHttp2StreamStatistics(qint64 bytesSent, qint64 bytesReceived,
+                                                 qint64 flowControlBlockedTime)
+{
+    Q_D(QHttpNetworkReply);
+    d->http2BytesSent = bytesSent;
+    d->http2BytesReceived = bytesReceived;
+    d->http2FlowControlBlockedTime = flowControlBlockedTime;
+}
+
+qint64 QHttpNetworkReply::http2BytesSent() const
+{
+    return d_func()->http2BytesSent;
+}
+
+qint64 QHttpNetworkReply::http2BytesReceived() const
+{
+    return d_func()->http2BytesReceived;
+}
+
+qint64 QHttpNetworkReply::http2FlowControlBlockedTime() const
+{
+    return d_func()->http2FlowControlBlockedTime;
+}
+
 qint64 QHttpNetworkReply::removedContentLength() const
 {
     return d_func()->removedContentLength;
@@ -308,6 +332,11 @@ QHttpNetworkConnection* QHttpNetworkReply::connection()
     return d_func()->connection;
 }
 
+QHttpNetworkConnectionChannel *QHttpNetworkReply::connectionChannel() const
+{
+    return d_func()->connectionChannel;
+}
+
 
 QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl)
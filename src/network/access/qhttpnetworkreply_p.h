@@ -144,11 +144,17 @@ public:
     bool isPipeliningUsed() const;
     bool isHttp2Used() const;
     void setHttp2WasUsed(bool h2Used);
+    void setHttp2StreamStatistics(qint64 bytesSent, qint64 bytesReceived,
+                                  qint64 flowControlBlockedTime);
+    qint64 http2BytesSent() const;
+    qint64 http2BytesReceived() const;
+    qint64 http2FlowControlBlockedTime() const;
     qint64 removedContentLength() const;
 
     bool isRedirecting() const;
 
     QHttpNetworkConnection* connection();
+    QHttpNetworkConnectionChannel *connectionChannel() const;
 
     QUrl redirectUrl() const;
     void setRedirectUrl(const QUrl &url);
@@ -273,6 +279,11 @@ public:
     bool h2Used;
     bool downstreamLimited;
 
+    // counters of the HTTP/2 stream, set when it is closed
+    qint64 http2BytesSent = 0;
+    qint64 http2BytesReceived = 0;
+    qint64 http2FlowControlBlockedTime = 0; // ms
+
     char* userProvidedDownloadBuffer;
     QUrl redirectUrl;
 
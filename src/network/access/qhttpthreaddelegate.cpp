@@ -181,9 +181,10 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
 {
     // Q_OBJECT
 public:
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, nullptr, connectionType)
     {
         setExpires(true);
         setShareable(true);
@@ -229,6 +230,14 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isHttp2Used(false)
+    , http2BytesSent(0)
+    , http2BytesReceived(0)
+    , http2FlowControlBlockedTime(0)
+    , http1RequestsSent(0)
+    , http1RequestsPipelined(0)
+    , http1MaximumPipelineDepth(0)
+    , http1PendingHighPriorityRequests(0)
+    , http1PendingLowPriorityRequests(0)
     , incomingContentLength(-1)
     , removedContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
@@ -326,8 +335,10 @@ void QHttpThreadDelegate::startRequest()
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType);
+        httpConnection = new QNetworkAccessCachedHttpConnection(
+                quint16(http1Parameters.numberOfConnectionsPerHost()), urlCopy.host(),
+                urlCopy.port(), ssl, connectionType);
+        httpConnection->setHttp1Parameters(http1Parameters);
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
@@ -522,6 +533,13 @@ void QHttpThreadDelegate::finishedSlot()
     if (httpRequest.isFollowRedirects() && httpReply->isRedirecting())
         emit redirected(httpReply->redirectUrl(), httpReply->statusCode(), httpReply->request().redirectCount() - 1);
 
+    if (fetchHttp2StreamStatistics())
+        emit http2StreamStatistics(http2BytesSent, http2BytesReceived, http2FlowControlBlockedTime);
+    else if (fetchHttp1ConnectionStatistics())
+        emit http1ConnectionStatistics(http1RequestsSent, http1RequestsPipelined,
+                                       http1MaximumPipelineDepth,
+                                       http1PendingHighPriorityRequests,
+                                       http1PendingLowPriorityRequests);
     emit downloadFinished();
 
     QMetaObject::invokeMethod(httpReply, "deleteLater", Qt::QueuedConnection);
@@ -546,6 +564,8 @@ void QHttpThreadDelegate::synchronousFinishedSlot()
     }
 
     synchronousDownloadData = httpReply->readAll();
+    if (!fetchHttp2StreamStatistics())
+        fetchHttp1ConnectionStatistics();
 
     QMetaObject::invokeMethod(httpReply, "deleteLater", Qt::QueuedConnection);
     QMetaObject::invokeMethod(synchronousRequestLoop, "quit", Qt::QueuedConnection);
@@ -566,6 +586,13 @@ void QHttpThreadDelegate::finishedWithErrorSlot(QNetworkReply::NetworkError erro
         emit sslConfigurationChanged(httpReply->sslConfiguration());
 #endif
     emit error(errorCode,detail);
+    if (fetchHttp2StreamStatistics())
+        emit http2StreamStatistics(http2BytesSent, http2BytesReceived, http2FlowControlBlockedTime);
+    else if (fetchHttp1ConnectionStatistics())
+        emit http1ConnectionStatistics(http1RequestsSent, http1RequestsPipelined,
+                                       http1MaximumPipelineDepth,
+                                       http1PendingHighPriorityRequests,
+                                       http1PendingLowPriorityRequests);
     emit downloadFinished();
 
 
@@ -587,12 +614,42 @@ void QHttpThreadDelegate::synchronousFinishedWithErrorSlot(QNetworkReply::Networ
     incomingErrorDetail = detail;
 
     synchronousDownloadData = httpReply->readAll();
+    if (!fetchHttp2StreamStatistics())
+        fetchHttp1ConnectionStatistics();
 
     QMetaObject::invokeMethod(httpReply, "deleteLater", Qt::QueuedConnection);
     QMetaObject::invokeMethod(synchronousRequestLoop, "quit", Qt::QueuedConnection);
     httpReply = nullptr;
 }
 
+// Takes the counters of the HTTP/2 stream the reply was received on, returns
+// false if it was not received with HTTP/2
+bool QHttpThreadDelegate::fetchHttp2StreamStatistics()
+{
+    if (!httpReply->isHttp2Used())
+        return false;
+    http2BytesSent = httpReply->http2BytesSent();
+    http2BytesReceived = httpReply->http2BytesReceived();
+    http2FlowControlBlockedTime = httpReply->http2FlowControlBlockedTime();
+    return true;
+}
+
+// Takes the counters of the HTTP/1 connection the reply was received on and
+// the number of requests still queued for the host, returns false if the
+// reply never got a connection
+bool QHttpThreadDelegate::fetchHttp1ConnectionStatistics()
+{
+    const QHttpNetworkConnectionChannel *channel = httpReply->connectionChannel();
+    if (!channel || !httpConnection)
+        return false;
+    http1RequestsSent = channel->requestsSent;
+    http1RequestsPipelined = channel->requestsPipelined;
+    http1MaximumPipelineDepth = channel->maximumPipelineDepth;
+    http1PendingHighPriorityRequests = httpConnection->pendingRequestCount(QHttpNetworkRequest::HighPriority);
+    http1PendingLowPriorityRequests = httpConnection->pendingRequestCount(QHttpNetworkRequest::NormalPriority);
+    return true;
+}
+
 static void downloadBufferDeleter(char *ptr)
 {
     delete[] ptr;
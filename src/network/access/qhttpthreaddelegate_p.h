@@ -62,6 +62,7 @@
 #include <QNetworkReply>
 #include "qhttpnetworkrequest_p.h"
 #include "qhttpnetworkconnection_p.h"
+#include "qhttp1configuration.h"
 #include "qhttp2configuration.h"
 #include <QSharedPointer>
 #include <QScopedPointer>
@@ -113,10 +114,19 @@ public:
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
     bool isHttp2Used;
+    qint64 http2BytesSent;
+    qint64 http2BytesReceived;
+    qint64 http2FlowControlBlockedTime;
+    qint64 http1RequestsSent;
+    qint64 http1RequestsPipelined;
+    int http1MaximumPipelineDepth;
+    int http1PendingHighPriorityRequests;
+    int http1PendingLowPriorityRequests;
     qint64 incomingContentLength;
     qint64 removedContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
+    QHttp1Configuration http1Parameters;
     QHttp2Configuration http2Parameters;
 
 protected:
@@ -126,6 +136,8 @@ protected:
     QNetworkAccessCachedHttpConnection *httpConnection;
     QByteArray cacheKey;
     QHttpNetworkReply *httpReply;
+    bool fetchHttp2StreamStatistics();
+    bool fetchHttp1ConnectionStatistics();
 
     // Used for implementing the synchronous HTTP, see startRequestSynchronously()
     QEventLoop *synchronousRequestLoop;
@@ -146,6 +158,8 @@ signals:
     void downloadProgress(qint64, qint64);
     void downloadData(const QByteArray &);
     void error(QNetworkReply::NetworkError, const QString &);
+    void http2StreamStatistics(qint64, qint64, qint64);
+    void http1ConnectionStatistics(qint64, qint64, int, int, int);
     void downloadFinished();
     void redirected(const QUrl &url, int httpStatus, int maxRedirectsRemainig);
 
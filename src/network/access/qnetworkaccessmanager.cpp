@@ -212,7 +212,8 @@ static void ensureInitialized()
     \note QNetworkAccessManager queues the requests it receives. The number
     of requests executed in parallel is dependent on the protocol.
     Currently, for the HTTP protocol on desktop platforms, 6 requests are
-    executed in parallel for one host/port combination.
+    executed in parallel for one host/port combination. This can be changed
+    with QNetworkRequest::setHttp1Configuration().
 
     A more involved example, assuming the manager is already existent,
     can be:
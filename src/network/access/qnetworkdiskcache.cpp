@@ -49,16 +49,29 @@
 #include <qdatastream.h>
 #include <qdatetime.h>
 #include <qdiriterator.h>
+#include <qrandom.h>
+#include <qsavefile.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
 #include <qdebug.h>
 
+#include <algorithm>
+
 #define CACHE_POSTFIX QLatin1String(".d")
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
+#define JOURNAL_FILE QLatin1String("journal")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
+// prepared files not written to for this long (in seconds) are left over
+#define PREPARED_FILE_MAX_AGE (24 * 60 * 60)
+// the data directory is rescanned this often (in seconds) for cache files
+// that no index knows about
+#define INDEX_MAX_AGE (24 * 60 * 60)
+#define JOURNAL_BUFFER_SIZE 4096
+#define JOURNAL_MAX_SIZE (1024 * 1024)
 
 QT_BEGIN_NAMESPACE
 
@@ -80,6 +93,16 @@ QT_BEGIN_NAMESPACE
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
 
+    The size and last access time of every cache file are kept in an index,
+    so that the cache size is known without scanning the cache directory and
+    expire() can remove the least recently used files first. The index is
+    kept in the cache directory together with a journal of the changes made
+    to it since it was written, so that it survives a crash of the
+    application, and so that disk caches in other processes using the same
+    directory know about each other's files when they expire. The cache
+    directory is scanned when no usable index is found, and once a day to
+    pick up files that no index knows about.
+
     Note you have to set the cache directory before it will work.
 
     A network disk cache can be enabled by:
@@ -112,6 +135,7 @@ QNetworkDiskCache::QNetworkDiskCache(QObject *parent)
 QNetworkDiskCache::~QNetworkDiskCache()
 {
     Q_D(QNetworkDiskCache);
+    d->saveIndex();
     qDeleteAll(d->inserting);
 }
 
@@ -142,14 +166,22 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
     Q_D(QNetworkDiskCache);
     if (cacheDir.isEmpty())
         return;
-    d->cacheDirectory = cacheDir;
-    QDir dir(d->cacheDirectory);
-    d->cacheDirectory = dir.absolutePath();
-    if (!d->cacheDirectory.endsWith(QLatin1Char('/')))
-        d->cacheDirectory += QLatin1Char('/');
+    QDir dir(cacheDir);
+    QString cacheDirectory = dir.absolutePath();
+    if (!cacheDirectory.endsWith(QLatin1Char('/')))
+        cacheDirectory += QLatin1Char('/');
+
+    const bool changed = (cacheDirectory != d->cacheDirectory);
+    if (changed) {
+        d->saveIndex();
+        d->resetIndex();
+    }
 
+    d->cacheDirectory = cacheDirectory;
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    if (changed)
+        d->loadIndex();
 }
 
 /*!
@@ -270,16 +302,21 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
 
+    ensureIndex();
     if (QFile::exists(fileName)) {
-        if (!QFile::remove(fileName)) {
+        if (!removeFile(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
     }
 
-    if (currentCacheSize > 0)
-        currentCacheSize += 1024 + cacheItem->size();
+    // make room for the new item; expire() is the extension point deciding
+    // what goes, and its result is the size of the cache from now on
+    pendingSize = 1024 + cacheItem->size();
     currentCacheSize = q->expire();
+    pendingSize = 0;
+    if (currentCacheSize < indexSize)
+        forgetMissingEntries();
     if (!cacheItem->file) {
         QString templateName = tmpCacheFileName();
         cacheItem->file = new QTemporaryFile(templateName, &cacheItem->data);
@@ -294,9 +331,11 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            const qint64 size = cacheItem->file->size();
+            recordEntry(fileName, size);
+            currentCacheSize += size;
+        } else
             cacheItem->file->setAutoRemove(true);
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
@@ -325,7 +364,9 @@ bool QNetworkDiskCache::remove(const QUrl &url)
 
     if (d->lastItem.metaData.url() == url)
         d->lastItem.reset();
-    return d->removeFile(d->cacheFileName(url));
+    const bool removed = d->removeFile(d->cacheFileName(url));
+    d->flushJournal();
+    return removed;
 }
 
 /*!
@@ -344,9 +385,11 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
         return false;
     qint64 size = info.size();
     if (QFile::remove(file)) {
+        forgetEntry(file);
         currentCacheSize -= size;
         return true;
     }
+    forgetEntryIfMissing(file);
     return false;
 }
 
@@ -361,7 +404,13 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    const QString fileName = d->cacheFileName(url);
+    QNetworkCacheMetaData metaData = fileMetaData(fileName);
+    if (metaData.isValid())
+        d->touchEntry(fileName);
+    else
+        d->forgetEntryIfMissing(fileName);
+    return metaData;
 }
 
 /*!
@@ -402,15 +451,19 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        const QString fileName = d->cacheFileName(url);
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            d->forgetEntryIfMissing(fileName);
             return nullptr;
+        }
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
             remove(url);
             return nullptr;
         }
+        d->touchEntry(fileName);
         if (d->lastItem.data.isOpen()) {
             // compressed
             buffer.reset(new QBuffer);
@@ -500,14 +553,18 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     Returns the current size of the cache.
 
     When the current size of the cache is greater than the maximumCacheSize()
-    older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    cache files are removed until the total size is less then 90% of
+    maximumCacheSize() starting with the least recently used ones first,
+    using the last time a cache file was inserted or read through a cache
+    using the same directory to determine how old it is.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
     knows about that QNetworkDiskCache does not, for example the number of times
-    a cache is accessed.
+    a cache is accessed. The returned size becomes the current cache size; if
+    it is smaller than the total size of the cache files QNetworkDiskCache
+    knows about, the files that the reimplementation removed are dropped from
+    its index.
 
     \note cacheSize() calls expire if the current cache size is unknown.
 
@@ -516,7 +573,9 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
-    if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
+    // account for what other caches using the directory did in the meantime
+    d->syncIndex();
+    if (d->currentCacheSize >= 0 && d->currentCacheSize + d->pendingSize < maximumCacheSize())
         return d->currentCacheSize;
 
     if (cacheDirectory().isEmpty()) {
@@ -526,57 +585,27 @@ qint64 QNetworkDiskCache::expire()
 
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
-
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
-            cacheItems.insert(birthTime.isValid() ? birthTime
-                              : info.fileTime(QFile::FileMetadataChangeTime), path);
-            totalSize += info.size();
-        }
-    }
+    d->ensureIndex();
 
     int removedFiles = 0;
     qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
-            break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = nullptr;
-                    break;
-                }
-            }
-        }
-
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
+    while (d->indexSize + d->pendingSize >= goal && !d->leastRecentlyUsed.isEmpty()) {
+        const QString name = d->dataDirectory + d->leastRecentlyUsed.first();
+        // stop tracking files that cannot be removed instead of retrying them
+        if (!d->removeFile(name))
+            d->forgetEntry(name);
         ++removedFiles;
-        ++i;
     }
 #if defined(QNETWORKDISKCACHE_DEBUG)
     if (removedFiles > 0) {
         qDebug() << "QNetworkDiskCache::expire()"
                 << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Kept:" << d->index.count();
     }
 #endif
-    return totalSize;
+    d->flushJournal();
+    d->currentCacheSize = d->indexSize;
+    return d->indexSize;
 }
 
 /*!
@@ -588,6 +617,8 @@ void QNetworkDiskCache::clear()
     qDebug("QNetworkDiskCache::clear()");
 #endif
     Q_D(QNetworkDiskCache);
+    // rescan, so that files the index does not know about are removed as well
+    d->resetIndex();
     qint64 size = d->maximumCacheSize;
     d->maximumCacheSize = 0;
     d->currentCacheSize = expire();
@@ -633,6 +664,477 @@ QString QNetworkDiskCachePrivate::cacheFileName(const QUrl &url) const
     return  fullpath;
 }
 
+enum
+{
+    IndexMagic = 0xe9,
+    JournalMagic = 0xea,
+    CurrentIndexVersion = 2
+};
+
+/*!
+    Returns the key of \a file in the index, or an empty string if \a file
+    does not live in the data directory.
+ */
+QString QNetworkDiskCachePrivate::indexKey(const QString &file) const
+{
+    if (dataDirectory.isEmpty() || !file.startsWith(dataDirectory))
+        return QString();
+    return file.mid(dataDirectory.size());
+}
+
+static bool isValidIndexKey(const QString &key)
+{
+    return key.endsWith(CACHE_POSTFIX) && !key.contains(QLatin1String(".."));
+}
+
+void QNetworkDiskCachePrivate::addIndexEntry(const QString &key, qint64 size, qint64 lastAccess)
+{
+    const auto it = index.constFind(key);
+    if (it != index.cend()) {
+        indexSize -= it->size;
+        leastRecentlyUsed.remove(it->sequence);
+    }
+    const quint64 sequence = ++accessSequence;
+    index.insert(key, { size, lastAccess, sequence });
+    leastRecentlyUsed.insert(sequence, key);
+    indexSize += size;
+}
+
+bool QNetworkDiskCachePrivate::removeIndexEntry(const QString &key)
+{
+    const auto it = index.constFind(key);
+    if (it == index.cend())
+        return false;
+    indexSize -= it->size;
+    leastRecentlyUsed.remove(it->sequence);
+    index.erase(it);
+    return true;
+}
+
+void QNetworkDiskCachePrivate::touchIndexEntry(const QString &key, qint64 lastAccess)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return;
+    leastRecentlyUsed.remove(it->sequence);
+    it->sequence = ++accessSequence;
+    it->lastAccess = lastAccess;
+    leastRecentlyUsed.insert(it->sequence, key);
+}
+
+/*!
+    Records that the cache file \a file of \a size bytes has just been written.
+ */
+void QNetworkDiskCachePrivate::recordEntry(const QString &file, qint64 size)
+{
+    if (!indexLoaded)
+        return;
+    const QString key = indexKey(file);
+    if (key.isEmpty())
+        return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    addIndexEntry(key, size, now);
+    journal(AddRecord, key, size, now);
+    // other caches must know about the file before they expire
+    flushJournal();
+}
+
+/*!
+    Drops \a file from the index. Returns \c false if it was not indexed.
+ */
+bool QNetworkDiskCachePrivate::forgetEntry(const QString &file)
+{
+    if (!indexLoaded)
+        return false;
+    const QString key = indexKey(file);
+    if (!removeIndexEntry(key))
+        return false;
+    journal(RemoveRecord, key, 0, 0);
+    return true;
+}
+
+/*!
+    Drops \a file from the index if it was removed behind the cache's back.
+ */
+void QNetworkDiskCachePrivate::forgetEntryIfMissing(const QString &file)
+{
+    if (!indexLoaded)
+        return;
+    const auto it = index.constFind(indexKey(file));
+    if (it == index.cend() || QFile::exists(file))
+        return;
+    if (currentCacheSize >= 0)
+        currentCacheSize = qMax(qint64(0), currentCacheSize - it->size);
+    forgetEntry(file);
+}
+
+/*!
+    Drops all files that were removed behind the cache's back from the index.
+ */
+void QNetworkDiskCachePrivate::forgetMissingEntries()
+{
+    if (!indexLoaded)
+        return;
+    const QStringList keys = index.keys();
+    for (const QString &key : keys) {
+        if (!QFile::exists(dataDirectory + key))
+            forgetEntry(dataDirectory + key);
+    }
+}
+
+/*!
+    Makes \a file the most recently used cache file.
+ */
+void QNetworkDiskCachePrivate::touchEntry(const QString &file)
+{
+    if (!indexLoaded)
+        return;
+    const QString key = indexKey(file);
+    if (!index.contains(key))
+        return;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    touchIndexEntry(key, now);
+    journal(TouchRecord, key, 0, now);
+}
+
+void QNetworkDiskCachePrivate::resetIndex()
+{
+    index.clear();
+    leastRecentlyUsed.clear();
+    indexSize = 0;
+    indexLoaded = false;
+    currentCacheSize = -1;
+    journalOffset = 0;
+    journalBuffer.clear();
+}
+
+/*!
+    Builds the index by scanning the data directory, unless it is already
+    known. Only needed when no index could be read in setCacheDirectory().
+ */
+void QNetworkDiskCachePrivate::ensureIndex()
+{
+    if (indexLoaded || dataDirectory.isEmpty())
+        return;
+    scanIndex();
+}
+
+/*!
+    Rebuilds the index from the files in the data directory and writes it.
+
+    Files the index already knows about keep their last access time, others
+    are ordered by the time they were created.
+ */
+void QNetworkDiskCachePrivate::scanIndex()
+{
+    const QHash<QString, IndexEntry> known = index;
+    resetIndex();
+
+    struct ScannedFile {
+        QString key;
+        qint64 size;
+        qint64 lastAccess;
+    };
+    QList<ScannedFile> files;
+    const QStringList nameFilters(QLatin1Char('*') + CACHE_POSTFIX);
+    QDirIterator it(dataDirectory, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QString key = path.mid(dataDirectory.size());
+        const QFileInfo info = it.fileInfo();
+        const auto entry = known.constFind(key);
+        if (entry != known.cend()) {
+            files.append({ key, info.size(), entry->lastAccess });
+            continue;
+        }
+        const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
+        const QDateTime time = birthTime.isValid() ? birthTime
+                                                   : info.fileTime(QFile::FileMetadataChangeTime);
+        files.append({ key, info.size(), time.toMSecsSinceEpoch() });
+    }
+    std::stable_sort(files.begin(), files.end(), [](const ScannedFile &a, const ScannedFile &b) {
+        return a.lastAccess < b.lastAccess;
+    });
+    for (const ScannedFile &file : qAsConst(files))
+        addIndexEntry(file.key, file.size, file.lastAccess);
+
+    // remove prepared files left behind by insertions that never finished;
+    // other caches sharing the directory may still be writing recent ones
+    const QDateTime staleTime = QDateTime::currentDateTimeUtc().addSecs(-PREPARED_FILE_MAX_AGE);
+    QDirIterator prepared(cacheDirectory + PREPARED_SLASH, nameFilters, QDir::Files);
+    while (prepared.hasNext()) {
+        const QString path = prepared.next();
+        if (prepared.fileInfo().lastModified().toUTC() > staleTime)
+            continue;
+        bool pending = false;
+        for (QCacheItem *item : qAsConst(inserting)) {
+            if (item && item->file && item->file->fileName() == path) {
+                pending = true;
+                break;
+            }
+        }
+        if (!pending)
+            QFile::remove(path);
+    }
+
+    indexLoaded = true;
+    lastScan = QDateTime::currentMSecsSinceEpoch();
+    currentCacheSize = indexSize;
+    writeIndex();
+}
+
+/*!
+    Brings the index up to date with the changes that other caches using
+    the same directory journaled, and rescans the data directory if the
+    index is stale or was not scanned for INDEX_MAX_AGE seconds.
+ */
+void QNetworkDiskCachePrivate::syncIndex()
+{
+    if (!indexLoaded)
+        return;
+    flushJournal();
+    const qint64 size = indexSize;
+    if (replayJournal()) {
+        if (currentCacheSize >= 0)
+            currentCacheSize = qMax(qint64(0), currentCacheSize + indexSize - size);
+    } else {
+        // another cache wrote a new index, or the journal is damaged
+        resetIndex();
+        loadIndex();
+    }
+    if (!indexLoaded || QDateTime::currentMSecsSinceEpoch() - lastScan > INDEX_MAX_AGE * 1000)
+        scanIndex();
+}
+
+/*!
+    Reads the index written by writeIndex() and applies the changes
+    journaled since, if any.
+
+    If there is no index, or its journal does not belong to it, the index
+    is left unloaded so that the data directory is scanned instead.
+ */
+void QNetworkDiskCachePrivate::loadIndex()
+{
+    QFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    qint32 marker;
+    qint32 version;
+    quint64 generation;
+    qint64 scanned;
+    qint64 count;
+    in >> marker >> version >> generation >> scanned >> count;
+    if (in.status() != QDataStream::Ok || marker != IndexMagic
+            || version != CurrentIndexVersion || count < 0) {
+        return;
+    }
+    for (qint64 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        qint64 size;
+        qint64 lastAccess;
+        in >> key >> size >> lastAccess;
+        if (!isValidIndexKey(key) || size < 0)
+            in.setStatus(QDataStream::ReadCorruptData);
+        else
+            addIndexEntry(key, size, lastAccess);
+    }
+    indexGeneration = generation;
+    journalOffset = 0;
+    if (in.status() == QDataStream::Ok && in.atEnd() && replayJournal()) {
+        indexLoaded = true;
+        lastScan = scanned;
+        currentCacheSize = indexSize;
+    } else {
+        resetIndex();
+    }
+}
+
+/*!
+    Writes the index to the data directory, including the changes that
+    other caches using the same directory journaled.
+ */
+void QNetworkDiskCachePrivate::saveIndex()
+{
+    if (!indexLoaded || dataDirectory.isEmpty())
+        return;
+    flushJournal();
+    if (!replayJournal()) {
+        resetIndex();
+        loadIndex();
+        if (!indexLoaded)
+            return;
+    }
+    writeIndex();
+}
+
+/*!
+    Writes the index to the data directory, oldest entry first, and starts
+    a new journal for it.
+ */
+void QNetworkDiskCachePrivate::writeIndex()
+{
+    // a random generation, so that caches sharing the directory can tell
+    // their index from the ones the others write
+    const quint64 generation = QRandomGenerator::global()->generate64();
+    QSaveFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << qint32(IndexMagic) << qint32(CurrentIndexVersion) << generation << lastScan
+        << qint64(index.size());
+    for (const QString &key : qAsConst(leastRecentlyUsed)) {
+        const IndexEntry entry = index.value(key);
+        out << key << entry.size << entry.lastAccess;
+    }
+    if (!file.commit()) {
+        qWarning() << "QNetworkDiskCache: couldn't write the cache index" << file.fileName();
+        return;
+    }
+
+    QSaveFile journalFile(dataDirectory + JOURNAL_FILE);
+    if (!journalFile.open(QIODevice::WriteOnly))
+        return;
+    QDataStream journalOut(&journalFile);
+    journalOut.setVersion(QDataStream::Qt_6_0);
+    journalOut << qint32(JournalMagic) << qint32(CurrentIndexVersion) << generation;
+    if (!journalFile.commit()) {
+        qWarning() << "QNetworkDiskCache: couldn't write the cache journal" << journalFile.fileName();
+        return;
+    }
+    indexGeneration = generation;
+    journalOffset = 0;
+    journalBuffer.clear();
+}
+
+/*!
+    Queues a record of a change to the index for the journal. Records are
+    written by flushJournal().
+ */
+void QNetworkDiskCachePrivate::journal(JournalRecordType type, const QString &key,
+                                       qint64 size, qint64 lastAccess)
+{
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << qint8(type) << key;
+    if (type == AddRecord)
+        out << size;
+    if (type != RemoveRecord)
+        out << lastAccess;
+
+    QDataStream buffer(&journalBuffer, QIODevice::WriteOnly | QIODevice::Append);
+    buffer.setVersion(QDataStream::Qt_6_0);
+    buffer << record;
+    if (journalBuffer.size() >= JOURNAL_BUFFER_SIZE)
+        flushJournal();
+}
+
+/*!
+    Appends the queued records to the journal, and writes a new index when
+    the journal has grown too large.
+ */
+void QNetworkDiskCachePrivate::flushJournal()
+{
+    if (journalBuffer.isEmpty() || !indexLoaded)
+        return;
+    QFile file(dataDirectory + JOURNAL_FILE);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        journalBuffer.clear();
+        return;
+    }
+    QByteArray data;
+    if (file.size() == 0) {
+        QDataStream header(&data, QIODevice::WriteOnly);
+        header.setVersion(QDataStream::Qt_6_0);
+        header << qint32(JournalMagic) << qint32(CurrentIndexVersion) << indexGeneration;
+    }
+    data += journalBuffer;
+    journalBuffer.clear();
+    // a single write, so that the records of caches sharing the journal
+    // do not interleave
+    file.write(data);
+    const bool compact = file.size() > JOURNAL_MAX_SIZE;
+    file.close();
+    if (compact)
+        saveIndex();
+}
+
+/*!
+    Applies the journal records that were written since the last call,
+    including the ones written by this cache, which is harmless.
+
+    Returns \c false if the journal does not belong to the index, or is
+    damaged.
+ */
+bool QNetworkDiskCachePrivate::replayJournal()
+{
+    QFile file(dataDirectory + JOURNAL_FILE);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    qint32 marker;
+    qint32 version;
+    quint64 generation;
+    in >> marker >> version >> generation;
+    if (in.status() != QDataStream::Ok || marker != JournalMagic
+            || version != CurrentIndexVersion || generation != indexGeneration) {
+        return false;
+    }
+    if (journalOffset <= file.pos())
+        journalOffset = file.pos();
+    else if (!file.seek(journalOffset))
+        return false;
+
+    while (!in.atEnd()) {
+        QByteArray record;
+        in >> record;
+        // the last record may still be being written by another cache
+        if (in.status() == QDataStream::ReadPastEnd)
+            break;
+        if (in.status() != QDataStream::Ok || !replayJournalRecord(record))
+            return false;
+        journalOffset = file.pos();
+    }
+    return true;
+}
+
+bool QNetworkDiskCachePrivate::replayJournalRecord(const QByteArray &record)
+{
+    QDataStream in(record);
+    in.setVersion(QDataStream::Qt_6_0);
+    qint8 type;
+    QString key;
+    qint64 size = 0;
+    qint64 lastAccess = 0;
+    in >> type >> key;
+    if (type == AddRecord)
+        in >> size;
+    if (type != RemoveRecord)
+        in >> lastAccess;
+    if (in.status() != QDataStream::Ok || !in.atEnd() || !isValidIndexKey(key) || size < 0)
+        return false;
+
+    switch (type) {
+    case AddRecord:
+        addIndexEntry(key, size, lastAccess);
+        return true;
+    case TouchRecord:
+        touchIndexEntry(key, lastAccess);
+        return true;
+    case RemoveRecord:
+        removeIndexEntry(key);
+        return true;
+    }
+    return false;
+}
+
 /*!
     We compress small text and JavaScript files.
  */
@@ -56,6 +56,7 @@
 
 #include <qbuffer.h>
 #include <qhash.h>
+#include <qmap.h>
 #include <qtemporaryfile.h>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
@@ -101,6 +102,13 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , indexSize(0)
+        , pendingSize(0)
+        , accessSequence(0)
+        , indexGeneration(0)
+        , lastScan(0)
+        , journalOffset(0)
+        , indexLoaded(false)
         {}
 
     static QString uniqueFileName(const QUrl &url);
@@ -111,12 +119,57 @@ public:
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    // The index of the files in dataDirectory, in least recently used order
+    struct IndexEntry {
+        qint64 size;
+        qint64 lastAccess; // msecs since epoch
+        quint64 sequence;  // key in leastRecentlyUsed
+    };
+    // The changes to the index since it was written, shared by all caches
+    // using dataDirectory
+    enum JournalRecordType : qint8 {
+        AddRecord = 1,
+        TouchRecord,
+        RemoveRecord
+    };
+    QString indexKey(const QString &file) const;
+    void addIndexEntry(const QString &key, qint64 size, qint64 lastAccess);
+    bool removeIndexEntry(const QString &key);
+    void touchIndexEntry(const QString &key, qint64 lastAccess);
+    void recordEntry(const QString &file, qint64 size);
+    bool forgetEntry(const QString &file);
+    void forgetEntryIfMissing(const QString &file);
+    void forgetMissingEntries();
+    void touchEntry(const QString &file);
+    void resetIndex();
+    void ensureIndex();
+    void scanIndex();
+    void syncIndex();
+    void loadIndex();
+    void saveIndex();
+    void writeIndex();
+    void journal(JournalRecordType type, const QString &key, qint64 size, qint64 lastAccess);
+    void flushJournal();
+    bool replayJournal();
+    bool replayJournalRecord(const QByteArray &record);
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
 
+    QHash<QString, IndexEntry> index;
+    QMap<quint64, QString> leastRecentlyUsed;
+    qint64 indexSize;
+    qint64 pendingSize; // of the item being stored, while expire() makes room
+    quint64 accessSequence;
+    quint64 indexGeneration; // written with the index and its journal
+    qint64 lastScan; // msecs since epoch
+    qint64 journalOffset; // of the first record not replayed yet
+    QByteArray journalBuffer; // records not written to the journal yet
+    bool indexLoaded;
+
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
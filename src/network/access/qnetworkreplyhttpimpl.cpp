@@ -786,7 +786,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
 
     // Create the HTTP thread delegate
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
-    // Propagate Http/2 settings:
+    // Propagate Http/1 and Http/2 settings:
+    delegate->http1Parameters = request.http1Configuration();
     delegate->http2Parameters = request.http2Configuration();
 
     // For the synchronous HTTP, this is the normal way the delegate gets deleted
@@ -857,6 +858,12 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         QObject::connect(delegate, SIGNAL(downloadProgress(qint64,qint64)),
                 q, SLOT(replyDownloadProgressSlot(qint64,qint64)),
                 Qt::QueuedConnection);
+        QObject::connect(delegate, SIGNAL(http2StreamStatistics(qint64,qint64,qint64)),
+                q, SLOT(replyHttp2StreamStatistics(qint64,qint64,qint64)),
+                Qt::QueuedConnection);
+        QObject::connect(delegate, SIGNAL(http1ConnectionStatistics(qint64,qint64,int,int,int)),
+                q, SLOT(replyHttp1ConnectionStatistics(qint64,qint64,int,int,int)),
+                Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(error(QNetworkReply::NetworkError,QString)),
                 q, SLOT(httpError(QNetworkReply::NetworkError,QString)),
                 Qt::QueuedConnection);
@@ -978,6 +985,17 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
             replyDownloadData(delegate->synchronousDownloadData);
         }
 
+        if (delegate->isHttp2Used) {
+            replyHttp2StreamStatistics(delegate->http2BytesSent, delegate->http2BytesReceived,
+                                       delegate->http2FlowControlBlockedTime);
+        } else {
+            replyHttp1ConnectionStatistics(delegate->http1RequestsSent,
+                                           delegate->http1RequestsPipelined,
+                                           delegate->http1MaximumPipelineDepth,
+                                           delegate->http1PendingHighPriorityRequests,
+                                           delegate->http1PendingLowPriorityRequests);
+        }
+
         thread->quit();
         thread->wait(QDeadlineTimer(5000));
         if (thread->isFinished())
@@ -1402,6 +1420,32 @@ void QNetworkReplyHttpImplPrivate::replyDownloadProgressSlot(qint64 bytesReceive
     }
 }
 
+void QNetworkReplyHttpImplPrivate::replyHttp2StreamStatistics(qint64 bytesSent,
+                                                               qint64 bytesReceived,
+                                                               qint64 flowControlBlockedTime)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+    q->setAttribute(QNetworkRequest::Http2StreamBytesSentAttribute, bytesSent);
+    q->setAttribute(QNetworkRequest::Http2StreamBytesReceivedAttribute, bytesReceived);
+    q->setAttribute(QNetworkRequest::Http2FlowControlBlockedTimeAttribute, flowControlBlockedTime);
+}
+
+void QNetworkReplyHttpImplPrivate::replyHttp1ConnectionStatistics(qint64 requestsSent,
+                                                                  qint64 requestsPipelined,
+                                                                  int maximumPipelineDepth,
+                                                                  int pendingHighPriorityRequests,
+                                                                  int pendingLowPriorityRequests)
+{
+    Q_Q(QNetworkReplyHttpImpl);
+    q->setAttribute(QNetworkRequest::Http1RequestsSentAttribute, requestsSent);
+    q->setAttribute(QNetworkRequest::Http1RequestsPipelinedAttribute, requestsPipelined);
+    q->setAttribute(QNetworkRequest::Http1MaximumPipelineDepthAttribute, maximumPipelineDepth);
+    q->setAttribute(QNetworkRequest::Http1PendingHighPriorityRequestsAttribute,
+                    pendingHighPriorityRequests);
+    q->setAttribute(QNetworkRequest::Http1PendingLowPriorityRequestsAttribute,
+                    pendingLowPriorityRequests);
+}
+
 void QNetworkReplyHttpImplPrivate::httpAuthenticationRequired(const QHttpNetworkRequest &request,
                                                            QAuthenticator *auth)
 {
@@ -112,6 +112,8 @@ public:
                                                         int, QString, bool, QSharedPointer<char>,
                                                         qint64, qint64, bool))
     Q_PRIVATE_SLOT(d_func(), void replyDownloadProgressSlot(qint64,qint64))
+    Q_PRIVATE_SLOT(d_func(), void replyHttp2StreamStatistics(qint64,qint64,qint64))
+    Q_PRIVATE_SLOT(d_func(), void replyHttp1ConnectionStatistics(qint64,qint64,int,int,int))
     Q_PRIVATE_SLOT(d_func(), void httpAuthenticationRequired(const QHttpNetworkRequest &, QAuthenticator *))
     Q_PRIVATE_SLOT(d_func(), void httpError(QNetworkReply::NetworkError, const QString &))
 #ifndef QT_NO_SSL
@@ -276,6 +278,12 @@ public:
     void replyDownloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &,
                                bool, QSharedPointer<char>, qint64, qint64, bool);
     void replyDownloadProgressSlot(qint64,qint64);
+    void replyHttp2StreamStatistics(qint64 bytesSent, qint64 bytesReceived,
+                                    qint64 flowControlBlockedTime);
+    void replyHttp1ConnectionStatistics(qint64 requestsSent, qint64 requestsPipelined,
+                                        int maximumPipelineDepth,
+                                        int pendingHighPriorityRequests,
+                                        int pendingLowPriorityRequests);
     void httpAuthenticationRequired(const QHttpNetworkRequest &request, QAuthenticator *auth);
     void httpError(QNetworkReply::NetworkError error, const QString &errorString);
 #ifndef QT_NO_SSL
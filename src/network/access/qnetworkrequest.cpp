@@ -43,6 +43,7 @@
 #include "qnetworkcookie.h"
 #include "qsslconfiguration.h"
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC)
+#include "qhttp1configuration.h"
 #include "qhttp2configuration.h"
 #include "private/http2protocol_p.h"
 #endif
@@ -212,7 +213,9 @@ QT_BEGIN_NAMESPACE
     \value HttpPipeliningAllowedAttribute
         Requests only, type: QMetaType::Bool (default: false)
         Indicates whether the QNetworkAccessManager code is
-        allowed to use HTTP pipelining with this request.
+        allowed to use HTTP pipelining with this request. The number of
+        requests pipelined on a connection is set by
+        QHttp1Configuration::setPipelineDepth().
 
     \value HttpPipeliningWasUsedAttribute
         Replies only, type: QMetaType::Bool
@@ -319,6 +322,62 @@ QT_BEGIN_NAMESPACE
         the QNetworkReply after having emitted "finished".
         (This value was introduced in 5.14.)
 
+    \value Http2StreamBytesSentAttribute
+        Replies only, type: QMetaType::LongLong
+        The number of payload octets of DATA frames sent on the HTTP/2
+        stream of the reply. Set when the reply has finished and
+        Http2WasUsedAttribute is true.
+        (This value was introduced in 6.1.)
+
+    \value Http2StreamBytesReceivedAttribute
+        Replies only, type: QMetaType::LongLong
+        The number of payload octets of DATA frames received on the HTTP/2
+        stream of the reply, padding included. Set when the reply has finished
+        and Http2WasUsedAttribute is true.
+        (This value was introduced in 6.1.)
+
+    \value Http2FlowControlBlockedTimeAttribute
+        Replies only, type: QMetaType::LongLong
+        The time in milliseconds the upload of the request had data to send
+        but had to wait for the peer to open its HTTP/2 flow control window.
+        Set when the reply has finished and Http2WasUsedAttribute is true.
+        (This value was introduced in 6.1.)
+
+    \value Http1RequestsSentAttribute
+        Replies only, type: QMetaType::LongLong
+        The number of requests sent so far on the HTTP/1 connection the
+        reply was received on, the request of the reply included. Set when
+        the reply has finished and Http2WasUsedAttribute is false.
+        (This value was introduced in 6.1.)
+
+    \value Http1RequestsPipelinedAttribute
+        Replies only, type: QMetaType::LongLong
+        The number of requests out of Http1RequestsSentAttribute that were
+        pipelined behind another request on the connection. Set when the
+        reply has finished and Http2WasUsedAttribute is false.
+        (This value was introduced in 6.1.)
+
+    \value Http1MaximumPipelineDepthAttribute
+        Replies only, type: QMetaType::Int
+        The largest number of requests the HTTP/1 connection the reply was
+        received on had waiting for their replies at once. Set when the
+        reply has finished and Http2WasUsedAttribute is false.
+        (This value was introduced in 6.1.)
+
+    \value Http1PendingHighPriorityRequestsAttribute
+        Replies only, type: QMetaType::Int
+        The number of high priority requests to the same host that were
+        still waiting for a free connection when the reply finished. Set
+        when the reply has finished and Http2WasUsedAttribute is false.
+        (This value was introduced in 6.1.)
+
+    \value Http1PendingLowPriorityRequestsAttribute
+        Replies only, type: QMetaType::Int
+        The number of normal and low priority requests to the same host that
+        were still waiting for a free connection when the reply finished.
+        Set when the reply has finished and Http2WasUsedAttribute is false.
+        (This value was introduced in 6.1.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -440,6 +499,7 @@ public:
 #endif
         peerVerifyName = other.peerVerifyName;
 #if QT_CONFIG(http)
+        h1Configuration = other.h1Configuration;
         h2Configuration = other.h2Configuration;
 #endif
         transferTimeout = other.transferTimeout;
@@ -454,6 +514,7 @@ public:
             maxRedirectsAllowed == other.maxRedirectsAllowed &&
             peerVerifyName == other.peerVerifyName
 #if QT_CONFIG(http)
+            && h1Configuration == other.h1Configuration
             && h2Configuration == other.h2Configuration
 #endif
             && transferTimeout == other.transferTimeout
@@ -469,6 +530,7 @@ public:
     int maxRedirectsAllowed;
     QString peerVerifyName;
 #if QT_CONFIG(http)
+    QHttp1Configuration h1Configuration;
     QHttp2Configuration h2Configuration;
 #endif
     int transferTimeout;
@@ -896,6 +958,39 @@ void QNetworkRequest::setHttp2Configuration(const QHttp2Configuration &configura
 {
     d->h2Configuration = configuration;
 }
+
+/*!
+    \since 6.1
+
+    Returns the current parameters that QNetworkAccessManager is
+    using for this request and its underlying HTTP/1 connections.
+    This is either a configuration previously set by an application
+    or a default configuration.
+
+    \sa setHttp1Configuration, QHttp1Configuration
+*/
+QHttp1Configuration QNetworkRequest::http1Configuration() const
+{
+    return d->h1Configuration;
+}
+
+/*!
+    \since 6.1
+
+    Sets request's HTTP/1 parameters from \a configuration.
+
+    \note The configuration must be set prior to making a request.
+    \note QNetworkAccessManager shares the connections to a host
+    between all requests sent to it. This implies that
+    QNetworkAccessManager will use the configuration found in the
+    first request from a series of requests sent to the same host.
+
+    \sa http1Configuration, QNetworkAccessManager, QHttp1Configuration
+*/
+void QNetworkRequest::setHttp1Configuration(const QHttp1Configuration &configuration)
+{
+    d->h1Configuration = configuration;
+}
 #endif // QT_CONFIG(http) || defined(Q_CLANG_QDOC)
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC) || defined (Q_OS_WASM)
 /*!
@@ -49,6 +49,7 @@
 QT_BEGIN_NAMESPACE
 
 class QSslConfiguration;
+class QHttp1Configuration;
 class QHttp2Configuration;
 
 class QNetworkRequestPrivate;
@@ -97,6 +98,14 @@ public:
         Http2DirectAttribute,
         ResourceTypeAttribute, // internal
         AutoDeleteReplyOnFinishAttribute,
+        Http2StreamBytesSentAttribute,
+        Http2StreamBytesReceivedAttribute,
+        Http2FlowControlBlockedTimeAttribute,
+        Http1RequestsSentAttribute,
+        Http1RequestsPipelinedAttribute,
+        Http1MaximumPipelineDepthAttribute,
+        Http1PendingHighPriorityRequestsAttribute,
+        Http1PendingLowPriorityRequestsAttribute,
 
         User = 1000,
         UserMax = 32767
@@ -179,6 +188,8 @@ public:
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC)
     QHttp2Configuration http2Configuration() const;
     void setHttp2Configuration(const QHttp2Configuration &configuration);
+    QHttp1Configuration http1Configuration() const;
+    void setHttp1Configuration(const QHttp1Configuration &configuration);
 #endif // QT_CONFIG(http) || defined(Q_CLANG_QDOC)
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC) || defined (Q_OS_WASM)
     int transferTimeout() const;
@@ -137,6 +137,26 @@ ci.ifa_prefered = ci.ifa_valid = 0;
 }
 ")
 
+# sendmmsg
+qt_config_compile_test(sendmmsg
+    LABEL "sendmmsg() and recvmmsg()"
+    CODE
+"#define _GNU_SOURCE 1
+#include <sys/types.h>
+#include <sys/socket.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+struct mmsghdr msgs[2] = {};
+(void) sendmmsg(-1, msgs, 2, 0);
+(void) recvmmsg(-1, msgs, 2, MSG_DONTWAIT, nullptr);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # sctp
 qt_config_compile_test(sctp
     LABEL "SCTP support"
@@ -257,6 +277,10 @@ qt_feature("linux-netlink" PRIVATE
     LABEL "Linux AF_NETLINK"
     CONDITION LINUX AND NOT ANDROID AND TEST_linux_netlink
 )
+qt_feature("sendmmsg" PRIVATE
+    LABEL "sendmmsg() and recvmmsg()"
+    CONDITION QT_FEATURE_udpsocket AND TEST_sendmmsg
+)
 qt_feature("openssl" PRIVATE
     LABEL "OpenSSL"
     CONDITION QT_FEATURE_openssl_runtime OR QT_FEATURE_openssl_linked
@@ -470,6 +470,7 @@
 #include "private/qhostinfo_p.h"
 
 #include <qabstracteventdispatcher.h>
+#include <qfiledevice.h>
 #include <qhostaddress.h>
 #include <qhostinfo.h>
 #include <qmetaobject.h>
@@ -480,6 +481,9 @@
 #include <qvarlengtharray.h>
 
 #include <private/qthread_p.h>
+#ifdef Q_OS_UNIX
+#include <private/qcore_unix_p.h>
+#endif
 
 #ifdef QABSTRACTSOCKET_DEBUG
 #include <qdebug.h>
@@ -500,6 +504,8 @@
 QT_BEGIN_NAMESPACE
 
 static const int DefaultConnectTimeout = 30000;
+// Write buffer chunks handed to the socket engine in a single write
+static const int MaxWriteSegments = 64;
 
 #if defined QABSTRACTSOCKET_DEBUG
 QT_BEGIN_INCLUDE_NAMESPACE
@@ -571,6 +577,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       isBuffered(false),
       hasPendingData(false),
       connectTimer(nullptr),
+      feedingFileTransfers(false),
       hostLookupId(-1),
       socketType(QAbstractSocket::UnknownSocketType),
       state(QAbstractSocket::UnconnectedState),
@@ -587,6 +594,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
 */
 QAbstractSocketPrivate::~QAbstractSocketPrivate()
 {
+    clearFileTransfers();
 }
 
 /*! \internal
@@ -827,7 +835,7 @@ bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
     if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
-        && socketEngine->bytesToWrite() == 0)) {
+        && fileTransfers.isEmpty() && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
            (socketEngine && socketEngine->isValid()) ? "yes" : "no", writeBuffer.isEmpty() ? "yes" : "no");
@@ -844,11 +852,29 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    if (!fileTransfers.isEmpty() && fileTransfers.constFirst().precedingBytes == 0)
+        return writeFileToSocket();
+
+    // Gather the buffered chunks, but don't write past the point where a
+    // file transfer was queued.
+    const qint64 limit = fileTransfers.isEmpty() ? writeBuffer.size()
+                                                 : fileTransfers.constFirst().precedingBytes;
+    QVarLengthArray<QByteArrayView, MaxWriteSegments> segments;
+    qint64 nextSize = 0;
+    while (nextSize < limit && segments.size() < MaxWriteSegments) {
+        qint64 length;
+        const char *ptr = writeBuffer.readPointerAtPosition(nextSize, length);
+        length = qMin(length, limit - nextSize);
+        segments.append(QByteArrayView(ptr, length));
+        nextSize += length;
+    }
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    // Attempt to write them all with one call.
+    qint64 written = Q_INT64_C(0);
+    if (segments.size() > 1)
+        written = socketEngine->writeSegments(segments.constData(), segments.size());
+    else if (nextSize)
+        written = socketEngine->write(segments.first().data(), nextSize);
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -868,19 +894,221 @@ bool QAbstractSocketPrivate::writeToSocket()
     if (written > 0) {
         // Remove what we wrote so far.
         writeBuffer.free(written);
+        if (!fileTransfers.isEmpty())
+            fileTransfers.first().precedingBytes -= written;
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (writeBuffer.isEmpty() && fileTransfers.isEmpty() && socketEngine
+        && !socketEngine->bytesToWrite()) {
         socketEngine->setWriteNotificationEnabled(false);
+    }
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
 
     return written > 0;
 }
 
+#ifdef Q_OS_UNIX
+/*! \internal
+
+    Reads the next chunk of at most \a maxSize bytes of \a transfer into
+    \a buffer, without moving the file position.
+*/
+static qint64 readFileTransfer(const QAbstractSocketPrivate::FileTransfer &transfer,
+                               char *buffer, qint64 maxSize)
+{
+    const size_t chunkSize = size_t(qMin(transfer.remaining, maxSize));
+    qint64 readBytes;
+#ifdef QT_LARGEFILE_SUPPORT
+    EINTR_LOOP(readBytes, ::pread64(transfer.fileDescriptor, buffer, chunkSize, transfer.offset));
+#else
+    EINTR_LOOP(readBytes, ::pread(transfer.fileDescriptor, buffer, chunkSize, transfer.offset));
+#endif
+    return readBytes;
+}
+#endif
+
+/*! \internal
+
+    Sends the next part of the file transfer at the head of the queue,
+    through the socket engine's sendFile() if it can, or by reading the
+    file and writing the data otherwise.
+
+    Emits bytesWritten().
+*/
+bool QAbstractSocketPrivate::writeFileToSocket()
+{
+#ifdef Q_OS_UNIX
+    Q_Q(QAbstractSocket);
+    FileTransfer &transfer = fileTransfers.first();
+
+    qint64 written = -2;
+    if (!transfer.copy) {
+        written = socketEngine->sendFile(transfer.fileDescriptor, transfer.offset,
+                                         transfer.remaining);
+        transfer.copy = (written == -2);
+    }
+    if (transfer.copy) {
+        char buffer[QABSTRACTSOCKET_BUFFERSIZE];
+        const qint64 readBytes = readFileTransfer(transfer, buffer, sizeof buffer);
+        if (readBytes < 0) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError, qt_error_string(errno));
+            q->abort();
+            return false;
+        }
+        // A file that shrank ends the transfer early.
+        if (readBytes == 0)
+            transfer.remaining = 0;
+        written = readBytes ? socketEngine->write(buffer, readBytes) : Q_INT64_C(0);
+    }
+
+    if (written < 0) {
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::writeFileToSocket() write error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        // an unexpected error so close the socket.
+        q->abort();
+        return false;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeFileToSocket() %lld bytes written to the network",
+           written);
+#endif
+
+    transfer.offset += written;
+    transfer.remaining = qMax(Q_INT64_C(0), transfer.remaining - written);
+    const bool finished = (transfer.remaining == 0);
+    if (finished) {
+        qt_safe_close(transfer.fileDescriptor);
+        fileTransfers.removeFirst();
+    }
+
+    if (written > 0)
+        emitBytesWritten(written);
+
+    if (writeBuffer.isEmpty() && fileTransfers.isEmpty() && socketEngine
+        && !socketEngine->bytesToWrite()) {
+        socketEngine->setWriteNotificationEnabled(false);
+    }
+    if (state == QAbstractSocket::ClosingState)
+        q->disconnectFromHost();
+
+    return written > 0 || finished;
+#else
+    return false;
+#endif
+}
+
+/*! \internal
+
+    Drops the file transfers queued by sendFile() that have not completed.
+*/
+void QAbstractSocketPrivate::clearFileTransfers()
+{
+#ifdef Q_OS_UNIX
+    for (const FileTransfer &transfer : qAsConst(fileTransfers))
+        qt_safe_close(transfer.fileDescriptor);
+#endif
+    fileTransfers.clear();
+    deferredWriteBuffer.clear();
+}
+
+/*! \internal
+
+    Writes the file transfers queued by sendFile(), and the data written
+    after them, to the socket with write(), for sockets that feed them
+    (see feedsFileTransfers()). Only tops up what the socket has buffered
+    to QABSTRACTSOCKET_BUFFERSIZE bytes, so a large file is never held in
+    memory; call it again whenever the socket has written some data.
+*/
+void QAbstractSocketPrivate::feedFileTransfers()
+{
+#ifdef Q_OS_UNIX
+    Q_Q(QAbstractSocket);
+    if (feedingFileTransfers)
+        return;
+    QScopedValueRollback<bool> feeding(feedingFileTransfers, true);
+
+    char buffer[QABSTRACTSOCKET_BUFFERSIZE];
+    while (!fileTransfers.isEmpty() && bufferedWriteBytes() < QABSTRACTSOCKET_BUFFERSIZE) {
+        FileTransfer &transfer = fileTransfers.first();
+        if (transfer.precedingBytes > 0) {
+            const qint64 length = qMin(deferredWriteBuffer.nextDataBlockSize(),
+                                       transfer.precedingBytes);
+            if (q->write(deferredWriteBuffer.readPointer(), length) < 0) {
+                clearFileTransfers();
+                return;
+            }
+            deferredWriteBuffer.free(length);
+            transfer.precedingBytes -= length;
+            continue;
+        }
+
+        const qint64 readBytes = readFileTransfer(transfer, buffer, sizeof buffer);
+        if (readBytes < 0) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError, qt_error_string(errno));
+            q->abort();
+            return;
+        }
+        // A file that shrank ends the transfer early.
+        if (readBytes == 0) {
+            transfer.remaining = 0;
+        } else if (q->write(buffer, readBytes) < 0) {
+            clearFileTransfers();
+            return;
+        }
+        transfer.offset += readBytes;
+        transfer.remaining -= readBytes;
+        if (transfer.remaining == 0) {
+            qt_safe_close(transfer.fileDescriptor);
+            fileTransfers.removeFirst();
+        }
+    }
+
+    // Nothing is left to wait for once the files have gone out.
+    if (fileTransfers.isEmpty()) {
+        while (!deferredWriteBuffer.isEmpty()) {
+            const qint64 length = deferredWriteBuffer.nextDataBlockSize();
+            if (q->write(deferredWriteBuffer.readPointer(), length) < 0)
+                break;
+            deferredWriteBuffer.free(length);
+        }
+        deferredWriteBuffer.clear();
+    }
+#endif
+}
+
+/*! \internal
+
+    Keeps \a len bytes of \a data back, returning \c true, if they were
+    written after a file transfer that is still being fed to the socket.
+*/
+bool QAbstractSocketPrivate::deferWrite(const char *data, qint64 len)
+{
+    if (fileTransfers.isEmpty() || feedingFileTransfers)
+        return false;
+    deferredWriteBuffer.append(data, len);
+    return true;
+}
+
+/*! \internal
+
+    Returns the number of bytes of queued file transfers not sent yet.
+*/
+qint64 QAbstractSocketPrivate::fileTransferBytes() const
+{
+    qint64 bytes = 0;
+    for (const FileTransfer &transfer : fileTransfers)
+        bytes += transfer.remaining;
+    return bytes;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -891,7 +1119,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while ((!allWriteBuffersEmpty() || !fileTransfers.isEmpty()) && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1676,6 +1904,7 @@ void QAbstractSocket::connectToHost(const QString &hostName, quint16 port,
     d->port = port;
     d->setReadChannelCount(0);
     d->setWriteChannelCount(0);
+    d->clearFileTransfers();
     d->abortCalled = false;
     d->pendingClose = false;
     if (d->state != BoundState) {
@@ -1774,7 +2003,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->fileTransferBytes();
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -1903,6 +2132,7 @@ bool QAbstractSocket::setSocketDescriptor(qintptr socketDescriptor, SocketState
     d->resetSocketLayer();
     d->setReadChannelCount(0);
     d->setWriteChannelCount(0);
+    d->clearFileTransfers();
     d->socketEngine = QAbstractSocketEngine::createSocketEngine(socketDescriptor, this);
     if (!d->socketEngine) {
         d->setError(UnsupportedSocketOperationError, tr("Operation on socket is not supported"));
@@ -2200,7 +2430,8 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true,
+                                                 !d->writeBuffer.isEmpty() || !d->fileTransfers.isEmpty(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2252,7 +2483,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (d->writeBuffer.isEmpty() && d->fileTransfers.isEmpty())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2269,7 +2500,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  !d->writeBuffer.isEmpty() || !d->fileTransfers.isEmpty(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2349,7 +2580,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               !d->writeBuffer.isEmpty() || !d->fileTransfers.isEmpty(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2386,6 +2617,7 @@ void QAbstractSocket::abort()
     qDebug("QAbstractSocket::abort()");
 #endif
     d->setWriteChannelCount(0);
+    d->clearFileTransfers();
     d->abortCalled = true;
     close();
 }
@@ -2416,6 +2648,176 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 6.1
+
+    Queues \a size bytes starting at \a offset in \a file for sending, after
+    any data already written to the socket. If \a size is -1, or exceeds
+    what the file holds past \a offset, everything up to the end of the
+    file is sent. Returns the number of bytes queued, or -1 if an error
+    occurred.
+
+    Like data passed to write(), the file data counts towards
+    bytesToWrite() and is reported through bytesWritten() as it goes out.
+
+    On Unix, the file position is not changed, \a file may be closed
+    right after this call, and the data is read from the file only as the
+    socket gets it out: a TCP socket has the operating system move it from
+    the file to the network directly, without copying it into the
+    application, where the platform allows it, and QSslSocket encrypts it
+    a chunk at a time. Otherwise, as for files that have no file
+    descriptor, the data is read from \a file and written to the socket
+    in the usual way right away.
+
+    \a file must be open for reading and must not be sequential.
+
+    \sa write(), bytesToWrite()
+*/
+qint64 QAbstractSocket::sendFile(QFileDevice *file, qint64 offset, qint64 size)
+{
+    Q_D(QAbstractSocket);
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::sendFile: Socket not open for writing");
+        return -1;
+    }
+    if (!file || !file->isReadable() || file->isSequential()) {
+        qWarning("QAbstractSocket::sendFile: File not open for random access reading");
+        return -1;
+    }
+    if (offset < 0) {
+        qWarning("QAbstractSocket::sendFile: Negative offset");
+        return -1;
+    }
+    if (d->state == QAbstractSocket::UnconnectedState) {
+        d->setError(UnknownSocketError, tr("Socket is not connected"));
+        return -1;
+    }
+
+    const qint64 available = qMax(Q_INT64_C(0), file->size() - offset);
+    if (size < 0 || size > available)
+        size = available;
+    if (size == 0)
+        return 0;
+
+    // Data buffered in the file object must reach the file first.
+    if (file->isWritable())
+        file->flush();
+
+#ifdef Q_OS_UNIX
+    // The transfer keeps a descriptor of its own, so it reads the file
+    // independently of the file object and of its position.
+    if (d->socketType == TcpSocket && file->handle() != -1) {
+        const int fileDescriptor = qt_safe_dup(file->handle());
+        if (fileDescriptor != -1) {
+            const bool feeds = d->feedsFileTransfers();
+            qint64 precedingBytes = feeds ? d->deferredWriteBuffer.size() : d->writeBuffer.size();
+            for (const QAbstractSocketPrivate::FileTransfer &transfer : qAsConst(d->fileTransfers))
+                precedingBytes -= transfer.precedingBytes;
+            d->fileTransfers.append({ fileDescriptor, offset, size, precedingBytes, false });
+            // A socket still looking up its peer starts sending once connected.
+            if (feeds)
+                d->feedFileTransfers();
+            else if (d->socketEngine)
+                d->socketEngine->setWriteNotificationEnabled(true);
+            return size;
+        }
+    }
+#endif
+
+    const qint64 savedPosition = file->pos();
+    if (!file->seek(offset))
+        return -1;
+    char buffer[QABSTRACTSOCKET_BUFFERSIZE];
+    qint64 queued = 0;
+    while (queued < size) {
+        const qint64 readBytes = file->read(buffer, qMin(size - queued, qint64(sizeof buffer)));
+        if (readBytes <= 0)
+            break;
+        const qint64 written = write(buffer, readBytes);
+        if (written < 0) {
+            if (!queued)
+                queued = -1;
+            break;
+        }
+        queued += written;
+    }
+    file->seek(savedPosition);
+    return queued;
+}
+
+/*!
+    \since 6.1
+
+    Writes the byte arrays in \a segments to the socket, in order, as if
+    write() had been called for each of them. Returns the number of bytes
+    written, or -1 if an error occurred.
+
+    Unlike concatenating the segments first, this does not copy their
+    contents: the segments are kept by reference until they have been sent,
+    and consecutive buffered segments reach the operating system with a
+    single system call where the platform allows it. This makes it cheap to
+    send a message assembled from many parts, such as protocol headers
+    followed by a large payload.
+
+    \sa write(), sendFile()
+*/
+qint64 QAbstractSocket::writeSegments(const QList<QByteArray> &segments)
+{
+    Q_D(QAbstractSocket);
+
+    // The unbuffered fast path of writeData(), for all segments at once.
+    // QSslSocket has no engine of its own and always takes the path below.
+    if (!d->isBuffered && d->socketType == TcpSocket && d->socketEngine && isWritable()
+        && d->state == QAbstractSocket::ConnectedState && d->writeBuffer.isEmpty()
+        && d->fileTransfers.isEmpty()) {
+        QVarLengthArray<QByteArrayView, MaxWriteSegments> views;
+        qint64 total = 0;
+        for (const QByteArray &segment : segments) {
+            views.append(QByteArrayView(segment));
+            total += segment.size();
+        }
+        if (total == 0)
+            return 0;
+
+        qint64 written = d->socketEngine->writeSegments(views.constData(), views.size());
+        if (written < 0) {
+            d->setError(d->socketEngine->error(), d->socketEngine->errorString());
+            return written;
+        }
+        if (written < total) {
+            // Buffer what was not written yet
+            for (const QByteArray &segment : segments) {
+                if (written >= segment.size()) {
+                    written -= segment.size();
+                } else if (written > 0) {
+                    d->writeBuffer.append(segment.constData() + written, segment.size() - written);
+                    written = 0;
+                } else if (!segment.isEmpty()) {
+                    d->writeBuffer.append(segment);
+                }
+            }
+            d->socketEngine->setWriteNotificationEnabled(true);
+        }
+        return total;
+    }
+
+    qint64 total = 0;
+    for (const QByteArray &segment : segments) {
+        if (segment.isEmpty())
+            continue;
+
+        // Let QIODevicePrivate::write() keep a shallow copy of the segment,
+        // as write(const QByteArray &) does for large chunks.
+        d->currentWriteChunk = &segment;
+        const qint64 written = write(segment.constData(), segment.size());
+        d->currentWriteChunk = nullptr;
+        if (written < 0)
+            return total ? total : written;
+        total += written;
+    }
+    return total;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2469,7 +2871,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && d->writeBuffer.isEmpty() && d->fileTransfers.isEmpty()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2700,7 +3102,7 @@ void QAbstractSocket::disconnectFromHost()
 
         // Wait for pending data to be written.
         if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
-            || d->socketEngine->bytesToWrite() > 0)) {
+            || !d->fileTransfers.isEmpty() || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
 #if defined(QABSTRACTSOCKET_DEBUG)
@@ -2730,6 +3132,7 @@ void QAbstractSocket::disconnectFromHost()
     d->peerAddress.clear();
     d->peerName.clear();
     d->setWriteChannelCount(0);
+    d->clearFileTransfers();
 
 #if defined(QABSTRACTSOCKET_DEBUG)
         qDebug("QAbstractSocket::disconnectFromHost() disconnected!");
@@ -56,6 +56,7 @@ class QNetworkProxy;
 #endif
 class QAbstractSocketPrivate;
 class QAuthenticator;
+class QFileDevice;
 
 class Q_NETWORK_EXPORT QAbstractSocket : public QIODevice
 {
@@ -186,6 +187,9 @@ public:
     bool isSequential() const override;
     bool flush();
 
+    qint64 sendFile(QFileDevice *file, qint64 offset = 0, qint64 size = -1);
+    qint64 writeSegments(const QList<QByteArray> &segments);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) override;
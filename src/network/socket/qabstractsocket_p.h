@@ -137,6 +137,8 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    bool writeFileToSocket();
+    void clearFileTransfers();
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -149,6 +151,29 @@ public:
 
     QTimer *connectTimer;
 
+    // File ranges queued by sendFile(), each sent once the bytes of the
+    // write buffer that were written before it have gone out.
+    struct FileTransfer
+    {
+        int fileDescriptor;
+        qint64 offset;
+        qint64 remaining;
+        qint64 precedingBytes;
+        bool copy;
+    };
+    QList<FileTransfer> fileTransfers;
+    qint64 fileTransferBytes() const;
+
+    // Sockets whose data doesn't go through writeToSocket(), such as
+    // QSslSocket, feed file transfers to write() in chunks instead, and
+    // hold back the data written after them until they are done.
+    virtual bool feedsFileTransfers() const { return false; }
+    virtual qint64 bufferedWriteBytes() const { return writeBuffer.size(); }
+    void feedFileTransfers();
+    bool deferWrite(const char *data, qint64 len);
+    QRingBuffer deferredWriteBuffer;
+    bool feedingFileTransfers;
+
     int hostLookupId;
 
     QAbstractSocket::SocketType socketType;
@@ -128,6 +128,103 @@ QAbstractSocketEngine *QAbstractSocketEngine::createSocketEngine(qintptr socketD
     return new QNativeSocketEngine(parent);
 }
 
+/*!
+    Writes the first \a count byte ranges in \a segments to the socket, in
+    order, and returns the number of bytes written, or -1 if an error
+    occurred before anything was written. Writing stops at the first range
+    that could not be written in full.
+
+    This default implementation calls write() once per range; engines that
+    can hand several ranges to the operating system at once reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeSegments(const QByteArrayView *segments, int count)
+{
+    qint64 total = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(segments[i].data(), segments[i].size());
+        if (written < 0)
+            return total ? total : written;
+        total += written;
+        if (written < segments[i].size())
+            break;
+    }
+    return total;
+}
+
+/*!
+    Sends up to \a length bytes from \a offset in the file referred to by
+    \a fileDescriptor directly to the socket, without copying them through
+    user space. Returns the number of bytes sent, which is 0 if the socket
+    cannot take any more data right now, or -1 if an error occurred.
+
+    Returns -2 if the engine cannot send this file directly; the caller
+    must then read the data itself and write() it. This default
+    implementation always returns -2.
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    return -2;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a count pending datagrams into \a datagrams, each at most
+    \a maxSize bytes long, or as large as the pending datagram if \a maxSize
+    is negative. The headers are filled in according to \a options. Returns
+    the number of datagrams read, which is 0 if none were pending, or -1 if
+    an error occurred before any datagram was read.
+
+    This default implementation calls readDatagram() once per datagram.
+*/
+int QAbstractSocketEngine::readDatagrams(QNetworkDatagramPrivate * const *datagrams, int count,
+                                         qint64 maxSize, PacketHeaderOptions options)
+{
+    int received = 0;
+    for (; received < count; ++received) {
+        QNetworkDatagramPrivate *datagram = datagrams[received];
+        qint64 size = maxSize;
+        if (size < 0) {
+            size = pendingDatagramSize();
+            if (size < 0)
+                break;
+        }
+
+        datagram->data.resize(size);
+        const qint64 readBytes = readDatagram(datagram->data.data(), size, &datagram->header,
+                                              options);
+        if (readBytes == -2)
+            break;
+        if (readBytes < 0)
+            return received ? received : -1;
+        datagram->data.truncate(readBytes);
+    }
+    return received;
+}
+
+/*!
+    Sends the first \a count datagrams in \a datagrams, each to the
+    destination in its header. Returns the number of datagrams sent, -2 if
+    the socket could not take any datagram right now, or -1 if an error
+    occurred before any datagram was sent.
+
+    This default implementation calls writeDatagram() once per datagram.
+*/
+int QAbstractSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count)
+{
+    for (int sent = 0; sent < count; ++sent) {
+        const QNetworkDatagramPrivate *datagram = datagrams[sent];
+        const qint64 result = writeDatagram(datagram->data.constData(), datagram->data.size(),
+                                            datagram->header);
+        if (result < 0)
+            return sent ? sent : int(result);
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 QAbstractSocket::SocketError QAbstractSocketEngine::error() const
 {
     return d_func()->socketError;
@@ -193,7 +193,8 @@ QNativeSocketEnginePrivate::QNativeSocketEnginePrivate() :
     socketDescriptor(-1),
     readNotifier(nullptr),
     writeNotifier(nullptr),
-    exceptNotifier(nullptr)
+    exceptNotifier(nullptr),
+    acceptNonBlocking(false)
 {
 #if defined(Q_OS_WIN)
     QSysInfo::machineHostName();        // this initializes ws2_32.dll
@@ -842,6 +843,56 @@ qint64 QNativeSocketEngine::pendingDatagramSize() const
 
     return d->nativePendingDatagramSize();
 }
+
+/*!
+    \since 6.1
+
+    Reads up to \a count pending datagrams into \a datagrams. Where the
+    platform supports it, several datagrams are received with each system
+    call. Returns the number of datagrams read, or -1 if an error occurred.
+
+    \sa QAbstractSocketEngine::readDatagrams()
+*/
+int QNativeSocketEngine::readDatagrams(QNetworkDatagramPrivate * const *datagrams, int count,
+                                       qint64 maxSize, PacketHeaderOptions options)
+{
+#if QT_CONFIG(sendmmsg)
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::readDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+    return d->nativeReceiveDatagrams(datagrams, count, maxSize, options);
+#else
+    return QAbstractSocketEngine::readDatagrams(datagrams, count, maxSize, options);
+#endif
+}
+
+/*!
+    \since 6.1
+
+    Sends the first \a count datagrams in \a datagrams. Where the platform
+    supports it, several datagrams are sent with each system call. Returns
+    the number of datagrams sent, -2 if the socket could not take any
+    datagram right now, or -1 if an error occurred.
+
+    \sa QAbstractSocketEngine::writeDatagrams()
+*/
+int QNativeSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count)
+{
+#if QT_CONFIG(sendmmsg)
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+    return d->nativeSendDatagrams(datagrams, count);
+#else
+    return QAbstractSocketEngine::writeDatagrams(datagrams, count);
+#endif
+}
 #endif // QT_NO_UDPSOCKET
 
 /*!
@@ -918,6 +969,43 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    \since 6.1
+
+    Writes the first \a count byte ranges in \a segments to the socket with
+    a single system call. Returns the number of bytes written, or -1 if an
+    error occurred.
+
+    Only TCP sockets gather the ranges; other socket types write each range
+    separately, so that a connected UDP socket still sends one datagram per
+    range.
+*/
+qint64 QNativeSocketEngine::writeSegments(const QByteArrayView *segments, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeSegments(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeSegments(), QAbstractSocket::ConnectedState, -1);
+    if (d->socketType != QAbstractSocket::TcpSocket)
+        return QAbstractSocketEngine::writeSegments(segments, count);
+    return d->nativeWriteSegments(segments, count);
+}
+
+/*!
+    Sends up to \a length bytes from \a offset in the file referred to by
+    \a fileDescriptor to the socket, letting the kernel copy the data
+    where the platform supports it. Returns the number of bytes sent, 0 if
+    the socket cannot take more data right now, -1 if an error occurred,
+    or -2 if the file cannot be sent this way.
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+    return d->nativeSendFile(fileDescriptor, offset, length);
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
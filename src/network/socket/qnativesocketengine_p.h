@@ -146,6 +146,8 @@ public:
 
     qint64 read(char *data, qint64 maxlen) override;
     qint64 write(const char *data, qint64 len) override;
+    qint64 writeSegments(const QByteArrayView *segments, int count) override;
+    qint64 sendFile(qintptr fileDescriptor, qint64 offset, qint64 length) override;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -159,6 +161,9 @@ public:
 
     bool hasPendingDatagrams() const override;
     qint64 pendingDatagramSize() const override;
+    int readDatagrams(QNetworkDatagramPrivate * const *datagrams, int count, qint64 maxSize,
+                      PacketHeaderOptions options = WantNone) override;
+    int writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count) override;
 #endif // QT_NO_UDPSOCKET
 
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
@@ -212,6 +217,10 @@ public:
 
     QSocketNotifier *readNotifier, *writeNotifier, *exceptNotifier;
 
+    // Whether accept() hands out non-blocking descriptors; only servers
+    // that opted into port sharing get them, see nativeAccept()
+    bool acceptNonBlocking;
+
 #if defined(Q_OS_WIN)
     LPFN_WSASENDMSG sendmsg;
     LPFN_WSARECVMSG recvmsg;
@@ -277,8 +286,16 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(sendmmsg)
+    int nativeReceiveDatagrams(QNetworkDatagramPrivate * const *datagrams, int count, qint64 maxSize,
+                               QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const QNetworkDatagramPrivate * const *datagrams, int count);
+    QByteArray datagramBuffer;
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeWriteSegments(const QByteArrayView *segments, int count);
+    qint64 nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 length);
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -52,6 +52,7 @@
 #include <qdatetime.h>
 #include <qnetworkinterface.h>
 #include <qoperatingsystemversion.h>
+#include <qvarlengtharray.h>
 
 #include <algorithm>
 
@@ -285,6 +286,7 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
         break;
 
     case QAbstractSocketEngine::PathMtuInformation:
+    case QAbstractSocketEngine::PortReusable:
         break;          // not supported on Windows
     }
 }
@@ -1481,6 +1483,52 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
     return ret;
 }
 
+qint64 QNativeSocketEnginePrivate::nativeWriteSegments(const QByteArrayView *segments, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    QVarLengthArray<WSABUF, 64> bufs(count);
+    for (int i = 0; i < count; ++i) {
+        bufs[i].buf = const_cast<char *>(segments[i].data());
+        bufs[i].len = ULONG(segments[i].size());
+    }
+
+    DWORD bytesWritten = 0;
+    qint64 ret = 0;
+    if (::WSASend(socketDescriptor, bufs.data(), DWORD(count), &bytesWritten, 0, 0, 0) != SOCKET_ERROR) {
+        ret = qint64(bytesWritten);
+    } else {
+        int err = WSAGetLastError();
+        WS_ERROR_DEBUG(err);
+        switch (err) {
+        case WSAECONNRESET:
+        case WSAECONNABORTED:
+            ret = -1;
+            setError(QAbstractSocket::NetworkError, WriteErrorString);
+            q->close();
+            break;
+        default:
+            // WSAEWOULDBLOCK and WSAENOBUFS: try again later
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteSegments(%p, %d) == %lli", segments, count, ret);
+#endif
+
+    return ret;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileDescriptor, qint64 offset, qint64 length)
+{
+    // TransmitFile() blocks on non-overlapped sockets; copy through write() instead
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    return -2;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxLength)
 {
     qint64 ret = -1;
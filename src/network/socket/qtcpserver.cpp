@@ -124,6 +124,7 @@ QTcpServerPrivate::QTcpServerPrivate()
  , socketEngine(nullptr)
  , serverSocketError(QAbstractSocket::UnknownSocketError)
  , maxConnections(30)
+ , portSharing(false)
 {
 }
 
@@ -325,6 +326,12 @@ bool QTcpServer::listen(const QHostAddress &address, quint16 port)
 
     d->configureCreatedSocket();
 
+    if (d->portSharing && !d->socketEngine->setOption(QAbstractSocketEngine::PortReusable, 1)) {
+        d->serverSocketError = QAbstractSocket::UnsupportedSocketOperationError;
+        d->serverSocketErrorString = tr("Port sharing is not supported");
+        return false;
+    }
+
     if (!d->socketEngine->bind(addr, port)) {
         d->serverSocketError = d->socketEngine->error();
         d->serverSocketErrorString = d->socketEngine->errorString();
@@ -589,6 +596,10 @@ QTcpSocket *QTcpServer::nextPendingConnection()
     to the other thread and create the QTcpSocket object there and
     use its setSocketDescriptor() method.
 
+    \note If port sharing is enabled, the \a socketDescriptor of a native
+    socket is in non-blocking mode on Unix, as QTcpSocket would set it
+    anyway. Otherwise it is in blocking mode.
+
     \sa newConnection(), nextPendingConnection(), addPendingConnection()
 */
 void QTcpServer::incomingConnection(qintptr socketDescriptor)
@@ -649,6 +660,47 @@ int QTcpServer::maxPendingConnections() const
     return d_func()->maxConnections;
 }
 
+/*!
+    \since 6.1
+
+    Sets whether the server lets other servers listen on the same address
+    and port to \a enabled. This takes effect on the next call to
+    listen(). The default is false.
+
+    When enabled, the operating system spreads incoming connections
+    between all servers listening on the port, which must all have
+    enabled port sharing. This allows a server to accept connections on
+    several threads at once: create one QTcpServer per worker thread,
+    each in that thread, and have all of them listen on the same port.
+
+    On Unix, this sets the \c SO_REUSEPORT socket option; Linux and
+    FreeBSD balance the connections between the servers. Where port
+    sharing is not supported, or when a proxy is in use, listen() fails
+    with QAbstractSocket::UnsupportedSocketOperationError.
+
+    On Unix, the descriptors passed to incomingConnection() by a server
+    with port sharing enabled are in non-blocking mode.
+
+    \sa isPortSharingEnabled(), listen(), incomingConnection()
+*/
+void QTcpServer::setPortSharingEnabled(bool enabled)
+{
+    d_func()->portSharing = enabled;
+}
+
+/*!
+    \since 6.1
+
+    Returns \c true if the server lets other servers listen on the same
+    address and port; otherwise returns \c false.
+
+    \sa setPortSharingEnabled()
+*/
+bool QTcpServer::isPortSharingEnabled() const
+{
+    return d_func()->portSharing;
+}
+
 /*!
     Returns an error code for the last error that occurred.
 
@@ -102,6 +102,7 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -431,6 +432,69 @@ qint64 QUdpSocket::writeDatagram(const QNetworkDatagram &datagram)
     return sent;
 }
 
+/*!
+    \since 6.1
+
+    Sends the datagrams in \a datagrams, each to the destination in its
+    header, and returns the number of datagrams sent. If none could be sent,
+    returns -1 and sets the socket error; if only some were, the remaining
+    ones can be passed to this function again.
+
+    Where the operating system supports it, several datagrams are handed to
+    the kernel with each system call, which makes this function considerably
+    cheaper than calling writeDatagram() for each datagram when sending at a
+    high rate.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+qsizetype QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qint64(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<const QNetworkDatagramPrivate *, 64> batch;
+    qsizetype sent = 0;
+    qint64 sentBytes = 0;
+    while (sent < datagrams.size()) {
+        batch.resize(qMin(datagrams.size() - sent, qsizetype(64)));
+        for (qsizetype i = 0; i < batch.size(); ++i)
+            batch[i] = datagrams.at(sent + i).d;
+
+        const int result = d->socketEngine->writeDatagrams(batch.constData(), int(batch.size()));
+        if (result < 0) {
+            if (sent)
+                break;
+            d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+            if (result == -2) {
+                // Socket engine reports EAGAIN. Treat as a temporary error.
+                d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                                   tr("Unable to send a datagram"));
+            } else {
+                d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+            }
+            return -1;
+        }
+
+        for (int i = 0; i < result; ++i)
+            sentBytes += batch.at(i)->data.size();
+        sent += result;
+        if (result < batch.size())
+            break;
+    }
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    emit bytesWritten(sentBytes);
+    return sent;
+}
+
 /*!
     \since 5.8
 
@@ -476,6 +540,56 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.1
+
+    Receives up to \a maxCount pending datagrams, each no larger than \a
+    maxSize bytes, and returns them along with their sender's host address
+    and port and, if possible, their destination address, port and hop
+    count. Returns an empty list if no datagram is pending or if an error
+    occurred.
+
+    Where the operating system supports it, several datagrams are received
+    with each system call, which makes this function considerably cheaper
+    than calling receiveDatagram() in a loop when datagrams arrive at a high
+    rate. Passing the largest datagram size you expect as \a maxSize, rather
+    than -1 (the default, which reads each datagram in full), lets more
+    datagrams be received with each call.
+
+    \sa receiveDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qint64(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    QList<QNetworkDatagram> result;
+    QVarLengthArray<QNetworkDatagramPrivate *, 64> batch;
+    while (result.size() < maxCount) {
+        const qsizetype offset = result.size();
+        batch.resize(qMin(maxCount - offset, qsizetype(64)));
+        result.resize(offset + batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i)
+            batch[i] = result[offset + i].d;
+
+        const int received = d->socketEngine->readDatagrams(batch.data(), int(batch.size()), maxSize,
+                                                            QAbstractSocketEngine::WantAll);
+        if (received < batch.size()) {
+            result.resize(offset + qMax(received, 0));
+            if (received < 0)
+                d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+            break;
+        }
+    }
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    return result;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
@@ -841,9 +841,10 @@ qint64 QSslSocket::bytesAvailable() const
 qint64 QSslSocket::bytesToWrite() const
 {
     Q_D(const QSslSocket);
+    const qint64 pendingBytes = d->fileTransferBytes() + d->deferredWriteBuffer.size();
     if (d->mode == UnencryptedMode)
-        return d->plainSocket ? d->plainSocket->bytesToWrite() : 0;
-    return d->writeBuffer.size();
+        return pendingBytes + (d->plainSocket ? d->plainSocket->bytesToWrite() : 0);
+    return pendingBytes + d->writeBuffer.size();
 }
 
 /*!
@@ -917,6 +918,7 @@ void QSslSocket::close()
     // must be cleared, reading/writing not possible on closed socket:
     d->buffer.clear();
     d->writeBuffer.clear();
+    d->clearFileTransfers();
 }
 
 /*!
@@ -1753,7 +1755,11 @@ void QSslSocket::disconnectFromHost()
     if (d->state == UnconnectedState)
         return;
     if (d->mode == UnencryptedMode && !d->autoStartHandshake) {
-        d->plainSocket->disconnectFromHost();
+        // Wait for the file transfers queued by sendFile() to go out.
+        if (!d->fileTransfers.isEmpty())
+            d->pendingClose = true;
+        else
+            d->plainSocket->disconnectFromHost();
         return;
     }
     if (d->state <= ConnectingState) {
@@ -1770,7 +1776,7 @@ void QSslSocket::disconnectFromHost()
         emit stateChanged(d->state);
     }
 
-    if (!d->writeBuffer.isEmpty()) {
+    if (!d->writeBuffer.isEmpty() || !d->fileTransfers.isEmpty()) {
         d->pendingClose = true;
         return;
     }
@@ -1816,6 +1822,8 @@ qint64 QSslSocket::writeData(const char *data, qint64 len)
 #ifdef QSSLSOCKET_DEBUG
     qCDebug(lcSsl) << "QSslSocket::writeData(" << (void *)data << ',' << len << ')';
 #endif
+    if (d->deferWrite(data, len))
+        return len;
     if (d->mode == UnencryptedMode && !d->autoStartHandshake)
         return d->plainSocket->write(data, len);
 
@@ -1877,6 +1885,7 @@ void QSslSocketPrivate::init()
 
     buffer.clear();
     writeBuffer.clear();
+    clearFileTransfers();
     configuration.peerCertificate.clear();
     configuration.peerCertificateChain.clear();
     fetchAuthorityInformation = false;
@@ -2375,12 +2384,33 @@ void QSslSocketPrivate::_q_bytesWrittenSlot(qint64 written)
     qCDebug(lcSsl) << "QSslSocket::_q_bytesWrittenSlot(" << written << ')';
 #endif
 
+    // Top up the data sent from files queued by sendFile().
+    const bool feeding = !fileTransfers.isEmpty();
+    if (feeding)
+        feedFileTransfers();
+
     if (mode == QSslSocket::UnencryptedMode)
         emit q->bytesWritten(written);
     else
         emit q->encryptedBytesWritten(written);
-    if (state == QAbstractSocket::ClosingState && writeBuffer.isEmpty())
+    if (feeding && pendingClose && fileTransfers.isEmpty() && mode == QSslSocket::UnencryptedMode
+        && !autoStartHandshake) {
+        pendingClose = false;
+        q->disconnectFromHost();
+    } else if (state == QAbstractSocket::ClosingState && writeBuffer.isEmpty()) {
         q->disconnectFromHost();
+    }
+}
+
+/*!
+    \internal
+
+    Returns the number of bytes written to the socket that have not gone out
+    to the network yet, encrypted or not.
+*/
+qint64 QSslSocketPrivate::bufferedWriteBytes() const
+{
+    return writeBuffer.size() + (plainSocket ? plainSocket->bytesToWrite() : 0);
 }
 
 /*!
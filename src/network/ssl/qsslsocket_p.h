@@ -191,6 +191,8 @@ public:
     virtual qint64 peek(char *data, qint64 maxSize) override;
     virtual QByteArray peek(qint64 maxSize) override;
     bool flush() override;
+    bool feedsFileTransfers() const override { return true; }
+    qint64 bufferedWriteBytes() const override;
 
     // Platform specific functions
     virtual void startClientEncryption() = 0;
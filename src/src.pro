@@ -28,6 +28,10 @@ src_tools_qlalr.target = sub-qlalr
 force_bootstrap: src_tools_qlalr.depends = src_tools_bootstrap
 else: src_tools_qlalr.depends = src_corelib
 
+src_tools_qlogdecode.subdir = tools/qlogdecode
+src_tools_qlogdecode.target = sub-qlogdecode
+src_tools_qlogdecode.depends = src_corelib
+
 src_tools_tracegen.subdir = tools/tracegen
 src_tools_tracegen.target = sub-tracegen
 src_tools_tracegen.depends = src_tools_bootstrap
@@ -155,8 +159,8 @@ qtConfig(regularexpression):!qtConfig(system-pcre2):pcre2 {
     SUBDIRS += src_3rdparty_pcre2
     src_corelib.depends += src_3rdparty_pcre2
 }
-TOOLS = src_tools_moc src_tools_rcc src_tools_tracegen src_tools_qlalr
-SUBDIRS += src_corelib src_tools_qlalr
+TOOLS = src_tools_moc src_tools_rcc src_tools_tracegen src_tools_qlalr src_tools_qlogdecode
+SUBDIRS += src_corelib src_tools_qlalr src_tools_qlogdecode
 
 uikit|win32:SUBDIRS += src_entrypoint
 
@@ -267,7 +271,7 @@ qtConfig(private_tests) {
 }
 
 TR_EXCLUDE = \
-    src_tools_bootstrap src_tools_moc src_tools_rcc src_tools_uic src_tools_qlalr \
+    src_tools_bootstrap src_tools_moc src_tools_rcc src_tools_uic src_tools_qlalr src_tools_qlogdecode \
     src_tools_bootstrap_dbus src_tools_qdbusxml2cpp src_tools_qdbuscpp2xml \
     src_3rdparty_pcre2 src_3rdparty_harfbuzzng src_3rdparty_freetype \
     src_tools_tracegen
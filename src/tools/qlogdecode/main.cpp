@@ -0,0 +1,480 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/private/qbinarylogging_p.h>
+#include <QtCore/private/qlogging_p.h>
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <string.h>
+
+QT_USE_NAMESPACE
+
+using namespace QBinaryLogging;
+
+namespace {
+
+struct Site
+{
+    QtMsgType type = QtDebugMsg;
+    int line = 0;
+    QByteArray category;
+    QByteArray file;
+    QByteArray function;
+    QByteArray format;
+    QList<ArgumentType> arguments;
+};
+
+struct Argument
+{
+    qint64 integer = 0;
+    double real = 0;
+    QByteArray string;
+};
+
+// A message as logged, formatted once the whole log has been read
+struct Entry
+{
+    qint64 timestamp = 0;
+    quint32 thread = 0;
+    QtMsgType type = QtDebugMsg;
+    int line = 0;
+    QByteArray category;
+    QByteArray file;
+    QByteArray function;
+    QString message;
+    bool formatted = false;     // message is printed as it is
+};
+
+struct Thread
+{
+    quint64 nativeId = 0;
+    qint64 threadId = 0;
+    QHash<quint32, Site> sites;
+};
+
+struct ApplicationName
+{
+    qint64 timestamp;
+    QString name;
+};
+
+class Reader
+{
+public:
+    Reader(const char *data, qsizetype size, bool swap)
+        : pos(data), end(data + size), swap(swap)
+    {}
+
+    bool atEnd() const { return pos == end; }
+    bool failed() const { return error; }
+
+    template <typename T>
+    T read()
+    {
+        T value = T();
+        if (end - pos < qsizetype(sizeof value)) {
+            error = true;
+            pos = end;
+            return value;
+        }
+        memcpy(&value, pos, sizeof value);
+        pos += sizeof value;
+        if (swap)
+            value = qbswap(value);
+        return value;
+    }
+
+    double readDouble()
+    {
+        const quint64 bits = read<quint64>();
+        double value;
+        memcpy(&value, &bits, sizeof value);
+        return value;
+    }
+
+    // A null string is returned as a null QByteArray
+    QByteArray readString()
+    {
+        const quint32 size = read<quint32>();
+        if (size == NullString)
+            return QByteArray();
+        if (quint64(end - pos) < size) {
+            error = true;
+            pos = end;
+            return QByteArray();
+        }
+        QByteArray string(pos, size);
+        pos += size;
+        return string;
+    }
+
+private:
+    const char *pos;
+    const char *end;
+    bool swap;
+    bool error = false;
+};
+
+const char *orNull(const QByteArray &string)
+{
+    return string.isNull() ? nullptr : string.constData();
+}
+
+QString formatConversion(const FormatConversion &conversion, const QList<Argument> &values,
+                         qsizetype *next)
+{
+    auto take = [&]() -> const Argument & {
+        static const Argument none;
+        return *next < values.size() ? values.at((*next)++) : none;
+    };
+
+    // rebuild the conversion with '*' replaced by the values given and the
+    // length modifier matching the type the values are stored with
+    QByteArray spec;
+    for (const char *c = conversion.begin; c != conversion.end - 1; ++c) {
+        switch (*c) {
+        case '*': {
+            const qint64 value = take().integer;
+            if (value >= 0)
+                spec += QByteArray::number(value);
+            break;
+        }
+        case 'h': case 'l': case 'L': case 'j': case 'z': case 'Z': case 't':
+            break;
+        default:
+            spec += *c;
+        }
+    }
+
+    const Argument &value = take();
+    switch (conversion.conversion) {
+    case 'd':
+    case 'i':
+        spec += "ll";
+        spec += conversion.conversion;
+        return QString::asprintf(spec.constData(), value.integer);
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+        spec += "ll";
+        spec += conversion.conversion;
+        return QString::asprintf(spec.constData(), quint64(value.integer));
+    case 'p':
+        // QString::asprintf() prints pointers as hexadecimal numbers with base
+        spec.insert(1, '#');
+        spec += "llx";
+        return QString::asprintf(spec.constData(), quint64(value.integer));
+    case 'c':
+        if (conversion.length == LongLength)
+            spec += 'l';
+        spec += 'c';
+        return QString::asprintf(spec.constData(), int(value.integer));
+    case 's':
+        spec += 's';
+        return QString::asprintf(spec.constData(), value.string.constData());
+    }
+    spec += conversion.conversion;
+    return QString::asprintf(spec.constData(), value.real);
+}
+
+QString formatMessage(const Site &site, const QList<Argument> &values)
+{
+    QString message;
+    qsizetype next = 0;
+    const char *literal = site.format.constData();
+    const bool ok = parseFormat(literal, [&](const FormatConversion &conversion) {
+        message += QString::fromUtf8(QByteArray(literal, conversion.begin - literal)
+                                     .replace("%%", "%"));
+        message += formatConversion(conversion, values, &next);
+        literal = conversion.end;
+    });
+    Q_UNUSED(ok); // the site was only recorded if the format could be parsed
+    message += QString::fromUtf8(QByteArray(literal).replace("%%", "%"));
+    return message;
+}
+
+class Decoder
+{
+public:
+    bool decode(const QByteArray &data);
+    void print(bool relative);
+
+private:
+    bool decodeChunk(quint32 threadNumber, Reader &reader);
+    QString format(const Entry &entry, const QString &applicationName) const;
+
+    QHash<quint32, Thread> threads;
+    QList<Entry> entries;
+    QList<ApplicationName> applicationNames;
+    qint64 startTime = 0;
+    qint64 bootTime = 0;
+    qint64 pid = 0;
+    bool swap = false;
+};
+
+bool Decoder::decode(const QByteArray &data)
+{
+    constexpr qsizetype HeaderSize = sizeof Magic + sizeof(quint32) * 2 + sizeof(qint64) * 3;
+    if (data.size() < HeaderSize || memcmp(data.constData(), Magic, sizeof Magic) != 0) {
+        fprintf(stderr, "qlogdecode: not a binary log file\n");
+        return false;
+    }
+
+    quint32 bom;
+    memcpy(&bom, data.constData() + sizeof Magic + sizeof(quint32), sizeof bom);
+    swap = bom != ByteOrderMark;
+    if (swap && qbswap(bom) != ByteOrderMark) {
+        fprintf(stderr, "qlogdecode: invalid byte order mark\n");
+        return false;
+    }
+
+    Reader reader(data.constData() + sizeof Magic, data.size() - sizeof Magic, swap);
+    const quint32 version = reader.read<quint32>();
+    if (version != Version) {
+        fprintf(stderr, "qlogdecode: unsupported version %u\n", version);
+        return false;
+    }
+    reader.read<quint32>();
+    startTime = reader.read<qint64>();
+    bootTime = reader.read<qint64>();
+    pid = reader.read<qint64>();
+
+    while (!reader.atEnd()) {
+        const quint32 threadNumber = reader.read<quint32>();
+        const QByteArray chunk = reader.readString();
+        if (reader.failed()) {
+            fprintf(stderr, "qlogdecode: warning: the log file is truncated\n");
+            break;
+        }
+        Reader chunkReader(chunk.constData(), chunk.size(), swap);
+        if (!decodeChunk(threadNumber, chunkReader)) {
+            fprintf(stderr, "qlogdecode: invalid records of thread %u\n", threadNumber);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Decoder::decodeChunk(quint32 threadNumber, Reader &reader)
+{
+    Thread &thread = threads[threadNumber];
+    while (!reader.atEnd()) {
+        switch (reader.read<quint8>()) {
+        case ThreadRecord:
+            thread.nativeId = reader.read<quint64>();
+            thread.threadId = reader.read<qint64>();
+            break;
+        case SiteRecord: {
+            const quint32 id = reader.read<quint32>();
+            Site &site = thread.sites[id];
+            site.type = QtMsgType(reader.read<quint8>());
+            site.line = reader.read<qint32>();
+            site.category = reader.readString();
+            site.file = reader.readString();
+            site.function = reader.readString();
+            site.format = reader.readString();
+            site.arguments.clear();
+            for (int count = reader.read<quint8>(); count > 0; --count)
+                site.arguments.append(ArgumentType(reader.read<quint8>()));
+            break;
+        }
+        case MessageRecord: {
+            const auto it = thread.sites.constFind(reader.read<quint32>());
+            if (it == thread.sites.constEnd())
+                return false;
+            const Site &site = *it;
+            const qint64 timestamp = reader.read<qint64>();
+            QList<Argument> values(site.arguments.size());
+            for (qsizetype i = 0; i < values.size(); ++i) {
+                switch (site.arguments.at(i)) {
+                case SignedArgument:
+                case UnsignedArgument:
+                case PointerArgument:
+                    values[i].integer = reader.read<qint64>();
+                    break;
+                case DoubleArgument:
+                    values[i].real = reader.readDouble();
+                    break;
+                case StringArgument:
+                    values[i].string = reader.readString();
+                    break;
+                default:
+                    return false;
+                }
+            }
+            entries.append({ timestamp, threadNumber, site.type, site.line, site.category,
+                             site.file, site.function, formatMessage(site, values) });
+            break;
+        }
+        case TextRecord: {
+            const qint64 timestamp = reader.read<qint64>();
+            const QtMsgType type = QtMsgType(reader.read<quint8>());
+            const int line = reader.read<qint32>();
+            const QByteArray category = reader.readString();
+            const QByteArray file = reader.readString();
+            const QByteArray function = reader.readString();
+            const QByteArray message = reader.readString();
+            entries.append({ timestamp, threadNumber, type, line, category, file, function,
+                             QString::fromUtf8(message) });
+            break;
+        }
+        case DroppedRecord: {
+            const qint64 timestamp = reader.read<qint64>();
+            const quint64 count = reader.read<quint64>();
+            Entry entry;
+            entry.timestamp = timestamp;
+            entry.thread = threadNumber;
+            entry.message = QString::asprintf("(%llu log messages were dropped)", count);
+            entry.formatted = true;
+            entries.append(entry);
+            break;
+        }
+        case ApplicationRecord: {
+            const qint64 timestamp = reader.read<qint64>();
+            applicationNames.append({ timestamp, QString::fromUtf8(reader.readString()) });
+            break;
+        }
+        default:
+            return false;
+        }
+        if (reader.failed())
+            return false;
+    }
+    return true;
+}
+
+// Formats the entry with the message pattern, as the logging process would have
+QString Decoder::format(const Entry &entry, const QString &applicationName) const
+{
+    if (entry.formatted)
+        return entry.message;
+
+    QtPrivate::LogMessageOrigin origin;
+    origin.pid = pid;
+    origin.applicationName = applicationName;
+    origin.threadId = threads.value(entry.thread).threadId;
+    origin.msecsSinceEpoch = startTime + entry.timestamp / 1000000;
+    origin.msecsSinceStart = entry.timestamp / 1000000;
+    origin.msecsSinceBoot = (bootTime + entry.timestamp) / 1000000;
+    const QMessageLogContext context(orNull(entry.file), entry.line, orNull(entry.function),
+                                     orNull(entry.category));
+    return QtPrivate::qFormatLogMessage(entry.type, context, entry.message, origin);
+}
+
+void Decoder::print(bool relative)
+{
+    // the threads are written out one after the other; interleave their messages again
+    const auto byTimestamp = [](const auto &lhs, const auto &rhs) {
+        return lhs.timestamp < rhs.timestamp;
+    };
+    std::stable_sort(entries.begin(), entries.end(), byTimestamp);
+    std::stable_sort(applicationNames.begin(), applicationNames.end(), byTimestamp);
+
+    auto applicationName = applicationNames.cbegin();
+    QString currentApplicationName;
+    for (const Entry &entry : qAsConst(entries)) {
+        for (; applicationName != applicationNames.cend()
+               && applicationName->timestamp <= entry.timestamp; ++applicationName) {
+            currentApplicationName = applicationName->name;
+        }
+
+        QString time;
+        if (relative) {
+            time = QString::asprintf("%12.6f", entry.timestamp / 1e9);
+        } else {
+            const QDateTime dateTime =
+                    QDateTime::fromMSecsSinceEpoch(startTime + entry.timestamp / 1000000);
+            time = dateTime.toString(u"yyyy-MM-ddTHH:mm:ss.zzz")
+                    + QString::asprintf("%03d", int(entry.timestamp / 1000 % 1000));
+        }
+        const quint64 nativeId = threads.value(entry.thread).nativeId;
+        printf("%s [0x%llx] %s\n", qPrintable(time), nativeId,
+               format(entry, currentApplicationName).toLocal8Bit().constData());
+    }
+}
+
+} // unnamed namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationVersion(QStringLiteral(QT_VERSION_STR));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Prints the messages of a binary log written by a Qt application that ran with "
+            "QT_BINARY_LOG_FILE set. Each message is formatted with the message pattern "
+            "(see QT_MESSAGE_PATTERN), with the process, thread and time it was logged with, "
+            "and prefixed with the time it was logged at and the id of the thread that "
+            "logged it."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption relativeOption(QStringList() << QStringLiteral("r") << QStringLiteral("relative"),
+                                      QStringLiteral("Print times in seconds since the start of the log."));
+    parser.addOption(relativeOption);
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The binary log file."));
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(1);
+
+    QFile file(files.constFirst());
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "qlogdecode: cannot open %s: %s\n",
+                qPrintable(file.fileName()), qPrintable(file.errorString()));
+        return 1;
+    }
+
+    Decoder decoder;
+    if (!decoder.decode(file.readAll()))
+        return 1;
+    decoder.print(parser.isSet(relativeOption));
+    return 0;
+}
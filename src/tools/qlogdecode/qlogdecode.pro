@@ -0,0 +1,10 @@
+option(host_build)
+QT = core-private
+
+SOURCES += main.cpp
+
+DEFINES += \
+    QT_NO_FOREACH
+
+QMAKE_TARGET_DESCRIPTION = "Qt Binary Log Decoder"
+load(qt_tool)
@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "builtin.h"
+#include "provider.h"
+#include "helpers.h"
+#include "qtheaders.h"
+
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qtextstream.h>
+
+static const QLatin1String entrySuffix("_entry");
+static const QLatin1String exitSuffix("_exit");
+
+static void writePrologue(QTextStream &stream, const QString &fileName, const Provider &provider)
+{
+    const QString guard = includeGuard(fileName);
+
+    stream << "#ifndef " << guard << "\n"
+           << "#define " << guard << "\n"
+           << "\n"
+           << "#include <QtCore/private/qtracebuffer_p.h>\n"
+           << "\n";
+
+    stream << qtHeaders();
+    stream << "\n";
+
+    if (!provider.prefixText.isEmpty())
+        stream << provider.prefixText.join(QLatin1Char('\n')) << "\n\n";
+}
+
+static void writeEpilogue(QTextStream &stream, const QString &fileName)
+{
+    stream << "\n#endif // " << includeGuard(fileName) << "\n"
+           << "#include <private/qtrace_p.h>\n";
+}
+
+// The names of the values recorded for a field, and the expressions giving them
+static void fieldValues(const Tracepoint::Field &field, QStringList *names, QStringList *values)
+{
+    const QString &name = field.name;
+
+    switch (field.backendType) {
+    case Tracepoint::Field::QtUrl:
+        *names << name;
+        *values << name + QLatin1String(".toString()");
+        return;
+    case Tracepoint::Field::QtRect:
+        // qualified, so that several rectangles don't share the same keys
+        *names << name + QLatin1String(".x") << name + QLatin1String(".y")
+               << name + QLatin1String(".width") << name + QLatin1String(".height");
+        *values << name + QLatin1String(".x()") << name + QLatin1String(".y()")
+                << name + QLatin1String(".width()") << name + QLatin1String(".height()");
+        return;
+    case Tracepoint::Field::Array:
+    case Tracepoint::Field::Sequence:
+        // the length of the data is not known to QTraceBuffer::Value
+        *names << name;
+        *values << QString();
+        return;
+    default:
+        break;
+    }
+
+    *names << name;
+    *values << name;
+}
+
+static void writeWrapper(QTextStream &stream, const Tracepoint &tracepoint,
+                         const QString &providerName)
+{
+    const QString argList = formatFunctionSignature(tracepoint.args);
+    const QString paramList = formatParameterList(tracepoint.args, BUILTIN);
+    const QString &name = tracepoint.name;
+
+    QString eventName = name;
+    QLatin1String phase("QTraceBuffer::Instant");
+    if (name.endsWith(entrySuffix)) {
+        eventName.chop(entrySuffix.size());
+        phase = QLatin1String("QTraceBuffer::Begin");
+    } else if (name.endsWith(exitSuffix)) {
+        eventName.chop(exitSuffix.size());
+        phase = QLatin1String("QTraceBuffer::End");
+    }
+
+    QStringList names;
+    QStringList values;
+    for (const Tracepoint::Field &field : tracepoint.fields)
+        fieldValues(field, &names, &values);
+
+    stream << "\n";
+
+    QString argumentNames = QStringLiteral("nullptr");
+    if (!names.isEmpty()) {
+        argumentNames = name + QLatin1String("_arguments");
+        stream << "inline constexpr const char *" << argumentNames << "[] = {\n"
+               << "    \"" << names.join(QLatin1String("\",\n    \"")) << "\"\n"
+               << "};\n";
+    }
+
+    stream << "inline constexpr QTraceBuffer::Tracepoint " << name << "_tracepoint = {\n"
+           << "    \"" << providerName << "\", \"" << eventName << "\", " << phase << ", "
+           << argumentNames << ", " << names.size() << "\n"
+           << "};\n\n";
+
+    stream << "inline void do_trace_" << name << "(" << argList << ")\n"
+           << "{\n"
+           << "    QTraceBuffer::record(" << name << "_tracepoint, {";
+    for (qsizetype i = 0; i < values.size(); ++i) {
+        stream << (i ? ",\n" : "\n")
+               << "        QTraceBuffer::Value(" << values.at(i) << ")";
+    }
+    stream << (values.isEmpty() ? "" : "\n    ") << "});\n"
+           << "}\n\n";
+
+    stream << "inline void trace_" << name << "(" << argList << ")\n"
+           << "{\n"
+           << "    if (QTraceBuffer::isEnabled())\n"
+           << "        do_trace_" << name << "(" << paramList << ");\n"
+           << "}\n\n";
+
+    stream << "inline bool trace_" << name << "_enabled()\n"
+           << "{\n"
+           << "    return QTraceBuffer::isEnabled();\n"
+           << "}\n";
+}
+
+static void writeTracepoints(QTextStream &stream, const Provider &provider)
+{
+    if (provider.tracepoints.isEmpty())
+        return;
+
+    const QString includeGuard = QStringLiteral("TP_%1_PROVIDER").arg(provider.name).toUpper();
+
+    stream << "#if !defined(" << includeGuard << ")\n"
+           << "#define " << includeGuard << "\n"
+           << "QT_BEGIN_NAMESPACE\n"
+           << "namespace QtPrivate {\n";
+
+    for (const Tracepoint &t : provider.tracepoints)
+        writeWrapper(stream, t, provider.name);
+
+    stream << "} // namespace QtPrivate\n"
+           << "QT_END_NAMESPACE\n"
+           << "#endif // " << includeGuard << "\n\n";
+}
+
+void writeBuiltin(QFile &file, const Provider &provider)
+{
+    QTextStream stream(&file);
+
+    const QString fileName = QFileInfo(file.fileName()).fileName();
+
+    writePrologue(stream, fileName, provider);
+    writeTracepoints(stream, provider);
+    writeEpilogue(stream, fileName);
+}
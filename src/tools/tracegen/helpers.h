@@ -47,7 +47,8 @@
 
 enum ParamType {
     LTTNG,
-    ETW
+    ETW,
+    BUILTIN
 };
 
 QString includeGuard(const QString &filename);
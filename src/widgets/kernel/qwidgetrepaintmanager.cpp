@@ -63,6 +63,8 @@
 
 #include <qpa/qplatformbackingstore.h>
 
+#include <qtwidgets_tracepoints_p.h>
+
 QT_BEGIN_NAMESPACE
 
 #ifndef QT_NO_OPENGL
@@ -803,6 +805,8 @@ bool QWidgetRepaintManager::syncAllowed()
 
 void QWidgetRepaintManager::paintAndFlush()
 {
+    Q_TRACE_SCOPE(QWidgetRepaintManager_paintAndFlush, tlw);
+
     qCInfo(lcWidgetPainting) << "Painting and flushing dirty"
         << "top level" << dirty << "and dirty widgets" << dirtyWidgets;
 
@@ -15,5 +15,8 @@ SUBDIRS=\
     qhooks \
     qoperatingsystemversion
 
+qtConfig(trace_builtin): SUBDIRS += \
+    qtracebuffer
+
 win32: SUBDIRS += \
     qwinregistry
@@ -32,6 +32,9 @@
 #if QT_CONFIG(process)
 # include <QtCore/QProcess>
 #endif
+#include <QtCore/QFileInfo>
+#include <QtCore/QLibraryInfo>
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QTest>
 
 class tst_qmessagehandler : public QObject
@@ -56,7 +59,9 @@ private slots:
 
     void qMessagePattern_data();
     void qMessagePattern();
+    void setMessagePattern_data();
     void setMessagePattern();
+    void binaryLog();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -813,6 +818,14 @@ void tst_qmessagehandler::qMessagePattern()
 #endif
 }
 
+void tst_qmessagehandler::setMessagePattern_data()
+{
+    QTest::addColumn<bool>("asyncStderr");
+
+    QTest::newRow("sync") << false;
+    QTest::newRow("async") << true;
+}
+
 void tst_qmessagehandler::setMessagePattern()
 {
 #if !QT_CONFIG(process)
@@ -842,6 +855,9 @@ void tst_qmessagehandler::setMessagePattern()
     std::copy_if(m_baseEnvironment.cbegin(), m_baseEnvironment.cend(),
                  std::back_inserter(environment),
                  doesNotStartWith(QLatin1String("QT_MESSAGE_PATTERN")));
+    QFETCH(bool, asyncStderr);
+    if (asyncStderr)
+        environment.append(QStringLiteral("QT_ASYNC_STDERR_LOGGING=1"));
     process.setEnvironment(environment);
 
     process.start(appExe);
@@ -864,6 +880,103 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::binaryLog()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    const QString logFile = dir.filePath(QStringLiteral("log.bin"));
+
+    QProcess process;
+#ifndef Q_OS_ANDROID
+    const QString appExe(QLatin1String(HELPER_BINARY));
+#else
+    const QString appExe(QCoreApplication::applicationDirPath() + QLatin1String("/libhelper.so"));
+#endif
+
+    QStringList environment = m_baseEnvironment;
+    environment.append(QStringLiteral("QT_BINARY_LOG_FILE=") + logFile);
+    process.setEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    const qint64 pid = process.processId();
+    process.waitForFinished();
+
+    // debug and info messages went to the log file instead
+    QByteArray output = process.readAllStandardError();
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1("[warning] qWarning\n"
+                                                              "[critical] qCritical\n"
+                                                              "[warning] qDebug with category\n"));
+
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray log = file.readAll();
+    QVERIFY(log.startsWith("QTBINLOG"));
+    // formats are stored as they are, streamed messages already formatted
+    QVERIFY(log.contains("static constructor"));
+    QVERIFY(log.contains("qDebug"));
+    QVERIFY(log.contains("qInfo"));
+    QVERIFY(log.contains("from_a_function 34"));
+    QVERIFY(!log.contains("qWarning"));
+
+    // qlogdecode formats the messages with the process, thread and application
+    // name they were logged with
+    QString decoderExe = QLibraryInfo::path(QLibraryInfo::BinariesPath)
+            + QLatin1String("/qlogdecode");
+#ifdef Q_OS_WIN
+    decoderExe += QLatin1String(".exe");
+#endif
+    if (!QFileInfo::exists(decoderExe))
+        QSKIP("qlogdecode was not built");
+
+    QProcess decoder;
+    environment = m_baseEnvironment;
+    environment.append(QStringLiteral(
+            "QT_MESSAGE_PATTERN=%{appname}|%{pid}|%{threadid}|%{type}|%{message}"));
+    decoder.setEnvironment(environment);
+    decoder.start(decoderExe, QStringList() << logFile);
+    QVERIFY2(decoder.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(decoderExe, decoder.errorString())));
+    QVERIFY(decoder.waitForFinished());
+    QCOMPARE(decoder.exitCode(), 0);
+
+    output = decoder.readAllStandardOutput();
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    // leave out the time and thread each line is prefixed with
+    QStringList decoded;
+    for (const QByteArray &line : output.split('\n')) {
+        if (!line.isEmpty())
+            decoded.append(QString::fromLocal8Bit(line.mid(line.indexOf("] ") + 2)));
+    }
+    QVERIFY(!decoded.isEmpty());
+    const QString threadId = decoded.constFirst().section(QLatin1Char('|'), 2, 2);
+    QVERIFY(threadId.toLongLong() != 0);
+    const QString origin = QLatin1Char('|') + QString::number(pid) + QLatin1Char('|') + threadId
+            + QLatin1Char('|');
+    // the helper only names itself once the static constructor has run
+    QCOMPARE(decoded.mid(0, 5), QStringList()
+             << origin + QLatin1String("debug|static constructor")
+             << QLatin1String("tst_qlogging") + origin + QLatin1String("debug|qDebug")
+             << QLatin1String("tst_qlogging") + origin + QLatin1String("info|qInfo")
+             << QLatin1String("tst_qlogging") + origin + QLatin1String("debug|qDebug2")
+             << QLatin1String("tst_qlogging") + origin
+                + QLatin1String("debug|from_a_function 34"));
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qtracebuffer
+QT = core-private testlib
+SOURCES = tst_qtracebuffer.cpp
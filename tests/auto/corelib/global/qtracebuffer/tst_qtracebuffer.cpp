@@ -0,0 +1,254 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/private/qtracebuffer_p.h>
+
+static constexpr const char *counterArguments[] = { "counter" };
+static constexpr QTraceBuffer::Tracepoint counterTracepoint = {
+    "tst_qtracebuffer", "counter", QTraceBuffer::Instant, counterArguments, 1
+};
+static constexpr QTraceBuffer::Tracepoint sliceEntry = {
+    "tst_qtracebuffer", "slice", QTraceBuffer::Begin, nullptr, 0
+};
+static constexpr QTraceBuffer::Tracepoint sliceExit = {
+    "tst_qtracebuffer", "slice", QTraceBuffer::End, nullptr, 0
+};
+static constexpr const char *valueArguments[] = {
+    "signed", "unsigned", "bool", "double", "pointer", "utf8", "utf16", "bytes"
+};
+static constexpr QTraceBuffer::Tracepoint valueTracepoint = {
+    "tst_qtracebuffer", "values", QTraceBuffer::Instant, valueArguments, 8
+};
+
+class tst_QTraceBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void chromeTrace();
+    void wrapAround();
+    void slicesAfterWrapAround();
+    void truncatedStrings();
+    void recordWhileWriting();
+
+private:
+    static QJsonArray writeEvents();
+};
+
+void tst_QTraceBuffer::init()
+{
+    QTraceBuffer::clear();
+    QTraceBuffer::setEnabled(true);
+}
+
+void tst_QTraceBuffer::cleanup()
+{
+    QTraceBuffer::setEnabled(false);
+}
+
+// Writes the trace, checks that it is valid JSON, and returns the events
+// recorded by this test
+QJsonArray tst_QTraceBuffer::writeEvents()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!QTraceBuffer::writeChromeTrace(&buffer))
+        return QJsonArray();
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(buffer.data(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "Invalid trace:" << error.errorString() << "at" << error.offset;
+        return QJsonArray();
+    }
+
+    QJsonArray events;
+    const QJsonArray traceEvents = document.object().value(QLatin1String("traceEvents")).toArray();
+    for (const QJsonValue &value : traceEvents) {
+        const QJsonObject event = value.toObject();
+        if (event.value(QLatin1String("cat")) == QLatin1String("tst_qtracebuffer"))
+            events.append(event);
+    }
+    return events;
+}
+
+void tst_QTraceBuffer::chromeTrace()
+{
+    int object = 0;
+    QTraceBuffer::record(sliceEntry, {});
+    QTraceBuffer::record(valueTracepoint, {
+        QTraceBuffer::Value(-42),
+        QTraceBuffer::Value(42u),
+        QTraceBuffer::Value(true),
+        QTraceBuffer::Value(0.5),
+        QTraceBuffer::Value(&object),
+        QTraceBuffer::Value("\"quoted\"\n"),
+        QTraceBuffer::Value(QStringLiteral("h\u00e9\u00e9")),
+        QTraceBuffer::Value(QByteArray("bytes"))
+    });
+    QTraceBuffer::record(sliceExit, {});
+
+    const QJsonArray events = writeEvents();
+    QCOMPARE(events.size(), 3);
+    const QJsonObject begin = events.at(0).toObject();
+    const QJsonObject values = events.at(1).toObject();
+    const QJsonObject end = events.at(2).toObject();
+    QCOMPARE(begin.value(QLatin1String("name")).toString(), QLatin1String("slice"));
+    QCOMPARE(begin.value(QLatin1String("ph")).toString(), QLatin1String("B"));
+    QCOMPARE(values.value(QLatin1String("ph")).toString(), QLatin1String("i"));
+    QCOMPARE(end.value(QLatin1String("ph")).toString(), QLatin1String("E"));
+    for (const QJsonValue &event : events) {
+        QVERIFY(event.toObject().value(QLatin1String("ts")).isDouble());
+        QCOMPARE(event.toObject().value(QLatin1String("tid")),
+                 begin.value(QLatin1String("tid")));
+    }
+    QVERIFY(begin.value(QLatin1String("ts")).toDouble()
+            <= end.value(QLatin1String("ts")).toDouble());
+
+    const QJsonObject args = values.value(QLatin1String("args")).toObject();
+    QCOMPARE(args.value(QLatin1String("signed")).toInt(), -42);
+    QCOMPARE(args.value(QLatin1String("unsigned")).toInt(), 42);
+    QCOMPARE(args.value(QLatin1String("bool")).toBool(), true);
+    QCOMPARE(args.value(QLatin1String("double")).toDouble(), 0.5);
+    QCOMPARE(args.value(QLatin1String("pointer")).toString(),
+             QLatin1String("0x") + QString::number(quintptr(&object), 16));
+    QCOMPARE(args.value(QLatin1String("utf8")).toString(), QLatin1String("\"quoted\"\n"));
+    QCOMPARE(args.value(QLatin1String("utf16")).toString(), QStringLiteral("h\u00e9\u00e9"));
+    QCOMPARE(args.value(QLatin1String("bytes")).toString(), QLatin1String("bytes"));
+}
+
+void tst_QTraceBuffer::wrapAround()
+{
+    const int count = QTraceBuffer::EventsPerThread + 100;
+    for (int i = 0; i < count; ++i)
+        QTraceBuffer::record(counterTracepoint, { QTraceBuffer::Value(i) });
+
+    // only the most recent events are kept, in order
+    const QJsonArray events = writeEvents();
+    QCOMPARE(events.size(), QTraceBuffer::EventsPerThread);
+    for (int i = 0; i < events.size(); ++i) {
+        const QJsonObject args = events.at(i).toObject().value(QLatin1String("args")).toObject();
+        QCOMPARE(args.value(QLatin1String("counter")).toInt(), 100 + i);
+    }
+
+    QTraceBuffer::clear();
+    QCOMPARE(writeEvents().size(), 0);
+}
+
+void tst_QTraceBuffer::slicesAfterWrapAround()
+{
+    // the beginning of the outer slice gets overwritten
+    QTraceBuffer::record(sliceEntry, {});
+    for (int i = 0; i < QTraceBuffer::EventsPerThread; ++i)
+        QTraceBuffer::record(counterTracepoint, { QTraceBuffer::Value(i) });
+    QTraceBuffer::record(sliceEntry, {});
+    QTraceBuffer::record(sliceExit, {});
+    QTraceBuffer::record(sliceExit, {});
+    QTraceBuffer::record(sliceEntry, {});
+
+    // the unmatched end is left out; the slice still open is kept
+    const QJsonArray events = writeEvents();
+    QString phases;
+    for (const QJsonValue &event : events) {
+        const QString phase = event.toObject().value(QLatin1String("ph")).toString();
+        if (phase != QLatin1String("i"))
+            phases += phase;
+    }
+    QCOMPARE(phases, QLatin1String("BEB"));
+}
+
+void tst_QTraceBuffer::truncatedStrings()
+{
+    const QString utf16 = QString(300, QChar(0xe9));
+    const QByteArray utf8 = utf16.toUtf8();
+    static constexpr const char *arguments[] = { "utf8", "utf16" };
+    static constexpr QTraceBuffer::Tracepoint tracepoint = {
+        "tst_qtracebuffer", "strings", QTraceBuffer::Instant, arguments, 2
+    };
+    QTraceBuffer::record(tracepoint, { QTraceBuffer::Value(utf8), QTraceBuffer::Value(utf16) });
+
+    const QJsonArray events = writeEvents();
+    QCOMPARE(events.size(), 1);
+    const QJsonObject args = events.at(0).toObject().value(QLatin1String("args")).toObject();
+    const QString truncatedUtf8 = args.value(QLatin1String("utf8")).toString();
+    const QString truncatedUtf16 = args.value(QLatin1String("utf16")).toString();
+    // the strings are cut at a character boundary, and share the space
+    QVERIFY(!truncatedUtf8.isEmpty());
+    QVERIFY(truncatedUtf8.size() < utf16.size());
+    QCOMPARE(truncatedUtf8, utf16.left(truncatedUtf8.size()));
+    QCOMPARE(truncatedUtf16, utf16.left(truncatedUtf16.size()));
+}
+
+void tst_QTraceBuffer::recordWhileWriting()
+{
+    QAtomicInt stop = 0;
+    QScopedPointer<QThread> thread(QThread::create([&stop] {
+        for (int i = 0; !stop.loadRelaxed(); ++i) {
+            QTraceBuffer::record(sliceEntry, {});
+            QTraceBuffer::record(counterTracepoint, { QTraceBuffer::Value(i) });
+            QTraceBuffer::record(sliceExit, {});
+        }
+    }));
+    thread->start();
+    auto stopThread = qScopeGuard([&] {
+        stop.storeRelaxed(1);
+        thread->wait();
+    });
+
+    QTRY_VERIFY(!writeEvents().isEmpty());
+    for (int i = 0; i < 20; ++i) {
+        const QJsonArray events = writeEvents();
+        QVERIFY(!events.isEmpty());
+        int depth = 0;
+        int previous = -1;
+        for (const QJsonValue &value : events) {
+            const QJsonObject event = value.toObject();
+            const QString phase = event.value(QLatin1String("ph")).toString();
+            if (phase == QLatin1String("B")) {
+                ++depth;
+            } else if (phase == QLatin1String("E")) {
+                QVERIFY(depth > 0);
+                --depth;
+            } else {
+                const int counter = event.value(QLatin1String("args")).toObject()
+                        .value(QLatin1String("counter")).toInt();
+                QVERIFY(counter > previous);
+                previous = counter;
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QTraceBuffer)
+#include "tst_qtracebuffer.moc"
@@ -6,6 +6,7 @@ SUBDIRS=\
     qdebug \
     qdir \
     qdiriterator \
+    qdirwalker \
     qfile \
     largefile \
     qfileinfo \
@@ -47,6 +48,7 @@ SUBDIRS=\
 
 !qtConfig(private_tests): SUBDIRS -= \
     qabstractfileengine \
+    qdirwalker \
     qfileinfo \
     qipaddress \
     qurlinternal \
@@ -110,6 +110,9 @@ private slots:
 #ifndef Q_OS_WIN
     void hiddenDirs_hiddenFiles();
 #endif
+#if !defined(Q_OS_WIN) && !defined(Q_NO_SYMLINKS)
+    void symlinkMetaData();
+#endif
 #ifdef BUILTIN_TESTDATA
 private:
     QSharedPointer<QTemporaryDir> m_dataDir;
@@ -642,6 +645,46 @@ void tst_QDirIterator::hiddenDirs_hiddenFiles()
 }
 #endif // Q_OS_WIN
 
+#if !defined(Q_OS_WIN) && !defined(Q_NO_SYMLINKS)
+void tst_QDirIterator::symlinkMetaData()
+{
+    // The type of symlinks is resolved relative to the directory being
+    // iterated, make sure that it matches what QFileInfo finds on its own
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+    QVERIFY(dir.mkpath("sub/subsub"));
+    QVERIFY(createFile(dir.filePath("sub/file"), DontDelete));
+    QVERIFY(createFile(dir.filePath("sub/subsub/file"), DontDelete));
+    QVERIFY(QFile::link(dir.filePath("sub/subsub"), dir.filePath("sub/dirlink")));
+    QVERIFY(QFile::link(dir.filePath("sub/file"), dir.filePath("sub/filelink")));
+    QVERIFY(QFile::link(dir.filePath("sub/nonexistent"), dir.filePath("sub/brokenlink")));
+
+    QStringList list;
+    QDirIterator it(tempDir.path(), QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        const QFileInfo reference(path);
+        QCOMPARE(info.isDir(), reference.isDir());
+        QCOMPARE(info.isFile(), reference.isFile());
+        QCOMPARE(info.isSymLink(), reference.isSymLink());
+        QCOMPARE(info.exists(), reference.exists());
+        QCOMPARE(info.isHidden(), reference.isHidden());
+        QCOMPARE(info.size(), reference.size());
+        list << dir.relativeFilePath(path);
+    }
+    list.sort();
+
+    const QStringList expected = {
+        "sub", "sub/brokenlink", "sub/dirlink", "sub/file",
+        "sub/filelink", "sub/subsub", "sub/subsub/file"
+    };
+    QCOMPARE(list, expected);
+}
+#endif
+
 QTEST_MAIN(tst_QDirIterator)
 
 #include "tst_qdiriterator.moc"
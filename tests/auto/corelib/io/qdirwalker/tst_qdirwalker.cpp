@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/private/qdirwalker_p.h>
+
+Q_DECLARE_METATYPE(QDir::Filters)
+Q_DECLARE_METATYPE(QDirIterator::IteratorFlags)
+Q_DECLARE_METATYPE(QDirWalker::Ordering)
+
+class tst_QDirWalker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void sameEntriesAsIterator_data();
+    void sameEntriesAsIterator();
+    void parentsFirst();
+    void batches();
+    void stop_data();
+    void stop();
+    void saturatedPool();
+    void symlinkLoop();
+    void resources();
+
+private:
+    static QStringList iterate(const QString &path, const QStringList &nameFilters,
+                               QDir::Filters filters, QDirIterator::IteratorFlags flags);
+    static QStringList walk(QDirWalker &walker);
+
+    QTemporaryDir tempDir;
+    QThreadPool pool;
+};
+
+void tst_QDirWalker::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    pool.setMaxThreadCount(4);
+
+    const std::function<void(const QString &, int)> populate = [&](const QString &dir, int depth) {
+        QVERIFY(QDir().mkpath(dir));
+        for (int i = 0; i < 5; ++i) {
+            QFile file(dir + QStringLiteral("/file%1.%2").arg(i).arg(i % 2 ? "txt" : "dat"));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+        QFile hidden(dir + QStringLiteral("/.hidden"));
+        QVERIFY(hidden.open(QIODevice::WriteOnly));
+        if (depth < 3) {
+            for (int i = 0; i < 3; ++i)
+                populate(dir + QStringLiteral("/dir%1").arg(i), depth + 1);
+        }
+    };
+    populate(tempDir.path(), 0);
+    QVERIFY(QDir().mkpath(tempDir.path() + QStringLiteral("/dir1/.hiddendir/sub")));
+
+#ifndef Q_OS_WIN
+    QVERIFY(QFile::link(tempDir.path() + QStringLiteral("/dir1"),
+                        tempDir.path() + QStringLiteral("/dir2/link")));
+    QVERIFY(QFile::link(tempDir.path(), tempDir.path() + QStringLiteral("/dir0/loop")));
+    QVERIFY(QFile::link(tempDir.path() + QStringLiteral("/missing"),
+                        tempDir.path() + QStringLiteral("/broken")));
+#endif
+}
+
+QStringList tst_QDirWalker::iterate(const QString &path, const QStringList &nameFilters,
+                                    QDir::Filters filters, QDirIterator::IteratorFlags flags)
+{
+    QStringList result;
+    QDirIterator it(path, nameFilters, filters, flags);
+    while (it.hasNext())
+        result << it.next();
+    return result;
+}
+
+QStringList tst_QDirWalker::walk(QDirWalker &walker)
+{
+    QStringList result;
+    const bool completed = walker.walk([&](const QFileInfoList &batch) {
+        for (const QFileInfo &info : batch)
+            result << info.filePath();
+        return true;
+    });
+    if (!completed)
+        qWarning("walk() did not complete");
+    return result;
+}
+
+void tst_QDirWalker::sameEntriesAsIterator_data()
+{
+    QTest::addColumn<QStringList>("nameFilters");
+    QTest::addColumn<QDir::Filters>("filters");
+    QTest::addColumn<QDirIterator::IteratorFlags>("flags");
+
+    const QDirIterator::IteratorFlags recursive = QDirIterator::Subdirectories;
+    QTest::newRow("flat") << QStringList() << QDir::Filters(QDir::NoFilter)
+                          << QDirIterator::IteratorFlags(QDirIterator::NoIteratorFlags);
+    QTest::newRow("recursive") << QStringList() << QDir::Filters(QDir::NoFilter) << recursive;
+    QTest::newRow("files") << QStringList() << QDir::Filters(QDir::Files) << recursive;
+    QTest::newRow("dirs") << QStringList() << QDir::Filters(QDir::Dirs | QDir::NoDotAndDotDot)
+                          << recursive;
+    QTest::newRow("hidden") << QStringList()
+                            << QDir::Filters(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot)
+                            << recursive;
+    QTest::newRow("system") << QStringList() << QDir::Filters(QDir::AllEntries | QDir::System)
+                            << recursive;
+    QTest::newRow("nameFilters") << QStringList{ "*.txt", "dir1*" } << QDir::Filters(QDir::NoFilter)
+                                 << recursive;
+    QTest::newRow("allDirs") << QStringList{ "*.txt" } << QDir::Filters(QDir::AllDirs | QDir::Files)
+                             << recursive;
+#ifndef Q_OS_WIN
+    QTest::newRow("followSymlinks") << QStringList() << QDir::Filters(QDir::NoFilter)
+                                    << (recursive | QDirIterator::FollowSymlinks);
+#endif
+}
+
+void tst_QDirWalker::sameEntriesAsIterator()
+{
+    QFETCH(QStringList, nameFilters);
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QDirIterator::IteratorFlags, flags);
+
+    const QStringList expected = iterate(tempDir.path(), nameFilters, filters, flags);
+    QVERIFY(!expected.isEmpty());
+
+    for (int batchSize : { 1, 7, 256 }) {
+        QDirWalker walker(tempDir.path(), nameFilters, filters, flags);
+        walker.setThreadPool(&pool);
+        walker.setBatchSize(batchSize);
+
+        walker.setOrdering(QDirWalker::IteratorOrder);
+        QCOMPARE(walk(walker), expected);
+
+        // Which path a directory reached through several links is listed
+        // under depends on timing when following symlinks unordered.
+        walker.setOrdering(QDirWalker::Unordered);
+        QStringList actual = walk(walker);
+        QCOMPARE(actual.size(), expected.size());
+        if (!(flags & QDirIterator::FollowSymlinks)) {
+            QStringList sorted = expected;
+            sorted.sort();
+            actual.sort();
+            QCOMPARE(actual, sorted);
+        }
+    }
+}
+
+void tst_QDirWalker::parentsFirst()
+{
+    QDirWalker walker(tempDir.path(), QDir::AllEntries | QDir::NoDotAndDotDot);
+    walker.setThreadPool(&pool);
+    walker.setBatchSize(2);
+
+    QSet<QString> seen;
+    for (const QString &path : walk(walker)) {
+        const QString parent = QFileInfo(path).path();
+        if (parent != tempDir.path())
+            QVERIFY2(seen.contains(parent), qPrintable(path));
+        seen.insert(path);
+    }
+    QVERIFY(!seen.isEmpty());
+}
+
+void tst_QDirWalker::batches()
+{
+    QDirWalker walker(tempDir.path());
+    walker.setThreadPool(&pool);
+    walker.setBatchSize(3);
+    QCOMPARE(walker.batchSize(), 3);
+    QCOMPARE(walker.threadPool(), &pool);
+    QCOMPARE(walker.maxConcurrency(), pool.maxThreadCount());
+    walker.setMaxConcurrency(2);
+    QCOMPARE(walker.maxConcurrency(), 2);
+
+    QThread *const callingThread = QThread::currentThread();
+    qsizetype total = 0;
+    QVERIFY(walker.walk([&](const QFileInfoList &batch) {
+        [&] {
+            QCOMPARE(QThread::currentThread(), callingThread);
+            QVERIFY(!batch.isEmpty());
+            QVERIFY(batch.size() <= 3);
+        }();
+        total += batch.size();
+        return true;
+    }));
+    QCOMPARE(total, iterate(tempDir.path(), QStringList(), QDir::NoFilter,
+                            QDirIterator::Subdirectories).size());
+}
+
+void tst_QDirWalker::stop_data()
+{
+    QTest::addColumn<QDirWalker::Ordering>("ordering");
+    QTest::newRow("unordered") << QDirWalker::Unordered;
+    QTest::newRow("iteratorOrder") << QDirWalker::IteratorOrder;
+}
+
+void tst_QDirWalker::stop()
+{
+    QFETCH(QDirWalker::Ordering, ordering);
+
+    QDirWalker walker(tempDir.path());
+    walker.setThreadPool(&pool);
+    walker.setBatchSize(2);
+    walker.setOrdering(ordering);
+
+    int calls = 0;
+    QVERIFY(!walker.walk([&](const QFileInfoList &) { return ++calls < 3; }));
+    QCOMPARE(calls, 3);
+}
+
+void tst_QDirWalker::saturatedPool()
+{
+    // The walk must complete even if the pool never gets to run its workers.
+    QThreadPool busyPool;
+    busyPool.setMaxThreadCount(1);
+    QSemaphore release;
+    busyPool.start([&release] { release.acquire(); });
+
+    const QStringList expected = iterate(tempDir.path(), QStringList(), QDir::NoFilter,
+                                         QDirIterator::Subdirectories);
+    QDirWalker walker(tempDir.path());
+    walker.setThreadPool(&busyPool);
+    walker.setOrdering(QDirWalker::IteratorOrder);
+    QCOMPARE(walk(walker), expected);
+    walker.setOrdering(QDirWalker::Unordered);
+    QCOMPARE(walk(walker).size(), expected.size());
+
+    release.release();
+}
+
+void tst_QDirWalker::symlinkLoop()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Test requires symlinks");
+#else
+    QDirWalker walker(tempDir.path(), QDir::Dirs | QDir::NoDotAndDotDot,
+                      QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    walker.setThreadPool(&pool);
+    const QStringList entries = walk(walker);
+    QVERIFY(entries.contains(tempDir.path() + QStringLiteral("/dir0/loop")));
+    for (const QString &entry : entries)
+        QVERIFY2(!entry.contains(QLatin1String("/loop/")), qPrintable(entry));
+#endif
+}
+
+void tst_QDirWalker::resources()
+{
+    const QString path = QStringLiteral(":/qt-project.org");
+    const QStringList expected = iterate(path, QStringList(), QDir::NoFilter,
+                                         QDirIterator::Subdirectories);
+    QDirWalker walker(path);
+    walker.setThreadPool(&pool);
+    QCOMPARE(walk(walker), expected);
+}
+
+QTEST_MAIN(tst_QDirWalker)
+
+#include "tst_qdirwalker.moc"
@@ -40,6 +40,9 @@
 #include <private/qabstractfileengine_p.h>
 #include <private/qfsfileengine_p.h>
 #include <private/qfilesystemengine_p.h>
+#if QT_CONFIG(future)
+#include <private/qfileasyncio_p.h>
+#endif
 
 #include "emulationdetector.h"
 
@@ -261,6 +264,12 @@ private slots:
     void resize_data();
     void resize();
 
+#if QT_CONFIG(future)
+    void readWriteAsync_data();
+    void readWriteAsync();
+    void readAsyncResource();
+#endif
+
     void objectConstructors();
 
     void caseSensitivity();
@@ -3476,6 +3485,104 @@ void tst_QFile::resize()
     QCOMPARE(QFileInfo(filename).size(), qint64(4));
 }
 
+#if QT_CONFIG(future)
+void tst_QFile::readWriteAsync_data()
+{
+    QTest::addColumn<QFileAsyncIO::Backend>("backend");
+
+    QTest::newRow("threadpool") << QFileAsyncIO::ThreadPool;
+    QTest::newRow("io_uring") << QFileAsyncIO::IoUring;
+}
+
+void tst_QFile::readWriteAsync()
+{
+    QFETCH(QFileAsyncIO::Backend, backend);
+    const QFileAsyncIO::Backend defaultBackend = QFileAsyncIO::backend();
+    if (!QFileAsyncIO::setBackend(backend))
+        QSKIP("Backend not available");
+    auto restoreBackend = qScopeGuard([defaultBackend] {
+        QFileAsyncIO::setBackend(defaultBackend);
+    });
+
+    QByteArray content(1 << 20, Qt::Uninitialized);
+    for (int i = 0; i < content.size(); ++i)
+        content[i] = char(i * 131 + (i >> 9));
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    QFile file(dir.filePath("async.bin"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(content), qint64(content.size()));
+
+    // Buffered data is flushed first and the file position is untouched
+    QFuture<QByteArray> single = file.readAsync(1000, 5000);
+    single.waitForFinished();
+    QCOMPARE(single.result(), content.mid(1000, 5000));
+    QCOMPARE(file.pos(), qint64(content.size()));
+
+    QList<QPair<qint64, qint64>> requests;
+    for (int i = 0; i < 1000; ++i)
+        requests.append(qMakePair(qint64(i) * 997, qint64(i % 50) * 37));
+    requests.append(qMakePair(qint64(content.size() - 10), qint64(100)));
+    requests.append(qMakePair(qint64(content.size() + 10), qint64(100)));
+    requests.append(qMakePair(qint64(0), qint64(content.size())));
+    QFuture<QByteArray> batch = file.readAsync(requests);
+
+    // Closing the file does not affect operations already submitted
+    file.close();
+    batch.waitForFinished();
+    const QList<QByteArray> results = batch.results();
+    QCOMPARE(results.size(), requests.size());
+    for (qsizetype i = 0; i < requests.size(); ++i)
+        QCOMPARE(results.at(i), content.mid(requests.at(i).first, requests.at(i).second));
+
+    // Only write once the reads past the end of the file are done
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QFuture<qint64> write = file.writeAsync(content.size() + 100, "appended");
+    file.close();
+    write.waitForFinished();
+    QCOMPARE(write.result(), qint64(8));
+
+    // Unbuffered, read() goes to the file each time, and still continues
+    // where it was after a readAsync()
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    QCOMPARE(file.read(10), content.left(10));
+    QFuture<QByteArray> ahead = file.readAsync(50000, 1000);
+    ahead.waitForFinished();
+    QCOMPARE(ahead.result(), content.mid(50000, 1000));
+    QCOMPARE(file.read(10), content.mid(10, 10));
+    QCOMPARE(file.pos(), qint64(20));
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.size(), qint64(content.size() + 108));
+    QVERIFY(file.seek(content.size()));
+    QCOMPARE(file.readAll(), QByteArray(100, '\0') + "appended");
+
+    QTest::ignoreMessage(QtWarningMsg, "QFile::writeAsync: File not open for writing");
+    QCOMPARE(file.writeAsync(0, "x").result(), qint64(-1));
+    file.close();
+    QTest::ignoreMessage(QtWarningMsg, "QFile::readAsync: File not open for reading");
+    QVERIFY(file.readAsync(0, 10).result().isEmpty());
+}
+
+void tst_QFile::readAsyncResource()
+{
+    QFile file(":/tst_qfileinfo/resources/file1.ext1");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray content = file.readAll();
+    QVERIFY(file.seek(1));
+
+    QFuture<QByteArray> result = file.readAsync({ qMakePair(qint64(1), qint64(3)),
+                                                  qMakePair(qint64(0), qint64(content.size())) });
+    result.waitForFinished();
+    QCOMPARE(result.resultCount(), 2);
+    QCOMPARE(result.resultAt(0), content.mid(1, 3));
+    QCOMPARE(result.resultAt(1), content);
+    QCOMPARE(file.pos(), qint64(1));
+}
+#endif
+
 void tst_QFile::objectConstructors()
 {
     QObject ob;
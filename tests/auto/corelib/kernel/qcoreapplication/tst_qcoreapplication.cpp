@@ -34,6 +34,9 @@
 
 #include <private/qcoreapplication_p.h>
 #include <private/qeventloop_p.h>
+#include <private/qeventloopstatistics_p.h>
+#include <private/qmetaobjectbuilder_p.h>
+#include <private/qobject_p.h>
 #include <private/qthread_p.h>
 
 #ifdef Q_OS_WIN
@@ -531,6 +534,104 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class QueuedCallRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    QList<int> recorded;
+
+public slots:
+    void call(int v) { recorded.append(v); }
+
+public:
+    bool event(QEvent *event) override
+    {
+        if (event->type() < QEvent::User)
+            return QObject::event(event);
+        recorded.append(event->type() - QEvent::User);
+        return true;
+    }
+};
+
+void tst_QCoreApplication::queuedCallsAndEventsInOrder()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls and other events take different paths into the posted
+    // event list, but must still be delivered in the order they were posted
+    QueuedCallRecorder recorder;
+    QScopedPointer<QThread> thread(QThread::create([&recorder] {
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 3)
+                QMetaObject::invokeMethod(&recorder, "call", Qt::QueuedConnection, Q_ARG(int, i));
+            else
+                QCoreApplication::postEvent(&recorder, new QEvent(QEvent::Type(QEvent::User + i)));
+        }
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    QList<int> expected;
+    for (int i = 0; i < 1000; ++i)
+        expected << i;
+    QCoreApplication::sendPostedEvents(&recorder);
+    QCOMPARE(recorder.recorded, expected);
+
+    // and queued calls still pending when the receiver is destroyed are dropped
+    QScopedPointer<QueuedCallRecorder> dropped(new QueuedCallRecorder);
+    thread.reset(QThread::create([&dropped] {
+        for (int i = 0; i < 100; ++i)
+            QMetaObject::invokeMethod(dropped.data(), "call", Qt::QueuedConnection, Q_ARG(int, i));
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+    dropped.reset();
+    QCoreApplication::sendPostedEvents();
+}
+
+class MetaCallCompressingApplication : public QCoreApplication
+{
+public:
+    using QCoreApplication::QCoreApplication;
+    int compressed = 0;
+
+protected:
+    bool compressEvent(QEvent *event, QObject *receiver, QPostEventList *postedEvents) override
+    {
+        if (event->type() != QEvent::MetaCall)
+            return QCoreApplication::compressEvent(event, receiver, postedEvents);
+        ++compressed;
+        delete event;
+        return true;
+    }
+};
+
+void tst_QCoreApplication::compressQueuedCalls()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    MetaCallCompressingApplication app(argc, argv);
+
+    // queued calls are merged into the posted event list after the fact, but
+    // an application's compressEvent() must still see them like other events
+    QueuedCallRecorder recorder;
+    QScopedPointer<QThread> thread(QThread::create([&recorder] {
+        for (int i = 0; i < 10; ++i)
+            QMetaObject::invokeMethod(&recorder, "call", Qt::QueuedConnection, Q_ARG(int, i));
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+    for (int i = 10; i < 20; ++i)
+        QMetaObject::invokeMethod(&recorder, "call", Qt::QueuedConnection, Q_ARG(int, i));
+
+    // compressEvent() is only asked once the receiver has pending events
+    QCoreApplication::sendPostedEvents(&recorder);
+    QCOMPARE(recorder.recorded, QList<int>{ 0 });
+    QCOMPARE(app.compressed, 19);
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
@@ -586,6 +687,151 @@ void tst_QCoreApplication::globalPostedEventsCount()
     QCOMPARE(x.globalPostedEventsCount, expected);
 }
 
+class StatisticsReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    int stallIn = -1;
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::User && --stallIn == 0)
+            QThread::msleep(20);
+        return QObject::event(event);
+    }
+};
+
+void tst_QCoreApplication::eventLoopStatistics()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const auto restore = qScopeGuard([previous = QEventLoopStatistics::stallThreshold()] {
+        QEventLoopStatistics::setEnabled(false);
+        QEventLoopStatistics::setStallThreshold(previous);
+        QEventLoopStatistics::reset();
+    });
+    QCoreApplication::sendPostedEvents();
+    QEventLoopStatistics::reset();
+
+    StatisticsReceiver receiver;
+    receiver.stallIn = 2;
+
+    // nothing is recorded unless enabled
+    QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QCoreApplication::sendPostedEvents();
+
+    QEventLoopStatistics::setEnabled(true);
+    QEventLoopStatistics::setStallThreshold(10 * 1000);
+    for (int i = 0; i < 3; ++i)
+        QCoreApplication::postEvent(&receiver, new QEvent(QEvent::User));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(
+            "^Event loop stalled: handling User for StatisticsReceiver took \\d+ ms$"));
+    QCoreApplication::sendPostedEvents();
+    QEvent sent(QEvent::User);
+    QCoreApplication::sendEvent(&receiver, &sent);
+    QEventLoopStatistics::setEnabled(false);
+
+    const quintptr threadId = quintptr(QThread::currentThreadId());
+    const QList<QEventLoopStatistics::ThreadStatistics> threads = QEventLoopStatistics::snapshot();
+    const auto thread = std::find_if(threads.cbegin(), threads.cend(), [&](const auto &thread) {
+        return thread.threadId == threadId && !thread.finished;
+    });
+    QVERIFY(thread != threads.cend());
+    QCOMPARE(thread->stalls, 1u);
+    QCOMPARE(thread->queueDepth.count, 1u);
+    QCOMPARE(thread->queueDepth.maximum, 3u);
+
+    const auto event = std::find_if(thread->events.cbegin(), thread->events.cend(), [](const auto &event) {
+        return event.eventType == QEvent::User && event.receiverClass == "StatisticsReceiver";
+    });
+    QVERIFY(event != thread->events.cend());
+    QCOMPARE(event->queueWait.count, 3u);
+    QCOMPARE(event->handlerDuration.count, 4u);
+    QCOMPARE(event->stalls, 1u);
+    QVERIFY(event->handlerDuration.maximum >= 20u * 1000 * 1000);
+    QVERIFY(event->handlerDuration.percentile(1.0) >= 20u * 1000 * 1000);
+    QVERIFY(event->handlerDuration.percentile(0.5) < 20u * 1000 * 1000);
+
+    const QString report = QEventLoopStatistics::report();
+    QVERIFY2(report.contains(QLatin1String("User -> StatisticsReceiver: 4 handled")), qPrintable(report));
+
+    QEventLoopStatistics::reset();
+    for (const auto &thread : QEventLoopStatistics::snapshot())
+        QVERIFY(thread.events.isEmpty());
+}
+
+// a metaobject owned by its object, like those of QML objects
+class OwnedMetaObject : public QAbstractDynamicMetaObject
+{
+public:
+    OwnedMetaObject(const QByteArray &className, const QMetaObject *superClass)
+    {
+        QMetaObjectBuilder builder;
+        builder.setClassName(className);
+        builder.setSuperClass(superClass);
+        built = builder.toMetaObject();
+        *static_cast<QMetaObject *>(this) = *built;
+    }
+    ~OwnedMetaObject() { free(built); }
+
+    int metaCall(QObject *object, QMetaObject::Call call, int id, void **argv) override
+    { return object->qt_metacall(call, id, argv); }
+
+private:
+    QMetaObject *built;
+};
+
+void tst_QCoreApplication::eventLoopStatisticsDynamicMetaObject()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    const auto restore = qScopeGuard([] {
+        QEventLoopStatistics::setEnabled(false);
+        QEventLoopStatistics::reset();
+    });
+    QCoreApplication::sendPostedEvents();
+    QEventLoopStatistics::reset();
+
+    // the dynamic metaobjects are gone with their receivers once the events
+    // are handled, and both are recorded under the same class
+    QEventLoopStatistics::setEnabled(true);
+    for (int i = 0; i < 2; ++i) {
+        StatisticsReceiver *receiver = new StatisticsReceiver;
+        QObjectPrivate::get(receiver)->metaObject =
+                new OwnedMetaObject("DynamicStatisticsReceiver", &StatisticsReceiver::staticMetaObject);
+        QCOMPARE(receiver->metaObject()->className(), "DynamicStatisticsReceiver");
+        QCoreApplication::postEvent(receiver, new QEvent(QEvent::User));
+        QCoreApplication::postEvent(receiver, new QDeferredDeleteEvent);
+        QCoreApplication::sendPostedEvents(receiver);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+    QEventLoopStatistics::setEnabled(false);
+
+    const quintptr threadId = quintptr(QThread::currentThreadId());
+    const QList<QEventLoopStatistics::ThreadStatistics> threads = QEventLoopStatistics::snapshot();
+    const auto thread = std::find_if(threads.cbegin(), threads.cend(), [&](const auto &thread) {
+        return thread.threadId == threadId && !thread.finished;
+    });
+    QVERIFY(thread != threads.cend());
+
+    for (QEvent::Type type : { QEvent::User, QEvent::DeferredDelete }) {
+        const auto count = std::count_if(thread->events.cbegin(), thread->events.cend(), [type](const auto &event) {
+            return event.eventType == type && event.receiverClass == "DynamicStatisticsReceiver";
+        });
+        QCOMPARE(count, 1);
+        const auto event = std::find_if(thread->events.cbegin(), thread->events.cend(), [type](const auto &event) {
+            return event.eventType == type && event.receiverClass == "DynamicStatisticsReceiver";
+        });
+        QCOMPARE(event->handlerDuration.count, 2u);
+        QCOMPARE(event->queueWait.count, 2u);
+    }
+}
+
 class ProcessEventsAlwaysSendsPostedEventsObject : public QObject
 {
 public:
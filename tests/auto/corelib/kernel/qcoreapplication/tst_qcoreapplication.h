@@ -45,9 +45,13 @@ private slots:
     void removePostedEvents();
 #if QT_CONFIG(thread)
     void deliverInDefinedOrder();
+    void queuedCallsAndEventsInOrder();
+    void compressQueuedCalls();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
+    void eventLoopStatistics();
+    void eventLoopStatisticsDynamicMetaObject();
     void processEventsAlwaysSendsPostedEvents();
 #ifdef Q_OS_WIN
     void sendPostedEventsInNativeLoop();
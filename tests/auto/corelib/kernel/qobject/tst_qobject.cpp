@@ -158,6 +158,8 @@ private slots:
     void functorReferencesConnection();
     void disconnectDisconnects();
     void singleShotConnection();
+    void batchedConnection();
+    void coalescedConnection();
 };
 
 struct QObjectCreatedOnShutdown
@@ -8107,6 +8109,106 @@ void tst_QObject::singleShotConnection()
     }
 }
 
+class MetaCallCounter : public QObject
+{
+public:
+    int metaCalls = 0;
+    bool eventFilter(QObject *, QEvent *event) override
+    {
+        if (event->type() == QEvent::MetaCall)
+            ++metaCalls;
+        return false;
+    }
+};
+
+void tst_QObject::batchedConnection()
+{
+    {
+        // emissions made while one is pending are delivered with the same event
+        SenderObject sender;
+        MetaCallCounter counter;
+        sender.installEventFilter(&counter);
+        QVERIFY(connect(&sender, &SenderObject::signal1, &sender, &SenderObject::aPublicSlot,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+
+        sender.emitSignal1();
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QCOMPARE(sender.aPublicSlotCalled, 0);
+
+        QCoreApplication::processEvents();
+        QCOMPARE(sender.aPublicSlotCalled, 3);
+        QCOMPARE(counter.metaCalls, 1);
+
+        sender.emitSignal1();
+        QCoreApplication::processEvents();
+        QCOMPARE(sender.aPublicSlotCalled, 4);
+        QCOMPARE(counter.metaCalls, 2);
+    }
+
+    {
+        // arguments are kept per emission, in order
+        SenderObject sender;
+        QObject context;
+        QList<int> received;
+        QVERIFY(connect(&sender, &SenderObject::signal7, &context,
+                        [&](int i, const QString &s) {
+                            QCOMPARE(s, QString::number(i));
+                            received << i;
+                            if (i == 1)
+                                emit sender.signal7(10, QStringLiteral("10"));
+                        },
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+
+        for (int i = 0; i < 5; ++i)
+            emit sender.signal7(i, QString::number(i));
+        QCoreApplication::processEvents();
+        // emissions from the slot go into the next batch
+        QCoreApplication::processEvents();
+        QCOMPARE(received, QList<int>({ 0, 1, 2, 3, 4, 10 }));
+    }
+
+    {
+        // pending emissions are dropped with the receiver
+        SenderObject sender;
+        QScopedPointer<ReceiverObject> receiver(new ReceiverObject);
+        receiver->reset();
+        QVERIFY(connect(&sender, &SenderObject::signal1, receiver.data(), &ReceiverObject::slot1,
+                        Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)));
+        sender.emitSignal1();
+        sender.emitSignal1();
+        receiver.reset();
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_QObject::coalescedConnection()
+{
+    SenderObject sender;
+    QObject context;
+    MetaCallCounter counter;
+    context.installEventFilter(&counter);
+    QList<int> received;
+    QVERIFY(connect(&sender, &SenderObject::signal7, &context,
+                    [&](int i, const QString &s) {
+                        QCOMPARE(s, QString::number(i));
+                        received << i;
+                    },
+                    Qt::ConnectionType(Qt::QueuedConnection | Qt::CoalescedConnection)));
+
+    for (int i = 0; i < 100; ++i)
+        emit sender.signal7(i, QString::number(i));
+    QVERIFY(received.isEmpty());
+    QCoreApplication::processEvents();
+    QCOMPARE(received, QList<int>({ 99 }));
+    QCOMPARE(counter.metaCalls, 1);
+
+    emit sender.signal7(100, QStringLiteral("100"));
+    QCoreApplication::processEvents();
+    QCOMPARE(received, QList<int>({ 99, 100 }));
+    QCOMPARE(counter.metaCalls, 2);
+}
+
 // Test for QtPrivate::HasQ_OBJECT_Macro
 static_assert(QtPrivate::HasQ_OBJECT_Macro<tst_QObject>::Value);
 static_assert(!QtPrivate::HasQ_OBJECT_Macro<SiblingDeleter>::Value);
@@ -40,6 +40,9 @@
 #include <qthread.h>
 #include <qelapsedtimer.h>
 
+#include <memory>
+#include <vector>
+
 #if defined Q_OS_UNIX
 #include <unistd.h>
 #endif
@@ -74,6 +77,7 @@ private slots:
     void timerFiresOnlyOncePerProcessEvents();
     void timerIdPersistsAfterThreadExit();
     void cancelLongTimer();
+    void manyTimersFireInOrder();
     void singleShotStaticFunctionZeroTimeout();
     void recurseOnTimeoutAndStopTimer();
     void singleShotToFunctors();
@@ -723,6 +727,40 @@ void tst_QTimer::cancelLongTimer()
     QVERIFY(!timer.isActive());
 }
 
+void tst_QTimer::manyTimersFireInOrder()
+{
+    // spread over more than one level of the timer wheel
+    const int count = 300;
+    QList<int> intervals;
+    for (int i = 0; i < count; ++i)
+        intervals << (i * 7 % count) * 4;
+
+    QList<int> fired;
+    std::vector<std::unique_ptr<QTimer>> timers;
+    for (int interval : qAsConst(intervals)) {
+        timers.emplace_back(new QTimer);
+        QTimer *timer = timers.back().get();
+        timer->setTimerType(Qt::PreciseTimer);
+        timer->setSingleShot(true);
+        connect(timer, &QTimer::timeout, [&fired, interval] { fired << interval; });
+    }
+    // restarting them must not leave stale entries behind
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < count; ++i)
+            timers[i]->start(intervals.at(i));
+    }
+    QTimer cancelled;
+    cancelled.setSingleShot(true);
+    connect(&cancelled, &QTimer::timeout, [&fired] { fired << -1; });
+    cancelled.start(100);
+    cancelled.stop();
+
+    QTRY_COMPARE_WITH_TIMEOUT(fired.size(), count, 10000);
+    QTest::qWait(150);
+    QCOMPARE(fired.size(), count);
+    QVERIFY(std::is_sorted(fired.cbegin(), fired.cend()));
+}
+
 class TimeoutCounter : public QObject
 {
     Q_OBJECT
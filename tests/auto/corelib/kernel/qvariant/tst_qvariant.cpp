@@ -102,6 +102,7 @@ private slots:
     void canConvert_data();
     void canConvert();
     void convert();
+    void convertToBuffer();
 
     void toSize_data();
     void toSize();
@@ -570,6 +571,42 @@ void tst_QVariant::convert()
    QCOMPARE(var.toInt(), 0);
 }
 
+void tst_QVariant::convertToBuffer()
+{
+    const QVariant var(QStringLiteral("42.5"));
+
+    double d = 0;
+    QVERIFY(var.convert(QMetaType::fromType<double>(), &d));
+    QCOMPARE(d, 42.5);
+    QCOMPARE(var.metaType(), QMetaType::fromType<QString>());
+
+    QByteArray ba;
+    QVERIFY(var.convert(QMetaType::fromType<QByteArray>(), &ba));
+    QCOMPARE(ba, QByteArray("42.5"));
+
+    QString s;
+    QVERIFY(var.convert(QMetaType::fromType<QString>(), &s));
+    QCOMPARE(s, QStringLiteral("42.5"));
+
+    int i = 7;
+    QVERIFY(!var.convert(QMetaType::fromType<int>(), &i));
+
+    // No conversion from QString to QRect is registered:
+    QVERIFY(!var.canConvert(QMetaType::fromType<QRect>()));
+    QRect r(1, 2, 3, 4);
+    QVERIFY(!var.convert(QMetaType::fromType<QRect>(), &r));
+
+    // Null variants never convert, and leave the target untouched:
+    i = 7;
+    QVERIFY(!QVariant().convert(QMetaType::fromType<int>(), &i));
+    QCOMPARE(i, 7);
+    QVERIFY(!QVariant(QMetaType::fromType<int>()).convert(QMetaType::fromType<int>(), &i));
+    QCOMPARE(i, 7);
+    s = QStringLiteral("unchanged");
+    QVERIFY(!QVariant(QMetaType::fromType<QString>()).convert(QMetaType::fromType<QString>(), &s));
+    QCOMPARE(s, QStringLiteral("unchanged"));
+}
+
 
 void tst_QVariant::toInt_data()
 {
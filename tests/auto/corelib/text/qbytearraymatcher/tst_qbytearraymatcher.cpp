@@ -43,6 +43,8 @@ class tst_QByteArrayMatcher : public QObject
 private slots:
     void interface();
     void indexIn();
+    void indexInEveryPosition();
+    void filterDefeatingText();
     void staticByteArrayMatcher();
 };
 
@@ -137,6 +139,44 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 34), -1);
 }
 
+void tst_QByteArrayMatcher::indexInEveryPosition()
+{
+    // covers the vectorized search, its tail, and candidates that only match partially
+    for (int needleLength : { 1, 2, 3, 15, 16, 17, 40 }) {
+        const QByteArray needle = QByteArray(needleLength - 1, '\xfe') + '\x80';
+        const QByteArray decoy = needleLength > 2
+                ? '\xfe' + QByteArray(needleLength - 2, 'x') + '\x80'
+                : QByteArray(needleLength, '\xfe');
+        for (int pos = 0; pos < 70; ++pos) {
+            QByteArray haystack = QByteArray(pos, 'a') + decoy + QByteArray(pos % 5, 'a');
+            const qsizetype expected = haystack.size();
+            haystack += needle + QByteArray(pos % 17, '\xfe');
+
+            const QByteArrayMatcher matcher(needle);
+            QCOMPARE(matcher.indexIn(haystack), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected + 1), -1);
+            QCOMPARE(matcher.indexIn(haystack.constData(), expected + needleLength - 1), -1);
+            QCOMPARE(haystack.indexOf(needle), expected);
+            QCOMPARE(haystack.indexOf(needle, expected + 1), -1);
+        }
+    }
+}
+
+void tst_QByteArrayMatcher::filterDefeatingText()
+{
+    // every position has the needle's first and last bytes, so the search
+    // falls back to Boyer-Moore
+    const QByteArray needle = QByteArray(10, 'a') + 'b' + QByteArray(10, 'a');
+    for (int length : { 100, 1000, 10000 }) {
+        const QByteArray haystack = QByteArray(length, 'a') + needle + QByteArray(5, 'a');
+        const QByteArrayMatcher matcher(needle);
+        QCOMPARE(matcher.indexIn(haystack), length);
+        QCOMPARE(matcher.indexIn(haystack, length + 1), -1);
+        QCOMPARE(haystack.indexOf(needle), length);
+    }
+}
+
 void tst_QByteArrayMatcher::staticByteArrayMatcher()
 {
     {
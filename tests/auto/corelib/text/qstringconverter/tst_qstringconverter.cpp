@@ -30,6 +30,7 @@
 #include <QtTest/QtTest>
 
 #include <qstringconverter.h>
+#include <qcborvalue.h>
 #include <qthreadpool.h>
 
 class tst_QStringConverter : public QObject
@@ -51,6 +52,12 @@ private slots:
     void utf8Codec_data();
     void utf8Codec();
 
+    void utf8BlockBoundaries_data();
+    void utf8BlockBoundaries();
+
+    void utf8EncodeBlockBoundaries_data();
+    void utf8EncodeBlockBoundaries();
+
     void utf8bom_data();
     void utf8bom();
 
@@ -1261,6 +1268,178 @@ void tst_QStringConverter::utf8Codec()
     QCOMPARE(str, res);
 }
 
+// Straightforward encoder for valid UTF-16, independent of the code under test.
+static QByteArray referenceUtf8(QStringView str)
+{
+    QByteArray result;
+    for (qsizetype i = 0; i < str.size(); ++i) {
+        char32_t uc = str.at(i).unicode();
+        if (QChar::isHighSurrogate(uc) && i + 1 < str.size() && str.at(i + 1).isLowSurrogate())
+            uc = QChar::surrogateToUcs4(char16_t(uc), str.at(++i).unicode());
+        if (uc < 0x80) {
+            result += char(uc);
+        } else if (uc < 0x800) {
+            result += char(0xc0 | (uc >> 6));
+            result += char(0x80 | (uc & 0x3f));
+        } else if (uc < 0x10000) {
+            result += char(0xe0 | (uc >> 12));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        } else {
+            result += char(0xf0 | (uc >> 18));
+            result += char(0x80 | ((uc >> 12) & 0x3f));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        }
+    }
+    return result;
+}
+
+// QCborValue validates the UTF-8 of text strings with QUtf8::isValidUtf8
+static bool isValidUtf8Text(const QByteArray &utf8)
+{
+    QByteArray cbor;
+    cbor += char(0x79);     // text string, 16-bit length
+    cbor += char(utf8.size() >> 8);
+    cbor += char(utf8.size());
+    cbor += utf8;
+    QCborParserError error;
+    QCborValue::fromCbor(cbor, &error);
+    return error.error == QCborError::NoError;
+}
+
+// Prefixes that move the following data across the 16-byte blocks the SIMD
+// code works on, and text that switches between ASCII and multi-byte runs.
+static QList<QPair<QByteArray, QString>> blockBoundaryPrefixes()
+{
+    const struct {
+        const char *name;
+        QString unit;
+        int maxCount;
+    } units[] = {
+        { "ascii", QStringLiteral("a"), 40 },
+        { "cyrillic", QString(QChar(0x434)), 20 },
+        { "cjk", QString(QChar(0x4e2d)), 14 },
+        { "mixed", QString(QLatin1Char('x')) + QChar(0x434) + QChar(0x4e2d), 10 },
+    };
+
+    QList<QPair<QByteArray, QString>> prefixes;
+    for (const auto &unit : units) {
+        for (int count = 0; count <= unit.maxCount; ++count) {
+            prefixes.append({ QByteArray(unit.name) + '-' + QByteArray::number(count),
+                              unit.unit.repeated(count) });
+        }
+    }
+
+    for (int run : { 1, 3, 7, 15, 16, 17, 31 }) {
+        const QString ascii = QString(QLatin1Char('b')).repeated(run);
+        const QString cyrillic = QString(QChar(0x436)).repeated(run);
+        const QString cjk = QString(QChar(0x6587)).repeated(run);
+        prefixes.append({ "alternating-" + QByteArray::number(run),
+                          (ascii + cyrillic + ascii + cjk).repeated(3) });
+    }
+    return prefixes;
+}
+
+void tst_QStringConverter::utf8BlockBoundaries_data()
+{
+    QTest::addColumn<QString>("prefix");
+    QTest::addColumn<QByteArray>("tail");
+
+    // Each tail is shorter than what the SIMD code needs to start, so decoding it
+    // on its own goes through the scalar code. Behind a prefix, the same bytes
+    // end up inside or across the edge of a 16-byte block.
+    const struct {
+        const char *name;
+        QByteArray bytes;
+    } tails[] = {
+        { "none", QByteArray() },
+        { "valid", QByteArray("\xd0\xb4\xe4\xb8\xad" "z") },
+        { "fourByte", QByteArray("\xf0\x9f\x98\x80" "z") },
+        { "truncated2", QByteArray("\xd0" "z") },
+        { "truncated3", QByteArray("\xe4\xb8" "z") },
+        { "truncated4", QByteArray("\xf0\x9f\x98" "z") },
+        { "truncatedAtEnd", QByteArray("\xe4\xb8") },
+        { "overlong2", QByteArray("\xc0\xaf" "z") },
+        { "overlong3", QByteArray("\xe0\x80\xaf" "z") },
+        { "surrogate", QByteArray("\xed\xa0\x80" "z") },
+        { "outOfRange", QByteArray("\xf4\x90\x80\x80" "z") },
+        { "invalidLead", QByteArray("\xf5\x80\x80\x80" "z") },
+        { "continuation", QByteArray("\x80" "z") },
+    };
+
+    const auto prefixes = blockBoundaryPrefixes();
+    for (const auto &prefix : prefixes) {
+        for (const auto &tail : tails)
+            QTest::addRow("%s-%s", prefix.first.constData(), tail.name) << prefix.second << tail.bytes;
+    }
+}
+
+void tst_QStringConverter::utf8BlockBoundaries()
+{
+    QFETCH(QString, prefix);
+    QFETCH(QByteArray, tail);
+
+    const QByteArray utf8 = referenceUtf8(prefix) + tail;
+    const QString expected = prefix + QString::fromUtf8(tail);
+
+    QCOMPARE(QString::fromUtf8(utf8), expected);
+
+    QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+    QString str = decoder(utf8);
+    QCOMPARE(str, expected);
+
+    // the stateful decoder stops at an incomplete sequence at the end
+    QStringDecoder statefulDecoder(QStringDecoder::Utf8);
+    str = statefulDecoder(utf8);
+    str += statefulDecoder(QByteArray());
+    QString tailStr = QStringDecoder(QStringDecoder::Utf8).decode(tail);
+    QCOMPARE(str, prefix + tailStr);
+
+    QCOMPARE(isValidUtf8Text(utf8), isValidUtf8Text(tail));
+}
+
+void tst_QStringConverter::utf8EncodeBlockBoundaries_data()
+{
+    QTest::addColumn<QString>("prefix");
+    QTest::addColumn<QString>("tail");
+
+    // As above, the tails are short enough to be encoded by the scalar code.
+    const struct {
+        const char *name;
+        QString chars;
+    } tails[] = {
+        { "none", QString() },
+        { "valid", QString(QChar(0x434)) + QChar(0x4e2d) + QLatin1Char('z') },
+        { "surrogatePair", QString::fromUcs4(U"\U0001F600z") },
+        { "loneHigh", QString(QChar(0xd800)) + QLatin1Char('z') },
+        { "loneLow", QString(QChar(0xdc00)) + QLatin1Char('z') },
+        { "highAtEnd", QString(QChar(0xd800)) },
+        { "reversedPair", QString(QChar(0xdc00)) + QChar(0xd800) + QLatin1Char('z') },
+        { "nonCharacter", QString(QChar(0xffff)) + QLatin1Char('z') },
+    };
+
+    const auto prefixes = blockBoundaryPrefixes();
+    for (const auto &prefix : prefixes) {
+        for (const auto &tail : tails)
+            QTest::addRow("%s-%s", prefix.first.constData(), tail.name) << prefix.second << tail.chars;
+    }
+}
+
+void tst_QStringConverter::utf8EncodeBlockBoundaries()
+{
+    QFETCH(QString, prefix);
+    QFETCH(QString, tail);
+
+    const QString str = prefix + tail;
+    QCOMPARE(str.toUtf8(), referenceUtf8(prefix) + tail.toUtf8());
+
+    QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+    QByteArray tailUtf8 = encoder(tail);
+    QByteArray utf8 = encoder(str);
+    QCOMPARE(utf8, referenceUtf8(prefix) + tailUtf8);
+}
+
 QT_WARNING_PUSH
 QT_WARNING_DISABLE_DEPRECATED
 void tst_QStringConverter::utf8bom_data()
@@ -41,6 +41,10 @@ private slots:
     void setCaseSensitivity_data();
     void setCaseSensitivity();
     void assignOperator();
+    void indexInEveryPosition();
+    void caseFoldingVariants();
+    void changeSearch();
+    void filterDefeatingText();
 };
 
 void tst_QStringMatcher::qstringmatcher()
@@ -148,6 +152,89 @@ void tst_QStringMatcher::assignOperator()
     QCOMPARE(m2.indexIn(hayStack), 3);
 }
 
+void tst_QStringMatcher::indexInEveryPosition()
+{
+    // covers the vectorized search, its tail, and candidates that only match partially
+    for (int needleLength : { 2, 3, 7, 8, 9, 17, 40 }) {
+        const QString needle = QString(needleLength - 1, u'b') + u'C';
+        const QString decoy = needleLength > 2
+                ? u'b' + QString(needleLength - 2, u'x') + u'C'
+                : QStringLiteral("bb");
+        for (int pos = 0; pos < 70; ++pos) {
+            QString haystack = QString(pos, u'a') + decoy + QString(pos % 5, u'a');
+            const qsizetype expected = haystack.size();
+            haystack += needle + QString(pos % 9, u'b');
+
+            QStringMatcher matcher(needle);
+            QCOMPARE(matcher.indexIn(haystack), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected + 1), -1);
+            QCOMPARE(haystack.indexOf(needle), expected);
+
+            const QString upperHaystack = haystack.toUpper();
+            matcher.setCaseSensitivity(Qt::CaseInsensitive);
+            QCOMPARE(matcher.indexIn(upperHaystack), expected);
+            QCOMPARE(matcher.indexIn(upperHaystack, expected + 1), -1);
+            QCOMPARE(upperHaystack.indexOf(needle, 0, Qt::CaseInsensitive), expected);
+        }
+    }
+}
+
+void tst_QStringMatcher::caseFoldingVariants()
+{
+    // U+212A KELVIN SIGN and U+017F LATIN SMALL LETTER LONG S case-fold to 'k' and 's'
+    const QString haystack = QString(40, u'-') + QStringLiteral("mas\u212Aed\u017Fearch") + QString(20, u'-');
+    QStringMatcher matcher(QStringLiteral("MASKEDSEARCH"), Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(haystack), 40);
+    QCOMPARE(haystack.indexOf(QLatin1String("kedsea"), 0, Qt::CaseInsensitive), 43);
+    QCOMPARE(haystack.indexOf(QLatin1String("kedsea"), 0, Qt::CaseSensitive), -1);
+
+    // needles without any character that case-folds to US-ASCII
+    const QString greek = QString(30, u'x') + QStringLiteral("\u03A3\u03C3\u03C2\u03B1") + QString(10, u'x');
+    matcher.setPattern(QStringLiteral("\u03C3\u03C3\u03C2\u0391"));
+    QCOMPARE(matcher.indexIn(greek), 30);
+    QCOMPARE(greek.indexOf(QStringLiteral("\u03C3\u03A3\u03C2\u0391"), 0, Qt::CaseInsensitive), 30);
+}
+
+void tst_QStringMatcher::changeSearch()
+{
+    // the search is chosen when the pattern or the case sensitivity is set
+    const QString haystack = QString(30, u'x') + QStringLiteral("\u03A3\u03C3\u03C2\u03B1")
+            + QString(10, u'x') + QStringLiteral("\u03C3\u03C3\u03C2\u0391");
+    QStringMatcher matcher(QStringLiteral("\u03C3\u03C3\u03C2\u0391"));
+    QCOMPARE(matcher.indexIn(haystack), 44);
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(haystack), 30);
+
+    const QStringMatcher copy = matcher;
+    QCOMPARE(copy.indexIn(haystack), 30);
+    matcher.setCaseSensitivity(Qt::CaseSensitive);
+    QCOMPARE(matcher.indexIn(haystack), 44);
+    QCOMPARE(copy.indexIn(haystack), 30);
+
+    matcher.setPattern(QStringLiteral("xx\u03A3"));
+    QCOMPARE(matcher.indexIn(haystack), 28);
+    matcher.setPattern(QString());
+    QCOMPARE(matcher.indexIn(haystack, 5), 5);
+}
+
+void tst_QStringMatcher::filterDefeatingText()
+{
+    // every position has the needle's first and last characters, so the
+    // search falls back to Boyer-Moore
+    const QString needle = QString(10, u'a') + u'b' + QString(10, u'a');
+    for (int length : { 100, 1000, 10000 }) {
+        const QString haystack = QString(length, u'a') + needle + QString(5, u'a');
+        const QStringMatcher matcher(needle);
+        QCOMPARE(matcher.indexIn(haystack), length);
+        QCOMPARE(matcher.indexIn(haystack, length + 1), -1);
+        QCOMPARE(haystack.indexOf(needle), length);
+
+        const QStringMatcher insensitive(needle.toUpper(), Qt::CaseInsensitive);
+        QCOMPARE(insensitive.indexIn(haystack), length);
+        QCOMPARE(haystack.indexOf(needle.toUpper(), 0, Qt::CaseInsensitive), length);
+    }
+}
+
 QTEST_MAIN(tst_QStringMatcher)
 #include "tst_qstringmatcher.moc"
-
@@ -34,6 +34,7 @@
 #include <qdebug.h>
 #include <qpainter.h>
 #include <qtexttable.h>
+#include <private/qtextdocumentlayout_p.h>
 #ifndef QT_NO_WIDGETS
 #include <qtextedit.h>
 #include <qscrollbar.h>
@@ -58,6 +59,7 @@ private slots:
     void floatingTablePageBreak();
     void imageAtRightAlignedTab();
     void blockVisibility();
+    void parallelLayout();
 
     void largeImage();
 
@@ -405,5 +407,68 @@ void tst_QTextDocumentLayout::largeImage()
      }
 }
 
+void tst_QTextDocumentLayout::parallelLayout()
+{
+    QString text;
+    for (int i = 0; i < 400; ++i) {
+        text += QString::fromLatin1("Paragraph %1: the quick brown fox jumps over the lazy dog, ").arg(i);
+        text += QString(i % 7, QLatin1Char('x'));
+        text += QLatin1String(" and keeps\ton running for a while\n");
+    }
+
+    auto collectLines = [&](bool parallel) {
+        QTextDocument document;
+        auto *layout = qobject_cast<QTextDocumentLayout *>(document.documentLayout());
+        Q_ASSERT(layout);
+        layout->setParallelLayoutEnabled(parallel);
+        document.setPlainText(text);
+        QTextCursor cursor(&document);
+        cursor.select(QTextCursor::Document);
+        QTextBlockFormat indented;
+        indented.setTextIndent(20);
+        indented.setLeftMargin(5);
+        cursor.mergeBlockFormat(indented);
+        // fonts that differ from the default one, shaped on the worker threads
+        for (int i = 0; i < 400; i += 3) {
+            cursor.setPosition(document.findBlockByNumber(i).position() + 10);
+            cursor.movePosition(QTextCursor::NextWord, QTextCursor::KeepAnchor, 4);
+            QTextCharFormat format;
+            switch (i % 4) {
+            case 0:
+                format.setFontWeight(QFont::Bold);
+                break;
+            case 1:
+                format.setVerticalAlignment(QTextCharFormat::AlignSuperScript);
+                break;
+            case 2:
+                format.setFontCapitalization(QFont::SmallCaps);
+                break;
+            default:
+                format.setFontPointSize(20);
+                break;
+            }
+            cursor.mergeCharFormat(format);
+        }
+        document.setTextWidth(250);
+        const QSizeF size = document.size();
+
+        QList<QRectF> lines;
+        for (QTextBlock block = document.begin(); block.isValid(); block = block.next()) {
+            const QTextLayout *blockLayout = block.layout();
+            for (int i = 0; i < blockLayout->lineCount(); ++i) {
+                const QTextLine line = blockLayout->lineAt(i);
+                lines.append(line.naturalTextRect().translated(blockLayout->position()));
+            }
+        }
+        return qMakePair(size, lines);
+    };
+
+    const auto sequential = collectLines(false);
+    const auto parallel = collectLines(true);
+    QVERIFY(sequential.second.size() > 400);
+    QCOMPARE(parallel.first, sequential.first);
+    QCOMPARE(parallel.second, sequential.second);
+}
+
 QTEST_MAIN(tst_QTextDocumentLayout)
 #include "tst_qtextdocumentlayout.moc"
@@ -37,6 +37,7 @@
 
 
 #include <private/qtextengine_p.h>
+#include <private/qshapedtextcache_p.h>
 #include <qtextlayout.h>
 
 #include <qdebug.h>
@@ -143,6 +144,7 @@ private slots:
     void tooManyDirectionalCharctersCrash_qtbug77819();
     void softHyphens();
     void min_maximumWidth();
+    void shapedTextCache();
 
 private:
     QFont testFont;
@@ -2543,5 +2545,54 @@ void tst_QTextLayout::min_maximumWidth()
     }
 }
 
+void tst_QTextLayout::shapedTextCache()
+{
+    QShapedTextCache *cache = QShapedTextCache::instance();
+    QVERIFY(cache);
+    const qsizetype oldMaxCost = cache->maxCost();
+    cache->setMaxCost(1024 * 1024);
+    cache->clear();
+    cache->resetStatistics();
+
+    const QString text = QStringLiteral("Repeated cell text");
+
+    auto layoutGlyphs = [&](const QString &str) {
+        QTextLayout layout(str, testFont);
+        layout.beginLayout();
+        layout.createLine();
+        layout.endLayout();
+        return layout.glyphRuns();
+    };
+
+    const QList<QGlyphRun> first = layoutGlyphs(text);
+    const QShapedTextCache::Statistics afterFirst = cache->statistics();
+    QCOMPARE(afterFirst.hits, quint64(0));
+    QVERIFY(afterFirst.misses > 0);
+    QCOMPARE(afterFirst.insertions, afterFirst.misses);
+
+    const QList<QGlyphRun> second = layoutGlyphs(text);
+    const QShapedTextCache::Statistics afterSecond = cache->statistics();
+    QCOMPARE(afterSecond.misses, afterFirst.misses);
+    QCOMPARE(afterSecond.hits, afterFirst.misses);
+    QCOMPARE(second.size(), first.size());
+    for (int i = 0; i < first.size(); ++i) {
+        QCOMPARE(second.at(i).glyphIndexes(), first.at(i).glyphIndexes());
+        QCOMPARE(second.at(i).positions(), first.at(i).positions());
+    }
+
+    // a different string must not be served from the cache
+    layoutGlyphs(QStringLiteral("Another cell text"));
+    QVERIFY(cache->statistics().misses > afterSecond.misses);
+
+    // a disabled cache is not consulted at all
+    cache->setMaxCost(0);
+    cache->resetStatistics();
+    QCOMPARE(layoutGlyphs(text).size(), first.size());
+    QCOMPARE(cache->statistics().hits + cache->statistics().misses, quint64(0));
+    QCOMPARE(cache->size(), qsizetype(0));
+
+    cache->setMaxCost(oldMaxCost);
+}
+
 QTEST_MAIN(tst_QTextLayout)
 #include "tst_qtextlayout.moc"
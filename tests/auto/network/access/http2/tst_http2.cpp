@@ -103,6 +103,8 @@ private slots:
     void multipleRequests();
     void flowControlClientSide();
     void flowControlServerSide();
+    void windowAutoTuning();
+    void streamStatistics();
     void pushPromise();
     void goaway_data();
     void goaway();
@@ -125,7 +127,7 @@ protected slots:
     void decompressionFailed(quint32 streamID);
     void receivedRequest(quint32 streamID);
     void receivedData(quint32 streamID);
-    void windowUpdated(quint32 streamID);
+    void windowUpdated(quint32 streamID, quint32 delta);
     void replyFinished();
     void replyFinishedWithError();
 
@@ -155,6 +157,7 @@ private:
     int nSentRequests = 0;
 
     int windowUpdates = 0;
+    quint32 maxWindowUpdateDelta = 0;
     bool prefaceOK = false;
     bool serverGotSettingsACK = false;
 
@@ -405,6 +408,104 @@ void tst_Http2::flowControlServerSide()
     QVERIFY(serverGotSettingsACK);
 }
 
+void tst_Http2::windowAutoTuning()
+{
+    // The client starts with the default (small) receive windows,
+    // the server's response is large enough for the protocol handler
+    // to measure the bandwidth-delay product (using PING) and
+    // grow the stream's receive window beyond the initial value.
+    using namespace Http2;
+
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 1;
+
+    QHttp2Configuration params;
+    params.setWindowAutoTuningEnabled(true);
+    QVERIFY(params.windowAutoTuningEnabled());
+    QVERIFY(params != QHttp2Configuration());
+
+    ServerPtr srv(newServer(defaultServerSettings, defaultConnectionType(),
+                            qt_H2ConfigurationToSettings(params)));
+
+    const QByteArray respond(int(Http2::defaultSessionWindowSize * 100), 'x');
+    srv->setResponseBody(respond);
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+
+    runEventLoop();
+    QVERIFY(serverPort != 0);
+
+    sendRequest(0, QNetworkRequest::NormalPriority, {}, params);
+
+    runEventLoop();
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QVERIFY(prefaceOK);
+    QVERIFY(serverGotSettingsACK);
+    QVERIFY(windowUpdates > 0);
+    QVERIFY(maxWindowUpdateDelta > quint32(Http2::defaultSessionWindowSize));
+}
+
+void tst_Http2::streamStatistics()
+{
+    // The replies report how much their streams sent and received, and
+    // for how long the upload waited for the server's window to open.
+    using namespace Http2;
+
+    clearHTTP2State();
+
+    serverPort = 0;
+    nRequests = 2;
+
+    ServerPtr srv(newServer(defaultServerSettings, defaultConnectionType()));
+
+    const QByteArray respond(int(Http2::defaultSessionWindowSize * 2), 'x');
+    srv->setResponseBody(respond);
+    // larger than the server's initial window, the upload has to wait for WINDOW_UPDATE
+    const QByteArray payload(int(Http2::defaultSessionWindowSize * 3), 'y');
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+
+    runEventLoop();
+    QVERIFY(serverPort != 0);
+
+    QHash<QNetworkAccessManager::Operation, QList<QVariant>> statistics;
+    connect(manager.get(), &QNetworkAccessManager::finished, this,
+            [&statistics](QNetworkReply *reply) {
+        statistics[reply->operation()]
+                << reply->attribute(QNetworkRequest::Http2StreamBytesSentAttribute)
+                << reply->attribute(QNetworkRequest::Http2StreamBytesReceivedAttribute)
+                << reply->attribute(QNetworkRequest::Http2FlowControlBlockedTimeAttribute);
+    });
+
+    sendRequest(0);
+    sendRequest(1, QNetworkRequest::NormalPriority, payload);
+
+    runEventLoop();
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QVERIFY(prefaceOK);
+    QVERIFY(serverGotSettingsACK);
+
+    // the server answers a POST with HEADERS only
+    const QList<QVariant> post = statistics.value(QNetworkAccessManager::PostOperation);
+    QCOMPARE(post.size(), 3);
+    QCOMPARE(post.at(0).toLongLong(), qint64(payload.size()));
+    QCOMPARE(post.at(1).toLongLong(), qint64(0));
+    QVERIFY(post.at(2).isValid());
+    QVERIFY(post.at(2).toLongLong() >= 0);
+
+    const QList<QVariant> get = statistics.value(QNetworkAccessManager::GetOperation);
+    QCOMPARE(get.size(), 3);
+    QCOMPARE(get.at(0).toLongLong(), qint64(0));
+    QCOMPARE(get.at(1).toLongLong(), qint64(respond.size()));
+    QCOMPARE(get.at(2).toLongLong(), qint64(0));
+}
+
 void tst_Http2::pushPromise()
 {
     // We will first send some request, the server should reply and also emulate
@@ -892,6 +993,7 @@ void tst_Http2::serverStarted(quint16 port)
 void tst_Http2::clearHTTP2State()
 {
     windowUpdates = 0;
+    maxWindowUpdateDelta = 0;
     prefaceOK = false;
     serverGotSettingsACK = false;
 }
@@ -1029,11 +1131,12 @@ void tst_Http2::receivedData(quint32 streamID)
                               Q_ARG(bool, true /*HEADERS only*/));
 }
 
-void tst_Http2::windowUpdated(quint32 streamID)
+void tst_Http2::windowUpdated(quint32 streamID, quint32 delta)
 {
     Q_UNUSED(streamID);
 
     ++windowUpdates;
+    maxWindowUpdateDelta = std::max(maxWindowUpdateDelta, delta);
 }
 
 void tst_Http2::replyFinished()
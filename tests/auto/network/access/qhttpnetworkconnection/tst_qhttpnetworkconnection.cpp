@@ -31,6 +31,7 @@
 #include "private/qhttpnetworkconnection_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 #include <QAuthenticator>
+#include <QHttp1Configuration>
 #include <QTcpServer>
 
 #include "../../../network-settings.h"
@@ -98,6 +99,10 @@ private Q_SLOTS:
     void getAndThenDeleteObject_data();
 
     void overlappingCloseAndWrite();
+    void connectionsPerHost();
+    void pipelineDepth();
+    void connectionStatistics();
+    void pipeliningFallback();
 };
 
 void tst_QHttpNetworkConnection::initTestCase()
@@ -1012,6 +1017,249 @@ void tst_QHttpNetworkConnection::overlappingCloseAndWrite()
     QTRY_COMPARE(server.errorCodeReports, 10);
 }
 
+class KeepAliveServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit KeepAliveServer(bool reply) : reply(reply)
+    {
+        connect(this, &QTcpServer::newConnection, this, &KeepAliveServer::onNewConnection);
+        QVERIFY(listen(QHostAddress::LocalHost));
+    }
+
+    int connectionCount = 0;
+
+public slots:
+    void onNewConnection()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            ++connectionCount;
+            if (!reply)
+                continue;
+            // answer every request, including pipelined ones, on a kept-alive connection
+            connect(socket, &QTcpSocket::readyRead, socket, [socket, buffer = QByteArray()]() mutable {
+                buffer += socket->readAll();
+                qsizetype end;
+                while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+                    buffer.remove(0, end + 4);
+                    socket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+                }
+            });
+        }
+    }
+
+private:
+    bool reply;
+};
+
+void tst_QHttpNetworkConnection::connectionsPerHost()
+{
+    // server accepts connections, but never replies, so every request keeps its connection busy
+    KeepAliveServer server(false);
+    QNetworkAccessManager accessManager;
+
+    QHttp1Configuration configuration;
+    QCOMPARE(configuration.numberOfConnectionsPerHost(), 6);
+    QTest::ignoreMessage(QtWarningMsg, "QHttp1Configuration: Invalid number of connections per host: 0");
+    QVERIFY(!configuration.setNumberOfConnectionsPerHost(0));
+    QVERIFY(configuration.setNumberOfConnectionsPerHost(10));
+
+    QUrl url;
+    url.setScheme(QStringLiteral("http"));
+    url.setHost(server.serverAddress().toString());
+    url.setPort(server.serverPort());
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < 20; ++i) {
+        QNetworkRequest request(url);
+        // HTTP/2 cleartext upgrades are attempted on a single connection
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+        request.setHttp1Configuration(configuration);
+        QCOMPARE(request.http1Configuration(), configuration);
+        replies.append(accessManager.get(request));
+    }
+
+    QTRY_COMPARE(server.connectionCount, 10);
+    qDeleteAll(replies);
+}
+
+void tst_QHttpNetworkConnection::pipelineDepth()
+{
+    KeepAliveServer server(true);
+    const int requestCount = 40;
+    const int depth = 5;
+
+    // use 1 connection.
+    QHttpNetworkConnection connection(1, server.serverAddress().toString(), server.serverPort());
+    QHttp1Configuration configuration;
+    QCOMPARE(configuration.pipelineDepth(), 3);
+    QVERIFY(configuration.setPipelineDepth(depth));
+    connection.setHttp1Parameters(configuration);
+
+    QUrl url;
+    url.setScheme(QStringLiteral("http"));
+    url.setHost(server.serverAddress().toString());
+    url.setPort(server.serverPort());
+    QList<QHttpNetworkReply *> replies;
+    for (int i = 0; i < requestCount; ++i) {
+        QHttpNetworkRequest request(url);
+        request.setPipeliningAllowed(true);
+        replies.append(connection.sendRequest(request));
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(allRepliesFinished(&replies), 10000);
+
+    int pipelinedCount = 0;
+    for (QHttpNetworkReply *reply : qAsConst(replies)) {
+        QCOMPARE(reply->statusCode(), 200);
+        if (reply->isPipeliningUsed())
+            ++pipelinedCount;
+    }
+    QVERIFY(pipelinedCount > 0);
+
+    const QList<QHttpNetworkConnection::ChannelStatistics> statistics = connection.channelStatistics();
+    QCOMPARE(statistics.size(), 1);
+    QCOMPARE(statistics.at(0).requestsSent, qint64(requestCount));
+    QCOMPARE(statistics.at(0).requestsPipelined, qint64(pipelinedCount));
+    QCOMPARE(statistics.at(0).pipelineDepth, 0);
+    QCOMPARE(statistics.at(0).maximumPipelineDepth, depth);
+
+    qDeleteAll(replies);
+}
+
+void tst_QHttpNetworkConnection::connectionStatistics()
+{
+    KeepAliveServer server(true);
+    const int requestCount = 20;
+    const int depth = 5;
+
+    QNetworkAccessManager accessManager;
+    QHttp1Configuration configuration;
+    QVERIFY(configuration.setNumberOfConnectionsPerHost(1));
+    QVERIFY(configuration.setPipelineDepth(depth));
+
+    QUrl url;
+    url.setScheme(QStringLiteral("http"));
+    url.setHost(server.serverAddress().toString());
+    url.setPort(server.serverPort());
+    QList<QNetworkReply *> finishedReplies;
+    connect(&accessManager, &QNetworkAccessManager::finished,
+            [&finishedReplies](QNetworkReply *reply) { finishedReplies.append(reply); });
+    for (int i = 0; i < requestCount; ++i) {
+        QNetworkRequest request(url);
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+        request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+        request.setPriority(i % 2 ? QNetworkRequest::HighPriority : QNetworkRequest::NormalPriority);
+        request.setHttp1Configuration(configuration);
+        accessManager.get(request);
+    }
+    QTRY_COMPARE_WITH_TIMEOUT(finishedReplies.size(), requestCount, 10000);
+
+    bool sawPendingHighPriority = false;
+    bool sawPendingLowPriority = false;
+    for (QNetworkReply *reply : qAsConst(finishedReplies)) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->attribute(QNetworkRequest::Http1RequestsSentAttribute).isValid());
+        const int pendingHighPriority
+                = reply->attribute(QNetworkRequest::Http1PendingHighPriorityRequestsAttribute).toInt();
+        const int pendingLowPriority
+                = reply->attribute(QNetworkRequest::Http1PendingLowPriorityRequestsAttribute).toInt();
+        sawPendingHighPriority |= pendingHighPriority > 0;
+        sawPendingLowPriority |= pendingLowPriority > 0;
+        QVERIFY(reply->attribute(QNetworkRequest::Http1MaximumPipelineDepthAttribute).toInt() <= depth);
+    }
+    // requests wait in the queues while the single connection is busy
+    QVERIFY(sawPendingHighPriority);
+    QVERIFY(sawPendingLowPriority);
+
+    QNetworkReply *lastReply = finishedReplies.last();
+    QCOMPARE(lastReply->attribute(QNetworkRequest::Http1RequestsSentAttribute).toLongLong(),
+             qint64(requestCount));
+    QVERIFY(lastReply->attribute(QNetworkRequest::Http1RequestsPipelinedAttribute).toLongLong() > 0);
+    QCOMPARE(lastReply->attribute(QNetworkRequest::Http1MaximumPipelineDepthAttribute).toInt(), depth);
+    QCOMPARE(lastReply->attribute(QNetworkRequest::Http1PendingHighPriorityRequestsAttribute).toInt(), 0);
+    QCOMPARE(lastReply->attribute(QNetworkRequest::Http1PendingLowPriorityRequestsAttribute).toInt(), 0);
+
+    qDeleteAll(finishedReplies);
+}
+
+class PipelineBreakingServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    PipelineBreakingServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, &PipelineBreakingServer::onNewConnection);
+        QVERIFY(listen(QHostAddress::LocalHost));
+    }
+
+    int connectionCount = 0;
+    bool pipelinedAfterBreak = false;
+
+public slots:
+    void onNewConnection()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            const bool firstConnection = ++connectionCount == 1;
+            // the first connection answers one request and is closed once the
+            // pipelined requests arrive, the later ones answer every request
+            connect(socket, &QTcpSocket::readyRead, this,
+                    [this, socket, firstConnection, answered = 0, buffer = QByteArray()]() mutable {
+                buffer += socket->readAll();
+                if (firstConnection && answered > 0) {
+                    socket->disconnectFromHost();
+                    return;
+                }
+                qsizetype end;
+                int received = 0;
+                while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+                    buffer.remove(0, end + 4);
+                    ++received;
+                    ++answered;
+                    socket->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+                }
+                if (!firstConnection && received > 1)
+                    pipelinedAfterBreak = true;
+            });
+        }
+    }
+};
+
+void tst_QHttpNetworkConnection::pipeliningFallback()
+{
+    PipelineBreakingServer server;
+    const int requestCount = 10;
+
+    // use 1 connection.
+    QHttpNetworkConnection connection(1, server.serverAddress().toString(), server.serverPort());
+
+    QUrl url;
+    url.setScheme(QStringLiteral("http"));
+    url.setHost(server.serverAddress().toString());
+    url.setPort(server.serverPort());
+    QList<QHttpNetworkReply *> replies;
+    for (int i = 0; i < requestCount; ++i) {
+        QHttpNetworkRequest request(url);
+        request.setPipeliningAllowed(true);
+        replies.append(connection.sendRequest(request));
+    }
+    QTRY_VERIFY_WITH_TIMEOUT(allRepliesFinished(&replies), 10000);
+
+    // the requests outstanding when the server closed the connection are
+    // resent on a new one, and nothing is pipelined there anymore
+    QCOMPARE(server.connectionCount, 2);
+    QVERIFY(!server.pipelinedAfterBreak);
+    for (QHttpNetworkReply *reply : qAsConst(replies)) {
+        QCOMPARE(reply->statusCode(), 200);
+        QVERIFY(!reply->isPipeliningUsed());
+    }
+
+    const QList<QHttpNetworkConnection::ChannelStatistics> statistics = connection.channelStatistics();
+    QCOMPARE(statistics.size(), 1);
+    QVERIFY(statistics.at(0).requestsPipelined > 0);
+    QVERIFY(statistics.at(0).requestsSent > qint64(requestCount));
+    QCOMPARE(statistics.at(0).pipelineDepth, 0);
+
+    qDeleteAll(replies);
+}
 
 QTEST_MAIN(tst_QHttpNetworkConnection)
 #include "tst_qhttpnetworkconnection.moc"
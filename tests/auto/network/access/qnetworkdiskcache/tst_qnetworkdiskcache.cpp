@@ -69,6 +69,11 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void expireLeastRecentlyUsed();
+    void expireReimplemented();
+    void sharedPreparedFiles();
+    void sharedIndex();
+    void indexAfterCrash();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -261,8 +266,13 @@ static QStringList countFiles(const QString dir)
     QStringList list;
     QDir::Filters filter(QDir::AllEntries | QDir::NoDotAndDotDot);
     QDirIterator it(dir, filter, QDirIterator::Subdirectories);
-    while (it.hasNext())
-        list.append(it.next());
+    while (it.hasNext()) {
+        const QString path = it.next();
+        // the index is not a cache file
+        const QString name = it.fileName();
+        if (name != QLatin1String("index") && name != QLatin1String("journal"))
+            list.append(path);
+    }
     return list;
 }
 
@@ -534,6 +544,231 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+void tst_QNetworkDiskCache::expireLeastRecentlyUsed()
+{
+    const QByteArray payload(100 * 1024, 'Z');
+    auto urlFor = [](int i) { return QUrl("http://localhost:4/" + QString::number(i)); };
+
+    qint64 size = 0;
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        for (int i = 0; i < 5; ++i) {
+            QNetworkCacheMetaData m;
+            m.setUrl(urlFor(i));
+            QIODevice *d = cache.prepare(m);
+            QVERIFY(d);
+            d->write(payload);
+            cache.insert(d);
+        }
+        // reading the oldest entry makes it the most recently used one
+        QScopedPointer<QIODevice> d(cache.data(urlFor(0)));
+        QVERIFY(d);
+        size = cache.cacheSize();
+        QVERIFY(size > 5 * payload.size());
+    }
+
+    // the index written on destruction is picked up again
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(tempDir.path());
+    QCOMPARE(cache.cacheSize(), size);
+    QCOMPARE(countFiles(cache.cacheDirectory()).count(), NUM_SUBDIRECTORIES + 2 + 5);
+
+    cache.setMaximumCacheSize(size);
+    QVERIFY(cache.cacheSize() < size);
+    QVERIFY(!cache.metaData(urlFor(1)).isValid());
+    QVERIFY(cache.metaData(urlFor(0)).isValid());
+    for (int i = 2; i < 5; ++i)
+        QVERIFY(cache.metaData(urlFor(i)).isValid());
+}
+
+class RemoveAllOnExpireCache : public QNetworkDiskCache
+{
+public:
+    int expireCalls = 0;
+    bool removeAll = false;
+
+protected:
+    qint64 expire() override
+    {
+        ++expireCalls;
+        if (!removeAll)
+            return QNetworkDiskCache::expire();
+        // remove the cache files behind QNetworkDiskCache's back
+        QDirIterator it(cacheDirectory(), QStringList("*.d"), QDir::Files,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString file = it.next();
+            if (!file.contains(QLatin1String("/prepared/")))
+                QFile::remove(file);
+        }
+        return 0;
+    }
+};
+
+void tst_QNetworkDiskCache::expireReimplemented()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray payload(10 * 1024, 'Z');
+    auto urlFor = [](int i) { return QUrl("http://localhost:4/" + QString::number(i)); };
+    auto insert = [&](QNetworkDiskCache &cache, int i) {
+        QNetworkCacheMetaData m;
+        m.setUrl(urlFor(i));
+        QIODevice *d = cache.prepare(m);
+        QVERIFY(d);
+        d->write(payload);
+        cache.insert(d);
+    };
+
+    qint64 size = 0;
+    {
+        RemoveAllOnExpireCache cache;
+        cache.setCacheDirectory(dir.path());
+        for (int i = 0; i < 3; ++i)
+            insert(cache, i);
+        QCOMPARE(cache.expireCalls, 3);
+        QVERIFY(cache.cacheSize() > 3 * payload.size());
+
+        // the size reported by the reimplementation drives the cache size,
+        // and the files it removed are dropped from the index
+        cache.removeAll = true;
+        insert(cache, 3);
+        QCOMPARE(cache.expireCalls, 4);
+        size = cache.cacheSize();
+        QVERIFY(size > payload.size());
+        QVERIFY(size < 2 * payload.size());
+        for (int i = 0; i < 3; ++i)
+            QVERIFY(!cache.metaData(urlFor(i)).isValid());
+        QVERIFY(cache.metaData(urlFor(3)).isValid());
+    }
+
+    // the index written on destruction only lists the remaining file
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), size);
+}
+
+void tst_QNetworkDiskCache::sharedPreparedFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QNetworkDiskCache writer;
+    writer.setCacheDirectory(dir.path());
+    QNetworkCacheMetaData m;
+    m.setUrl(QUrl("http://localhost:4/shared"));
+    QIODevice *device = writer.prepare(m);
+    QVERIFY(device);
+    device->write(QByteArray(1024, 'Z'));
+
+    // a prepared file nobody wrote to for a long time is left over...
+    const QString stalePath = writer.cacheDirectory() + QLatin1String("prepared/stale.d");
+    QFile stale(stalePath);
+    QVERIFY(stale.open(QIODevice::WriteOnly));
+    QVERIFY(stale.setFileTime(QDateTime::currentDateTime().addDays(-2),
+                              QFileDevice::FileModificationTime));
+    stale.close();
+
+    // as is one that another process is still writing
+    const QString freshPath = writer.cacheDirectory() + QLatin1String("prepared/fresh.d");
+    QFile fresh(freshPath);
+    QVERIFY(fresh.open(QIODevice::WriteOnly));
+    fresh.close();
+
+    // another cache on the same directory scans it, but must not remove
+    // the files other caches are still writing
+    QNetworkDiskCache other;
+    other.setCacheDirectory(dir.path());
+    QCOMPARE(other.cacheSize(), qint64(0));
+    QVERIFY(!QFile::exists(stalePath));
+    QVERIFY(QFile::exists(freshPath));
+
+    writer.insert(device);
+    QVERIFY(writer.metaData(m.url()).isValid());
+    QVERIFY(other.metaData(m.url()).isValid());
+}
+
+static void insertPayload(QNetworkDiskCache &cache, const QUrl &url, const QByteArray &payload)
+{
+    QNetworkCacheMetaData m;
+    m.setUrl(url);
+    QIODevice *d = cache.prepare(m);
+    QVERIFY(d);
+    d->write(payload);
+    cache.insert(d);
+}
+
+void tst_QNetworkDiskCache::sharedIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray payload(100 * 1024, 'Z');
+    auto urlFor = [](int i) { return QUrl("http://localhost:4/" + QString::number(i)); };
+
+    QNetworkDiskCache first;
+    first.setCacheDirectory(dir.path());
+    QCOMPARE(first.cacheSize(), qint64(0));
+
+    QNetworkDiskCache second;
+    second.setCacheDirectory(dir.path());
+    for (int i = 0; i < 5; ++i)
+        insertPayload(second, urlFor(i), payload);
+    const qint64 size = second.cacheSize();
+    QVERIFY(size > 5 * payload.size());
+
+    // the first cache knows about the files the second one wrote
+    first.setMaximumCacheSize(size);
+    QVERIFY(first.cacheSize() < size);
+    QVERIFY(first.cacheSize() > 3 * payload.size());
+    QVERIFY(!second.metaData(urlFor(0)).isValid());
+    for (int i = 1; i < 5; ++i)
+        QVERIFY(second.metaData(urlFor(i)).isValid());
+}
+
+void tst_QNetworkDiskCache::indexAfterCrash()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QByteArray payload(10 * 1024, 'Z');
+    auto urlFor = [](int i) { return QUrl("http://localhost:4/" + QString::number(i)); };
+
+    // a cache that is not destroyed before the next one starts, as if the
+    // application crashed, so the files are only listed in the journal
+    QNetworkDiskCache crashed;
+    crashed.setCacheDirectory(dir.path());
+    for (int i = 0; i < 3; ++i)
+        insertPayload(crashed, urlFor(i), payload);
+    const qint64 size = crashed.cacheSize();
+    QVERIFY(size > 3 * payload.size());
+
+    // a cache file that no index knows about
+    QDirIterator it(crashed.cacheDirectory(), QStringList("*.d"), QDir::Files,
+                    QDirIterator::Subdirectories);
+    QString stray;
+    while (it.hasNext() && stray.isEmpty()) {
+        const QString file = it.next();
+        if (!file.contains(QLatin1String("/prepared/")))
+            stray = it.fileInfo().absolutePath() + QLatin1String("/stray.d");
+    }
+    QVERIFY(!stray.isEmpty());
+    QFile strayFile(stray);
+    QVERIFY(strayFile.open(QIODevice::WriteOnly));
+    strayFile.write(payload);
+    strayFile.close();
+
+    // the index and its journal are read instead of scanning the directory
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), size);
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(cache.metaData(urlFor(i)).isValid());
+
+    // clearing the cache scans it
+    cache.clear();
+    QVERIFY(!QFile::exists(stray));
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
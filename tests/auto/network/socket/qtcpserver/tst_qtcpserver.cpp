@@ -42,6 +42,7 @@
 
 #ifndef Q_OS_WIN
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/ioctl.h>
 #endif
 
@@ -115,6 +116,9 @@ private slots:
 
     void pauseAccepting();
 
+    void portSharing();
+    void acceptedDescriptorMode();
+
 private:
     bool shouldSkipIpv6TestsForBrokenGetsockopt();
 #ifdef SHOULD_CHECK_SYSCALL_SUPPORT
@@ -1079,5 +1083,92 @@ void tst_QTcpServer::pauseAccepting()
     QCOMPARE(spy.count(), 6);
 }
 
+void tst_QTcpServer::portSharing()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QTcpServer first;
+    QVERIFY(!first.isPortSharingEnabled());
+    first.setPortSharingEnabled(true);
+    QVERIFY(first.isPortSharingEnabled());
+    if (!first.listen(QHostAddress::LocalHost)) {
+        if (first.serverError() == QAbstractSocket::UnsupportedSocketOperationError)
+            QSKIP("Port sharing is not supported on this platform");
+        QFAIL(qPrintable(first.errorString()));
+    }
+
+    // A server that does not share the port cannot join
+    QTcpServer exclusive;
+    QVERIFY(!exclusive.listen(QHostAddress::LocalHost, first.serverPort()));
+    QCOMPARE(exclusive.serverError(), QAbstractSocket::AddressInUseError);
+
+    QTcpServer second;
+    second.setPortSharingEnabled(true);
+    QVERIFY2(second.listen(QHostAddress::LocalHost, first.serverPort()),
+             qPrintable(second.errorString()));
+
+    // Every connection is accepted by one of the servers
+    QSignalSpy firstSpy(&first, &QTcpServer::newConnection);
+    QSignalSpy secondSpy(&second, &QTcpServer::newConnection);
+    const int count = 20;
+    QList<QTcpSocket *> clients;
+    for (int i = 0; i < count; ++i) {
+        QTcpSocket *client = new QTcpSocket(this);
+        client->connectToHost(QHostAddress::LocalHost, first.serverPort());
+        QVERIFY(client->waitForConnected(5000));
+        clients.append(client);
+    }
+    QTRY_COMPARE(firstSpy.count() + secondSpy.count(), count);
+    qDeleteAll(clients);
+}
+
+class DescriptorModeServer : public QTcpServer
+{
+public:
+    int flags = -1;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+#ifndef Q_OS_WIN
+        flags = ::fcntl(socketDescriptor, F_GETFL);
+        ::close(socketDescriptor);
+#else
+        Q_UNUSED(socketDescriptor);
+#endif
+    }
+};
+
+void tst_QTcpServer::acceptedDescriptorMode()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Only Unix descriptors can be queried for their blocking mode");
+#else
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    // Descriptors passed to incomingConnection() stay blocking, as they
+    // always were, unless the server opted into port sharing
+    for (bool portSharing : {false, true}) {
+        DescriptorModeServer server;
+        server.setPortSharingEnabled(portSharing);
+        if (!server.listen(QHostAddress::LocalHost)) {
+            if (portSharing && server.serverError() == QAbstractSocket::UnsupportedSocketOperationError)
+                QSKIP("Port sharing is not supported on this platform");
+            QFAIL(qPrintable(server.errorString()));
+        }
+
+        QTcpSocket client;
+        client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(client.waitForConnected(5000));
+        QTRY_VERIFY(server.flags != -1);
+        QCOMPARE(bool(server.flags & O_NONBLOCK), portSharing);
+    }
+#endif
+}
+
 QTEST_MAIN(tst_QTcpServer)
 #include "tst_qtcpserver.moc"
@@ -62,6 +62,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -206,6 +207,10 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void sendFile_data();
+    void sendFile();
+    void writeSegments_data();
+    void writeSegments();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3240,5 +3245,142 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::sendFile_data()
+{
+    QTest::addColumn<bool>("connected");
+    QTest::newRow("connected") << true;
+    QTest::newRow("connecting") << false;
+}
+
+void tst_QTcpSocket::sendFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, connected);
+
+    // larger than what the socket buffers, so that the SSL socket has to
+    // feed the file to the connection in chunks
+    QByteArray content(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < content.size(); ++i)
+        content[i] = char(i * 131 + (i >> 9));
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(content), qint64(content.size()));
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::sendFile: Socket not open for writing");
+    QCOMPARE(socket->sendFile(&file), qint64(-1));
+
+    if (connected) {
+        socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+        QVERIFY(socket->waitForConnected(5000));
+    } else {
+        // queue everything while the peer is still being looked up
+        socket->connectToHost(QStringLiteral("localhost"), tcpServer.serverPort());
+        QCOMPARE(socket->state(), QAbstractSocket::HostLookupState);
+    }
+
+    qint64 bytesWritten = 0;
+    connect(socket, &QIODevice::bytesWritten, [&bytesWritten](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+
+    // File data is sent in order with what is written around it
+    QCOMPARE(socket->write("head"), qint64(4));
+    QCOMPARE(socket->sendFile(&file, 100, 1000), qint64(1000));
+    QCOMPARE(socket->write("middle"), qint64(6));
+    QCOMPARE(socket->sendFile(&file), qint64(content.size()));
+    QCOMPARE(socket->sendFile(&file, content.size() - 10, 100), qint64(10));
+    QCOMPARE(socket->sendFile(&file, content.size() + 10), qint64(0));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    const QByteArray expected = "head" + content.mid(100, 1000) + "middle" + content
+            + content.right(10) + "tail";
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+    QCOMPARE(file.pos(), qint64(content.size()));
+
+    // Closing the file does not affect the queued transfers
+    file.close();
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::sendFile: File not open for random access reading");
+    QCOMPARE(socket->sendFile(&file), qint64(-1));
+
+    // the event loop has to run for the host lookup to finish
+    QTRY_VERIFY(tcpServer.hasPendingConnections());
+    QScopedPointer<QTcpSocket> peer(tcpServer.nextPendingConnection());
+    QVERIFY(peer);
+
+    // Read while the data is being sent, so that the connection never stalls
+    QByteArray received;
+    connect(peer.data(), &QIODevice::readyRead, [&received, &peer]() {
+        received += peer->readAll();
+    });
+    received += peer->readAll();
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QCOMPARE(received, expected);
+    QTRY_COMPARE(bytesWritten, qint64(expected.size()));
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    delete socket;
+}
+
+void tst_QTcpSocket::writeSegments_data()
+{
+    QTest::addColumn<bool>("unbuffered");
+    QTest::newRow("buffered") << false;
+    QTest::newRow("unbuffered") << true;
+}
+
+void tst_QTcpSocket::writeSegments()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, unbuffered);
+
+    QList<QByteArray> segments;
+    QByteArray expected;
+    for (int i = 0; i < 100; ++i) {
+        // mix segments the write buffer copies with ones it keeps by reference
+        segments.append(QByteArray(i % 2 ? 20 * 1024 : 10, char('a' + i % 26)));
+        expected += segments.constLast();
+    }
+    segments.insert(50, QByteArray());
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    QTcpSocket *socket = newSocket();
+    QIODevice::OpenMode openMode = QIODevice::ReadWrite;
+    if (unbuffered)
+        openMode |= QIODevice::Unbuffered;
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort(), openMode);
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY(tcpServer.waitForNewConnection(5000));
+    QScopedPointer<QTcpSocket> peer(tcpServer.nextPendingConnection());
+    QVERIFY(peer);
+
+    QCOMPARE(socket->writeSegments({}), qint64(0));
+    QCOMPARE(socket->writeSegments(segments), qint64(expected.size()));
+    QCOMPARE(socket->write("|"), qint64(1));
+    QCOMPARE(socket->writeSegments(segments), qint64(expected.size()));
+    expected = expected + '|' + expected;
+    if (!unbuffered)
+        QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    // Read while the data is being sent, so that the connection never stalls
+    QByteArray received;
+    connect(peer.data(), &QIODevice::readyRead, [&received, &peer]() {
+        received += peer->readAll();
+    });
+    received += peer->readAll();
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+
+    delete socket;
+}
+
 QTEST_MAIN(tst_QTcpSocket)
+
 #include "tst_qtcpsocket.moc"
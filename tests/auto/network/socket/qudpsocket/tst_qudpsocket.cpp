@@ -90,6 +90,7 @@ private slots:
     void bindAndConnectToHost();
     void pendingDatagramSize();
     void writeDatagram();
+    void batchDatagrams();
     void performance();
     void bindMode();
     void writeDatagramToNonExistingPeer_data();
@@ -911,6 +912,56 @@ void tst_QUdpSocket::writeDatagram()
     }
 }
 
+void tst_QUdpSocket::batchDatagrams()
+{
+    QUdpSocket server;
+    QVERIFY2(server.bind(), server.errorString().toLatin1().constData());
+    QVERIFY(server.receiveDatagrams(10).isEmpty());
+
+    QHostAddress serverAddress = makeNonAny(server.localAddress());
+    QUdpSocket client;
+    QSignalSpy bytesspy(&client, SIGNAL(bytesWritten(qint64)));
+
+    QList<QNetworkDatagram> datagrams;
+    qint64 totalSize = 0;
+    for (int i = 0; i < 20; ++i) {
+        QByteArray data(i * 50, char('a' + i));
+        datagrams.append(QNetworkDatagram(data, serverAddress, server.localPort()));
+        totalSize += data.size();
+    }
+    QCOMPARE(client.writeDatagrams({}), qsizetype(0));
+    QCOMPARE(client.writeDatagrams(datagrams), qsizetype(datagrams.size()));
+    QCOMPARE(bytesspy.count(), 1);
+    QCOMPARE(bytesspy.at(0).at(0).toLongLong(), totalSize);
+
+    QList<QNetworkDatagram> received;
+    QDeadlineTimer deadline(5000);
+    while (received.size() < datagrams.size() && server.waitForReadyRead(deadline.remainingTime()))
+        received += server.receiveDatagrams(datagrams.size() - received.size(), 1000);
+    if (received.size() < datagrams.size())
+        QSKIP("UDP packets lost, unable to complete the test.");
+
+    for (int i = 0; i < datagrams.size(); ++i) {
+        const QNetworkDatagram &datagram = received.at(i);
+        QVERIFY(datagram.isValid());
+        QCOMPARE(datagram.data(), datagrams.at(i).data());
+        QCOMPARE(datagram.senderPort(), int(client.localPort()));
+        QCOMPARE(datagram.destinationPort(), int(server.localPort()));
+    }
+
+    // datagrams longer than maxSize are truncated
+    QCOMPARE(client.writeDatagrams({ QNetworkDatagram("hello world", serverAddress, server.localPort()),
+                                     QNetworkDatagram("hi", serverAddress, server.localPort()) }),
+             qsizetype(2));
+    received.clear();
+    while (received.size() < 2 && server.waitForReadyRead(5000))
+        received += server.receiveDatagrams(2 - received.size(), 5);
+    if (received.size() < 2)
+        QSKIP("UDP packets lost, unable to complete the test.");
+    QCOMPARE(received.at(0).data(), QByteArray("hello"));
+    QCOMPARE(received.at(1).data(), QByteArray("hi"));
+}
+
 void tst_QUdpSocket::performance()
 {
     QByteArray arr(8192, '@');
@@ -28,7 +28,11 @@
 #include <QDebug>
 #include <QDirIterator>
 #include <QString>
+#include <QTemporaryDir>
 #include <qplatformdefs.h>
+#if QT_CONFIG(thread)
+#include <QtCore/private/qdirwalker_p.h>
+#endif
 
 #ifdef Q_OS_WIN
 #   include <qt_windows.h>
@@ -53,11 +57,19 @@ class tst_qdiriterator : public QObject
     Q_OBJECT
 
     void data();
+    QTemporaryDir tree;
 private slots:
+    void initTestCase();
     void posix();
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorNameFilters();
+    void diriteratorNameFilters_data() { data(); }
+    void diriteratorFileInfo();
+    void diriteratorFileInfo_data() { data(); }
+    void dirwalker();
+    void dirwalker_data();
     void fsiterator();
     void fsiterator_data() { data(); }
     void stdRecursiveDirectoryIterator();
@@ -65,6 +77,27 @@ private slots:
 };
 
 
+void tst_qdiriterator::initTestCase()
+{
+    // A tree of 20000 files in 250 directories, with a few symlinks,
+    // so that the benchmarks do not depend on a source checkout
+    QVERIFY(tree.isValid());
+    QDir root(tree.path());
+    for (int i = 0; i < 50; ++i) {
+        for (int j = 0; j < 5; ++j) {
+            const QString dir = QString::fromLatin1("d%1/s%2").arg(i).arg(j);
+            QVERIFY(root.mkpath(dir));
+            for (int k = 0; k < 80; ++k) {
+                const QString suffix = QLatin1String(k % 10 ? ".txt" : ".cpp");
+                QFile file(root.filePath(dir + QLatin1String("/file") + QString::number(k) + suffix));
+                QVERIFY(file.open(QIODevice::WriteOnly));
+            }
+        }
+        QFile::link(root.filePath(QString::fromLatin1("d%1/s0/file0.cpp").arg(i)),
+                    root.filePath(QString::fromLatin1("d%1/link.cpp").arg(i)));
+    }
+}
+
 void tst_qdiriterator::data()
 {
 #if defined(Q_OS_WIN)
@@ -72,16 +105,15 @@ void tst_qdiriterator::data()
 #else
     const char *qtdir = ::getenv("QTDIR");
 #endif
-    if (!qtdir) {
-        fprintf(stderr, "QTDIR not set\n");
-        exit(1);
-    }
 
     QTest::addColumn<QByteArray>("dirpath");
-    QByteArray ba = QByteArray(qtdir) + "/src/corelib";
-    QByteArray ba1 = ba + "/io";
-    QTest::newRow(ba) << ba;
-    //QTest::newRow(ba1) << ba1;
+    if (qtdir) {
+        QByteArray ba = QByteArray(qtdir) + "/src/corelib";
+        QByteArray ba1 = ba + "/io";
+        QTest::newRow(ba) << ba;
+        //QTest::newRow(ba1) << ba1;
+    }
+    QTest::newRow("generated tree") << QFile::encodeName(tree.path());
 }
 
 #ifdef Q_OS_WIN
@@ -205,6 +237,101 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::diriteratorNameFilters()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath,
+            QStringList(QLatin1String("*.cpp")),
+            QDir::Files,
+            QDirIterator::Subdirectories);
+
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    qDebug() << count;
+}
+
+void tst_qdiriterator::diriteratorFileInfo()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+    qint64 size = 0;
+
+    QBENCHMARK {
+        int c = 0;
+        qint64 s = 0;
+
+        QDirIterator dir(dirpath,
+            QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+            QDirIterator::Subdirectories);
+
+        while (dir.hasNext()) {
+            dir.next();
+            const QFileInfo info = dir.fileInfo();
+            if (!info.isDir())
+                s += info.size();
+            ++c;
+        }
+        count = c;
+        size = s;
+    }
+    qDebug() << count << size;
+}
+
+void tst_qdiriterator::dirwalker_data()
+{
+    QTest::addColumn<QByteArray>("dirpath");
+    QTest::addColumn<bool>("iteratorOrder");
+
+    const QByteArray path = QFile::encodeName(tree.path());
+    QTest::newRow("generated tree, unordered") << path << false;
+    QTest::newRow("generated tree, iterator order") << path << true;
+}
+
+void tst_qdiriterator::dirwalker()
+{
+#if QT_CONFIG(thread)
+    QFETCH(QByteArray, dirpath);
+    QFETCH(bool, iteratorOrder);
+
+    int count = 0;
+    qint64 size = 0;
+
+    QBENCHMARK {
+        int c = 0;
+        qint64 s = 0;
+
+        QDirWalker walker(QFile::decodeName(dirpath),
+            QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+            QDirIterator::Subdirectories);
+        walker.setOrdering(iteratorOrder ? QDirWalker::IteratorOrder : QDirWalker::Unordered);
+        walker.walk([&](const QFileInfoList &batch) {
+            for (const QFileInfo &info : batch) {
+                if (!info.isDir())
+                    s += info.size();
+                ++c;
+            }
+            return true;
+        });
+        count = c;
+        size = s;
+    }
+    qDebug() << count << size;
+#else
+    QSKIP("Qt was built without thread support");
+#endif
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
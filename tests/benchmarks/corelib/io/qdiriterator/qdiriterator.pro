@@ -1,5 +1,5 @@
 CONFIG += benchmark
-QT = core testlib
+QT = core-private testlib
 
 # Enable c++17 support for std::filesystem
 qtConfig(cxx17_filesystem) {
@@ -83,6 +83,34 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class Collector : public QObject
+{
+    Q_OBJECT
+public:
+    void reset(int expected) { m_received = 0; m_expected = expected; }
+
+public slots:
+    void collect(int)
+    {
+        if (++m_received == m_expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::User) {
+            collect(0);
+            return true;
+        }
+        return QObject::event(e);
+    }
+
+private:
+    int m_received = 0;
+    int m_expected = 0;
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +124,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void postEventCrossThread_data();
+    void postEventCrossThread();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +199,49 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::postEventCrossThread_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<bool>("queuedCall");
+    for (int producers : {1, 2, 4, 8}) {
+        const QByteArray name = QByteArray::number(producers) + " producer(s)";
+        QTest::newRow(name + ", queued call") << producers << true;
+        QTest::newRow(name + ", user event") << producers << false;
+    }
+}
+
+void EventsBench::postEventCrossThread()
+{
+    QFETCH(int, producers);
+    QFETCH(bool, queuedCall);
+    const int eventsPerProducer = 20000;
+
+    Collector collector;
+    QList<QThread *> threads;
+
+    QBENCHMARK {
+        collector.reset(producers * eventsPerProducer);
+        for (int i = 0; i < producers; ++i) {
+            threads << QThread::create([&collector, queuedCall] {
+                for (int n = 0; n < eventsPerProducer; ++n) {
+                    if (queuedCall)
+                        QMetaObject::invokeMethod(&collector, "collect", Qt::QueuedConnection, Q_ARG(int, n));
+                    else
+                        QCoreApplication::postEvent(&collector, new QEvent(QEvent::User));
+                }
+            });
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        QTestEventLoop::instance().enterLoop(60);
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+        threads.clear();
+    }
+    QVERIFY(!QTestEventLoop::instance().timeout());
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
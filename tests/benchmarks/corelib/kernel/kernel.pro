@@ -6,6 +6,7 @@ SUBDIRS = \
         qobject \
         qvariant \
         qcoreapplication \
+        qtimer \
         qtimer_vs_qmetaobject \
         qwineventnotifier
 
@@ -28,6 +28,7 @@
 
 #include <qtest.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qthread.h>
 
 class tst_QMetaType : public QObject
 {
@@ -48,6 +49,8 @@ private slots:
     void typeCustomNotNormalized();
     void typeNotRegistered();
     void typeNotRegisteredNotNormalized();
+    void typeCustomConcurrent_data();
+    void typeCustomConcurrent();
 
     void typeNameBuiltin_data();
     void typeNameBuiltin();
@@ -175,6 +178,45 @@ void tst_QMetaType::typeNotRegisteredNotNormalized()
     }
 }
 
+void tst_QMetaType::typeCustomConcurrent_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("byName");
+    for (int threadCount : {1, 2, 4, 8}) {
+        const QByteArray name = QByteArray::number(threadCount) + " thread(s)";
+        QTest::newRow(name + ", by name") << threadCount << true;
+        QTest::newRow(name + ", by id") << threadCount << false;
+    }
+}
+
+// custom type lookups from several threads, as done by QVariant-heavy pipelines
+void tst_QMetaType::typeCustomConcurrent()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, byName);
+    const int id = qRegisterMetaType<Foo>("Foo");
+
+    QList<QThread *> threads;
+    QBENCHMARK {
+        for (int t = 0; t < threadCount; ++t) {
+            threads << QThread::create([id, byName] {
+                for (int i = 0; i < 100000; ++i) {
+                    if (byName)
+                        QMetaType::fromName("Foo");
+                    else
+                        QMetaType(id).sizeOf();
+                }
+            });
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+        threads.clear();
+    }
+}
+
 void tst_QMetaType::typeNameBuiltin_data()
 {
     QTest::addColumn<int>("type");
@@ -51,6 +51,8 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void connect_disconnect_multithreaded_data();
+    void connect_disconnect_multithreaded();
 
     void stdAllocator();
 };
@@ -305,6 +307,55 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+void QObjectBenchmark::connect_disconnect_multithreaded_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharedSender");
+    for (int threadCount : {1, 2, 4, 8}) {
+        const QByteArray name = QByteArray::number(threadCount) + " thread(s)";
+        QTest::newRow(name + ", own objects") << threadCount << false;
+        QTest::newRow(name + ", shared sender") << threadCount << true;
+    }
+}
+
+void QObjectBenchmark::connect_disconnect_multithreaded()
+{
+    // Worker threads creating, connecting and tearing down objects while
+    // emitting; with a shared sender, every thread also connects to and
+    // emits a signal of an object living in the main thread.
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharedSender);
+    const int iterations = 20000;
+
+    Object shared;
+    QList<QThread *> threads;
+    QBENCHMARK {
+        for (int i = 0; i < threadCount; ++i) {
+            threads << QThread::create([&shared, sharedSender] {
+                for (int n = 0; n < iterations; ++n) {
+                    Object sender;
+                    Object receiver;
+                    QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0);
+                    QObject::connect(&sender, &Object::signal1, &receiver, &Object::slot1);
+                    Object *source = sharedSender ? &shared : &sender;
+                    // receivers of the other threads get queued calls
+                    const QMetaObject::Connection c =
+                            QObject::connect(source, &Object::signal2, &receiver, &Object::slot2);
+                    emit sender.signal0();
+                    emit source->signal2();
+                    QObject::disconnect(c);
+                }
+            });
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+        threads.clear();
+    }
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
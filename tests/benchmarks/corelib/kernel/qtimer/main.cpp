@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore>
+#include <qtest.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void restart_data();
+    void restart();
+    void startStop_data() { restart_data(); }
+    void startStop();
+};
+
+void tst_QTimer::restart_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    for (int count : { 100, 10000, 100000 }) {
+        QTest::addRow("%d precise", count) << count << Qt::PreciseTimer;
+        QTest::addRow("%d coarse", count) << count << Qt::CoarseTimer;
+        QTest::addRow("%d very coarse", count) << count << Qt::VeryCoarseTimer;
+    }
+}
+
+static std::vector<std::unique_ptr<QTimer>> createTimers(int count, Qt::TimerType timerType)
+{
+    std::vector<std::unique_ptr<QTimer>> timers;
+    timers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        timers.emplace_back(new QTimer);
+        timers.back()->setTimerType(timerType);
+        // spread them out like the idle timeouts of connections
+        timers.back()->setInterval(30000 + i % 1000 * 10);
+    }
+    return timers;
+}
+
+// like a server restarting the idle timer of each connection that had
+// traffic, with all of them running
+void tst_QTimer::restart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    const auto timers = createTimers(count, timerType);
+    for (const auto &timer : timers)
+        timer->start();
+
+    QBENCHMARK {
+        for (const auto &timer : timers)
+            timer->start();
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_QTimer::startStop()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    const auto timers = createTimers(count, timerType);
+
+    QBENCHMARK {
+        for (const auto &timer : timers)
+            timer->start();
+        QCoreApplication::processEvents();
+        for (const auto &timer : timers)
+            timer->stop();
+    }
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "main.moc"
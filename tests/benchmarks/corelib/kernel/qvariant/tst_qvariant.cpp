@@ -85,6 +85,11 @@ private slots:
     void createCoreType();
     void createCoreTypeCopy_data();
     void createCoreTypeCopy();
+
+    void convert_data();
+    void convert();
+    void convertInPlace_data();
+    void convertInPlace();
 };
 
 struct BigClass
@@ -373,6 +378,57 @@ void tst_qvariant::createCoreTypeCopy()
     }
 }
 
+void tst_qvariant::convert_data()
+{
+    QTest::addColumn<QVariant>("value");
+    QTest::addColumn<int>("targetTypeId");
+
+    QTest::newRow("int->double") << QVariant(42) << qMetaTypeId<double>();
+    QTest::newRow("double->int") << QVariant(42.5) << qMetaTypeId<int>();
+    QTest::newRow("int->QString") << QVariant(42) << qMetaTypeId<QString>();
+    QTest::newRow("QString->int") << QVariant(QStringLiteral("42")) << qMetaTypeId<int>();
+    QTest::newRow("QString->double") << QVariant(QStringLiteral("42.5")) << qMetaTypeId<double>();
+    QTest::newRow("QString->bool") << QVariant(QStringLiteral("true")) << qMetaTypeId<bool>();
+    QTest::newRow("QByteArray->qlonglong") << QVariant(QByteArray("42")) << qMetaTypeId<qlonglong>();
+    QTest::newRow("QString->QByteArray") << QVariant(QStringLiteral("42")) << qMetaTypeId<QByteArray>();
+    QTest::newRow("QDate->QString") << QVariant(QDate(2020, 1, 2)) << qMetaTypeId<QString>();
+}
+
+// Tests converting a QVariant of one core type to another one,
+// replacing the value held by the variant.
+void tst_qvariant::convert()
+{
+    QFETCH(QVariant, value);
+    QFETCH(int, targetTypeId);
+    const QMetaType targetType(targetTypeId);
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i) {
+            QVariant v = value;
+            v.convert(targetType);
+        }
+    }
+}
+
+void tst_qvariant::convertInPlace_data()
+{
+    convert_data();
+}
+
+// Tests converting the value of a QVariant into an object provided by
+// the caller, which involves no temporary QVariant at all.
+void tst_qvariant::convertInPlace()
+{
+    QFETCH(QVariant, value);
+    QFETCH(int, targetTypeId);
+    const QMetaType targetType(targetTypeId);
+    QVariant target(targetType);
+    void *buffer = target.data();
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i)
+            value.convert(targetType, buffer);
+    }
+}
+
 QTEST_MAIN(tst_qvariant)
 
 #include "tst_qvariant.moc"
@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QStringDecoder>
+#include <QStringEncoder>
+#include <QtTest>
+
+class tst_QStringConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeUtf8_data();
+    void decodeUtf8();
+    void encodeUtf8_data();
+    void encodeUtf8();
+};
+
+static QString makeText(QStringView sample)
+{
+    // about 64 kB of UTF-16, large enough to measure throughput rather than call overhead
+    QString text;
+    text.reserve(32 * 1024 + sample.size());
+    while (text.size() < 32 * 1024)
+        text += sample;
+    return text;
+}
+
+static void addCorpora()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("ascii")
+            << makeText(u"The quick brown fox jumps over the lazy dog. 0123456789\n");
+    QTest::newRow("latin1-heavy")
+            << makeText(u"Größenänderung für Fenster, Über Æsir og Ørsted, à bientôt déjà vu.\n");
+    QTest::newRow("cyrillic")
+            << makeText(u"Съешь же ещё этих мягких французских булок, да выпей чаю.\n");
+    QTest::newRow("cjk")
+            << makeText(u"敏捷的棕色狐狸跳过了懒狗。日本語の文章を表示します。한국어텍스트입니다。\n");
+    QTest::newRow("mixed-cjk-ascii")
+            << makeText(u"Qt 6 提供了新的 QStringConverter 类，用于 UTF-8 和 UTF-16 之间的转换。\n");
+}
+
+void tst_QStringConverter::decodeUtf8_data()
+{
+    addCorpora();
+}
+
+void tst_QStringConverter::decodeUtf8()
+{
+    QFETCH(QString, text);
+    const QByteArray utf8 = text.toUtf8();
+
+    QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+    QString result;
+    QBENCHMARK {
+        result = decoder.decode(utf8);
+    }
+    QCOMPARE(result, text);
+}
+
+void tst_QStringConverter::encodeUtf8_data()
+{
+    addCorpora();
+}
+
+void tst_QStringConverter::encodeUtf8()
+{
+    QFETCH(QString, text);
+    const QByteArray expected = text.toUtf8();
+
+    QStringEncoder encoder(QStringEncoder::Utf8, QStringEncoder::Flag::Stateless);
+    QByteArray result;
+    QBENCHMARK {
+        result = encoder.encode(text);
+    }
+    QCOMPARE(result, expected);
+}
+
+QTEST_MAIN(tst_QStringConverter)
+
+#include "main.moc"
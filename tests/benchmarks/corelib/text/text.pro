@@ -3,6 +3,7 @@ SUBDIRS = \
         qbytearray \
         qchar \
         qlocale \
+        qstringconverter \
         qstringbuilder \
         qstringlist
 
@@ -30,12 +30,16 @@
 #include <QTextDocument>
 #include <qtest.h>
 
+#include <private/qtextdocumentlayout_p.h>
+
 class tst_QTextDocument : public QObject
 {
     Q_OBJECT
 private slots:
     void mightBeRichText_data();
     void mightBeRichText();
+    void layout_data();
+    void layout();
 };
 
 void tst_QTextDocument::mightBeRichText_data()
@@ -66,6 +70,39 @@ void tst_QTextDocument::mightBeRichText()
     }
 }
 
+void tst_QTextDocument::layout_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::newRow("sequential") << false;
+    QTest::newRow("parallel") << true;
+}
+
+void tst_QTextDocument::layout()
+{
+    QFETCH(bool, parallel);
+
+    QString text;
+    for (int i = 0; i < 2000; ++i) {
+        text += QString::fromLatin1("Paragraph %1: the quick brown fox jumps over the lazy dog, ").arg(i);
+        text += QString::fromUtf8("\u00e9t\u00e9 \u05e9\u05dc\u05d5\u05dd ");
+        text += QLatin1String("and keeps on running for a while until it reaches the end of the line\n");
+    }
+
+    QTextDocument document;
+    auto *layout = qobject_cast<QTextDocumentLayout *>(document.documentLayout());
+    QVERIFY(layout);
+    layout->setParallelLayoutEnabled(parallel);
+    document.setPlainText(text);
+
+    qreal width = 300;
+    QBENCHMARK {
+        // a different width each time, so that all blocks need new lines
+        width = width == 300 ? 301 : 300;
+        document.setTextWidth(width);
+        document.size();
+    }
+}
+
 QTEST_MAIN(tst_QTextDocument)
 
 #include "main.moc"
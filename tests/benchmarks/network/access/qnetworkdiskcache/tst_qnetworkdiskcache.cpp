@@ -53,7 +53,7 @@ class tst_qnetworkdiskcache : public QObject
 {
     Q_OBJECT
 private:
-    void injectFakeData();
+    void injectFakeData(quint32 count = NumFakeCacheObjects);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
@@ -77,6 +77,10 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+    void timeFullCacheInsertion_data();
+    void timeFullCacheInsertion();
+    void timeReopen_data();
+    void timeReopen();
 };
 
 
@@ -323,11 +327,101 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+
+void tst_qnetworkdiskcache::timeFullCacheInsertion_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<int>("entries");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("1000 entries") << cacheLoc << 1000;
+    QTest::newRow("10000 entries") << cacheLoc << 10000;
+}
+
+//Times insertions into a cache that is full, so that
+//every insertion has to evict the least recently used entries.
+void tst_qnetworkdiskcache::timeFullCacheInsertion()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    initCacheObject();
+    cleanRecursive(cacheDir); // slow op.
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+
+    injectFakeData(entries);
+
+    //Shrink the cache to what is stored already, so that insertions keep evicting
+    cache->setMaximumCacheSize(cache->cacheSize());
+    const qint64 limit = cache->maximumCacheSize();
+
+    QBENCHMARK_ONCE {
+        for (quint32 i = entries; i < quint32(entries) + NumInsertions; i++) {
+            QNetworkCacheMetaData meta;
+            QString fakeURL;
+            QTextStream stream(&fakeURL);
+            stream << fakeURLbase << i;
+            QUrl url(fakeURL);
+            meta.setUrl(url);
+            meta.setSaveToDisk(true);
+
+            QIODevice *device = cache->prepare(meta);
+            device->write(payload);
+            cache->insert(device);
+        }
+    }
+    QVERIFY(cache->cacheSize() <= limit);
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
+void tst_qnetworkdiskcache::timeReopen_data()
+{
+    timeFullCacheInsertion_data();
+}
+
+//Times opening a populated cache and querying its size.
+void tst_qnetworkdiskcache::timeReopen()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    initCacheObject();
+    cleanRecursive(cacheDir); // slow op.
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+
+    injectFakeData(entries);
+    const qint64 size = cache->cacheSize();
+    cleanupCacheObject();
+
+    QBENCHMARK_ONCE {
+        initCacheObject();
+        cache->setCacheDirectory(cacheDir);
+        QCOMPARE(cache->cacheSize(), size);
+        cleanupCacheObject();
+    }
+
+    //Cleanup (slow)
+    cleanRecursive(cacheDir);
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
-void tst_qnetworkdiskcache::injectFakeData()
+void tst_qnetworkdiskcache::injectFakeData(quint32 count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -335,7 +429,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (quint32 i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void sendReceive_data();
+    void sendReceive();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,52 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::sendReceive_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("size");
+    for (int value : {64, 512, 1400}) {
+        QTest::addRow("single-%d", value) << false << value;
+        QTest::addRow("batched-%d", value) << true << value;
+    }
+}
+
+void tst_QUdpSocket::sendReceive()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, size);
+    const int count = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < count; ++i)
+        datagrams.append(QNetworkDatagram(QByteArray(size, 'a'), QHostAddress::LocalHost,
+                                          receiver.localPort()));
+
+    QBENCHMARK {
+        int received = 0;
+        if (batched) {
+            QCOMPARE(sender.writeDatagrams(datagrams), qsizetype(count));
+            while (received < count && receiver.waitForReadyRead(5000))
+                received += receiver.receiveDatagrams(count - received, size).size();
+        } else {
+            for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+                QCOMPARE(sender.writeDatagram(datagram), qint64(size));
+            while (received < count && receiver.waitForReadyRead(5000)) {
+                while (received < count && receiver.hasPendingDatagrams()) {
+                    receiver.receiveDatagram(size);
+                    ++received;
+                }
+            }
+        }
+        QCOMPARE(received, count);
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"